@@ -48,8 +48,11 @@ CREATE TABLE IF NOT EXISTS `QInfo` (
   `returned` TIMESTAMP NULL COMMENT 'Time when result is sent back to user. NULL if not completed yet.',
   `messageTable` CHAR(63) NULL COMMENT 'Name of the message table for the ASYNC query',
   `resultLocation` TEXT NULL COMMENT 'Result destination - table name, file name, etc.',
+  `qTemplateHash` BINARY(16) NULL COMMENT 'MD5 hash of the query template, used to find similar queries',
+  `resultBytes` BIGINT NULL COMMENT 'Size of the data merged into the result table, NULL if unknown',
   PRIMARY KEY (`queryId`),
   INDEX `QInfo_czarId_index` (`czarId` ASC),
+  INDEX `QInfo_qTemplateHash_index` (`qTemplateHash` ASC),
   CONSTRAINT `QInfo_cid`
     FOREIGN KEY (`czarId`)
     REFERENCES `QCzar` (`czarId`)
@@ -95,6 +98,26 @@ CREATE TABLE IF NOT EXISTS `QWorker` (
 ENGINE = InnoDB
 COMMENT = 'Mapping of queries to workers';
 
+-- -----------------------------------------------------
+-- Table `QTrace`
+-- -----------------------------------------------------
+CREATE TABLE IF NOT EXISTS `QTrace` (
+  `queryId` BIGINT NOT NULL COMMENT 'Query ID',
+  `jobId` INT NOT NULL COMMENT 'Job ID within the query',
+  `chunk` INT NOT NULL COMMENT 'Chunk number, -1 if not known',
+  `source` CHAR(63) NOT NULL COMMENT 'Where the span was recorded, czar or worker host name',
+  `stage` CHAR(32) NOT NULL COMMENT 'Processing stage',
+  `start` BIGINT NOT NULL COMMENT 'Start of the stage, microseconds since epoch',
+  `duration` BIGINT NOT NULL COMMENT 'Time spent in the stage, microseconds',
+  INDEX `QTrace_queryId_index` (`queryId` ASC, `jobId` ASC),
+  CONSTRAINT `QTrace_qid`
+    FOREIGN KEY (`queryId`)
+    REFERENCES `QInfo` (`queryId`)
+    ON DELETE CASCADE
+    ON UPDATE CASCADE)
+ENGINE = InnoDB
+COMMENT = 'Timeline of processing stages of traced queries';
+
 -- -----------------------------------------------------
 -- Table `QStatsTmp`
 -- MEMORY table - will be recreated(but empty) by mariadb every time server starts. 
@@ -183,7 +206,9 @@ COMMENT = 'Metadata about database as a whole, bunch of key-value pairs';
 -- QMetadata table at all.
 -- Version 1 introduced QMetadata table and altered schema for QInfo table
 -- Version 2 added query progress data to ProcessList tables.
-INSERT INTO `QMetadata` (`metakey`, `value`) VALUES ('version', '2');
+-- Version 3 added query template hash and result size to QInfo table.
+-- Version 4 added QTrace table.
+INSERT INTO `QMetadata` (`metakey`, `value`) VALUES ('version', '4');
 
 SET SQL_MODE=@OLD_SQL_MODE;
 SET FOREIGN_KEY_CHECKS=@OLD_FOREIGN_KEY_CHECKS;
@@ -26,6 +26,7 @@
 
 // System headers
 #include <cassert>
+#include <cstdint>
 
 // LSST headers
 #include "lsst/log/Log.h"
@@ -38,7 +39,9 @@
 #include "proto/ProtoHeaderWrap.h"
 #include "proto/ProtoImporter.h"
 #include "proto/WorkerResponse.h"
+#include "proto/WorkerResponsePool.h"
 #include "qdisp/JobQuery.h"
+#include "qdisp/QueryRequest.h"
 #include "rproc/InfileMerger.h"
 #include "util/common.h"
 #include "util/StringHash.h"
@@ -50,6 +53,11 @@ using lsst::qserv::proto::WorkerResponse;
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.ccontrol.MergingHandler");
+
+/// Responses are recycled between all handlers, which avoids allocating
+/// and freeing the whole message tree for every result message.
+lsst::qserv::proto::WorkerResponsePool::Ptr responsePool =
+    lsst::qserv::proto::WorkerResponsePool::create(256, 16*1024*1024);
 }
 
 
@@ -59,6 +67,7 @@ namespace ccontrol {
 
 std::atomic<std::int64_t> MergeBuffer::_totalBytes{0};
 std::atomic<int> MergeBuffer::_sequence{0};
+size_t const MergeBuffer::maxRetainedBytes = 16*1024*1024;
 
 ////////////////////////////////////////////////////////////////////////
 // MergingHandler public
@@ -68,7 +77,7 @@ MergingHandler::MergingHandler(
     std::shared_ptr<rproc::InfileMerger> merger,
     std::string const& tableName)
     : _msgReceiver{msgReceiver}, _infileMerger{merger}, _tableName{tableName},
-      _response{new WorkerResponse()} {
+      _response{responsePool->get()} {
     _initState();
 }
 
@@ -114,9 +123,18 @@ bool MergingHandler::flush(int bLen, bool& last, bool& largeResult) {
 
         LOGS(_log, LOG_LVL_DEBUG, "HEADER_SIZE_WAIT: From:" << _wName
              << "Resizing buffer to " <<  _response->protoHeader.size());
-        _mBuf.zero(); // Free memory.
+        _mBuf.clear(); // Keep memory for the result message.
         _mBuf.setTargetSize(_response->protoHeader.size());
         largeResult = _response->protoHeader.largeresult();
+        if (_response->protoHeader.combined()) {
+            // The worker combined the rows of this job with those of other jobs,
+            // retrying it alone would lose their rows or merge its rows twice.
+            if (auto job = getJobQuery().lock()) {
+                if (auto queryRequest = job->getQueryRequest()) {
+                    queryRequest->doNotRetry();
+                }
+            }
+        }
         _state = MsgState::RESULT_WAIT;
         return true;
 
@@ -124,13 +142,37 @@ bool MergingHandler::flush(int bLen, bool& last, bool& largeResult) {
         {
             auto jobQuery = getJobQuery().lock();
             auto jobId = (jobQuery != nullptr) ? jobQuery->getIdStr() : "?";
+            auto trace = (jobQuery != nullptr) ? jobQuery->getTrace() : nullptr;
+            std::uint64_t const decodeStart = (trace != nullptr) ? qdisp::QueryTrace::now() : 0;
             if (!_verifyResult()) { return false; }
             if (!_setResult()) { return false; } // set _response->result
+            if (trace != nullptr) {
+                int const chunkId = jobQuery->getChunkId();
+                trace->addSince(jobQuery->getIdInt(), chunkId, "decode", decodeStart);
+                trace->addWorkerSpans(jobQuery->getIdInt(), chunkId, _wName, _response->result);
+            }
+            // The rows of these jobs come with this result, they must not be retried.
+            for (auto const& combinedJob : _response->result.combinedjob()) {
+                auto executive = (jobQuery != nullptr) ? jobQuery->getExecutive() : nullptr;
+                if (executive == nullptr
+                    || !executive->markCombined(combinedJob.jobid(), combinedJob.attemptcount())) {
+                    _setError(ccontrol::MSG_RESULT_ERROR, "From:" + _wName + " rows of job "
+                              + std::to_string(combinedJob.jobid()) + " were combined with "
+                              + jobId + " after the job was retried");
+                    _state = MsgState::RESULT_ERR;
+                    return false;
+                }
+            }
             largeResult = _response->result.largeresult();
             LOGS(_log, LOG_LVL_DEBUG, jobId << " From:" << _wName << " _mBuf "
                     << util::prettyCharList(_mBuf.getBuffer(), 5));
-            _mBuf.zero(); // not needed after _response->result set.
             bool msgContinues = _response->result.continues();
+            // Buffer contents are not needed after _response->result set.
+            if (msgContinues) {
+                _mBuf.clear(); // Keep memory for the next message.
+            } else {
+                _mBuf.zero(); // No more messages, free memory.
+            }
             _state = MsgState::RESULT_RECV;
             if (msgContinues) {
                 LOGS(_log, LOG_LVL_DEBUG, jobId << " Message continues, waiting for next header.");
@@ -145,7 +187,7 @@ bool MergingHandler::flush(int bLen, bool& last, bool& largeResult) {
 
             auto success = _merge();
             if (msgContinues) {
-                _response.reset(new WorkerResponse());
+                _response = responsePool->get();
             }
             return success;
         }
@@ -159,7 +201,7 @@ bool MergingHandler::flush(int bLen, bool& last, bool& largeResult) {
         largeResult = _response->protoHeader.largeresult();
         LOGS(_log, LOG_LVL_DEBUG, "RESULT_EXTRA: Resizing buffer to "
              << _response->protoHeader.size() << " largeResult=" << largeResult);
-        _mBuf.zero();
+        _mBuf.clear();
         _mBuf.setTargetSize(_response->protoHeader.size());
         _state = MsgState::RESULT_WAIT;
         return true;
@@ -226,6 +268,7 @@ void MergingHandler::_initState() {
     _mBuf.setTargetSize(proto::ProtoHeaderWrap::PROTO_HEADER_SIZE);
     _state = MsgState::HEADER_SIZE_WAIT;
     _setError(0, "");
+    _mergedRows = 0;
 }
 
 bool MergingHandler::_merge() {
@@ -233,12 +276,20 @@ bool MergingHandler::_merge() {
         if (_flushed) {
             throw Bug("MergingRequester::_merge : already flushed");
         }
+        int const rows = _response->result.row_size();
+        auto trace = job->getTrace();
+        std::uint64_t const mergeStart = (trace != nullptr) ? qdisp::QueryTrace::now() : 0;
         bool success = _infileMerger->merge(_response);
+        if (trace != nullptr) {
+            trace->addSince(job->getIdInt(), job->getChunkId(), "merge", mergeStart);
+        }
         if (!success) {
             LOGS(_log, LOG_LVL_WARN, "_merge() failed");
             rproc::InfileMergerError const& err = _infileMerger->getError();
             _setError(ccontrol::MSG_RESULT_ERROR, err.getMsg());
             _state = MsgState::RESULT_ERR;
+        } else {
+            _mergedRows += rows;
         }
         _response.reset();
         return success;
@@ -255,7 +306,7 @@ void MergingHandler::_setError(int code, std::string const& msg) {
 
 bool MergingHandler::_setResult() {
     auto start = std::chrono::system_clock::now();
-    auto buff = _mBuf.getBuffer();
+    auto& buff = _mBuf.getBuffer();
     if (!ProtoImporter<proto::Result>::setMsgFrom(_response->result, &((buff)[0]), _mBuf.getSize())) {
         _setError(ccontrol::MSG_RESULT_DECODE, "Error decoding result msg");
         _state = MsgState::RESULT_ERR;
@@ -267,7 +318,7 @@ bool MergingHandler::_setResult() {
     return true;
 }
 bool MergingHandler::_verifyResult() {
-    auto buff = _mBuf.getBuffer();
+    auto& buff = _mBuf.getBuffer();
     if (_response->protoHeader.md5() != util::StringHash::getMd5(buff.data(), _mBuf.getSize())) {
         _setError(ccontrol::MSG_RESULT_MD5, "Result message MD5 mismatch");
         _state = MsgState::RESULT_ERR;
@@ -278,8 +329,8 @@ bool MergingHandler::_verifyResult() {
 
 
 MergeBuffer::~MergeBuffer() {
-    if (_buff != nullptr && _buff->size() != 0) {
-        _totalBytes -= _buff->size();
+    if (_heldBytes != 0) {
+        _totalBytes -= _heldBytes;
         LOGS(_log, LOG_LVL_DEBUG, _id << " ~ totalBytes=" << _totalBytes);
     }
 }
@@ -312,25 +363,42 @@ void MergeBuffer::resizeToTargetSize() {
 }
 
 
+void MergeBuffer::clear() {
+    if (_buff == nullptr || _buff->capacity() > maxRetainedBytes) {
+        zero();
+        return;
+    }
+    setTargetSize(0);
+    // clear() leaves the capacity unchanged.
+    _buff->clear();
+}
+
+
 void MergeBuffer::zero() {
     setTargetSize(0);
-    if (_buff != nullptr && _buff->size() != 0) {
-        _totalBytes -= _buff->size();
-        LOGS(_log, LOG_LVL_DEBUG, _id << " zero totalBytes=" << _totalBytes);
-    }
     // Just resizing to 0 would not guarantee freeing the memory.
     _buff.reset(new bufType(0));
+    _updateHeldBytes();
  }
 
 
  void MergeBuffer::_resize(int sz) {
      if (sz != (int)_buff->size()) {
-         _totalBytes += sz - _buff->size();
          _buff->resize(sz);
-         LOGS(_log, LOG_LVL_DEBUG, _id << " resize totalBytes=" << _totalBytes);
+         _updateHeldBytes();
      } else if (sz != 0) {
          LOGS(_log, LOG_LVL_WARN, _id << " resize called twice sz=" << sz << " totalBytes=" << _totalBytes);
      }
  }
 
+
+void MergeBuffer::_updateHeldBytes() {
+    size_t const held = _buff->capacity();
+    if (held != _heldBytes) {
+        _totalBytes += static_cast<std::int64_t>(held) - static_cast<std::int64_t>(_heldBytes);
+        _heldBytes = held;
+        LOGS(_log, LOG_LVL_DEBUG, _id << " held=" << _heldBytes << " totalBytes=" << _totalBytes);
+    }
+}
+
 }}} // lsst::qserv::ccontrol
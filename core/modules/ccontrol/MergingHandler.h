@@ -49,7 +49,9 @@ namespace ccontrol {
 /// A class to delay creating the buffer until it is requested
 /// by xrootd SSI. The size of the buffer that will be needed is
 /// set using setTargetSize(int sz), and the buffer of that size is
-/// created by calling resizeToTargetSize(). When a buffer is no longer
+/// created by calling resizeToTargetSize(). When a message has been
+/// consumed, clear() should be called to make the buffer ready for the
+/// next message while keeping its memory. When a buffer is no longer
 /// needed, zero() should be called to free the memory.
 class MergeBuffer {
 public:
@@ -69,15 +71,20 @@ public:
     size_t getTargetSize() { return _targetSize; }
     void setTargetSize(int sz);
     void resizeToTargetSize();
+    void clear(); ///< Set buffer size and _targetSize to zero, keep memory for reuse.
     void zero(); ///< Set buffer size and _targetSize to zero, ensure memory is freed.
 
+    /// Buffers with larger capacity are freed by clear().
+    static size_t const maxRetainedBytes;
 
 private:
     void _resize(int sz);
+    void _updateHeldBytes(); ///< Update _totalBytes after the buffer capacity changed.
 
     std::string _id;
     std::unique_ptr<bufType> _buff;
     int _targetSize{0};
+    size_t _heldBytes{0}; ///< number of bytes held by this instance.
     static std::atomic<std::int64_t> _totalBytes; ///< number of bytes held by all instances.
     static std::atomic<int> _sequence;
 };
@@ -147,6 +154,8 @@ public:
     /// Prepare to scrub the results from jobId-attempt from the result table.
     void prepScrubResults(int jobId, int attempt) override;
 
+    std::int64_t getMergedRows() const override { return _mergedRows; }
+
 private:
     void _initState();
     bool _merge();
@@ -162,8 +171,9 @@ private:
     Error _error; ///< Error description
     mutable std::mutex _errorMutex; ///< Protect readers from partial updates
     MsgState _state; ///< Received message state
-    std::shared_ptr<proto::WorkerResponse> _response; ///< protobufs msg buf
+    std::shared_ptr<proto::WorkerResponse> _response; ///< protobufs msg buf, recycled
     bool _flushed {false}; ///< flushed to InfileMerger?
+    std::atomic<std::int64_t> _mergedRows{0}; ///< rows merged since the last reset
     std::string _wName {"~"}; /// worker name
 };
 
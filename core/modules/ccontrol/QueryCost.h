@@ -0,0 +1,52 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_QSERV_CCONTROL_QUERYCOST_H
+#define LSST_QSERV_CCONTROL_QUERYCOST_H
+
+// System headers
+#include <cstdint>
+#include <ostream>
+
+namespace lsst {
+namespace qserv {
+namespace ccontrol {
+
+/// Estimated czar-side cost of a user query, used for admission control.
+/// Default-constructed cost describes a query which needs no dispatching
+/// at all (e.g. metadata queries), such queries are never throttled.
+struct QueryCost {
+    int chunkCount{0};              ///< number of chunk queries to dispatch
+    int scanRating{0};              ///< slowest scan rating, see proto::ScanInfo::Rating
+    bool interactive{true};         ///< true for queries which touch few chunks
+    std::int64_t resultBytes{-1};   ///< expected result size, negative if unknown
+};
+
+inline std::ostream& operator<<(std::ostream& os, QueryCost const& cost) {
+    return os << "QueryCost(chunks=" << cost.chunkCount << " scanRating=" << cost.scanRating
+              << " interactive=" << cost.interactive << " resultBytes=" << cost.resultBytes << ")";
+}
+
+}}} // namespace lsst::qserv::ccontrol
+
+#endif // LSST_QSERV_CCONTROL_QUERYCOST_H
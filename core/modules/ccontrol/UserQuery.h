@@ -37,6 +37,7 @@
 // Third-party headers
 
 // Qserv headers
+#include "ccontrol/QueryCost.h"
 #include "ccontrol/QueryState.h"
 #include "global/intTypes.h"
 
@@ -106,6 +107,10 @@ public:
     /// @return True if query is async query
     virtual bool isAsync() const { return false; }
 
+    /// @return estimated cost of the query for admission control, default
+    /// cost means the query does not dispatch anything to workers.
+    virtual QueryCost getCost() const { return QueryCost(); }
+
     /// set up the merge table (stores results from workers)
     /// @throw UserQueryError if the merge table can't be set up (maybe the user query is not valid?). The
     /// exception's what() message will be returned to the user.
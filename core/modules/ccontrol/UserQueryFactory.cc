@@ -25,7 +25,9 @@
 #include "ccontrol/UserQueryFactory.h"
 
 // System headers
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
 #include <string>
 
@@ -55,6 +57,7 @@
 #include "qmeta/QMetaMysql.h"
 #include "qmeta/QMetaSelect.h"
 #include "qmeta/QStatusMysql.h"
+#include "qproc/QueryPlanCache.h"
 #include "qproc/QuerySession.h"
 #include "qproc/SecondaryIndex.h"
 #include "query/FromList.h"
@@ -83,11 +86,14 @@ public:
     std::shared_ptr<css::CssAccess> css;
     mysql::MySqlConfig const mysqlResultConfig;
     std::shared_ptr<qproc::SecondaryIndex> secondaryIndex;
+    qproc::QueryPlanCache::Ptr queryPlanCache; ///< nullptr if plan caching is disabled
     std::shared_ptr<qmeta::QMeta> queryMetadata;
     std::shared_ptr<qmeta::QStatus> queryStatsData;
     std::shared_ptr<qmeta::QMetaSelect> qMetaSelect;
     std::unique_ptr<sql::SqlConnection> resultDbConn;
     qmeta::CzarId qMetaCzarId = {0};   ///< Czar ID in QMeta database
+    unsigned int traceEveryNQueries = 0; ///< 0 if tracing is disabled
+    std::atomic<unsigned int> selectCount{0}; ///< Number of SELECT queries, used to pick traced ones
 };
 
 
@@ -147,53 +153,65 @@ UserQueryFactory::newUserQuery(std::string const& aQuery,
         bool sessionValid = true;
         std::string errorExtra;
 
-        // Parse SELECT
-
-        auto parser = parser::SelectParser::newInstance(query);
-        try {
-            parser->setup();
-        } catch (parser::ParseException& e) {
-            return std::make_shared<UserQueryInvalid>(std::string("ParseException:") + e.what());
+        // Queries with the shape of an already analyzed query reuse its plan,
+        // parsing and analysis are skipped.
+        std::shared_ptr<qproc::QuerySession> qs;
+        if (_impl->queryPlanCache != nullptr) {
+            qs = _impl->queryPlanCache->find(query, defaultDb);
         }
-        auto stmt = parser->getSelectStmt();
-
-        // handle special database/table names
-        auto&& tblRefList = stmt->getFromList().getTableRefList();
-        if (tblRefList.size() == 1) {
-            auto&& tblRef = tblRefList[0];
-            std::string const db = tblRef->getDb().empty() ? defaultDb : tblRef->getDb();
-            if (UserQueryType::isProcessListTable(db, tblRef->getTable())) {
-                if (async) {
-                    // no point supporting async for these
-                    auto uq = std::make_shared<UserQueryInvalid>("SUBMIT is not allowed with query: " + aQuery);
-                    return uq;
-                }
-                LOGS(_log, LOG_LVL_DEBUG, "SELECT query is a PROCESSLIST");
-                try {
-                    return std::make_shared<UserQueryProcessList>(stmt, _impl->resultDbConn.get(),
-                            _impl->qMetaSelect, _impl->qMetaCzarId, userQueryId);
-                } catch(std::exception const& exc) {
-                    return std::make_shared<UserQueryInvalid>(exc.what());
+
+        if (qs == nullptr) {
+            // Parse SELECT
+
+            auto parser = parser::SelectParser::newInstance(query);
+            try {
+                parser->setup();
+            } catch (parser::ParseException& e) {
+                return std::make_shared<UserQueryInvalid>(std::string("ParseException:") + e.what());
+            }
+            auto stmt = parser->getSelectStmt();
+
+            // handle special database/table names
+            auto&& tblRefList = stmt->getFromList().getTableRefList();
+            if (tblRefList.size() == 1) {
+                auto&& tblRef = tblRefList[0];
+                std::string const db = tblRef->getDb().empty() ? defaultDb : tblRef->getDb();
+                if (UserQueryType::isProcessListTable(db, tblRef->getTable())) {
+                    if (async) {
+                        // no point supporting async for these
+                        auto uq = std::make_shared<UserQueryInvalid>("SUBMIT is not allowed with query: " + aQuery);
+                        return uq;
+                    }
+                    LOGS(_log, LOG_LVL_DEBUG, "SELECT query is a PROCESSLIST");
+                    try {
+                        return std::make_shared<UserQueryProcessList>(stmt, _impl->resultDbConn.get(),
+                                _impl->qMetaSelect, _impl->qMetaCzarId, userQueryId);
+                    } catch(std::exception const& exc) {
+                        return std::make_shared<UserQueryInvalid>(exc.what());
+                    }
                 }
             }
-        }
 
-        // This is a regular SELECT for qserv
-
-        // Currently using the database for results to get schema information.
-        auto qs = std::make_shared<qproc::QuerySession>(_impl->css,
-                                                        _impl->mysqlResultConfig,
-                                                        defaultDb);
-        try {
-            qs->analyzeQuery(query, stmt);
-        } catch (...) {
-            errorExtra = "Unknown failure occurred setting up QuerySession (query is invalid).";
-            LOGS(_log, LOG_LVL_ERROR, errorExtra);
-            sessionValid = false;
-        }
-        if (!qs->getError().empty()) {
-            LOGS(_log, LOG_LVL_ERROR, "Invalid query: " << qs->getError());
-            sessionValid = false;
+            // This is a regular SELECT for qserv
+
+            // Currently using the database for results to get schema information.
+            qs = std::make_shared<qproc::QuerySession>(_impl->css,
+                                                       _impl->mysqlResultConfig,
+                                                       defaultDb);
+            try {
+                qs->analyzeQuery(query, stmt);
+            } catch (...) {
+                errorExtra = "Unknown failure occurred setting up QuerySession (query is invalid).";
+                LOGS(_log, LOG_LVL_ERROR, errorExtra);
+                sessionValid = false;
+            }
+            if (!qs->getError().empty()) {
+                LOGS(_log, LOG_LVL_ERROR, "Invalid query: " << qs->getError());
+                sessionValid = false;
+            }
+            if (sessionValid && _impl->queryPlanCache != nullptr) {
+                _impl->queryPlanCache->insert(query, defaultDb, qs);
+            }
         }
 
         auto messageStore = std::make_shared<qdisp::MessageStore>();
@@ -202,6 +220,10 @@ UserQueryFactory::newUserQuery(std::string const& aQuery,
         if (sessionValid) {
             executive = qdisp::Executive::create(*_impl->executiveConfig, messageStore,
                                                  qdispPool, _impl->queryStatsData);
+            if (_impl->traceEveryNQueries > 0 &&
+                    _impl->selectCount++ % _impl->traceEveryNQueries == 0) {
+                executive->setTrace(std::make_shared<qdisp::QueryTrace>());
+            }
             infileMergerConfig = std::make_shared<rproc::InfileMergerConfig>(_impl->mysqlResultConfig);
         }
         auto uq = std::make_shared<UserQuerySelect>(qs, messageStore, executive, infileMergerConfig,
@@ -228,6 +250,7 @@ UserQueryFactory::newUserQuery(std::string const& aQuery,
                                                   _impl->resultDbConn.get(),
                                                   _impl->queryMetadata, _impl->qMetaCzarId);
         LOGS(_log, LOG_LVL_DEBUG, "make UserQueryDrop: " << dbName << "." << tableName);
+        if (_impl->queryPlanCache != nullptr) _impl->queryPlanCache->clear();
         return uq;
     } else if (UserQueryType::isDropDb(query, dbName)) {
         // processing DROP DATABASE
@@ -235,11 +258,14 @@ UserQueryFactory::newUserQuery(std::string const& aQuery,
                                                   _impl->resultDbConn.get(),
                                                   _impl->queryMetadata, _impl->qMetaCzarId);
         LOGS(_log, LOG_LVL_DEBUG, "make UserQueryDrop: db=" << dbName);
+        if (_impl->queryPlanCache != nullptr) _impl->queryPlanCache->clear();
         return uq;
     } else if (UserQueryType::isFlushChunksCache(query, dbName)) {
         auto uq = std::make_shared<UserQueryFlushChunksCache>(_impl->css, dbName,
-                                                              _impl->resultDbConn.get());
+                                                              _impl->resultDbConn.get(),
+                                                              _impl->secondaryIndex);
         LOGS(_log, LOG_LVL_DEBUG, "make UserQueryFlushChunksCache: " << dbName);
+        if (_impl->queryPlanCache != nullptr) _impl->queryPlanCache->clear();
         return uq;
     } else if (UserQueryType::isShowProcessList(query, full)) {
         LOGS(_log, LOG_LVL_DEBUG, "make UserQueryProcessList: full=" << (full ? 'y' : 'n'));
@@ -262,7 +288,9 @@ UserQueryFactory::Impl::Impl(czar::CzarConfig const& czarConfig)
     executiveConfig = std::make_shared<qdisp::Executive::Config>(
                           czarConfig.getXrootdFrontendUrl(),
                           czarConfig.getQMetaSecondsBetweenChunkUpdates());
-    secondaryIndex = std::make_shared<qproc::SecondaryIndex>(mysqlResultConfig);
+    secondaryIndex = std::make_shared<qproc::SecondaryIndex>(mysqlResultConfig,
+                                                             czarConfig.getSecondaryIndexCacheSize(),
+                                                             czarConfig.getSecondaryIndexPath());
 
     // make one dedicated connection for results database
     resultDbConn.reset(new sql::SqlConnection(mysqlResultConfig));
@@ -274,6 +302,16 @@ UserQueryFactory::Impl::Impl(czar::CzarConfig const& czarConfig)
 
     // create CssAccess instance
     css = css::CssAccess::createFromConfig(czarConfig.getCssConfigMap(), czarConfig.getEmptyChunkPath());
+
+    if (czarConfig.getTraceEveryNQueries() > 0) {
+        traceEveryNQueries = czarConfig.getTraceEveryNQueries();
+    }
+
+    if (czarConfig.getQueryPlanCacheSize() > 0) {
+        queryPlanCache = std::make_shared<qproc::QueryPlanCache>(
+                             css, mysqlResultConfig, czarConfig.getQueryPlanCacheSize(),
+                             std::chrono::seconds(czarConfig.getQueryPlanCacheCssCheckSecs()));
+    }
 }
 
 }}} // lsst::qserv::ccontrol
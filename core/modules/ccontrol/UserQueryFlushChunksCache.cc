@@ -32,6 +32,7 @@
 #include "css/CssAccess.h"
 #include "css/EmptyChunks.h"
 #include "qdisp/MessageStore.h"
+#include "qproc/SecondaryIndex.h"
 #include "sql/SqlConnection.h"
 #include "sql/SqlErrorObject.h"
 
@@ -46,8 +47,9 @@ namespace ccontrol {
 // Constructor
 UserQueryFlushChunksCache::UserQueryFlushChunksCache(std::shared_ptr<css::CssAccess> const& css,
                                                      std::string const& dbName,
-                                                     sql::SqlConnection* resultDbConn)
-    : _css(css), _dbName(dbName), _resultDbConn(resultDbConn),
+                                                     sql::SqlConnection* resultDbConn,
+                                                     std::shared_ptr<qproc::SecondaryIndex> const& secondaryIndex)
+    : _css(css), _dbName(dbName), _resultDbConn(resultDbConn), _secondaryIndex(secondaryIndex),
       _qState(UNKNOWN), _messageStore(std::make_shared<qdisp::MessageStore>()) {
 }
 
@@ -67,6 +69,11 @@ void UserQueryFlushChunksCache::submit() {
     // reset empty chunk cache , this does not throw
     _css->getEmptyChunks().clearCache(_dbName);
 
+    // drop cached secondary index entries and re-open index files
+    if (_secondaryIndex) {
+        _secondaryIndex->clearCache(_dbName);
+    }
+
     _qState = SUCCESS;
 }
 
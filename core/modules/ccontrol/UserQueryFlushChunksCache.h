@@ -36,6 +36,9 @@ namespace qserv {
 namespace css {
 class CssAccess;
 }
+namespace qproc {
+class SecondaryIndex;
+}
 namespace sql {
 class SqlConnection;
 }}}
@@ -56,13 +59,15 @@ class UserQueryFlushChunksCache : public UserQuery {
 public:
 
     /**
-     *  @param css:           CSS interface
-     *  @param dbName:        Name of the database where table is
-     *  @param resultDbConn:  Connection to results database
+     *  @param css:             CSS interface
+     *  @param dbName:          Name of the database where table is
+     *  @param resultDbConn:    Connection to results database
+     *  @param secondaryIndex:  Secondary index whose cache is flushed as well
      */
     UserQueryFlushChunksCache(std::shared_ptr<css::CssAccess> const& css,
                               std::string const& dbName,
-                              sql::SqlConnection* resultDbConn);
+                              sql::SqlConnection* resultDbConn,
+                              std::shared_ptr<qproc::SecondaryIndex> const& secondaryIndex=nullptr);
 
     UserQueryFlushChunksCache(UserQueryFlushChunksCache const&) = delete;
     UserQueryFlushChunksCache& operator=(UserQueryFlushChunksCache const&) = delete;
@@ -97,6 +102,7 @@ private:
     std::shared_ptr<css::CssAccess> const _css;
     std::string const _dbName;
     sql::SqlConnection* _resultDbConn;
+    std::shared_ptr<qproc::SecondaryIndex> const _secondaryIndex;
     QueryState _qState;
     std::shared_ptr<qdisp::MessageStore> _messageStore;
 
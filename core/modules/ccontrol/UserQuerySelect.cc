@@ -211,7 +211,9 @@ void UserQuerySelect::submit() {
     LOGS(_log, LOG_LVL_DEBUG, getQueryIdString() << " UserQuerySelect beginning submission");
     assert(_infileMerger);
 
-    auto taskMsgFactory = std::make_shared<qproc::TaskMsgFactory>(_qMetaQueryId);
+    auto const trace = _executive->getTrace();
+    auto taskMsgFactory = std::make_shared<qproc::TaskMsgFactory>(_qMetaQueryId, trace != nullptr,
+                                                                  _qSession->getCombineOps());
     TmpTableName ttn(_qMetaQueryId, _qSession->getOriginal());
     std::vector<int> chunks;
     std::mutex chunksMtx;
@@ -243,18 +245,24 @@ void UserQuerySelect::submit() {
     }
 
     _executive->setScanInteractive(_qSession->getScanInteractive());
+    // Stop dispatching and squash remaining jobs once enough rows are merged.
+    _executive->setResultRowLimit(_qSession->getResultRowLimit());
 
     for(auto i = _qSession->cQueryBegin(), e = _qSession->cQueryEnd();
             i != e && !_executive->getCancelled(); ++i) {
         auto& chunkSpec = *i;
 
+        std::uint64_t const queuedAt = (trace != nullptr) ? qdisp::QueryTrace::now() : 0;
         std::function<void(util::CmdData*)> funcBuildJob =
                 [this, sequence,     // sequence must be a copy
                  &chunkSpec, &queryTemplates,
                  &chunks, &chunksMtx, &ttn,
-                 &taskMsgFactory, &addTimeSum](util::CmdData*) {
+                 &taskMsgFactory, &addTimeSum, &trace, queuedAt](util::CmdData*) {
 
             auto startbuildQSJ = std::chrono::system_clock::now(); // TEMPORARY-timing
+            if (trace != nullptr) {
+                trace->addSince(sequence, chunkSpec.chunkId, "dispatchQueue", queuedAt);
+            }
             qproc::ChunkQuerySpec::Ptr cs;
             {
                 std::lock_guard<std::mutex> lock(chunksMtx);
@@ -322,6 +330,16 @@ QueryState UserQuerySelect::join() {
         _messageStore->addMessage(-1, 1105, "Failure while merging result",
                 MessageSeverity::MSG_ERROR);
     }
+    if (successful) {
+        // Remember result size so that similar queries can be admitted
+        // with a better estimate.
+        try {
+            _queryMetadata->saveResultSize(_qMetaQueryId, _infileMerger->getResultBytes());
+        } catch (qmeta::QMetaError const&) {
+            LOGS(_log, LOG_LVL_WARN, getQueryIdString() << " failed to save result size");
+        }
+    }
+    _saveTrace();
     try {
         _discardMerger();
     } catch (std::exception const& exc) {
@@ -344,6 +362,19 @@ QueryState UserQuerySelect::join() {
     }
 }
 
+/// Store the timeline of a traced query in QMeta and log its breakdown by stage
+void UserQuerySelect::_saveTrace() {
+    auto const trace = _executive->getTrace();
+    if (trace == nullptr) return;
+    LOGS(_log, LOG_LVL_INFO, getQueryIdString() << " trace seconds total/critical: "
+         << trace->getBreakdown());
+    try {
+        _queryMetadata->saveTrace(_qMetaQueryId, trace->getSpans());
+    } catch (qmeta::QMetaError const&) {
+        LOGS(_log, LOG_LVL_WARN, getQueryIdString() << " failed to save query trace");
+    }
+}
+
 /// Release resources held by the merger
 void UserQuerySelect::_discardMerger() {
     _infileMergerConfig.reset();
@@ -410,13 +441,10 @@ void UserQuerySelect::setupChunking() {
         throw UserQueryError(getQueryIdString() + " Couldn't determine dominantDb for dispatch");
     }
 
-    std::shared_ptr<IntSet const> eSet = _qSession->getEmptyChunks();
-    {
-        eSet = _qSession->getEmptyChunks();
-        if (!eSet) {
-            eSet = std::make_shared<IntSet>();
-            LOGS(_log, LOG_LVL_WARN, getQueryIdString() << " Missing empty chunks info for " << dominantDb);
-        }
+    std::shared_ptr<util::ChunkSet const> eSet = _qSession->getEmptyChunks();
+    if (!eSet) {
+        eSet = std::make_shared<util::ChunkSet>();
+        LOGS(_log, LOG_LVL_WARN, getQueryIdString() << " Missing empty chunks info for " << dominantDb);
     }
     // FIXME add operator<< for QuerySession
     LOGS(_log, LOG_LVL_TRACE, getQueryIdString() << " _qSession: " << _qSession);
@@ -424,7 +452,8 @@ void UserQuerySelect::setupChunking() {
         std::shared_ptr<query::ConstraintVector> constraints = _qSession->getConstraints();
         css::StripingParams partStriping = _qSession->getDbStriping();
 
-        im = std::make_shared<qproc::IndexMap>(partStriping, _secondaryIndex);
+        // Empty chunks are filtered out by the IndexMap
+        im = std::make_shared<qproc::IndexMap>(partStriping, _secondaryIndex, eSet);
         qproc::ChunkSpecVector csv;
         if (constraints) {
             csv = im->getChunks(*constraints);
@@ -433,13 +462,8 @@ void UserQuerySelect::setupChunking() {
         }
 
         LOGS(_log, LOG_LVL_TRACE, getQueryIdString() << " Chunk specs: " << util::printable(csv));
-        // Filter out empty chunks
-        for(qproc::ChunkSpecVector::const_iterator i=csv.begin(), e=csv.end();
-            i != e;
-            ++i) {
-            if (eSet->count(i->chunkId) == 0) { // chunk not in empty?
-                _qSession->addChunk(*i);
-            }
+        for (auto const& chunkSpec: csv) {
+            _qSession->addChunk(chunkSpec);
         }
     } else {
         LOGS(_log, LOG_LVL_TRACE, getQueryIdString() << " No chunks added, QuerySession will add dummy chunk");
@@ -480,6 +504,7 @@ void UserQuerySelect::qMetaRegister(std::string const& resultLocation, std::stri
     }
     qmeta::QInfo qInfo(qType, _qMetaCzarId, user, _qSession->getOriginal(),
                        qTemplate, qMerge, proxyOrderBy, _resultLoc, msgTableName);
+    _qTemplate = qTemplate;
 
     // find all table names used by statement (which appear in FROM ... [JOIN ...])
     qmeta::QMeta::TableNames tableNames;
@@ -552,6 +577,25 @@ void UserQuerySelect::_qMetaUpdateStatus(qmeta::QInfo::QStatus qStatus)
     }
 }
 
+// estimate query cost for admission control
+QueryCost UserQuerySelect::getCost() const {
+    QueryCost cost;
+    if (_qSession == nullptr) {
+        return cost;
+    }
+    cost.chunkCount = _qSession->getChunksSize();
+    cost.scanRating = _qSession->getScanRating();
+    cost.interactive = _qSession->getScanInteractive();
+    if (not _qTemplate.empty()) {
+        try {
+            cost.resultBytes = _queryMetadata->getResultSizeEstimate(_qTemplate);
+        } catch (qmeta::QMetaError const&) {
+            LOGS(_log, LOG_LVL_WARN, getQueryIdString() << " failed to estimate result size");
+        }
+    }
+    return cost;
+}
+
 // add chunk information to qmeta
 void UserQuerySelect::_qMetaAddChunks(std::vector<int> const& chunks)
 {
@@ -141,6 +141,10 @@ public:
     /// @return True if query is async query
     bool isAsync() const override { return _async; }
 
+    /// @return estimated cost of the query, result size is estimated from
+    /// the history of queries with the same template kept in QMeta.
+    QueryCost getCost() const override;
+
     void setupChunking();
 
     /// set up the merge table (stores results from workers)
@@ -150,6 +154,7 @@ public:
 
 private:
     void _discardMerger();
+    void _saveTrace();
     void _qMetaUpdateStatus(qmeta::QInfo::QStatus qStatus);
     void _qMetaAddChunks(std::vector<int> const& chunks);
 
@@ -173,6 +178,7 @@ private:
     std::string _errorExtra;    ///< Additional error information
     std::string _resultTable;   ///< Result table name
     std::string _resultLoc;     ///< Result location
+    std::string _qTemplate;     ///< Query template as registered in QMeta
     bool _async;                ///< true for async query
 };
 
@@ -0,0 +1,293 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/**
+ * @file
+ *
+ * @brief Benchmark of the czar result path.
+ *
+ * Jobs are dispatched by qdisp::Executive to the in-process XrdSsiServiceMock,
+ * which streams generated proto::Result messages framed the way workers send
+ * them. The results are decoded by ccontrol::MergingHandler and loaded into
+ * the result database by rproc::InfileMerger, so a MySQL server for results
+ * is required (the same one the czar uses).
+ */
+
+// System headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "ccontrol/MergingHandler.h"
+#include "global/MsgReceiver.h"
+#include "global/ResourceUnit.h"
+#include "mysql/MySqlConfig.h"
+#include "proto/worker.pb.h"
+#include "qdisp/Executive.h"
+#include "qdisp/JobDescription.h"
+#include "qdisp/MessageStore.h"
+#include "qdisp/QdispPool.h"
+#include "qdisp/QueryTrace.h"
+#include "qdisp/XrdSsiMocks.h"
+#include "qproc/ChunkQuerySpec.h"
+#include "qproc/TaskMsgFactory.h"
+#include "rproc/InfileMerger.h"
+#include "sql/Schema.h"
+#include "sql/SqlConnection.h"
+#include "sql/SqlErrorObject.h"
+#include "util/CmdLineParser.h"
+
+namespace ccontrol = lsst::qserv::ccontrol;
+namespace mysql    = lsst::qserv::mysql;
+namespace qdisp    = lsst::qserv::qdisp;
+namespace qproc    = lsst::qserv::qproc;
+namespace rproc    = lsst::qserv::rproc;
+namespace sql      = lsst::qserv::sql;
+namespace util     = lsst::qserv::util;
+
+using lsst::qserv::MsgReceiver;
+using lsst::qserv::ResourceUnit;
+
+using namespace std;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.ccontrol.qserv-czar-bench");
+
+// Command line parameters
+
+unsigned int numChunks;
+qdisp::XrdSsiServiceMock::ResultSpec resultSpec;
+string mysqlUser;
+string mysqlPassword;
+string mysqlSocket;
+string mysqlDb;
+unsigned int maxTableSizeMB;
+bool keepTable;
+
+/// Ask the mock service for a result stream of the job.
+class BenchTaskMsgFactory : public qproc::TaskMsgFactory {
+public:
+    BenchTaskMsgFactory() : TaskMsgFactory(0) {}
+    void serializeMsg(qproc::ChunkQuerySpec const& s,
+                      string const& chunkResultName,
+                      uint64_t queryId, int jobId, int attemptCount,
+                      ostream& os) override {
+        os << "respresult " << jobId;
+    }
+};
+
+/// Count the errors reported for jobs.
+class ErrorCounter : public MsgReceiver {
+public:
+    void operator()(int code, string const& msg) override {
+        if (code != 0) {
+            LOGS(_log, LOG_LVL_ERROR, "job error code=" << code << " msg=" << msg);
+            ++errors;
+        }
+    }
+    atomic<int> errors{0};
+};
+
+double secondsSince(chrono::steady_clock::time_point const& start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/// Print count, mean and percentiles of the czar stage durations of all jobs.
+void printStages(vector<lsst::qserv::qmeta::QTraceSpan> const& spans) {
+    map<string, vector<uint64_t>> durations;
+    vector<string> stages;
+    for (auto const& span : spans) {
+        auto& d = durations[span.stage];
+        if (d.empty()) stages.push_back(span.stage);
+        d.push_back(span.duration);
+    }
+    cout << left << setw(16) << "stage" << right
+         << setw(8) << "jobs" << setw(12) << "mean[ms]" << setw(12) << "p50[ms]"
+         << setw(12) << "p99[ms]" << setw(12) << "max[ms]" << "\n";
+    for (auto const& stage : stages) {
+        auto& d = durations[stage];
+        sort(d.begin(), d.end());
+        uint64_t sum = 0;
+        for (auto v : d) sum += v;
+        auto pct = [&d](double p) { return d[min(d.size() - 1, size_t(p * d.size()))] / 1000.; };
+        cout << left << setw(16) << stage << right << fixed << setprecision(3)
+             << setw(8) << d.size() << setw(12) << sum / 1000. / d.size()
+             << setw(12) << pct(0.5) << setw(12) << pct(0.99) << setw(12) << d.back() / 1000. << "\n";
+    }
+}
+
+int test() {
+    qdisp::XrdSsiServiceMock::setResultSpec(resultSpec);
+    qdisp::XrdSsiServiceMock::Reset();
+
+    mysql::MySqlConfig const mySqlConfig(mysqlUser, mysqlPassword, mysqlSocket, mysqlDb,
+                                         maxTableSizeMB);
+    rproc::InfileMergerConfig const mergerConfig(mySqlConfig);
+    auto infileMerger = make_shared<rproc::InfileMerger>(mergerConfig);
+
+    sql::Schema schema;
+    vector<string> const sqlTypes = qdisp::XrdSsiServiceMock::getResultSqlTypes();
+    for (size_t i = 0; i < sqlTypes.size(); ++i) {
+        sql::ColSchema column;
+        column.name = "c" + to_string(i);
+        column.colType.sqlType = sqlTypes[i];
+        schema.columns.push_back(column);
+    }
+    string errMsg;
+    if (not infileMerger->makeResultsTable(schema, errMsg)) {
+        cerr << "failed to create the result table: " << errMsg << endl;
+        return 1;
+    }
+
+    qdisp::Executive::Config const conf(qdisp::Executive::Config::getMockStr(), 0);
+    auto messageStore = make_shared<qdisp::MessageStore>();
+    auto qdispPool = make_shared<qdisp::QdispPool>();
+    shared_ptr<lsst::qserv::qmeta::QStatus> qStatus; // no QMeta updates
+    auto executive = qdisp::Executive::create(conf, messageStore, qdispPool, qStatus);
+    auto trace = make_shared<qdisp::QueryTrace>();
+    executive->setTrace(trace);
+
+    auto taskMsgFactory = make_shared<BenchTaskMsgFactory>();
+    auto errorCounter = make_shared<ErrorCounter>();
+    string const chunkResultName = "bench";
+
+    auto const start = chrono::steady_clock::now();
+    for (unsigned int chunkId = 0; chunkId < numChunks; ++chunkId) {
+        ResourceUnit ru;
+        ru.setAsDbChunk("Bench", chunkId);
+        auto cqs = make_shared<qproc::ChunkQuerySpec>(); // unused by the mock
+        cqs->chunkId = chunkId;
+        auto jobDesc = qdisp::JobDescription::create(
+                executive->getId(), chunkId, ru,
+                make_shared<ccontrol::MergingHandler>(errorCounter, infileMerger, chunkResultName),
+                taskMsgFactory, cqs, chunkResultName, true);
+        executive->add(jobDesc);
+    }
+    double const dispatchSeconds = secondsSince(start);
+    bool const success = executive->join();
+    double const joinSeconds = secondsSince(start);
+    bool const finalized = infileMerger->finalize();
+    double const totalSeconds = secondsSince(start);
+
+    if (not keepTable) {
+        sql::SqlConnection sqlConn(mySqlConfig);
+        sql::SqlErrorObject errObj;
+        if (not sqlConn.dropTable(infileMerger->getTargetTable(), errObj, false)) {
+            cerr << "failed to drop " << infileMerger->getTargetTable() << ": " << errObj.errMsg() << endl;
+        }
+    }
+
+    uint64_t const bytes = infileMerger->getResultBytes();
+    uint64_t const rows = uint64_t(numChunks) * resultSpec.rows;
+    cout << fixed << setprecision(3)
+         << "chunks:         " << numChunks << "\n"
+         << "rows:           " << rows << " (" << resultSpec.columns << " columns, "
+                               << resultSpec.columnWidth << " bytes wide)\n"
+         << "result bytes:   " << bytes << "\n"
+         << "dispatch:       " << dispatchSeconds << " s, "
+                               << numChunks / max(dispatchSeconds, 1e-9) << " jobs/s\n"
+         << "merge:          " << joinSeconds << " s, "
+                               << bytes / 1048576. / max(joinSeconds, 1e-9) << " MB/s, "
+                               << rows / max(joinSeconds, 1e-9) << " rows/s\n"
+         << "finalize:       " << totalSeconds - joinSeconds << " s\n"
+         << "errors:         " << errorCounter->errors << "\n\n";
+    printStages(trace->getSpans());
+    cout << "\ntotal/critical [s]: " << trace->getBreakdown() << endl;
+
+    return (success and finalized and errorCounter->errors == 0) ? 0 : 1;
+}
+} // namespace
+
+
+int main(int argc, const char* const argv[]) {
+
+    // Verify that the version of the library that we linked against is
+    // compatible with the version of the headers we compiled against.
+
+    GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+    // Parse command line parameters
+    try {
+        util::CmdLineParser parser(
+            argc,
+            argv,
+            "\n"
+            "Usage:\n"
+            "  [--chunks=<value>]\n"
+            "  [--rows=<value>]\n"
+            "  [--columns=<value>]\n"
+            "  [--width=<value>]\n"
+            "  [--user=<name>]\n"
+            "  [--password=<value>]\n"
+            "  [--socket=<path>]\n"
+            "  [--db=<name>]\n"
+            "  [--max-table-mb=<value>]\n"
+            "  [--keep-table]\n"
+            "\n"
+            "Flags and options:\n"
+            "  --chunks=<value>       - the number of chunks (jobs) (default: 100)\n"
+            "  --rows=<value>         - the number of rows per chunk (default: 10000)\n"
+            "  --columns=<value>      - the number of columns, the first one is BIGINT\n"
+            "                           and the rest are CHAR (default: 4)\n"
+            "  --width=<value>        - the width of CHAR columns (default: 16)\n"
+            "  --user=<name>          - MySQL user of the result database (default: 'qsmaster')\n"
+            "  --password=<value>     - MySQL password (default: '')\n"
+            "  --socket=<path>        - MySQL socket (default: '/qserv/data/mysql/mysql.sock')\n"
+            "  --db=<name>            - result database (default: 'qservResult')\n"
+            "  --max-table-mb=<value> - the maximum size of the result table (default: 5000)\n"
+            "  --keep-table           - do not drop the result table at the end\n");
+
+        ::numChunks                = parser.option<unsigned int>("chunks", 100);
+        ::resultSpec.rows          = parser.option<unsigned int>("rows", 10000);
+        ::resultSpec.columns       = max(1U, parser.option<unsigned int>("columns", 4));
+        ::resultSpec.columnWidth   = parser.option<unsigned int>("width", 16);
+        ::mysqlUser                = parser.option<string>("user", "qsmaster");
+        ::mysqlPassword            = parser.option<string>("password", "");
+        ::mysqlSocket              = parser.option<string>("socket", "/qserv/data/mysql/mysql.sock");
+        ::mysqlDb                  = parser.option<string>("db", "qservResult");
+        ::maxTableSizeMB           = parser.option<unsigned int>("max-table-mb", 5000);
+        ::keepTable                = parser.flag("keep-table");
+
+    } catch (exception const& ex) {
+        return 1;
+    }
+    try {
+        return ::test();
+    } catch (exception const& ex) {
+        cerr << "benchmark failed: " << ex.what() << endl;
+        return 1;
+    }
+}
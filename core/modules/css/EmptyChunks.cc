@@ -25,10 +25,9 @@
 #include "css/EmptyChunks.h"
 
 // System headers
-#include <algorithm>
+#include <exception>
 #include <iterator>
 #include <fstream>
-#include <functional>
 #include <memory>
 
 // LSST headers
@@ -39,38 +38,62 @@
 #include "global/stringUtil.h"
 
 using lsst::qserv::ConfigError;
-using lsst::qserv::IntSet;
+using lsst::qserv::util::ChunkSet;
 
 namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.css.EmptyChunks");
 
 std::string
-makeFilename(std::string const& db) {
-    return "empty_" + lsst::qserv::sanitizeName(db) + ".txt";
+makeFilename(std::string const& db, std::string const& ext) {
+    return "empty_" + lsst::qserv::sanitizeName(db) + ext;
+}
+
+bool
+fileExists(std::string const& fileName) {
+    return std::ifstream(fileName.c_str()).good();
+}
+
+void
+readFile(std::string const& fileName, ChunkSet& s) {
+    if (ChunkSet::isBinaryFile(fileName)) {
+        try {
+            s = ChunkSet::load(fileName);
+        } catch (std::exception const& e) {
+            throw ConfigError("Failed to load empty chunks file: " + fileName + ", error: " + e.what());
+        }
+        return;
+    }
+    std::ifstream rawStream(fileName.c_str());
+    std::istream_iterator<int> chunkStream(rawStream);
+    std::istream_iterator<int> eos;
+    for (; chunkStream != eos; ++chunkStream) {
+        s.insert(*chunkStream);
+    }
 }
 
 void
 populate(std::string const& path,
          std::string const& fallbackFile,
-         IntSet& s,
+         ChunkSet& s,
          std::string const& db) {
-    std::string const best = path + "/" + makeFilename(db);
-    std::string fileName = best;
-    std::ifstream rawStream(best.c_str());
-    if (!rawStream.good()) { // On error, try using default filename
-        rawStream.close();
-        rawStream.open(fallbackFile.c_str());
-        fileName = fallbackFile;
+    std::string const binary = path + "/" + makeFilename(db, ".bin");
+    std::string const best = path + "/" + makeFilename(db, ".txt");
+    std::string fileName;
+    for (auto&& candidate: {binary, best, fallbackFile}) {
+        if (fileExists(candidate)) {
+            fileName = candidate;
+            break;
+        }
     }
-    LOGS(_log, LOG_LVL_DEBUG, "Reading empty chunks for db " << db << " from file " << fileName);
-    if (!rawStream.good()) {
-        throw ConfigError("No such empty chunks file: " + best
+    if (fileName.empty()) {
+        throw ConfigError("No such empty chunks file: " + binary + ", " + best
                           + " or " + fallbackFile);
     }
-    std::istream_iterator<int> chunkStream(rawStream);
-    std::istream_iterator<int> eos;
-    std::copy(chunkStream, eos, std::insert_iterator<IntSet>(s, s.begin()));
+    LOGS(_log, LOG_LVL_DEBUG, "Reading empty chunks for db " << db << " from file " << fileName);
+    readFile(fileName, s);
+    LOGS(_log, LOG_LVL_DEBUG, "Read " << s.size() << " empty chunks for db " << db
+         << " (" << s.memoryUsage() << " bytes)");
 }
 } // anonymous namespace
 
@@ -78,28 +101,29 @@ namespace lsst {
 namespace qserv {
 namespace css {
 
-std::shared_ptr<IntSet const>
+std::shared_ptr<util::ChunkSet const>
 EmptyChunks::getEmpty(std::string const& db) const {
     std::lock_guard<std::mutex> lock(_setsMutex);
-    IntSetMap::const_iterator i = _sets.find(db);
+    ChunkSetMap::const_iterator i = _sets.find(db);
     if (i != _sets.end()) {
-        IntSetConstPtr readOnly = i->second;
+        ChunkSetConstPtr readOnly = i->second;
         return readOnly;
     }
-    IntSetPtr newSet = std::make_shared<IntSet>();
-    _sets.insert(IntSetMap::value_type(db, newSet));
+    ChunkSetPtr newSet = std::make_shared<util::ChunkSet>();
+    _sets.insert(ChunkSetMap::value_type(db, newSet));
     populate(_path, _fallbackFile, *newSet, db); // Populate reference
-    return IntSetConstPtr(newSet);
+    return ChunkSetConstPtr(newSet);
 }
 
 bool
 EmptyChunks::isEmpty(std::string const& db, int chunk) const {
-    IntSetConstPtr s = getEmpty(db);
-    return s->end() != s->find(chunk);
+    ChunkSetConstPtr s = getEmpty(db);
+    return s->contains(chunk);
 }
 
 void
 EmptyChunks::clearCache(std::string const& db) const {
+    std::lock_guard<std::mutex> lock(_setsMutex);
     if (db.empty()) {
         LOGS(_log, LOG_LVL_DEBUG, "Clearing empty chunks cache for all databases");
         _sets.clear();
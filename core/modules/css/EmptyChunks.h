@@ -25,7 +25,8 @@
   * @file
   *
   * @brief Empty-chunks tracker. Reads an on-disk file from cwd, but
-  * should ideally query (and cache) table state.
+  * should ideally query (and cache) table state. Files may be either
+  * plain text lists of chunk numbers or binary util::ChunkSet images.
   *
   * @Author Daniel L. Wang, SLAC
   */
@@ -40,7 +41,7 @@
 #include <string>
 
 // Qserv headers
-#include "global/intTypes.h"
+#include "util/ChunkSet.h"
 
 namespace lsst {
 namespace qserv {
@@ -51,6 +52,11 @@ namespace css {
 /// per-partitioning-group scheme, at which point, we will re-think
 /// the db-based dispatch as well (user tables in the partitioning
 /// group may be extremely sparse).
+///
+/// For each database the binary file "empty_<db>.bin" (see util::ChunkSet
+/// for the format) is preferred over the text file "empty_<db>.txt" as it's
+/// loaded via a memory mapping without parsing. The fallback file may be in
+/// either format.
 class EmptyChunks {
 public:
     EmptyChunks(std::string const& path=".",
@@ -60,7 +66,7 @@ public:
     // accessors
 
     /// @return set of empty chunks for this db
-    std::shared_ptr<IntSet const> getEmpty(std::string const& db) const;
+    std::shared_ptr<util::ChunkSet const> getEmpty(std::string const& db) const;
 
     /// @return true if db/chunk is empty
     bool isEmpty(std::string const& db, int chunk) const;
@@ -73,13 +79,13 @@ public:
 private:
 
     // Convenience types
-    typedef std::shared_ptr<IntSet> IntSetPtr;
-    typedef std::shared_ptr<IntSet const> IntSetConstPtr;
+    typedef std::shared_ptr<util::ChunkSet> ChunkSetPtr;
+    typedef std::shared_ptr<util::ChunkSet const> ChunkSetConstPtr;
 
-    typedef std::map<std::string, IntSetPtr> IntSetMap;
+    typedef std::map<std::string, ChunkSetPtr> ChunkSetMap;
     std::string _path; ///< Search path for empty chunks files
     std::string _fallbackFile; ///< Fallback path for empty chunks
-    mutable IntSetMap _sets; ///< Container for empty chunks sets (cache)
+    mutable ChunkSetMap _sets; ///< Container for empty chunks sets (cache)
     mutable std::mutex _setsMutex;
 };
 
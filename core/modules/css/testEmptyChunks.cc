@@ -124,5 +124,16 @@ BOOST_AUTO_TEST_CASE(Basic) {
 
 }
 
+BOOST_AUTO_TEST_CASE(Binary) {
+    lsst::qserv::util::ChunkSet chunks{5, 500, 50000};
+    chunks.save(dummyFile._path + "/empty_TestThree.bin");
+    EmptyChunks ec(dummyFile._path, dummyFile._fallback);
+    auto s = ec.getEmpty("TestThree");
+    BOOST_CHECK(*s == chunks);
+    BOOST_CHECK(ec.isEmpty("TestThree", 50000));
+    BOOST_CHECK(not ec.isEmpty("TestThree", 3));
+    BOOST_CHECK(ec.isEmpty("TestOne", 3));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,174 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "czar/AdmissionController.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.czar.AdmissionController");
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace czar {
+
+AdmissionController::Ticket::~Ticket() {
+    auto controller = _controller.lock();
+    if (controller != nullptr) {
+        controller->_release(_charge);
+    }
+}
+
+AdmissionController::AdmissionController(Config const& config)
+    : _config(config) {
+}
+
+AdmissionController::Ticket::Ptr AdmissionController::admit(QueryId queryId,
+                                                            ccontrol::QueryCost const& cost) {
+    std::string const qIdStr = QueryIdHelper::makeIdStr(queryId);
+    Ticket::Charge const charge = _makeCharge(cost);
+
+    std::unique_lock<std::mutex> lock(_mtx);
+
+    // Queries which dispatch nothing and interactive queries are not queued,
+    // interactive queries still count against the budgets.
+    if (cost.chunkCount == 0 || cost.interactive) {
+        _acquire(charge);
+        LOGS(_log, LOG_LVL_DEBUG, qIdStr << " admitted immediately " << cost);
+        return Ticket::Ptr(new Ticket(shared_from_this(), charge));
+    }
+
+    auto waiter = std::make_shared<Waiter>();
+    waiter->queryId = queryId;
+    waiter->charge = charge;
+    _queue.push_back(waiter);
+    _admitWaiting();
+    if (not waiter->admitted) {
+        LOGS(_log, LOG_LVL_INFO, qIdStr << " queued for admission " << cost
+             << " position=" << _queue.size());
+        _cv.wait(lock, [&waiter]() { return waiter->admitted || waiter->cancelled; });
+    }
+    if (waiter->cancelled) {
+        LOGS(_log, LOG_LVL_INFO, qIdStr << " cancelled while waiting for admission");
+        return nullptr;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, qIdStr << " admitted " << cost);
+    return Ticket::Ptr(new Ticket(shared_from_this(), charge));
+}
+
+bool AdmissionController::cancel(QueryId queryId) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    for (auto itr = _queue.begin(); itr != _queue.end(); ++itr) {
+        if ((*itr)->queryId == queryId) {
+            (*itr)->cancelled = true;
+            _queue.erase(itr);
+            // Queries behind this one may fit now
+            _admitWaiting();
+            _cv.notify_all();
+            return true;
+        }
+    }
+    return false;
+}
+
+AdmissionController::Status AdmissionController::getStatus() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    Status status;
+    status.runningQueries = _runningQueries;
+    status.queuedQueries = _queue.size();
+    status.inFlightChunks = _inFlightChunks;
+    status.largeResults = _largeResults;
+    status.resultBytes = _resultBytes;
+    return status;
+}
+
+AdmissionController::Ticket::Charge
+AdmissionController::_makeCharge(ccontrol::QueryCost const& cost) const {
+    Ticket::Charge charge;
+    charge.chunks = cost.chunkCount;
+    if (cost.chunkCount > 0) {
+        charge.resultBytes = cost.resultBytes < 0 ? _config.defaultResultBytes : cost.resultBytes;
+    }
+    charge.largeResults = charge.resultBytes > _config.largeResultBytes ? 1 : 0;
+    return charge;
+}
+
+bool AdmissionController::_fits(Ticket::Charge const& charge) const {
+    if (_runningQueries == 0) return true;
+    if (_config.maxInFlightChunks > 0 &&
+        _inFlightChunks + charge.chunks > _config.maxInFlightChunks) {
+        return false;
+    }
+    if (_config.maxLargeResults > 0 &&
+        _largeResults + charge.largeResults > _config.maxLargeResults) {
+        return false;
+    }
+    if (_config.maxResultBytes > 0 &&
+        _resultBytes + charge.resultBytes > _config.maxResultBytes) {
+        return false;
+    }
+    return true;
+}
+
+void AdmissionController::_acquire(Ticket::Charge const& charge) {
+    ++_runningQueries;
+    _inFlightChunks += charge.chunks;
+    _largeResults += charge.largeResults;
+    _resultBytes += charge.resultBytes;
+}
+
+void AdmissionController::_release(Ticket::Charge const& charge) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    --_runningQueries;
+    _inFlightChunks -= charge.chunks;
+    _largeResults -= charge.largeResults;
+    _resultBytes -= charge.resultBytes;
+    _admitWaiting();
+    _cv.notify_all();
+}
+
+void AdmissionController::_admitWaiting() {
+    // Strict FIFO, a large query at the head is not bypassed by smaller
+    // ones queued after it, otherwise it could wait forever.
+    while (not _queue.empty() && _fits(_queue.front()->charge)) {
+        auto waiter = _queue.front();
+        _queue.pop_front();
+        _acquire(waiter->charge);
+        waiter->admitted = true;
+    }
+}
+
+std::ostream& operator<<(std::ostream& os, AdmissionController::Status const& status) {
+    return os << "AdmissionController(running=" << status.runningQueries
+              << " queued=" << status.queuedQueries
+              << " inFlightChunks=" << status.inFlightChunks
+              << " largeResults=" << status.largeResults
+              << " resultBytes=" << status.resultBytes << ")";
+}
+
+}}} // namespace lsst::qserv::czar
@@ -0,0 +1,170 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_CZAR_ADMISSIONCONTROLLER_H
+#define LSST_QSERV_CZAR_ADMISSIONCONTROLLER_H
+
+// System headers
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+// Qserv headers
+#include "ccontrol/QueryCost.h"
+#include "global/intTypes.h"
+
+namespace lsst {
+namespace qserv {
+namespace czar {
+
+/**
+ *  AdmissionController decides when a user query may start dispatching
+ *  jobs to workers. Each query is charged its estimated cost against
+ *  czar-wide budgets:
+ *   - number of chunk queries in flight,
+ *   - number of concurrently merged large results (merge bandwidth),
+ *   - expected size of all result tables (result disk).
+ *
+ *  Interactive queries are always admitted immediately (they are still
+ *  charged), so that large scans cannot starve them. Other queries wait
+ *  in FIFO order until their cost fits the remaining budgets; a query is
+ *  always admitted when nothing else is running so that a query larger
+ *  than the budget can still execute on its own.
+ *
+ *  A zero budget means unlimited.
+ */
+class AdmissionController : public std::enable_shared_from_this<AdmissionController> {
+public:
+    typedef std::shared_ptr<AdmissionController> Ptr;
+
+    struct Config {
+        int maxInFlightChunks{0};               ///< budget for chunk queries in flight
+        int maxLargeResults{0};                 ///< budget for concurrent large result merges
+        std::uint64_t maxResultBytes{0};        ///< budget for expected result tables size
+        std::uint64_t largeResultBytes{100*1048576ULL}; ///< results above this are "large"
+        std::uint64_t defaultResultBytes{10*1048576ULL}; ///< assumed size if there is no history
+    };
+
+    /// Ticket holds the resources of an admitted query until it's destroyed.
+    class Ticket {
+    public:
+        typedef std::shared_ptr<Ticket> Ptr;
+
+        Ticket(Ticket const&) = delete;
+        Ticket& operator=(Ticket const&) = delete;
+
+        ~Ticket();
+
+    private:
+        friend class AdmissionController;
+        struct Charge {
+            int chunks{0};
+            int largeResults{0};
+            std::uint64_t resultBytes{0};
+        };
+
+        Ticket(std::shared_ptr<AdmissionController> const& controller, Charge const& charge)
+            : _controller(controller), _charge(charge) {}
+
+        std::weak_ptr<AdmissionController> _controller;
+        Charge const _charge;
+    };
+
+    /// Current state of the controller
+    struct Status {
+        int runningQueries{0};
+        int queuedQueries{0};
+        int inFlightChunks{0};
+        int largeResults{0};
+        std::uint64_t resultBytes{0};
+    };
+
+    static Ptr create(Config const& config) { return Ptr(new AdmissionController(config)); }
+
+    AdmissionController(AdmissionController const&) = delete;
+    AdmissionController& operator=(AdmissionController const&) = delete;
+
+    /**
+     *  Wait until the query is admitted. Resources are returned to the
+     *  controller when the ticket is destroyed.
+     *
+     *  @param queryId:  Query ID, used for logging and to cancel waiting.
+     *  @param cost:     Estimated cost of the query.
+     *  @return ticket, or nullptr if the query was cancelled while waiting.
+     */
+    Ticket::Ptr admit(QueryId queryId, ccontrol::QueryCost const& cost);
+
+    /**
+     *  Cancel a query waiting for admission.
+     *
+     *  @return true if the query was waiting and is now cancelled.
+     */
+    bool cancel(QueryId queryId);
+
+    Config const& getConfig() const { return _config; }
+
+    Status getStatus() const;
+
+private:
+    struct Waiter {
+        QueryId queryId;
+        Ticket::Charge charge;
+        bool admitted{false};
+        bool cancelled{false};
+    };
+
+    explicit AdmissionController(Config const& config);
+
+    /// @return charge for the query cost
+    Ticket::Charge _makeCharge(ccontrol::QueryCost const& cost) const;
+
+    /// @return true if the charge fits remaining budgets, _mtx must be locked
+    bool _fits(Ticket::Charge const& charge) const;
+
+    /// Charge the budgets, _mtx must be locked
+    void _acquire(Ticket::Charge const& charge);
+
+    /// Return resources and admit waiting queries
+    void _release(Ticket::Charge const& charge);
+
+    /// Admit queries from the head of the queue, _mtx must be locked
+    void _admitWaiting();
+
+    Config const _config;
+
+    mutable std::mutex _mtx;        ///< protects all members below
+    std::condition_variable _cv;    ///< notified when waiters are admitted or cancelled
+    std::list<std::shared_ptr<Waiter>> _queue; ///< queries waiting for admission
+    int _runningQueries{0};
+    int _inFlightChunks{0};
+    int _largeResults{0};
+    std::uint64_t _resultBytes{0};
+};
+
+std::ostream& operator<<(std::ostream& os, AdmissionController::Status const& status);
+
+}}} // namespace lsst::qserv::czar
+
+#endif // LSST_QSERV_CZAR_ADMISSIONCONTROLLER_H
@@ -39,9 +39,13 @@
 #include "ccontrol/UserQueryType.h"
 #include "czar/CzarErrors.h"
 #include "czar/MessageTable.h"
+#include "metrics/MetricsServer.h"
+#include "qdisp/MessageStore.h"
+#include "qdisp/ResultFlowControl.h"
 #include "rproc/InfileMerger.h"
 #include "sql/SqlConnection.h"
 #include "util/IterableFormatter.h"
+#include "util/Metrics.h"
 #include "XrdSsi/XrdSsiProvider.hh"
 
 
@@ -88,11 +92,28 @@ Czar::Czar(std::string const& configPath, std::string const& czarName)
         LOG_CONFIG(logConfig);
     }
 
-    int largeResultConcurrent = _czarConfig.getLargeResultConcurrentMerges();
-    // TODO:DM-10273 - remove largeResults from configuration
-    LOGS(_log, LOG_LVL_INFO, "config largeResultConcurrent=" << largeResultConcurrent);
+    AdmissionController::Config admissionConfig;
+    admissionConfig.maxInFlightChunks = _czarConfig.getAdmissionMaxInFlightChunks();
+    admissionConfig.maxLargeResults = _czarConfig.getLargeResultConcurrentMerges();
+    admissionConfig.maxResultBytes = _czarConfig.getAdmissionMaxResultMB()*1048576ULL;
+    admissionConfig.largeResultBytes = _czarConfig.getAdmissionLargeResultMB()*1048576ULL;
+    admissionConfig.defaultResultBytes = _czarConfig.getAdmissionDefaultResultMB()*1048576ULL;
+    _admission = AdmissionController::create(admissionConfig);
+    LOGS(_log, LOG_LVL_INFO, "config admission maxInFlightChunks=" << admissionConfig.maxInFlightChunks
+         << " maxLargeResults=" << admissionConfig.maxLargeResults
+         << " maxResultBytes=" << admissionConfig.maxResultBytes);
     _qdispPool = std::make_shared<qdisp::QdispPool>(); // TODO:configuration add to configuration
 
+    qdisp::ResultFlowControl::Config flowConfig;
+    flowConfig.maxBytes = _czarConfig.getResultFlowMaxInFlightMB()*1048576ULL;
+    flowConfig.maxQueryBytes = _czarConfig.getResultFlowMaxQueryInFlightMB()*1048576ULL;
+    flowConfig.targetMergeSeconds = _czarConfig.getResultFlowTargetMergeSecs();
+    auto flowControl = qdisp::ResultFlowControl::create(flowConfig);
+    _qdispPool->setFlowControl(flowControl);
+    LOGS(_log, LOG_LVL_INFO, "config result flow maxBytes=" << flowConfig.maxBytes
+         << " maxQueryBytes=" << flowConfig.maxQueryBytes
+         << " targetMergeSeconds=" << flowConfig.targetMergeSeconds);
+
     int xrootdCBThreadsMax = _czarConfig.getXrootdCBThreadsMax();
     int xrootdCBThreadsInit = _czarConfig.getXrootdCBThreadsInit();
     LOGS(_log, LOG_LVL_INFO, "config xrootdCBThreadsMax=" << xrootdCBThreadsMax);
@@ -103,6 +124,55 @@ Czar::Czar(std::string const& configPath, std::string const& czarName)
     LOGS(_log, LOG_LVL_DEBUG, "Czar config: " << _czarConfig);
 
     _uqFactory.reset(new ccontrol::UserQueryFactory(_czarConfig, _czarName));
+
+    // Admission queue depths are computed when metrics are read.
+    std::weak_ptr<AdmissionController> weakAdmission = _admission;
+    auto& registry = util::MetricsRegistry::instance();
+    registry.gaugeFunction("qserv_czar_running_queries", "Queries admitted and not finished",
+        [weakAdmission]() {
+            auto admission = weakAdmission.lock();
+            return admission ? static_cast<double>(admission->getStatus().runningQueries) : 0.0;
+        });
+    registry.gaugeFunction("qserv_czar_queued_queries", "Queries waiting for admission",
+        [weakAdmission]() {
+            auto admission = weakAdmission.lock();
+            return admission ? static_cast<double>(admission->getStatus().queuedQueries) : 0.0;
+        });
+    registry.gaugeFunction("qserv_czar_inflight_chunks", "Chunk queries of admitted queries",
+        [weakAdmission]() {
+            auto admission = weakAdmission.lock();
+            return admission ? static_cast<double>(admission->getStatus().inFlightChunks) : 0.0;
+        });
+
+    // Result flow control usage.
+    std::weak_ptr<qdisp::ResultFlowControl> weakFlow = flowControl;
+    registry.gaugeFunction("qserv_czar_result_inflight_bytes",
+        "Result bytes requested from workers and not yet merged",
+        [weakFlow]() {
+            auto flow = weakFlow.lock();
+            return flow ? static_cast<double>(flow->getStatus().inFlightBytes) : 0.0;
+        });
+    registry.gaugeFunction("qserv_czar_result_limit_bytes",
+        "Limit of result bytes in flight in effect, 0 if unlimited",
+        [weakFlow]() {
+            auto flow = weakFlow.lock();
+            return flow ? static_cast<double>(flow->getStatus().limitBytes) : 0.0;
+        });
+    registry.gaugeFunction("qserv_czar_result_waiting_requests",
+        "Jobs waiting for flow control credit to request result data",
+        [weakFlow]() {
+            auto flow = weakFlow.lock();
+            return flow ? static_cast<double>(flow->getStatus().waitingRequests) : 0.0;
+        });
+    registry.gaugeFunction("qserv_czar_result_merge_rate_bytes",
+        "Measured merge rate of results in bytes per second",
+        [weakFlow]() {
+            auto flow = weakFlow.lock();
+            return flow ? flow->getStatus().mergeBytesPerSec : 0.0;
+        });
+    if (_czarConfig.getMetricsPort() > 0) {
+        _metricsServer = metrics::MetricsServer::create(_czarConfig.getMetricsPort());
+    }
 }
 
 SubmitResult
@@ -168,11 +238,22 @@ Czar::submitQuery(std::string const& query,
     }
 
     // spawn background thread to wait until query finishes to unlock,
-    // note that lambda stores copies of uq and msgTable.
-    auto finalizer = [uq, msgTable]() mutable {
-        LOGS(_log, LOG_LVL_DEBUG, uq->getQueryIdString() << " submitting new query");
-        uq->submit();
-        uq->join();
+    // note that lambda stores copies of uq, msgTable and admission controller.
+    auto admission = _admission;
+    auto finalizer = [uq, msgTable, admission]() mutable {
+        // Wait for the czar-wide budgets before dispatching anything,
+        // ticket returns the resources when the query is finished.
+        auto ticket = admission->admit(uq->getQueryId(), uq->getCost());
+        if (ticket != nullptr) {
+            LOGS(_log, LOG_LVL_DEBUG, uq->getQueryIdString() << " submitting new query");
+            uq->submit();
+            uq->join();
+            ticket.reset();
+        } else {
+            // Error: 1317 SQLSTATE: 70100 (ER_QUERY_INTERRUPTED)
+            uq->getMessageStore()->addMessage(-1, 1317, "Query cancelled while waiting for admission",
+                                              MessageSeverity::MSG_ERROR);
+        }
         try {
             msgTable.unlock(uq);
             if (uq) uq->discard();
@@ -278,6 +359,8 @@ Czar::killQuery(std::string const& query, std::string const& clientId) {
     // assume this cannot fail or throw
     if (uq) {
         LOGS(_log, LOG_LVL_DEBUG, "Killing query: " << uq->getQueryId());
+        // a query still waiting for admission is just taken off the queue
+        _admission->cancel(uq->getQueryId());
         // query killing can potentially take very long and we do now want to block
         // proxy from serving other requests so run it in a detached thread
         std::thread killThread([uq]() {
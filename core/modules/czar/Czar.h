@@ -37,12 +37,20 @@
 // Qserv headers
 #include "ccontrol/UserQuery.h"
 #include "ccontrol/UserQueryFactory.h"
+#include "czar/AdmissionController.h"
 #include "czar/CzarConfig.h"
 #include "czar/SubmitResult.h"
 #include "global/stringTypes.h"
 #include "mysql/MySqlConfig.h"
 #include "util/ConfigStore.h"
 
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace metrics {
+    class MetricsServer;
+}}} // End of forward declarations
+
 namespace lsst {
 namespace qserv {
 namespace czar {
@@ -144,6 +152,8 @@ private:
     std::mutex _mutex;                  ///< protects _uqFactory, _clientToQuery, and _idToQuery
 
     qdisp::QdispPool::Ptr _qdispPool; ///< Thread pool for handling Responses from XrdSsi.
+    AdmissionController::Ptr _admission; ///< Decides when queries may start dispatching.
+    std::shared_ptr<metrics::MetricsServer> _metricsServer; ///< nullptr if metrics are not served
 };
 
 }}} // namespace lsst::qserv::czar
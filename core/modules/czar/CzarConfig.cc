@@ -87,7 +87,20 @@ CzarConfig::CzarConfig(util::ConfigStore const& configStore)
                               configStore.get("qstatus.db", "qservStatusData")),
       _xrootdFrontendUrl(configStore.get("frontend.xrootd", "localhost:1094")),
       _emptyChunkPath(configStore.get("partitioner.emptyChunkPath", ".")),
+      _secondaryIndexPath(configStore.get("partitioner.secondaryIndexPath")),
+      _secondaryIndexCacheSize(configStore.getInt("tuning.secondaryIndexCacheSize", 1000000)),
+      _queryPlanCacheSize(configStore.getInt("tuning.queryPlanCacheSize", 1000)),
+      _queryPlanCacheCssCheckSecs(configStore.getInt("tuning.queryPlanCacheCssCheckSecs", 10)),
+      _metricsPort(configStore.getInt("metrics.port", 0)),
+      _traceEveryNQueries(configStore.getInt("tracing.everyNQueries", 0)),
       _largeResultConcurrentMerges(configStore.getInt("tuning.largeResultConcurrentMerges", 3)),
+      _admissionMaxInFlightChunks(configStore.getInt("tuning.admissionMaxInFlightChunks", 0)),
+      _admissionMaxResultMB(configStore.getInt("tuning.admissionMaxResultMB", 0)),
+      _admissionLargeResultMB(configStore.getInt("tuning.admissionLargeResultMB", 100)),
+      _admissionDefaultResultMB(configStore.getInt("tuning.admissionDefaultResultMB", 10)),
+      _resultFlowMaxInFlightMB(configStore.getInt("tuning.resultFlowMaxInFlightMB", 2000)),
+      _resultFlowMaxQueryInFlightMB(configStore.getInt("tuning.resultFlowMaxQueryInFlightMB", 0)),
+      _resultFlowTargetMergeSecs(configStore.getInt("tuning.resultFlowTargetMergeSecs", 5)),
       _xrootdCBThreadsMax(configStore.getInt("tuning.xrootdCBThreadsMax", 500)),
       _xrootdCBThreadsInit(configStore.getInt("tuning.xrootdCBThreadsInit", 50)),
       _qMetaSecsBetweenChunkCompletionUpdates(configStore.getInt(
@@ -97,6 +110,18 @@ CzarConfig::CzarConfig(util::ConfigStore const& configStore)
 std::ostream& operator<<(std::ostream &out, CzarConfig const& czarConfig) {
     out << "[cssConfigMap=" << util::printable(czarConfig._cssConfigMap) <<
            ", emptyChunkPath=" << czarConfig._emptyChunkPath <<
+           ", secondaryIndexPath=" << czarConfig._secondaryIndexPath <<
+           ", secondaryIndexCacheSize=" << czarConfig._secondaryIndexCacheSize <<
+           ", queryPlanCacheSize=" << czarConfig._queryPlanCacheSize <<
+           ", queryPlanCacheCssCheckSecs=" << czarConfig._queryPlanCacheCssCheckSecs <<
+           ", metricsPort=" << czarConfig._metricsPort <<
+           ", traceEveryNQueries=" << czarConfig._traceEveryNQueries <<
+           ", largeResultConcurrentMerges=" << czarConfig._largeResultConcurrentMerges <<
+           ", admissionMaxInFlightChunks=" << czarConfig._admissionMaxInFlightChunks <<
+           ", admissionMaxResultMB=" << czarConfig._admissionMaxResultMB <<
+           ", resultFlowMaxInFlightMB=" << czarConfig._resultFlowMaxInFlightMB <<
+           ", resultFlowMaxQueryInFlightMB=" << czarConfig._resultFlowMaxQueryInFlightMB <<
+           ", resultFlowTargetMergeSecs=" << czarConfig._resultFlowTargetMergeSecs <<
            ", logConfig=" << czarConfig._logConfig <<
            ", mySqlQmetaConfig=" << czarConfig._mySqlQmetaConfig <<
            ", mySqlQStatusDataConfig=" << czarConfig._mySqlQstatusDataConfig <<
@@ -110,6 +110,56 @@ public:
         return _emptyChunkPath;
     }
 
+    /* Get path to directory where the memory-mapped secondary index files reside
+     *
+     * @return path to directory, empty if file-based lookups are disabled
+     */
+    std::string const& getSecondaryIndexPath() const {
+        return _secondaryIndexPath;
+    }
+
+    /* Get the maximum number of entries in the secondary index lookup cache
+     *
+     * @return the number of entries, 0 if the cache is disabled
+     */
+    int getSecondaryIndexCacheSize() const {
+        return _secondaryIndexCacheSize;
+    }
+
+    /* Get the maximum number of analyzed query plans kept in the plan cache
+     *
+     * @return the number of plans, 0 if the cache is disabled
+     */
+    int getQueryPlanCacheSize() const {
+        return _queryPlanCacheSize;
+    }
+
+    /* Get the minimum time between checks of CSS for changes invalidating
+     * cached query plans
+     *
+     * @return the number of seconds
+     */
+    int getQueryPlanCacheCssCheckSecs() const {
+        return _queryPlanCacheCssCheckSecs;
+    }
+
+    /* Get the TCP port of the HTTP endpoint serving czar metrics
+     *
+     * @return the port number, 0 if metrics are not served
+     */
+    int getMetricsPort() const {
+        return _metricsPort;
+    }
+
+    /* Get how often queries are traced, every N-th query records a timeline
+     * of its processing stages on czar and workers and stores it in QMeta
+     *
+     * @return N, 0 if tracing is disabled
+     */
+    int getTraceEveryNQueries() const {
+        return _traceEveryNQueries;
+    }
+
     /* Get hostname and port for xrootd manager
      *
      * "localhost:1094" is the most reasonable default, even though it is
@@ -121,14 +171,75 @@ public:
         return _xrootdFrontendUrl;
     }
 
-    /* Get number of threads to use for collecting large result data.
+    /* Get number of queries with large results that can be merged concurrently.
      *
-     * @return the number of blocks that can be merged concurrently.
+     * @return the number of queries, 0 means unlimited.
      */
     int getLargeResultConcurrentMerges() const {
          return _largeResultConcurrentMerges;
     }
 
+    /* Get the maximum number of chunk queries in flight for all admitted
+     * non-interactive queries.
+     *
+     * @return the number of chunk queries, 0 means unlimited.
+     */
+    int getAdmissionMaxInFlightChunks() const {
+        return _admissionMaxInFlightChunks;
+    }
+
+    /* Get the maximum expected size of all result tables of admitted queries.
+     *
+     * @return size in MB, 0 means unlimited.
+     */
+    int getAdmissionMaxResultMB() const {
+        return _admissionMaxResultMB;
+    }
+
+    /* Get the expected result size above which the result is considered
+     * large and counts against getLargeResultConcurrentMerges().
+     *
+     * @return size in MB.
+     */
+    int getAdmissionLargeResultMB() const {
+        return _admissionLargeResultMB;
+    }
+
+    /* Get the result size assumed for queries without history in QMeta.
+     *
+     * @return size in MB.
+     */
+    int getAdmissionDefaultResultMB() const {
+        return _admissionDefaultResultMB;
+    }
+
+    /* Get the maximum size of result data requested from workers and not
+     * yet merged, for all queries.
+     *
+     * @return size in MB, 0 means unlimited.
+     */
+    int getResultFlowMaxInFlightMB() const {
+        return _resultFlowMaxInFlightMB;
+    }
+
+    /* Get the maximum size of result data requested from workers and not
+     * yet merged, for a single query.
+     *
+     * @return size in MB, 0 means unlimited.
+     */
+    int getResultFlowMaxQueryInFlightMB() const {
+        return _resultFlowMaxQueryInFlightMB;
+    }
+
+    /* Get the number of seconds of merging, at the measured merge rate, that
+     * may be requested from workers ahead of the mergers.
+     *
+     * @return seconds, 0 disables adapting to the merge rate.
+     */
+    int getResultFlowTargetMergeSecs() const {
+        return _resultFlowTargetMergeSecs;
+    }
+
     /* Get the maximum number of threads for xrootd to use.
      *
      * @return the maximum number of threads for xrootd to use.
@@ -166,7 +277,20 @@ private:
     mysql::MySqlConfig const _mySqlQstatusDataConfig;
     std::string const _xrootdFrontendUrl;
     std::string const _emptyChunkPath;
+    std::string const _secondaryIndexPath;
+    int const _secondaryIndexCacheSize;
+    int const _queryPlanCacheSize;
+    int const _queryPlanCacheCssCheckSecs;
+    int const _metricsPort;
+    int const _traceEveryNQueries;
     int const _largeResultConcurrentMerges;
+    int const _admissionMaxInFlightChunks;
+    int const _admissionMaxResultMB;
+    int const _admissionLargeResultMB;
+    int const _admissionDefaultResultMB;
+    int const _resultFlowMaxInFlightMB;
+    int const _resultFlowMaxQueryInFlightMB;
+    int const _resultFlowTargetMergeSecs;
     int const _xrootdCBThreadsMax;
     int const _xrootdCBThreadsInit;
     int const _qMetaSecsBetweenChunkCompletionUpdates;
@@ -0,0 +1,138 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+ /**
+  * @file
+  *
+  * @brief Test AdmissionController.
+  */
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Qserv headers
+#include "czar/AdmissionController.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE AdmissionController
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::ccontrol::QueryCost;
+using lsst::qserv::czar::AdmissionController;
+
+namespace {
+
+QueryCost makeCost(int chunks, bool interactive, std::int64_t resultBytes=-1) {
+    QueryCost cost;
+    cost.chunkCount = chunks;
+    cost.interactive = interactive;
+    cost.resultBytes = resultBytes;
+    return cost;
+}
+
+/// Wait (with a timeout) until the number of queued queries reaches the value
+bool waitQueued(AdmissionController const& ac, int queued) {
+    for (int i = 0; i < 1000; ++i) {
+        if (ac.getStatus().queuedQueries == queued) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Budgets) {
+    AdmissionController::Config config;
+    config.maxInFlightChunks = 100;
+    auto ac = AdmissionController::create(config);
+
+    // First query is always admitted even if it's over the budget
+    auto t1 = ac->admit(1, makeCost(150, false));
+    BOOST_REQUIRE(t1 != nullptr);
+    BOOST_CHECK_EQUAL(ac->getStatus().inFlightChunks, 150);
+
+    // Interactive queries are never queued
+    auto t2 = ac->admit(2, makeCost(5, true));
+    BOOST_REQUIRE(t2 != nullptr);
+    BOOST_CHECK_EQUAL(ac->getStatus().runningQueries, 2);
+
+    // Scan has to wait until the first query finishes
+    std::atomic<bool> admitted{false};
+    std::thread scan([&ac, &admitted]() {
+        auto t3 = ac->admit(3, makeCost(50, false));
+        admitted = (t3 != nullptr);
+    });
+    BOOST_CHECK(waitQueued(*ac, 1));
+    BOOST_CHECK(not admitted);
+    t1.reset();
+    scan.join();
+    BOOST_CHECK(admitted);
+
+    t2.reset();
+    auto status = ac->getStatus();
+    BOOST_CHECK_EQUAL(status.runningQueries, 0);
+    BOOST_CHECK_EQUAL(status.inFlightChunks, 0);
+    BOOST_CHECK_EQUAL(status.resultBytes, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(LargeResults) {
+    AdmissionController::Config config;
+    config.maxLargeResults = 1;
+    config.largeResultBytes = 1000;
+    auto ac = AdmissionController::create(config);
+
+    auto t1 = ac->admit(1, makeCost(10, false, 5000));
+    BOOST_CHECK_EQUAL(ac->getStatus().largeResults, 1);
+    // small result is not limited by merge budget
+    auto t2 = ac->admit(2, makeCost(10, false, 10));
+    BOOST_REQUIRE(t2 != nullptr);
+    BOOST_CHECK_EQUAL(ac->getStatus().largeResults, 1);
+}
+
+BOOST_AUTO_TEST_CASE(Cancel) {
+    AdmissionController::Config config;
+    config.maxResultBytes = 1000;
+    auto ac = AdmissionController::create(config);
+
+    auto t1 = ac->admit(1, makeCost(10, false, 900));
+    std::atomic<bool> cancelled{false};
+    std::thread scan([&ac, &cancelled]() {
+        auto t2 = ac->admit(2, makeCost(10, false, 900));
+        cancelled = (t2 == nullptr);
+    });
+    BOOST_CHECK(waitQueued(*ac, 1));
+    BOOST_CHECK(not ac->cancel(3));
+    BOOST_CHECK(ac->cancel(2));
+    scan.join();
+    BOOST_CHECK(cancelled);
+    BOOST_CHECK_EQUAL(ac->getStatus().queuedQueries, 0);
+    BOOST_CHECK_EQUAL(ac->getStatus().resultBytes, 900U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -47,6 +47,9 @@ const char SUBCHUNK_TAG[] = "%S\007S%";
 /// `CHUNK_TAG` is a pattern that is replaced with a chunk number
 /// when generating concrete query text from a template.
 const char CHUNK_TAG[] = "%C\007C%";
+/// `SEMIJOIN_PREDICATE` is a placeholder of a semi-join predicate, see
+/// proto::TaskMsg::SemiJoin. It's true unless a worker replaces it.
+const char SEMIJOIN_PREDICATE[] = "/*qserv_semijoin*/ TRUE";
 
 /**
  * The absolute maximum number of job attempts. The number
@@ -35,10 +35,14 @@
 #include "lsst/log/Log.h"
 
 // qserv headers
+#include "util/Metrics.h"
 #include "util/Timer.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.memman.Memory");
+
+auto const mlockSeconds = lsst::qserv::util::MetricsRegistry::instance().histogram(
+    "qserv_worker_mlock_seconds", "Time to lock a table file in memory");
 }
 
 namespace lsst {
@@ -98,8 +102,6 @@ std::string Memory::filePath(std::string const& dbTable,
 /******************************************************************************/
 /*                               m e m L o c k                                */
 /******************************************************************************/
-util::TimerHistogram mlockHisto("mlock Hist", {1, 10, 20, 40});
-
 int Memory::memLock(MemInfo& mInfo, bool isFlex) {
 
     // Verify that this is a valid mapping
@@ -118,8 +120,8 @@ int Memory::memLock(MemInfo& mInfo, bool isFlex) {
         timer.stop();
     }
     mInfo._mlockTime = timer.getElapsed();
-    auto logMsg = mlockHisto.addTime(mInfo._mlockTime, LOG_CHECK_DEBUG() ? "a":"");
-    LOGS(_log, LOG_LVL_DEBUG, logMsg);
+    mlockSeconds->record(mInfo._mlockTime);
+    LOGS(_log, LOG_LVL_DEBUG, "mlock end time=" << mInfo._mlockTime);
 
     if (!result) {
         std::lock_guard<std::mutex> guard(_memMutex);
@@ -0,0 +1,63 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "metrics/MetricsServer.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "util/Metrics.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.metrics.MetricsServer");
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace metrics {
+
+MetricsServer::Ptr MetricsServer::create(unsigned short port) {
+    return Ptr(new MetricsServer(port));
+}
+
+MetricsServer::MetricsServer(unsigned short port)
+    : _server(qhttp::Server::create(_ioService, port)) {
+    _server->addHandler("GET", "/metrics", [](qhttp::Request::Ptr, qhttp::Response::Ptr resp) {
+        resp->send(util::MetricsRegistry::instance().format(), "text/plain; version=0.0.4");
+    });
+    _server->start();
+    LOGS(_log, LOG_LVL_INFO, "Serving metrics on port " << _server->getPort());
+    _thread = std::thread([this]() { _ioService.run(); });
+}
+
+MetricsServer::~MetricsServer() {
+    _server->stop();
+    _ioService.stop();
+    if (_thread.joinable()) _thread.join();
+}
+
+}}} // namespace lsst::qserv::metrics
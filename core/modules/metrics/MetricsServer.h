@@ -0,0 +1,67 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_METRICS_METRICSSERVER_H
+#define LSST_QSERV_METRICS_METRICSSERVER_H
+
+// System headers
+#include <memory>
+#include <thread>
+
+// Third-party headers
+#include "boost/asio.hpp"
+
+// Qserv headers
+#include "qhttp/Server.h"
+
+namespace lsst {
+namespace qserv {
+namespace metrics {
+
+/// MetricsServer serves the metrics of util::MetricsRegistry::instance() over HTTP
+/// at "GET /metrics" from its own thread, until it is destroyed.
+class MetricsServer {
+public:
+    typedef std::shared_ptr<MetricsServer> Ptr;
+
+    /// Start serving metrics.
+    /// @param port: TCP port to listen on, 0 to let the system pick one.
+    static Ptr create(unsigned short port);
+
+    MetricsServer(MetricsServer const&) = delete;
+    MetricsServer& operator=(MetricsServer const&) = delete;
+
+    ~MetricsServer();
+
+    unsigned short getPort() { return _server->getPort(); }
+
+private:
+    explicit MetricsServer(unsigned short port);
+
+    boost::asio::io_service _ioService;
+    qhttp::Server::Ptr _server;
+    std::thread _thread;
+};
+
+}}} // namespace lsst::qserv::metrics
+
+#endif // LSST_QSERV_METRICS_METRICSSERVER_H
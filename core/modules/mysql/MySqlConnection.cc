@@ -117,9 +117,13 @@ bool MySqlConnection::checkConnection(mysql::MySqlConfig const& mysqlconfig) {
 
 void
 MySqlConnection::closeMySqlConn() {
-    // Close mysql connection and set deallocated pointer to null
+    // Close mysql connection and set deallocated pointer to null.
+    // Holding the lock keeps cancel() from using the connection while it is closed.
+    std::lock_guard<std::mutex> lock(_interruptMutex);
     mysql_close(_mysql);
     _mysql = nullptr;
+    _isExecuting = false;
+    _isConnected = false;
 }
 
 bool
@@ -0,0 +1,90 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "proto/WorkerResponsePool.h"
+
+namespace lsst {
+namespace qserv {
+namespace proto {
+
+WorkerResponsePool::~WorkerResponsePool() {
+    for (auto response: _free) {
+        delete response;
+    }
+}
+
+std::shared_ptr<WorkerResponse> WorkerResponsePool::get() {
+    WorkerResponse* response = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (not _free.empty()) {
+            response = _free.back();
+            _free.pop_back();
+            ++_reuseCount;
+        }
+    }
+    if (response == nullptr) {
+        response = new WorkerResponse();
+    }
+    std::weak_ptr<WorkerResponsePool> pool = shared_from_this();
+    return std::shared_ptr<WorkerResponse>(response, [pool](WorkerResponse* resp) {
+        auto p = pool.lock();
+        if (p != nullptr) {
+            p->_recycle(resp);
+        } else {
+            delete resp;
+        }
+    });
+}
+
+std::size_t WorkerResponsePool::freeCount() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _free.size();
+}
+
+std::size_t WorkerResponsePool::reuseCount() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _reuseCount;
+}
+
+void WorkerResponsePool::_recycle(WorkerResponse* response) {
+    // Size of the last result message is a good measure of the memory
+    // retained by the cleared message.
+    bool const tooLarge = response->protoHeader.has_size() &&
+                          static_cast<std::size_t>(response->protoHeader.size()) > _maxRetainedBytes;
+    if (not tooLarge) {
+        // Clear() keeps allocated sub-messages for reuse, do it outside of the lock
+        response->headerSize = 0;
+        response->protoHeader.Clear();
+        response->result.Clear();
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (_free.size() < _maxFree) {
+            _free.push_back(response);
+            return;
+        }
+    }
+    delete response;
+}
+
+}}} // namespace lsst::qserv::proto
@@ -0,0 +1,91 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_QSERV_PROTO_WORKERRESPONSEPOOL_H
+#define LSST_QSERV_PROTO_WORKERRESPONSEPOOL_H
+
+// System headers
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Qserv headers
+#include "proto/WorkerResponse.h"
+
+namespace lsst {
+namespace qserv {
+namespace proto {
+
+/// WorkerResponsePool recycles WorkerResponse objects. A cleared protobuf
+/// message keeps its repeated sub-messages and string buffers, so parsing
+/// the next result into a recycled response reuses that memory instead of
+/// allocating thousands of RowBundle objects for every message.
+///
+/// Responses are handed out as shared pointers which return the object to
+/// the pool when the last reference is dropped. Only a bounded number of
+/// responses is kept, and responses that held very large messages are freed
+/// so that a single large result does not pin memory forever.
+class WorkerResponsePool : public std::enable_shared_from_this<WorkerResponsePool> {
+public:
+    typedef std::shared_ptr<WorkerResponsePool> Ptr;
+
+    /// @param maxFree - maximum number of idle responses kept in the pool
+    /// @param maxRetainedBytes - responses with larger serialized result
+    ///                           messages are freed instead of recycled
+    static Ptr create(std::size_t maxFree, std::size_t maxRetainedBytes) {
+        return Ptr(new WorkerResponsePool(maxFree, maxRetainedBytes));
+    }
+
+    WorkerResponsePool(WorkerResponsePool const&) = delete;
+    WorkerResponsePool& operator=(WorkerResponsePool const&) = delete;
+
+    ~WorkerResponsePool();
+
+    /// @return an empty response, recycled if possible
+    std::shared_ptr<WorkerResponse> get();
+
+    /// @return the number of idle responses in the pool
+    std::size_t freeCount() const;
+
+    /// @return the number of responses handed out by get() which were recycled
+    std::size_t reuseCount() const;
+
+private:
+    WorkerResponsePool(std::size_t maxFree, std::size_t maxRetainedBytes)
+        : _maxFree(maxFree), _maxRetainedBytes(maxRetainedBytes) {}
+
+    /// Take back a response which is no longer used
+    void _recycle(WorkerResponse* response);
+
+    std::size_t const _maxFree;
+    std::size_t const _maxRetainedBytes;
+
+    mutable std::mutex _mtx; ///< protects _free and _reuseCount
+    std::vector<WorkerResponse*> _free;
+    std::size_t _reuseCount{0};
+};
+
+}}} // namespace lsst::qserv::proto
+
+#endif // LSST_QSERV_PROTO_WORKERRESPONSEPOOL_H
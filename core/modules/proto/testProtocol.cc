@@ -41,6 +41,7 @@
 #include "proto/TaskMsgDigest.h"
 #include "proto/worker.pb.h"
 #include "proto/WorkerResponse.h"
+#include "proto/WorkerResponsePool.h"
 
 #include "proto/FakeProtocolFixture.h"
 
@@ -193,6 +194,41 @@ BOOST_AUTO_TEST_CASE(ProtoHeaderWrap) {
     BOOST_CHECK(compareProtoHeaders(response->protoHeader, *ph));
 }
 
+BOOST_AUTO_TEST_CASE(WorkerResponsePool) {
+    auto pool = proto::WorkerResponsePool::create(1, 1000);
+    proto::WorkerResponse* kept = nullptr;
+    {
+        auto r1 = pool->get();
+        auto r2 = pool->get();
+        kept = r2.get(); // r2 is released first
+        r1->protoHeader.set_size(100);
+        r1->result.set_queryid(42);
+        r1->result.add_row()->add_column("abc");
+        r2->protoHeader.set_size(100);
+        r2->result.add_row()->add_column("def");
+    }
+    // only one response is kept
+    BOOST_CHECK_EQUAL(pool->freeCount(), 1U);
+    auto r3 = pool->get();
+    BOOST_CHECK_EQUAL(pool->reuseCount(), 1U);
+    BOOST_CHECK_EQUAL(pool->freeCount(), 0U);
+    // recycled response is empty
+    BOOST_CHECK(r3.get() == kept);
+    BOOST_CHECK_EQUAL(r3->result.row_size(), 0);
+    BOOST_CHECK(not r3->result.has_queryid());
+    BOOST_CHECK(not r3->protoHeader.has_size());
+
+    // responses which held large messages are not kept
+    r3->protoHeader.set_size(2000);
+    r3.reset();
+    BOOST_CHECK_EQUAL(pool->freeCount(), 0U);
+
+    // responses outliving the pool are just deleted
+    auto r4 = pool->get();
+    pool.reset();
+    r4.reset();
+}
+
 BOOST_AUTO_TEST_CASE(ScanTableInfo) {
     lsst::qserv::proto::ScanTableInfo stiA{"dba", "fruit", false, 1};
     lsst::qserv::proto::ScanTableInfo stiB{"dba", "fruit", true, 1};
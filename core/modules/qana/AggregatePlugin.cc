@@ -31,8 +31,10 @@
 #include "qana/AggregatePlugin.h"
 
 // System headers
+#include <algorithm>
 #include <string>
 #include <stdexcept>
+#include <vector>
 
 // Third-party headers
 
@@ -50,6 +52,7 @@
 #include "query/ValueExpr.h"
 #include "query/ValueFactor.h"
 #include "util/common.h"
+#include "util/IterableFormatter.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.qana.AggregatePlugin");
@@ -71,8 +74,8 @@ template <class C>
 class convertAgg {
 public:
     typedef typename C::value_type T;
-    convertAgg(C& pList_, C& mList_, query::AggOp::Mgr& aMgr_)
-        : pList(pList_), mList(mList_), aMgr(aMgr_) {}
+    convertAgg(C& pList_, C& mList_, std::vector<std::string>& cList_, query::AggOp::Mgr& aMgr_)
+        : pList(pList_), mList(mList_), cList(cList_), aMgr(aMgr_) {}
     void operator()(T const& e) {
         _makeRecord(*e);
     }
@@ -96,6 +99,8 @@ private:
             query::ValueExprPtr par(e.clone());
             par->setAlias(interName);
             pList.push_back(par);
+            // * expands to an unknown number of columns.
+            cList.push_back(e.isStar() ? "*" : "");
 
             if (!interName.empty()) {
                 query::ValueExprPtr mer = newExprFromAlias(interName);
@@ -121,6 +126,7 @@ private:
             query::ValueFactorPtr newFactor = i->factor->clone();
             if (newFactor->getType() != query::ValueFactor::AGGFUNC) {
                 pList.push_back(query::ValueExpr::newSimple(newFactor));
+                cList.push_back("");
             } else {
                 query::AggRecord r;
                 r.orig = newFactor;
@@ -133,6 +139,11 @@ private:
                     throw std::logic_error("Couldn't process AggRecord");
                 }
                 pList.insert(pList.end(), p->parallel.begin(), p->parallel.end());
+                if (p->combine.size() == p->parallel.size()) {
+                    cList.insert(cList.end(), p->combine.begin(), p->combine.end());
+                } else {
+                    cList.insert(cList.end(), p->parallel.size(), "*");
+                }
                 query::ValueExpr::FactorOp m;
                 m.factor = p->merge;
                 m.op = i->op;
@@ -145,6 +156,7 @@ private:
 
     C& pList;
     C& mList;
+    std::vector<std::string>& cList; ///< combine op of each pList entry, "*" if unknown
     query::AggOp::Mgr& aMgr;
 };
 
@@ -176,8 +188,10 @@ AggregatePlugin::applyPhysical(QueryPlugin::Plan& plan,
     pList.getValueExprList()->clear();
     mList.getValueExprList()->clear();
     query::AggOp::Mgr m; // Eventually, this can be shared?
+    std::vector<std::string> combineOps;
     convertAgg<query::ValueExprPtrVector> ca(*pList.getValueExprList(),
                                              *mList.getValueExprList(),
+                                             combineOps,
                                              m);
     std::for_each(vlist->begin(), vlist->end(), ca);
     // Also need to operate on GROUP BY.
@@ -186,6 +200,16 @@ AggregatePlugin::applyPhysical(QueryPlugin::Plan& plan,
         context.needsMerge = true;
     }
 
+    // The merge query groups by columns of the parallel results, so rows of
+    // several chunks grouped by all non-aggregate columns may be combined
+    // before they reach the czar.
+    context.combineOps.clear();
+    if (m.hasAggregate() && combineOps.size() == pList.getValueExprList()->size()
+        && std::find(combineOps.begin(), combineOps.end(), "*") == combineOps.end()) {
+        context.combineOps = combineOps;
+        LOGS(_log, LOG_LVL_DEBUG, "combineOps=" << util::printable(combineOps));
+    }
+
     std::shared_ptr<query::OrderByClause> _nullptr;
 
     for(auto first=plan.stmtParallel.begin(), parallel_query=first, end=plan.stmtParallel.end();
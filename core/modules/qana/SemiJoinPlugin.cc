@@ -0,0 +1,290 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/** @file
+  * @brief A plugin pushing director table restrictions down to the
+  *        tables joined with it.
+  */
+
+// Class header
+#include "qana/SemiJoinPlugin.h"
+
+// System headers
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "global/constants.h"
+#include "qana/AnalysisError.h"
+#include "qana/TableInfo.h"
+#include "qana/TableInfoPool.h"
+#include "query/AndTerm.h"
+#include "query/BoolFactor.h"
+#include "query/BoolTerm.h"
+#include "query/ColumnRef.h"
+#include "query/CompPredicate.h"
+#include "query/FromList.h"
+#include "query/JoinRef.h"
+#include "query/JoinSpec.h"
+#include "query/OrTerm.h"
+#include "query/PassTerm.h"
+#include "query/QueryContext.h"
+#include "query/QueryTemplate.h"
+#include "query/SelectStmt.h"
+#include "query/TableRef.h"
+#include "query/ValueExpr.h"
+#include "query/WhereClause.h"
+
+using lsst::qserv::query::AndTerm;
+using lsst::qserv::query::BoolFactor;
+using lsst::qserv::query::BoolTerm;
+using lsst::qserv::query::ColumnRef;
+using lsst::qserv::query::CompPredicate;
+using lsst::qserv::query::FromList;
+using lsst::qserv::query::JoinRef;
+using lsst::qserv::query::OrTerm;
+using lsst::qserv::query::PassTerm;
+using lsst::qserv::query::QueryTemplate;
+using lsst::qserv::query::SelectStmt;
+using lsst::qserv::query::TableRef;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qana.SemiJoinPlugin");
+
+/// The tables of an inner join and the conditions of its FROM list.
+struct InnerJoin {
+    std::vector<TableRef::Ptr> tables;
+    BoolTerm::PtrVector onTerms;
+    std::vector<std::string> usingColumns;
+};
+
+/// Add the terms of the conjunction 'term' to 'terms'.
+void addConjuncts(BoolTerm::Ptr const& term, BoolTerm::PtrVector& terms) {
+    if (term == nullptr) {
+        return;
+    }
+    auto andTerm = std::dynamic_pointer_cast<AndTerm>(term);
+    auto orTerm = std::dynamic_pointer_cast<OrTerm>(term);
+    if (andTerm != nullptr) {
+        for (auto const& t : andTerm->_terms) {
+            addConjuncts(t, terms);
+        }
+    } else if (orTerm != nullptr && orTerm->_terms.size() == 1) {
+        addConjuncts(orTerm->_terms.front(), terms);
+    } else {
+        terms.push_back(term);
+    }
+}
+
+/// @return false if 'fromList' is not made of inner joins of simple tables.
+bool getInnerJoin(FromList const& fromList, InnerJoin& join) {
+    for (auto const& table : fromList.getTableRefList()) {
+        join.tables.push_back(table);
+        for (auto const& joinRef : table->getJoins()) {
+            auto const type = joinRef->getJoinType();
+            if (type != JoinRef::DEFAULT && type != JoinRef::INNER && type != JoinRef::CROSS) {
+                return false;
+            }
+            auto right = joinRef->getRight();
+            if (joinRef->isNatural() || right == nullptr || not right->isSimple()) {
+                return false;
+            }
+            join.tables.push_back(right);
+            auto spec = joinRef->getSpec();
+            if (spec != nullptr) {
+                if (spec->getUsing() != nullptr) {
+                    join.usingColumns.push_back(spec->getUsing()->getColumn());
+                }
+                addConjuncts(spec->getOn(), join.onTerms);
+            }
+        }
+    }
+    return true;
+}
+
+/// @return the table aliased 'alias' in 'fromList', nullptr if there is none.
+TableRef::Ptr findTable(FromList& fromList, std::string const& alias) {
+    for (auto const& table : fromList.getTableRefList()) {
+        if (table->getAlias() == alias) {
+            return table;
+        }
+        for (auto const& joinRef : table->getJoins()) {
+            if (joinRef->getRight() != nullptr && joinRef->getRight()->getAlias() == alias) {
+                return joinRef->getRight();
+            }
+        }
+    }
+    return nullptr;
+}
+
+/// @return the columns of 'info' which refer to the primary key of 'dir'.
+std::vector<std::string> foreignKeys(lsst::qserv::qana::TableInfo const* info,
+                                     lsst::qserv::qana::DirTableInfo const* dir) {
+    using lsst::qserv::qana::ChildTableInfo;
+    using lsst::qserv::qana::MatchTableInfo;
+    std::vector<std::string> keys;
+    auto child = dynamic_cast<ChildTableInfo const*>(info);
+    auto match = dynamic_cast<MatchTableInfo const*>(info);
+    if (child != nullptr && child->director == dir) {
+        keys.push_back(child->fk);
+    } else if (match != nullptr) {
+        if (match->director.first == dir) keys.push_back(match->fk.first);
+        if (match->director.second == dir) keys.push_back(match->fk.second);
+    }
+    return keys;
+}
+
+bool isColumn(ColumnRef const& ref, std::string const& alias, std::string const& column) {
+    return ref.getDb().empty() && ref.getTable() == alias && ref.getColumn() == column;
+}
+
+/// @return true if 'term' is "a1.c1 = a2.c2", in any order.
+bool isEquality(BoolTerm::Ptr const& term, std::string const& a1, std::string const& c1,
+                std::string const& a2, std::string const& c2) {
+    auto factor = std::dynamic_pointer_cast<BoolFactor>(term);
+    if (factor == nullptr || factor->_hasNot || factor->_terms.size() != 1) {
+        return false;
+    }
+    auto comp = std::dynamic_pointer_cast<CompPredicate>(factor->_terms.front());
+    if (comp == nullptr || comp->op != CompPredicate::EQUALS_OP || !comp->left || !comp->right) {
+        return false;
+    }
+    auto left = comp->left->copyAsColumnRef();
+    auto right = comp->right->copyAsColumnRef();
+    if (left == nullptr || right == nullptr) {
+        return false;
+    }
+    return (isColumn(*left, a1, c1) && isColumn(*right, a2, c2))
+        || (isColumn(*left, a2, c2) && isColumn(*right, a1, c1));
+}
+
+/// @return true if the rows of 'join' match only if 'alias.fk' equals 'dirAlias.pk'.
+bool isJoinedOn(InnerJoin const& join, SelectStmt const& stmt,
+                std::string const& alias, std::string const& fk,
+                std::string const& dirAlias, std::string const& pk) {
+    if (fk == pk && std::find(join.usingColumns.begin(), join.usingColumns.end(), fk)
+                    != join.usingColumns.end()) {
+        return true;
+    }
+    BoolTerm::PtrVector terms = join.onTerms;
+    if (stmt.hasWhereClause()) {
+        addConjuncts(stmt.getWhereClause().getRootAndTerm(), terms);
+    }
+    return std::any_of(terms.begin(), terms.end(), [&](BoolTerm::Ptr const& term) {
+        return isEquality(term, alias, fk, dirAlias, pk);
+    });
+}
+
+/// Prepend the SEMIJOIN_PREDICATE placeholder to the WHERE clause of 'stmt'.
+/// @return the key query "SELECT DISTINCT dirAlias.pk FROM <director> WHERE <cuts>",
+///         where cuts are the terms of the global AND of 'stmt' which refer to
+///         the director alone. Nothing is done if there are none, and an empty
+///         string is returned.
+std::string addSemiJoin(SelectStmt& stmt, std::string const& dirAlias, std::string const& pk) {
+    if (not stmt.hasWhereClause()) {
+        return std::string();
+    }
+    auto rootAnd = stmt.getWhereClause().getRootAndTerm();
+    if (rootAnd == nullptr) {
+        return std::string();
+    }
+    std::string cuts;
+    for (auto const& term : rootAnd->_terms) {
+        ColumnRef::Vector refs;
+        term->findColumnRefs(refs);
+        bool const dirOnly = not refs.empty() && std::all_of(refs.begin(), refs.end(),
+            [&dirAlias](ColumnRef::Ptr const& ref) {
+                return ref->getDb().empty() && ref->getTable() == dirAlias;
+            });
+        if (not dirOnly) {
+            continue;
+        }
+        QueryTemplate qt;
+        term->renderTo(qt);
+        std::string const sql = qt.sqlFragment();
+        if (sql.empty()) {
+            continue;
+        }
+        cuts += (cuts.empty() ? "(" : " AND (") + sql + ")";
+    }
+    auto dirTable = findTable(stmt.getFromList(), dirAlias);
+    if (cuts.empty() || dirTable == nullptr) {
+        return std::string();
+    }
+    QueryTemplate from;
+    TableRef(dirTable->getDb(), dirTable->getTable(), dirAlias).putTemplate(from);
+    std::string const keyQuery = "SELECT DISTINCT " + dirAlias + "." + pk + " FROM " + from.sqlFragment()
+        + " WHERE " + cuts;
+    stmt.getWhereClause().prependAndTerm(
+        std::make_shared<BoolFactor>(std::make_shared<PassTerm>(lsst::qserv::SEMIJOIN_PREDICATE)));
+    return keyQuery;
+}
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace qana {
+
+void
+SemiJoinPlugin::applyPhysical(QueryPlugin::Plan& p, query::QueryContext& context) {
+    InnerJoin join;
+    if (not getInnerJoin(p.stmtOriginal.getFromList(), join) || join.tables.size() != 2) {
+        return;
+    }
+    if (!context.css) {
+        throw AnalysisBug("Missing metadata in context");
+    }
+    TableInfoPool pool(context.defaultDb, *context.css);
+    for (int d = 0; d < 2; ++d) {
+        TableRef const& dirRef = *join.tables[d];
+        TableRef const& ref = *join.tables[1 - d];
+        auto dir = dynamic_cast<DirTableInfo const*>(pool.get(dirRef.getDb(), dirRef.getTable()));
+        if (dir == nullptr) {
+            continue;
+        }
+        for (auto const& fk : foreignKeys(pool.get(ref.getDb(), ref.getTable()), dir)) {
+            if (isJoinedOn(join, p.stmtOriginal, ref.getAlias(), fk, dirRef.getAlias(), dir->pk)) {
+                // The parallel queries only differ in their select lists.
+                for (auto const& stmt : p.stmtParallel) {
+                    std::string const keyQuery = addSemiJoin(*stmt, dirRef.getAlias(), dir->pk);
+                    if (not keyQuery.empty()) {
+                        context.semiJoinColumn = ref.getAlias() + "." + fk;
+                        context.semiJoinKeyQuery = keyQuery;
+                    }
+                }
+                LOGS(_log, LOG_LVL_DEBUG, "semi-join column: " << context.semiJoinColumn
+                     << " key query: " << context.semiJoinKeyQuery);
+                return;
+            }
+        }
+    }
+}
+
+}}} // namespace lsst::qserv::qana
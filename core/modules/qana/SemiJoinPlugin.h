@@ -0,0 +1,73 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QANA_SEMIJOINPLUGIN_H
+#define LSST_QSERV_QANA_SEMIJOINPLUGIN_H
+
+// Qserv headers
+#include "qana/QueryPlugin.h"
+
+
+namespace lsst {
+namespace qserv {
+namespace qana {
+
+/// SemiJoinPlugin pushes the restrictions on a director table down to the
+/// table joined with it in director joins, such as
+///
+///     SELECT ... FROM Object o, Source s
+///     WHERE o.objectId = s.objectId AND o.gFlux > 1e-29
+///
+/// Each parallel query is given the SEMIJOIN_PREDICATE placeholder, and
+/// the query context the column "s.objectId" and the key query
+///
+///     SELECT DISTINCT o.objectId FROM Object_%C AS o WHERE (o.gFlux > 1e-29)
+///
+/// which are sent to the workers in proto::TaskMsg::SemiJoin. A worker runs
+/// the key query first and replaces the placeholder by a test for the keys it
+/// found, so that only the rows of the joined table which can match are read.
+/// The test is implied by the join, a query with the placeholder left in
+/// place has the same result.
+///
+/// Only inner joins of two tables are considered, where one is a director
+/// and the other one a child or match table of it, the tables are joined on
+/// the director key, and some terms of the global AND of the WHERE clause
+/// refer to the director alone. The plugin must run after TablePlugin and
+/// QservRestrictorPlugin, so that tables are aliased and spatial restrictors
+/// are part of the WHERE clause.
+class SemiJoinPlugin : public QueryPlugin {
+public:
+    typedef std::shared_ptr<SemiJoinPlugin> Ptr;
+
+    SemiJoinPlugin() {}
+    virtual ~SemiJoinPlugin() {}
+
+    void prepare() override {}
+    void applyPhysical(QueryPlugin::Plan& p, query::QueryContext& context) override;
+
+    /// Return the name of the plugin class for logging.
+    std::string name() const override { return "SemiJoinPlugin"; }
+};
+
+}}} // namespace lsst::qserv::qana
+
+#endif // LSST_QSERV_QANA_SEMIJOINPLUGIN_H
@@ -275,12 +275,17 @@ bool Executive::join() {
     if (sCount == _requestCount) {
         LOGS(_log, LOG_LVL_DEBUG, "Query execution succeeded: " << _requestCount
              << " jobs dispatched and completed.");
+    } else if (_rowLimitComplete) {
+        LOGS(_log, LOG_LVL_DEBUG, "Query execution succeeded: " << _requestCount
+             << " jobs dispatched, " << sCount << " jobs completed before reaching row limit "
+             << _resultRowLimit);
     } else {
         LOGS(_log, LOG_LVL_ERROR, "Query execution failed: " << _requestCount
              << " jobs dispatched, but only " << sCount << " jobs completed");
     }
     _updateProxyMessages();
-    bool empty = (sCount == _requestCount);
+    // Jobs squashed after enough rows were merged are not needed for the result.
+    bool empty = (sCount == _requestCount) || _rowLimitComplete;
     _empty.store(empty);
     LOGS(_log, LOG_LVL_DEBUG, "Flag set to _empty=" << empty << ", sCount=" << sCount
          << ", requestCount=" << _requestCount);
@@ -292,6 +297,8 @@ void Executive::markCompleted(int jobId, bool success) {
     std::string idStr = QueryIdHelper::makeIdStr(_id, jobId);
     LOGS(_log, LOG_LVL_DEBUG, "Executive::markCompleted " << idStr
             << " " << success);
+    // Rows of failed attempts are scrubbed, only those of completed jobs count.
+    bool const rowLimitReached = success && _addResultRows(jobId);
     if (!success) {
         {
             std::lock_guard<std::mutex> lock(_incompleteJobsMutex);
@@ -313,6 +320,18 @@ void Executive::markCompleted(int jobId, bool success) {
                 return;
             }
         }
+        if (_rowLimitComplete) {
+            // Result already has enough rows, the job was squashed or its
+            // failure does not matter.
+            LOGS(_log, LOG_LVL_DEBUG, "Executive: " << idStr << " ended after row limit was reached");
+            {
+                std::lock_guard<std::recursive_mutex> lockJobMap(_jobMapMtx);
+                auto job = _jobMap[jobId];
+                job->getStatus()->updateInfo(job->getIdStr(), JobStatus::CANCEL);
+            }
+            _unTrack(jobId);
+            return;
+        }
         LOGS(_log, LOG_LVL_WARN, "Executive: error executing " << idStr
              << " " << err << " (status: " << err.getStatus() << ")");
         {
@@ -333,6 +352,8 @@ void Executive::markCompleted(int jobId, bool success) {
         LOGS(_log, LOG_LVL_ERROR, "Executive: requesting squash, cause: "
              << idStr << " failed (code=" << err.getCode() << " " << err.getMsg() << ")");
         squash(); // ask to squash
+    } else if (rowLimitReached) {
+        squash();
     }
 }
 
@@ -359,6 +380,36 @@ void Executive::squash() {
     LOGS_DEBUG(getIdStr() << " Executive::squash done");
 }
 
+bool Executive::markCombined(int jobId, int attemptCount) {
+    JobQuery::Ptr job;
+    {
+        std::lock_guard<std::recursive_mutex> lockJobMap(_jobMapMtx);
+        auto iter = _jobMap.find(jobId);
+        if (iter == _jobMap.end()) {
+            LOGS(_log, LOG_LVL_ERROR, getIdStr() << " combined job " << jobId << " not found");
+            return false;
+        }
+        job = iter->second;
+    }
+    return job->markCombined(attemptCount);
+}
+
+bool Executive::_addResultRows(int jobId) {
+    if (_resultRowLimit == NOTSET) return false;
+    std::int64_t rows = 0;
+    {
+        std::lock_guard<std::recursive_mutex> lockJobMap(_jobMapMtx);
+        auto iter = _jobMap.find(jobId);
+        if (iter == _jobMap.end()) return false;
+        rows = iter->second->getDescription()->respHandler()->getMergedRows();
+    }
+    std::int64_t const total = _resultRows += rows;
+    if (total < _resultRowLimit || _rowLimitComplete.exchange(true)) return false;
+    LOGS(_log, LOG_LVL_INFO, getIdStr() << " row limit " << _resultRowLimit
+         << " reached with " << total << " rows, squashing remaining jobs");
+    return true;
+}
+
 int Executive::getNumInflight() {
     std::unique_lock<std::mutex> lock(_incompleteJobsMutex);
     return _incompleteJobs.size();
@@ -28,12 +28,14 @@
 
 // System headers
 #include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <sstream>
 #include <unordered_map>
 #include <vector>
 
 // Qserv headers
+#include "global/constants.h"
 #include "global/intTypes.h"
 #include "global/ResourceUnit.h"
 #include "global/stringTypes.h"
@@ -41,6 +43,7 @@
 #include "qdisp/JobStatus.h"
 #include "qdisp/ResponseHandler.h"
 #include "qdisp/QdispPool.h"
+#include "qdisp/QueryTrace.h"
 #include "util/EventThread.h"
 #include "util/InstanceCount.h"
 #include "util/MultiError.h"
@@ -110,6 +113,11 @@ public:
     /// Squash all the jobs.
     void squash();
 
+    /// A worker combined the rows of attempt 'attemptCount' of job 'jobId'
+    /// into the result of another job, see JobQuery::markCombined().
+    /// @return false if the rows of the job must not be merged.
+    bool markCombined(int jobId, int attemptCount);
+
     bool getEmpty() { return _empty; }
 
     void setQueryId(QueryId id);
@@ -118,6 +126,22 @@ public:
 
     void setScanInteractive(bool interactive) { _scanInteractive = interactive; }
 
+    /// Set the number of merged rows which is enough to answer the query,
+    /// NOTSET means that results of all jobs are needed. Must be set before
+    /// jobs are added. Rows of a job count once it completes, when the limit
+    /// is reached no more jobs are dispatched and the remaining ones are squashed.
+    void setResultRowLimit(std::int64_t rowLimit) { _resultRowLimit = rowLimit; }
+
+    /// @return true if the query completed early because of the result row limit.
+    bool getRowLimitComplete() const { return _rowLimitComplete; }
+
+    /// Set the collector of the query timeline, jobs record their spans
+    /// only when it is set. Must be set before jobs are added.
+    void setTrace(QueryTrace::Ptr const& trace) { _trace = trace; }
+
+    /// @return the collector of the query timeline, nullptr if the query is not traced
+    QueryTrace::Ptr const& getTrace() const { return _trace; }
+
     /// @return number of items in flight.
     int getNumInflight(); // non-const, requires a mutex.
 
@@ -153,6 +177,10 @@ private:
 
     void _updateProxyMessages();
 
+    /// Account for the rows merged by completed job 'jobId'.
+    /// @return true if the result row limit was reached by them.
+    bool _addResultRows(int jobId);
+
     void _waitAllUntilEmpty();
 
     // for debugging
@@ -198,6 +226,12 @@ private:
     std::mutex _lastQMetaMtx; ///< protects _lastQMetaUpdate.
 
     bool _scanInteractive = false; ///< true for interactive scans.
+
+    std::int64_t _resultRowLimit{NOTSET}; ///< rows needed to answer the query, NOTSET if unlimited.
+    std::atomic<std::int64_t> _resultRows{0}; ///< rows merged by completed jobs.
+    std::atomic<bool> _rowLimitComplete{false}; ///< true once _resultRowLimit rows were merged.
+
+    QueryTrace::Ptr _trace; ///< nullptr if the query is not traced
 };
 
 class MarkCompleteFunc {
@@ -81,6 +81,12 @@ bool JobQuery::runJob() {
 
         LOGS(_log, LOG_LVL_DEBUG, _idStr << " runJob checking attempt=" << _jobDescription->getAttemptCount());
         std::lock_guard<std::recursive_mutex> lock(_rmutex);
+        if (_combined) {
+            // The rows of the chunk were merged with those of another job,
+            // running it again would merge them twice.
+            criticalErr("can't retry a job combined with another one");
+            return false;
+        }
         if (_jobDescription->getAttemptCount() < _getMaxAttempts()) {
             bool okCount = _jobDescription->incrAttemptCountScrubResults();
             if (!okCount) {
@@ -116,6 +122,20 @@ bool JobQuery::runJob() {
     return false;
 }
 
+bool JobQuery::markCombined(int attemptCount) {
+    std::lock_guard<std::recursive_mutex> lock(_rmutex);
+    if (_jobDescription->getAttemptCount() != attemptCount) {
+        LOGS(_log, LOG_LVL_ERROR, _idStr << " attempt " << attemptCount << " was combined, but attempt "
+             << _jobDescription->getAttemptCount() << " is running");
+        return false;
+    }
+    _combined = true;
+    if (_queryRequestPtr != nullptr) {
+        _queryRequestPtr->doNotRetry();
+    }
+    return true;
+}
+
 /// Cancel response handling. Return true if this is the first time cancel has been called.
 bool JobQuery::cancel() {
     LOGS(_log, LOG_LVL_DEBUG, _idStr << " JobQuery::cancel()");
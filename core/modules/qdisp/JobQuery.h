@@ -64,6 +64,7 @@ public:
     virtual bool runJob();
 
     int getIdInt() const { return _jobDescription->id(); }
+    QueryId getQueryId() const { return _qid; }
     std::string const& getIdStr() const { return _idStr; }
     JobDescription::Ptr getDescription() { return _jobDescription; }
     JobStatus::Ptr getStatus() { return _jobStatus; }
@@ -82,10 +83,25 @@ public:
     bool cancel();
     bool isQueryCancelled();
 
+    /// A worker combined the rows of attempt 'attemptCount' into the result
+    /// of another job, the job is not retried from now on.
+    /// @return false if the job already runs another attempt, the rows of
+    ///         the chunk would be merged twice.
+    bool markCombined(int attemptCount);
+
     Executive::Ptr getExecutive() { return _executive.lock(); }
 
     std::shared_ptr<QdispPool> getQdispPool() { return _qdispPool; }
 
+    /// @return the chunk queried by this job
+    int getChunkId() const { return _jobDescription->resource().chunk(); }
+
+    /// @return the timeline collector of the user query, nullptr if the query is not traced
+    QueryTrace::Ptr getTrace() {
+        auto executive = _executive.lock();
+        return (executive != nullptr) ? executive->getTrace() : nullptr;
+    }
+
     friend std::ostream& operator<<(std::ostream& os, JobQuery const& jq);
 
     /// Make a copy of the job description. JobQuery::_setup() must be called after creation.
@@ -120,11 +136,12 @@ protected:
 
     // Values that need mutex protection
     mutable std::recursive_mutex _rmutex; ///< protects _jobDescription,
-                                          ///< _queryRequestPtr, and _inSsi
+                                          ///< _queryRequestPtr, _inSsi and _combined
 
     // SSI items
     std::shared_ptr<QueryRequest> _queryRequestPtr;
     bool _inSsi{false};
+    bool _combined{false}; ///< Rows were merged with another job, see markCombined().
 
     // Cancellation
     std::atomic<bool> _cancelled {false}; ///< Lock to make sure cancel() is only called once.
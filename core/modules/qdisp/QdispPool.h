@@ -30,6 +30,7 @@
 
 // Qserv headers
 #include "global/Bug.h"
+#include "qdisp/ResultFlowControl.h"
 #include "util/ThreadPool.h"
 
 namespace lsst {
@@ -153,11 +154,19 @@ public:
         _pool->shutdownPool();
     }
 
+    /// Set the flow control asked for credit before result data is requested
+    /// from workers. Must be called before any query is dispatched.
+    void setFlowControl(ResultFlowControl::Ptr const& flowControl) { _flowControl = flowControl; }
+
+    /// @return the result flow control, nullptr if result data is requested without limits.
+    ResultFlowControl::Ptr const& getFlowControl() const { return _flowControl; }
+
 private:
     void _setup(bool unitTest);
 
     PriorityQueue::Ptr _prQueue;
     util::ThreadPool::Ptr _pool;
+    ResultFlowControl::Ptr _flowControl;
 };
 
 
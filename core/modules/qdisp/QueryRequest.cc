@@ -63,12 +63,20 @@ public:
     typedef std::shared_ptr<AskForResponseDataCmd> Ptr;
     enum class State { STARTED0, DATAREADY1, DONE2 };
     AskForResponseDataCmd(QueryRequest::Ptr const& qr, JobQuery::Ptr const& jq)
-        : _qRequest(qr), _jQuery(jq), _idStr(jq->getIdStr()) {}
+        : _qRequest(qr), _jQuery(jq), _idStr(jq->getIdStr()),
+          _queuedAt(qr->_trace != nullptr ? QueryTrace::now() : 0) {}
 
     void action(util::CmdData *data) override {
+        // Flow control credit for the buffer is returned when this function is done with it.
+        ResultFlowControl::Credit::Ptr credit;
+        {
+            std::lock_guard<std::mutex> lg(_mtx);
+            credit = std::move(_credit);
+        }
         // If everything is ok, call GetResponseData to have XrdSsi ask the worker for the data.
         util::Timer tWaiting;
         util::Timer tTotal;
+        std::uint64_t waitStart = 0; // only set if the query is traced
         {
             tTotal.start();
             auto jq = _jQuery.lock();
@@ -86,6 +94,10 @@ public:
                 _setState(State::DONE2);
                 return;
             }
+            if (qr->_trace != nullptr) {
+                qr->_trace->addSince(qr->_jobId, qr->_chunkId, "responseQueue", _queuedAt);
+                waitStart = QueryTrace::now();
+            }
             std::vector<char>& buffer = jq->getDescription()->respHandler()->nextBuffer();
             LOGS(_log, LOG_LVL_DEBUG, _idStr << " AskForResp GetResponseData size=" << buffer.size());
             tWaiting.start();
@@ -123,6 +135,10 @@ public:
                 LOGS(_log, LOG_LVL_WARN, _idStr << " AskForResp null before processData");
                 return;
             }
+            if (waitStart != 0) {
+                qr->_trace->add(qr->_jobId, qr->_chunkId, QueryTrace::CZAR, "responseWait",
+                                waitStart, static_cast<std::uint64_t>(tWaiting.getElapsed() * 1e6));
+            }
             qr->_processData(jq, _blen, _last);
             // _processData will have created another AskForResponseDataCmd object if needed.
             tTotal.stop();
@@ -153,6 +169,12 @@ public:
         return _state;
     }
 
+    /// Hold flow control credit for the buffer until action() is done.
+    void setCredit(ResultFlowControl::Credit::Ptr credit) {
+        std::lock_guard<std::mutex> lg(_mtx);
+        _credit = std::move(credit);
+    }
+
 private:
     void _setState(State const state) {
         std::lock_guard<std::mutex> lg(_mtx);
@@ -169,6 +191,8 @@ private:
 
     int _blen{-1};
     bool _last{true};
+    std::uint64_t const _queuedAt; ///< When this command was queued, 0 if the query is not traced.
+    ResultFlowControl::Credit::Ptr _credit; ///< nullptr without flow control
 };
 
 
@@ -178,7 +202,14 @@ private:
 QueryRequest::QueryRequest(JobQuery::Ptr const& jobQuery) :
   _jobQuery(jobQuery),
   _jobIdStr(jobQuery->getIdStr()),
-  _qdispPool(_jobQuery->getQdispPool()){
+  _qdispPool(_jobQuery->getQdispPool()),
+  _trace(jobQuery->getTrace()),
+  _jobId(jobQuery->getIdInt()),
+  _chunkId(jobQuery->getChunkId()) {
+    if (_trace != nullptr) {
+        // The request is handed to XrdSsi right after construction.
+        _requestStart = QueryTrace::now();
+    }
     LOGS(_log, LOG_LVL_DEBUG, _jobIdStr <<" New QueryRequest");
 }
 
@@ -216,6 +247,10 @@ char* QueryRequest::GetRequest(int& requestLength) {
 //
 bool QueryRequest::ProcessResponse(XrdSsiErrInfo  const& eInfo, XrdSsiRespInfo const& rInfo) {
     LOGS(_log, LOG_LVL_DEBUG, _jobIdStr << "workerName=" << GetEndPoint() << " ProcessResponse");
+    if (_trace != nullptr) {
+        // From sending the request until the worker starts responding.
+        _trace->addSince(_jobId, _chunkId, "request", _requestStart);
+    }
     std::string errorDesc = _jobIdStr + " ";
     if (isQueryCancelled()) {
         LOGS(_log, LOG_LVL_WARN, _jobIdStr << " QueryRequest::ProcessResponse job already cancelled");
@@ -288,31 +323,31 @@ bool QueryRequest::_importStream(JobQuery::Ptr const& jq) {
 void QueryRequest::_queueAskForResponse(AskForResponseDataCmd::Ptr const& cmd, JobQuery::Ptr const& jq) {
     // ScanInfo::Rating { FASTEST = 0, FAST = 10, MEDIUM = 20, SLOW = 30, SLOWEST = 100 };
 
+    int priority = 7;
     int rating = jq->getDescription()->getScanRating();
     if (jq->getDescription()->getScanInteractive()) {
-        _qdispPool->queCmd(cmd, 0);
+        priority = 0;
     } else if (rating <= proto::ScanInfo::Rating::FAST) {
-        if (_largeResult) {
-            _qdispPool->queCmd(cmd, 5);
-        } else {
-            _qdispPool->queCmd(cmd, 2);
-        }
+        priority = _largeResult ? 5 : 2;
     } else if (rating <= proto::ScanInfo::Rating::MEDIUM) {
-        if (_largeResult) {
-            _qdispPool->queCmd(cmd, 6);
-        } else {
-            _qdispPool->queCmd(cmd, 3);
-        }
+        priority = _largeResult ? 6 : 3;
     } else if (rating <= proto::ScanInfo::Rating::SLOW) {
-        if (not _largeResult) {
-            _qdispPool->queCmd(cmd, 4);
-        } else {
-            _qdispPool->queCmd(cmd, 7);
-        }
-    } else {
-        _qdispPool->queCmd(cmd, 7);
+        priority = _largeResult ? 7 : 4;
     }
 
+    auto flowControl = _qdispPool->getFlowControl();
+    if (flowControl == nullptr) {
+        _qdispPool->queCmd(cmd, priority);
+        return;
+    }
+    // The command is queued once the czar can take the buffer it asks for.
+    std::uint64_t const bytes = jq->getDescription()->respHandler()->nextBufferSize();
+    auto qdispPool = _qdispPool;
+    flowControl->request(jq->getQueryId(), bytes, _largeResult, _receivedBytes,
+        [qdispPool, cmd, priority](ResultFlowControl::Credit::Ptr credit) {
+            cmd->setCredit(std::move(credit));
+            qdispPool->queCmd(cmd, priority);
+        });
 }
 
 /// Process an incoming error.
@@ -406,6 +441,7 @@ void QueryRequest::_processData(JobQuery::Ptr const& jq, int blen, bool last) {
     }
 
     _askForResponseDataCmd.reset(); // No longer need it, and don't want our destructor calling _errorFinish().
+    if (blen > 0) _receivedBytes += blen;
     bool largeResult = false;
     bool flushOk = jq->getDescription()->respHandler()->flush(blen, last, largeResult);
     if (largeResult) {
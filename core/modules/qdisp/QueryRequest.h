@@ -24,6 +24,7 @@
 #define LSST_QSERV_QDISP_QUERYREQUEST_H
 
 // System headers
+#include <cstdint>
 #include <exception>
 #include <iostream>
 #include <memory>
@@ -171,7 +172,15 @@ private:
     std::atomic<bool> _finishedCalled{false};
 
     bool _largeResult{false}; ///< True if the worker flags this job as having a large result.
+    std::uint64_t _receivedBytes{0}; ///< Response bytes received, used by flow control.
     QdispPool::Ptr _qdispPool;
+
+    // Timeline of the user query, nullptr if the query is not traced.
+    QueryTrace::Ptr _trace;
+    int const _jobId;
+    int const _chunkId;
+    std::uint64_t _requestStart{0}; ///< When the request was handed to XrdSsi.
+
     std::shared_ptr<AskForResponseDataCmd> _askForResponseDataCmd;
 };
 
@@ -0,0 +1,131 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qdisp/QueryTrace.h"
+
+// System headers
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+// Qserv headers
+#include "proto/worker.pb.h"
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+
+std::string const QueryTrace::CZAR = "czar";
+
+std::uint64_t QueryTrace::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void QueryTrace::add(int jobId, int chunk, std::string const& source, std::string const& stage,
+                     std::uint64_t start, std::uint64_t duration) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto res = _index.emplace(Key(jobId, source, stage), _spans.size());
+    if (res.second) {
+        _spans.emplace_back(jobId, chunk, source, stage, start, duration);
+    } else {
+        auto& span = _spans[res.first->second];
+        span.start = std::min(span.start, start);
+        span.duration += duration;
+    }
+}
+
+void QueryTrace::addWorkerSpans(int jobId, int chunk, std::string const& worker,
+                                proto::Result const& result) {
+    for (auto const& span : result.tracespan()) {
+        add(jobId, chunk, worker, span.stage(), span.start(), span.duration());
+    }
+}
+
+std::vector<qmeta::QTraceSpan> QueryTrace::getSpans() const {
+    std::vector<qmeta::QTraceSpan> spans;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        spans = _spans;
+    }
+    std::stable_sort(spans.begin(), spans.end(),
+        [](qmeta::QTraceSpan const& a, qmeta::QTraceSpan const& b) {
+            return a.jobId < b.jobId || (a.jobId == b.jobId && a.start < b.start);
+        });
+    return spans;
+}
+
+std::vector<QueryTrace::StageTime> QueryTrace::getBreakdown() const {
+    auto const spans = getSpans();
+
+    // The job on the critical path is the one whose last span ends last.
+    int criticalJob = -1;
+    std::uint64_t latestEnd = 0;
+    for (auto const& span : spans) {
+        if (span.start + span.duration >= latestEnd) {
+            latestEnd = span.start + span.duration;
+            criticalJob = span.jobId;
+        }
+    }
+
+    // Stages in order of their first start on the timeline.
+    std::vector<std::pair<std::uint64_t, StageTime>> stages;
+    for (auto const& span : spans) {
+        auto itr = std::find_if(stages.begin(), stages.end(),
+            [&span](std::pair<std::uint64_t, StageTime> const& s) { return s.second.stage == span.stage; });
+        if (itr == stages.end()) {
+            StageTime st;
+            st.stage = span.stage;
+            stages.emplace_back(span.start, st);
+            itr = stages.end() - 1;
+        }
+        itr->first = std::min(itr->first, span.start);
+        itr->second.total += span.duration;
+        if (span.jobId == criticalJob) itr->second.critical += span.duration;
+    }
+    std::stable_sort(stages.begin(), stages.end(),
+        [](std::pair<std::uint64_t, StageTime> const& a, std::pair<std::uint64_t, StageTime> const& b) {
+            return a.first < b.first;
+        });
+    std::vector<StageTime> breakdown;
+    for (auto const& s : stages) breakdown.push_back(s.second);
+    return breakdown;
+}
+
+std::ostream& operator<<(std::ostream& os, std::vector<QueryTrace::StageTime> const& breakdown) {
+    auto const flags = os.flags();
+    auto const precision = os.precision();
+    bool first = true;
+    os << std::fixed << std::setprecision(3);
+    for (auto const& st : breakdown) {
+        if (!first) os << " ";
+        first = false;
+        os << st.stage << "=" << st.total / 1e6 << "/" << st.critical / 1e6;
+    }
+    os.flags(flags);
+    os.precision(precision);
+    return os;
+}
+
+}}} // namespace lsst::qserv::qdisp
@@ -0,0 +1,115 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QDISP_QUERYTRACE_H
+#define LSST_QSERV_QDISP_QUERYTRACE_H
+
+// System headers
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Qserv headers
+#include "qmeta/QTrace.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace proto {
+    class Result;
+}}} // End of forward declarations
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+
+/**
+ *  QueryTrace collects the timeline of a traced user query: time spent by
+ *  each job in each processing stage on the czar (dispatch, request, result
+ *  merging) and on workers (scheduling, memory locking, SQL, transmitting),
+ *  the latter being returned by workers in result messages.
+ *
+ *  Stages which repeat within a job, e.g. once per result message, are
+ *  summed up into a single span which starts when the stage was first
+ *  entered, so the number of spans is bounded by jobs times stages.
+ *  All methods are thread safe.
+ */
+class QueryTrace {
+public:
+    using Ptr = std::shared_ptr<QueryTrace>;
+
+    /// Source of spans recorded on the czar
+    static std::string const CZAR;
+
+    /// Time spent in a stage summed over all jobs and over the critical
+    /// path, which is the job finishing last.
+    struct StageTime {
+        std::string stage;
+        std::uint64_t total{0};    ///< microseconds, all jobs
+        std::uint64_t critical{0}; ///< microseconds, job on the critical path
+    };
+
+    /// @return current time in microseconds since the epoch
+    static std::uint64_t now();
+
+    QueryTrace() = default;
+    QueryTrace(QueryTrace const&) = delete;
+    QueryTrace& operator=(QueryTrace const&) = delete;
+
+    /// Add time spent by a job in a stage.
+    void add(int jobId, int chunk, std::string const& source, std::string const& stage,
+             std::uint64_t start, std::uint64_t duration);
+
+    /// Add time spent by a job in a stage on the czar, from start until now.
+    void addSince(int jobId, int chunk, std::string const& stage, std::uint64_t start) {
+        std::uint64_t const end = now();
+        add(jobId, chunk, CZAR, stage, start, end > start ? end - start : 0);
+    }
+
+    /// Add spans returned by a worker in a result message.
+    void addWorkerSpans(int jobId, int chunk, std::string const& worker, proto::Result const& result);
+
+    /// @return all spans ordered by job and start time
+    std::vector<qmeta::QTraceSpan> getSpans() const;
+
+    /// @return time spent per stage, in order of first appearance on the timeline
+    std::vector<StageTime> getBreakdown() const;
+
+private:
+    using Key = std::tuple<int, std::string, std::string>; ///< jobId, source, stage
+
+    mutable std::mutex _mtx; ///< protects _spans and _index
+    std::vector<qmeta::QTraceSpan> _spans;
+    std::map<Key, size_t> _index; ///< position of a span in _spans
+};
+
+/// Print stage breakdown as "stage=total/critical" in seconds
+std::ostream& operator<<(std::ostream& os, std::vector<QueryTrace::StageTime> const& breakdown);
+
+}}} // namespace lsst::qserv::qdisp
+
+#endif // LSST_QSERV_QDISP_QUERYTRACE_H
@@ -24,6 +24,7 @@
 #define LSST_QSERV_QDISP_RESPONSEHANDLER_H
 
 // System headers
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -86,6 +87,9 @@ public:
     /// Scrub the results from jobId-attempt from the result table.
     virtual void prepScrubResults(int jobId, int attempt) = 0;
 
+    /// @return the number of rows merged from the current attempt of the job.
+    virtual std::int64_t getMergedRows() const { return 0; }
+
     std::weak_ptr<JobQuery> getJobQuery() { return _jobQuery; }
 
 private:
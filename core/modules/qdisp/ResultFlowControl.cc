@@ -0,0 +1,191 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qdisp/ResultFlowControl.h"
+
+// System headers
+#include <algorithm>
+#include <vector>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qdisp.ResultFlowControl");
+
+/// Merge rate samples are taken over periods at least this long.
+std::chrono::seconds const ratePeriod(1);
+
+/// Weight of a new merge rate sample.
+double const rateWeight = 0.3;
+
+}
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+
+ResultFlowControl::Credit::~Credit() {
+    auto control = _control.lock();
+    if (control != nullptr) {
+        control->_release(_queryId, _bytes);
+    }
+}
+
+
+ResultFlowControl::ResultFlowControl(Config const& config)
+    : _config(config), _periodStart(Clock::now()) {
+}
+
+
+void ResultFlowControl::request(QueryId queryId, std::uint64_t bytes, bool largeResult,
+                                std::uint64_t receivedBytes, GrantFunc const& grant) {
+    std::vector<std::pair<Waiter, Credit::Ptr>> granted;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (_waiting.empty()) {
+            // Start measuring the merge rate of a backlog.
+            _periodStart = Clock::now();
+            _periodBytes = 0;
+        }
+        Key key(largeResult, ~receivedBytes, _sequence++);
+        _waiting.emplace(key, Waiter{queryId, bytes, grant});
+        _grantWaiting(granted);
+    }
+    for (auto& g : granted) {
+        g.first.grant(std::move(g.second));
+    }
+}
+
+
+void ResultFlowControl::_release(QueryId queryId, std::uint64_t bytes) {
+    std::vector<std::pair<Waiter, Credit::Ptr>> granted;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _inFlightBytes -= std::min(bytes, _inFlightBytes);
+        auto iter = _queryBytes.find(queryId);
+        if (iter != _queryBytes.end()) {
+            iter->second -= std::min(bytes, iter->second);
+            if (iter->second == 0) _queryBytes.erase(iter);
+        }
+        _updateRate(bytes);
+        _grantWaiting(granted);
+    }
+    // Grant functions may take a while, call them without the lock.
+    for (auto& g : granted) {
+        g.first.grant(std::move(g.second));
+    }
+}
+
+
+void ResultFlowControl::_grantWaiting(std::vector<std::pair<Waiter, Credit::Ptr>>& granted) {
+    for (auto iter = _waiting.begin(); iter != _waiting.end();) {
+        Waiter& waiter = iter->second;
+        if (not _fitsQuery(waiter.queryId, waiter.bytes)) {
+            // Other queries may still use the credit.
+            ++iter;
+            continue;
+        }
+        if (not _fitsCzar(waiter.bytes)) {
+            break;
+        }
+        _acquire(waiter.queryId, waiter.bytes);
+        Credit::Ptr credit(new Credit(shared_from_this(), waiter.queryId, waiter.bytes));
+        granted.emplace_back(std::move(waiter), std::move(credit));
+        iter = _waiting.erase(iter);
+    }
+}
+
+
+std::uint64_t ResultFlowControl::_limit() const {
+    if (_config.maxBytes == 0) return 0;
+    std::uint64_t limit = _config.maxBytes;
+    if (_config.targetMergeSeconds > 0 && _mergeBytesPerSec > 0) {
+        auto const measured = static_cast<std::uint64_t>(_mergeBytesPerSec * _config.targetMergeSeconds);
+        limit = std::min(limit, std::max(measured, _config.minBytes));
+    }
+    return limit;
+}
+
+
+bool ResultFlowControl::_fitsCzar(std::uint64_t bytes) const {
+    std::uint64_t const limit = _limit();
+    return limit == 0 || _inFlightBytes == 0 || _inFlightBytes + bytes <= limit;
+}
+
+
+bool ResultFlowControl::_fitsQuery(QueryId queryId, std::uint64_t bytes) const {
+    if (_config.maxQueryBytes == 0) return true;
+    auto iter = _queryBytes.find(queryId);
+    return iter == _queryBytes.end() || iter->second + bytes <= _config.maxQueryBytes;
+}
+
+
+void ResultFlowControl::_acquire(QueryId queryId, std::uint64_t bytes) {
+    _inFlightBytes += bytes;
+    _queryBytes[queryId] += bytes;
+}
+
+
+void ResultFlowControl::_updateRate(std::uint64_t bytes) {
+    if (_waiting.empty()) return;
+    _periodBytes += bytes;
+    auto const now = Clock::now();
+    if (now - _periodStart < ratePeriod) return;
+    double const seconds = std::chrono::duration<double>(now - _periodStart).count();
+    double const sample = _periodBytes / seconds;
+    _mergeBytesPerSec = (_mergeBytesPerSec == 0) ? sample
+                      : (1 - rateWeight) * _mergeBytesPerSec + rateWeight * sample;
+    _periodStart = now;
+    _periodBytes = 0;
+    LOGS(_log, LOG_LVL_DEBUG, "merge rate sample=" << sample << " B/s rate=" << _mergeBytesPerSec
+         << " B/s limit=" << _limit());
+}
+
+
+ResultFlowControl::Status ResultFlowControl::getStatus() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    Status status;
+    status.maxBytes = _config.maxBytes;
+    status.limitBytes = _limit();
+    status.inFlightBytes = _inFlightBytes;
+    status.waitingRequests = _waiting.size();
+    status.activeQueries = _queryBytes.size();
+    status.mergeBytesPerSec = _mergeBytesPerSec;
+    return status;
+}
+
+
+std::ostream& operator<<(std::ostream& os, ResultFlowControl::Status const& status) {
+    os << "ResultFlowControl(limitBytes=" << status.limitBytes
+       << " maxBytes=" << status.maxBytes
+       << " inFlightBytes=" << status.inFlightBytes
+       << " waitingRequests=" << status.waitingRequests
+       << " activeQueries=" << status.activeQueries
+       << " mergeBytesPerSec=" << status.mergeBytesPerSec << ")";
+    return os;
+}
+
+}}} // namespace lsst::qserv::qdisp
@@ -0,0 +1,186 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QDISP_RESULTFLOWCONTROL_H
+#define LSST_QSERV_QDISP_RESULTFLOWCONTROL_H
+
+// System headers
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Qserv headers
+#include "global/intTypes.h"
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+
+/**
+ *  ResultFlowControl bounds the result bytes the czar has asked workers for
+ *  and not yet merged. Before a job asks XrdSsi for the next response buffer
+ *  it requests credit for the size of that buffer; the credit is returned
+ *  when the buffer has been merged. Requests that don't fit wait, and
+ *  waiting requests are granted in order of:
+ *   - results not flagged as large first, they are usually done with the
+ *     next buffer,
+ *   - then jobs which already received the most bytes. The remaining size
+ *     of a result isn't known, this finishes started results first and frees
+ *     their buffers.
+ *
+ *  Limits apply czar-wide and per user query. The czar-wide limit is also
+ *  lowered to what the mergers are measured to merge in targetMergeSeconds,
+ *  so results are pulled at the rate they can be merged. A request is always
+ *  granted when nothing is in flight (or nothing for its query, for the query
+ *  limit), so that buffers larger than a limit still make progress.
+ *
+ *  A zero limit means unlimited.
+ */
+class ResultFlowControl : public std::enable_shared_from_this<ResultFlowControl> {
+public:
+    typedef std::shared_ptr<ResultFlowControl> Ptr;
+
+    struct Config {
+        std::uint64_t maxBytes{0};          ///< czar-wide limit of bytes in flight
+        std::uint64_t maxQueryBytes{0};     ///< limit of bytes in flight per user query
+        double targetMergeSeconds{0};       ///< merge backlog allowed in flight, 0 to disable
+        std::uint64_t minBytes{32*1048576ULL}; ///< the measured limit is never below this
+    };
+
+    /// Credit holds bytes of the flow control until it's destroyed.
+    class Credit {
+    public:
+        typedef std::unique_ptr<Credit> Ptr;
+
+        Credit(Credit const&) = delete;
+        Credit& operator=(Credit const&) = delete;
+
+        ~Credit();
+
+    private:
+        friend class ResultFlowControl;
+        Credit(std::shared_ptr<ResultFlowControl> const& control, QueryId queryId, std::uint64_t bytes)
+            : _control(control), _queryId(queryId), _bytes(bytes) {}
+
+        std::weak_ptr<ResultFlowControl> _control;
+        QueryId const _queryId;
+        std::uint64_t const _bytes;
+    };
+
+    /// Called with the credit once a request is granted.
+    typedef std::function<void(Credit::Ptr)> GrantFunc;
+
+    /// Current state of the flow control
+    struct Status {
+        std::uint64_t maxBytes{0};      ///< configured czar-wide limit
+        std::uint64_t limitBytes{0};    ///< limit in effect, 0 if unlimited
+        std::uint64_t inFlightBytes{0};
+        int waitingRequests{0};
+        int activeQueries{0};           ///< queries with bytes in flight
+        double mergeBytesPerSec{0};     ///< measured merge rate, 0 if not known yet
+    };
+
+    static Ptr create(Config const& config) { return Ptr(new ResultFlowControl(config)); }
+
+    ResultFlowControl(ResultFlowControl const&) = delete;
+    ResultFlowControl& operator=(ResultFlowControl const&) = delete;
+
+    /**
+     *  Request credit for a response buffer. 'grant' is called with the
+     *  credit, from this call if the request fits, or later from the thread
+     *  returning credit.
+     *
+     *  @param queryId:       User query the job belongs to.
+     *  @param bytes:         Size of the buffer.
+     *  @param largeResult:   True if the worker flagged the result as large.
+     *  @param receivedBytes: Bytes of the result the job received so far.
+     *  @param grant:         Function taking the credit.
+     */
+    void request(QueryId queryId, std::uint64_t bytes, bool largeResult,
+                 std::uint64_t receivedBytes, GrantFunc const& grant);
+
+    Config const& getConfig() const { return _config; }
+
+    Status getStatus() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /// Waiting requests are ordered by this key, see class description.
+    typedef std::tuple<bool, std::uint64_t, std::uint64_t> Key; // largeResult, ~receivedBytes, sequence
+
+    struct Waiter {
+        QueryId queryId;
+        std::uint64_t bytes;
+        GrantFunc grant;
+    };
+
+    explicit ResultFlowControl(Config const& config);
+
+    /// @return the czar-wide limit in effect, _mtx must be locked
+    std::uint64_t _limit() const;
+
+    /// @return true if the request fits the czar-wide limit, _mtx must be locked
+    bool _fitsCzar(std::uint64_t bytes) const;
+
+    /// @return true if the request fits the limit of its query, _mtx must be locked
+    bool _fitsQuery(QueryId queryId, std::uint64_t bytes) const;
+
+    /// Charge the limits, _mtx must be locked
+    void _acquire(QueryId queryId, std::uint64_t bytes);
+
+    /// Return credit, update the merge rate and grant waiting requests
+    void _release(QueryId queryId, std::uint64_t bytes);
+
+    /// Charge and remove waiting requests which fit, _mtx must be locked
+    void _grantWaiting(std::vector<std::pair<Waiter, Credit::Ptr>>& granted);
+
+    /// Update the merge rate after 'bytes' were merged, _mtx must be locked
+    void _updateRate(std::uint64_t bytes);
+
+    Config const _config;
+
+    mutable std::mutex _mtx;        ///< protects all members below
+    std::map<Key, Waiter> _waiting;
+    std::uint64_t _sequence{0};
+    std::uint64_t _inFlightBytes{0};
+    std::map<QueryId, std::uint64_t> _queryBytes; ///< bytes in flight per query
+
+    // Merge rate is measured over periods in which requests were waiting,
+    // the merge rate of an idle czar says nothing about its capacity.
+    Clock::time_point _periodStart;
+    std::uint64_t _periodBytes{0};
+    double _mergeBytesPerSec{0};
+};
+
+std::ostream& operator<<(std::ostream& os, ResultFlowControl::Status const& status);
+
+}}} // namespace lsst::qserv::qdisp
+
+#endif // LSST_QSERV_QDISP_RESULTFLOWCONTROL_H
@@ -24,6 +24,7 @@
  */
 
 // System headers
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <errno.h>
@@ -32,6 +33,7 @@
 #include <stdlib.h>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 // Third party headers
 #include "XrdSsi/XrdSsiErrInfo.hh"
@@ -66,7 +68,82 @@ std::atomic<int> totCount(0);
 bool _aOK = true;
 
 enum RespType {RESP_BADREQ, RESP_DATA, RESP_ERROR, RESP_ERRNR,
-               RESP_STREAM, RESP_STRERR};
+               RESP_STREAM, RESP_STRERR, RESP_RESULT};
+
+std::mutex _specMtx;
+lsst::qserv::qdisp::XrdSsiServiceMock::ResultSpec _resultSpec;
+
+/// Append a header and the serialized Result to the stream, the way
+/// wdb::QueryRunner transmits them.
+void appendResult(std::string& stream, lsst::qserv::proto::Result& result,
+                  bool last, bool largeResult, unsigned int rowCount, size_t tSize) {
+    result.set_continues(!last);
+    result.set_largeresult(largeResult);
+    result.set_rowcount(rowCount);
+    result.set_transmitsize(tSize);
+    std::string resultString;
+    result.SerializeToString(&resultString);
+
+    lsst::qserv::proto::ProtoHeader header;
+    header.set_protocol(2);
+    header.set_size(resultString.size());
+    header.set_md5(lsst::qserv::util::StringHash::getMd5(resultString.data(), resultString.size()));
+    header.set_wname("localhost");
+    header.set_largeresult(largeResult);
+    std::string headerString;
+    header.SerializeToString(&headerString);
+
+    stream += lsst::qserv::proto::ProtoHeaderWrap::wrap(headerString);
+    stream += resultString;
+}
+
+/// @return the complete response stream of a job for the current ResultSpec.
+std::string makeResultStream(int jobId) {
+    using namespace lsst::qserv;
+    qdisp::XrdSsiServiceMock::ResultSpec const spec = qdisp::XrdSsiServiceMock::getResultSpec();
+    std::vector<std::string> const sqlTypes = qdisp::XrdSsiServiceMock::getResultSqlTypes();
+    size_t const szLimit = std::min(proto::ProtoHeaderWrap::PROTOBUFFER_DESIRED_LIMIT,
+                                    proto::ProtoHeaderWrap::PROTOBUFFER_HARD_LIMIT);
+    std::string const text(spec.columnWidth, 'x');
+
+    auto newResult = [jobId](proto::Result& result) {
+        result.Clear();
+        result.mutable_rowschema();
+        result.set_queryid(0);
+        result.set_jobid(jobId);
+        result.set_attemptcount(0);
+    };
+    std::string stream;
+    proto::Result result;
+    newResult(result);
+    for (unsigned int i = 0; i < sqlTypes.size(); ++i) {
+        proto::ColumnSchema* cs = result.mutable_rowschema()->add_columnschema();
+        cs->set_name("c" + std::to_string(i));
+        cs->set_deprecated_hasdefault(false);
+        cs->set_sqltype(sqlTypes[i]);
+    }
+    bool largeResult = false;
+    unsigned int rowCount = 0;
+    size_t tSize = 0;
+    for (unsigned int j = 0; j < spec.rows; ++j) {
+        proto::RowBundle* row = result.add_row();
+        for (unsigned int i = 0; i < sqlTypes.size(); ++i) {
+            row->add_column(i == 0 ? std::to_string(j) : text);
+            row->add_isnull(false);
+        }
+        tSize += row->ByteSize();
+        ++rowCount;
+        if (tSize > szLimit) {
+            appendResult(stream, result, false, largeResult, rowCount, tSize);
+            newResult(result);
+            largeResult = true;
+            rowCount = 0;
+            tSize = 0;
+        }
+    }
+    appendResult(stream, result, true, largeResult, rowCount, tSize);
+    return stream;
+}
 
 class Agent : public XrdSsiResponder, public XrdSsiStream {
 public:
@@ -114,6 +191,13 @@ public:
                   _reqP->doNotRetry();  // Kill retries on stream errors
                   _ReplyStream();
                   break;
+             case RESP_RESULT:
+                  _msgBuf = makeResultStream(_jobId);
+                  _bOff = 0;
+                  _bLen = _msgBuf.size();
+                  _noData = false;
+                  _ReplyStream();
+                  break;
              default:
                   _reqP->doNotRetry();
                   _ReplyError("Bad mock request!", 13);
@@ -133,9 +217,9 @@ public:
     }
 
     Agent(lsst::qserv::qdisp::QueryRequest* rP,
-          std::string const& rname, int rnum) :
+          std::string const& rname, int rnum, int jobId=0) :
          XrdSsiStream(XrdSsiStream::isPassive),
-         _reqP(rP), _rName(rname), _rNum(rnum), _noData(true),
+         _reqP(rP), _rName(rname), _rNum(rnum), _jobId(jobId), _noData(true),
          _isFIN(false), _active(true) {
 
         // Initialize a null message we will return as a response
@@ -182,8 +266,8 @@ private:
     void _ReplyStream() {SetResponse(this);}
 
     void _StrmResp(XrdSsiErrInfo* eP, char* buff, int blen) {
-        std::cerr<<"Stream: cleint asks for " <<blen <<" bytes, have "
-                 <<_bLen <<'\n' <<std::flush;
+        LOGS(_log, LOG_LVL_DEBUG, "Stream: client asks for " << blen
+                                  << " bytes, have " << _bLen);
         bool last;
 
         // Check for cancellation while we were waiting
@@ -219,6 +303,7 @@ private:
     int         _bOff;
     int         _bLen;
     int         _rNum;
+    int         _jobId;
     bool        _noData;
     bool        _isFIN;
     bool        _active;
@@ -249,6 +334,25 @@ void XrdSsiServiceMock::Reset() {
 
 void XrdSsiServiceMock::setGo(bool go) {_go.exchangeNotify(go);}
 
+void XrdSsiServiceMock::setResultSpec(ResultSpec const& spec) {
+    std::lock_guard<std::mutex> lock(_specMtx);
+    _resultSpec = spec;
+}
+
+XrdSsiServiceMock::ResultSpec XrdSsiServiceMock::getResultSpec() {
+    std::lock_guard<std::mutex> lock(_specMtx);
+    return _resultSpec;
+}
+
+std::vector<std::string> XrdSsiServiceMock::getResultSqlTypes() {
+    ResultSpec const spec = getResultSpec();
+    std::vector<std::string> sqlTypes;
+    for (unsigned int i = 0; i < spec.columns; ++i) {
+        sqlTypes.push_back(i == 0 ? "BIGINT" : "CHAR(" + std::to_string(spec.columnWidth) + ")");
+    }
+    return sqlTypes;
+}
+
 void XrdSsiServiceMock::ProcessRequest(XrdSsiRequest  &reqRef,
                                        XrdSsiResource &resRef) {
     static struct {const char *cmd; RespType rType;} reqTab[] = {
@@ -257,6 +361,7 @@ void XrdSsiServiceMock::ProcessRequest(XrdSsiRequest  &reqRef,
            {"resperrnr",  RESP_ERRNR},
            {"respstream", RESP_STREAM},
            {"respstrerr", RESP_STRERR},
+           {"respresult", RESP_RESULT},
            {0, RESP_BADREQ}
     };
 
@@ -274,19 +379,26 @@ void XrdSsiServiceMock::ProcessRequest(XrdSsiRequest  &reqRef,
     //
     QueryRequest * r = dynamic_cast<QueryRequest *>(&reqRef);
     if (r) {
-        Agent* aP = new Agent(r, resRef.rName, reqNum);
-        RespType doResp;
-        aP->BindRequest(reqRef);
-
         // Get the request data and setup to handle request. Make sure the
-        // request string is null terminated (it should be).
+        // request string is null terminated (it should be). A request may
+        // carry the job id after a blank, e.g. "respresult 12".
         //
         std::string reqStr;
         int reqLen;
         const char *reqData = r->GetRequest(reqLen);
         if (reqData != nullptr) reqStr.assign(reqData, reqLen);
+        int jobId = 0;
+        auto const blank = reqStr.find(' ');
+        if (blank != std::string::npos) {
+            jobId = atoi(reqStr.c_str() + blank + 1);
+            reqStr.erase(blank);
+        }
         reqData = reqStr.c_str();
 
+        Agent* aP = new Agent(r, resRef.rName, reqNum, jobId);
+        RespType doResp;
+        aP->BindRequest(reqRef);
+
         // Convert request to response type
         //
         int i = 0;
@@ -26,6 +26,10 @@
 #ifndef LSST_QSERV_QDISP_XRDSSIMOCKS_H
 #define LSST_QSERV_QDISP_XRDSSIMOCKS_H
 
+// System headers
+#include <string>
+#include <vector>
+
 // External headers
 #include "XrdSsi/XrdSsiRequest.hh"
 #include "XrdSsi/XrdSsiResource.hh"
@@ -44,6 +48,14 @@ class Executive;
 class XrdSsiServiceMock : public XrdSsiService
 {
 public:
+    /// Shape of the result streams returned for "respresult" requests. The
+    /// rows are split into Result messages the same way workers split them.
+    struct ResultSpec {
+        unsigned int rows = 1000;       ///< rows per job
+        unsigned int columns = 4;       ///< columns per row, the first one is a BIGINT
+        unsigned int columnWidth = 16;  ///< bytes per CHAR column
+    };
+
     void ProcessRequest(XrdSsiRequest &reqRef, XrdSsiResource &resRef) override;
 
     XrdSsiServiceMock(Executive *executive) {};
@@ -66,6 +78,13 @@ public:
 
     static void setRName(std::string const& rname) {_myRName = rname;}
 
+    static void setResultSpec(ResultSpec const& spec);
+
+    static ResultSpec getResultSpec();
+
+    /// @return the SQL types of the columns of the generated results.
+    static std::vector<std::string> getResultSqlTypes();
+
 private:
     static std::string _myRName;
 };
@@ -0,0 +1,94 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/**
+  * @file
+  *
+  * @brief Test QueryTrace.
+  */
+
+// System headers
+#include <sstream>
+#include <string>
+
+// Qserv headers
+#include "proto/worker.pb.h"
+#include "qdisp/QueryTrace.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE QueryTrace
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::qdisp::QueryTrace;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Spans) {
+    QueryTrace trace;
+    trace.add(1, 20, QueryTrace::CZAR, "request", 1000, 500);
+    trace.add(0, 10, QueryTrace::CZAR, "request", 1000, 300);
+    // Repeated stages of a job are summed up
+    trace.add(1, 20, QueryTrace::CZAR, "merge", 1600, 10);
+    trace.add(1, 20, QueryTrace::CZAR, "merge", 1500, 20);
+
+    lsst::qserv::proto::Result result;
+    auto span = result.add_tracespan();
+    span->set_stage("sql");
+    span->set_start(1100);
+    span->set_duration(200);
+    trace.addWorkerSpans(1, 20, "worker-1", result);
+
+    auto const spans = trace.getSpans();
+    BOOST_REQUIRE_EQUAL(spans.size(), 4U);
+    BOOST_CHECK_EQUAL(spans[0].jobId, 0);
+    BOOST_CHECK_EQUAL(spans[1].stage, "request");
+    BOOST_CHECK_EQUAL(spans[2].source, "worker-1");
+    BOOST_CHECK_EQUAL(spans[2].chunk, 20);
+    BOOST_CHECK_EQUAL(spans[3].stage, "merge");
+    BOOST_CHECK_EQUAL(spans[3].start, 1500U);
+    BOOST_CHECK_EQUAL(spans[3].duration, 30U);
+}
+
+BOOST_AUTO_TEST_CASE(Breakdown) {
+    QueryTrace trace;
+    trace.add(0, 10, QueryTrace::CZAR, "request", 1000, 300);
+    trace.add(0, 10, QueryTrace::CZAR, "merge", 1300, 100);
+    trace.add(1, 20, QueryTrace::CZAR, "request", 1000, 2000000);
+    trace.add(1, 20, QueryTrace::CZAR, "merge", 2001000, 500000);
+
+    auto const breakdown = trace.getBreakdown();
+    BOOST_REQUIRE_EQUAL(breakdown.size(), 2U);
+    BOOST_CHECK_EQUAL(breakdown[0].stage, "request");
+    BOOST_CHECK_EQUAL(breakdown[0].total, 2000300U);
+    // Job 1 finishes last, it is on the critical path
+    BOOST_CHECK_EQUAL(breakdown[0].critical, 2000000U);
+    BOOST_CHECK_EQUAL(breakdown[1].critical, 500000U);
+
+    std::ostringstream os;
+    os << breakdown;
+    BOOST_CHECK_EQUAL(os.str(), "request=2.000/2.000 merge=0.500/0.500");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+ /**
+  * @file
+  *
+  * @brief Test ResultFlowControl.
+  */
+
+// System headers
+#include <map>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "qdisp/ResultFlowControl.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE ResultFlowControl
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::qdisp::ResultFlowControl;
+
+namespace {
+
+/// Collects the credits of granted requests by name, in the order of granting.
+struct Grants {
+    ResultFlowControl::GrantFunc make(std::string const& name) {
+        return [this, name](ResultFlowControl::Credit::Ptr credit) {
+            order.push_back(name);
+            credits[name] = std::move(credit);
+        };
+    }
+    bool has(std::string const& name) const { return credits.count(name) != 0; }
+    void release(std::string const& name) {
+        // Returning credit may grant other requests, which are added to 'credits'.
+        auto credit = std::move(credits[name]);
+        credits.erase(name);
+        credit.reset();
+    }
+
+    std::vector<std::string> order;
+    std::map<std::string, ResultFlowControl::Credit::Ptr> credits;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(CzarLimit) {
+    ResultFlowControl::Config config;
+    config.maxBytes = 100;
+    auto flow = ResultFlowControl::create(config);
+    Grants grants;
+
+    flow->request(1, 60, false, 0, grants.make("a"));
+    flow->request(2, 60, false, 0, grants.make("b"));
+    BOOST_CHECK(grants.has("a"));
+    BOOST_CHECK(not grants.has("b"));
+    auto status = flow->getStatus();
+    BOOST_CHECK_EQUAL(status.inFlightBytes, 60U);
+    BOOST_CHECK_EQUAL(status.waitingRequests, 1);
+    BOOST_CHECK_EQUAL(status.activeQueries, 1);
+
+    grants.release("a");
+    BOOST_CHECK(grants.has("b"));
+    grants.release("b");
+    BOOST_CHECK_EQUAL(flow->getStatus().inFlightBytes, 0U);
+
+    // A buffer larger than the limit is granted when nothing is in flight.
+    flow->request(1, 500, false, 0, grants.make("c"));
+    BOOST_CHECK(grants.has("c"));
+}
+
+BOOST_AUTO_TEST_CASE(QueryLimit) {
+    ResultFlowControl::Config config;
+    config.maxBytes = 1000;
+    config.maxQueryBytes = 100;
+    auto flow = ResultFlowControl::create(config);
+    Grants grants;
+
+    flow->request(1, 80, false, 0, grants.make("a"));
+    flow->request(1, 80, false, 0, grants.make("b"));
+    // The waiting request of query 1 doesn't hold up query 2.
+    flow->request(2, 80, false, 0, grants.make("c"));
+    BOOST_CHECK(grants.has("a"));
+    BOOST_CHECK(not grants.has("b"));
+    BOOST_CHECK(grants.has("c"));
+    BOOST_CHECK_EQUAL(flow->getStatus().activeQueries, 2);
+
+    grants.release("a");
+    BOOST_CHECK(grants.has("b"));
+}
+
+BOOST_AUTO_TEST_CASE(Priority) {
+    ResultFlowControl::Config config;
+    config.maxBytes = 10;
+    auto flow = ResultFlowControl::create(config);
+    Grants grants;
+
+    flow->request(1, 10, false, 0, grants.make("first"));
+    flow->request(2, 10, true, 100, grants.make("largeLittle"));
+    flow->request(3, 10, true, 5000, grants.make("largeMuch"));
+    flow->request(4, 10, false, 0, grants.make("small"));
+    BOOST_CHECK_EQUAL(flow->getStatus().waitingRequests, 3);
+
+    std::vector<std::string> const expected = {"first", "small", "largeMuch", "largeLittle"};
+    for (auto const& name : expected) {
+        grants.release(name);
+    }
+    BOOST_CHECK_EQUAL_COLLECTIONS(grants.order.begin(), grants.order.end(),
+                                  expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL(flow->getStatus().waitingRequests, 0);
+}
+
+BOOST_AUTO_TEST_CASE(Unlimited) {
+    auto flow = ResultFlowControl::create(ResultFlowControl::Config());
+    Grants grants;
+    for (int i = 0; i < 10; ++i) {
+        flow->request(i % 2, 1000000, true, 0, grants.make(std::to_string(i)));
+    }
+    BOOST_CHECK_EQUAL(grants.credits.size(), 10U);
+    BOOST_CHECK_EQUAL(flow->getStatus().limitBytes, 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
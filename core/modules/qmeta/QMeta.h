@@ -23,6 +23,7 @@
 #define LSST_QSERV_QMETA_QMETA_H
 
 // System headers
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -32,6 +33,7 @@
 // Qserv headers
 #include "qmeta/QInfo.h"
 #include "qmeta/QStats.h"
+#include "qmeta/QTrace.h"
 #include "qmeta/types.h"
 
 
@@ -273,6 +275,51 @@ public:
     virtual std::vector<QueryId> getQueriesForTable(std::string const& dbName,
                                                     std::string const& tableName) = 0;
 
+    /**
+     *  @brief Save size of the query result.
+     *
+     *  This should be called when all data is merged into the result table,
+     *  the size is used later to estimate result size of similar queries.
+     *  This method will throw if query ID is not known.
+     *
+     *  @param queryId:     Query ID, non-negative number.
+     *  @param resultBytes: Size of the data merged into the result table.
+     */
+    virtual void saveResultSize(QueryId queryId, std::uint64_t resultBytes) = 0;
+
+    /**
+     *  @brief Estimate result size of a query.
+     *
+     *  The estimate is the average result size of the most recent queries
+     *  which had the same query template.
+     *
+     *  @param qTemplate:   Query template, same as QInfo::queryTemplate().
+     *  @param maxHistory:  Maximum number of recent queries to consider.
+     *  @return: Estimated result size in bytes, negative if there is no history.
+     */
+    virtual std::int64_t getResultSizeEstimate(std::string const& qTemplate,
+                                               unsigned maxHistory=10) = 0;
+
+    /**
+     *  @brief Save processing timeline of a traced query.
+     *
+     *  Spans are appended to the spans already saved for the query.
+     *  This method will throw if query ID is not known.
+     *
+     *  @param queryId:  Query ID, non-negative number.
+     *  @param spans:    Time spent by query jobs in processing stages.
+     */
+    virtual void saveTrace(QueryId queryId, std::vector<QTraceSpan> const& spans) = 0;
+
+    /**
+     *  @brief Get processing timeline of a traced query.
+     *
+     *  @param queryId:  Query ID, non-negative number.
+     *  @return: Spans ordered by job ID and start time, empty if the query
+     *           was not traced.
+     */
+    virtual std::vector<QTraceSpan> getTrace(QueryId queryId) = 0;
+
 protected:
 
     // Default constructor
@@ -42,7 +42,7 @@
 namespace {
 
 // Current version of QMeta schema
-char const VERSION_STR[] = "2";
+char const VERSION_STR[] = "4";
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.qmeta.QMetaMysql");
 
@@ -286,7 +286,7 @@ QMetaMysql::registerQuery(QInfo const& qInfo,
         proxyOrderBy = "'" + _conn.escapeString(qInfo.proxyOrderBy()) + "'";
     }
     std::string query = "INSERT INTO QInfo (qType, czarId, user, query, qTemplate, qMerge, "
-                        "proxyOrderBy, status, messageTable, resultLocation) VALUES (";
+                        "proxyOrderBy, status, messageTable, resultLocation, qTemplateHash) VALUES (";
     query += qType;
     query += ", ";
     query += boost::lexical_cast<std::string>(qInfo.czarId());
@@ -304,7 +304,9 @@ QMetaMysql::registerQuery(QInfo const& qInfo,
     query += msgTableName;
     query += ", ";
     query += resultLocation;
-    query += ")";
+    query += ", UNHEX(MD5(";
+    query += queryTemplate;
+    query += ")))";
 
     // run query
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
@@ -769,6 +771,167 @@ QMetaMysql::getQueriesForTable(std::string const& dbName,
     return result;
 }
 
+// Save size of the query result.
+void
+QMetaMysql::saveResultSize(QueryId queryId, std::uint64_t resultBytes) {
+
+    std::lock_guard<std::mutex> sync(_dbMutex);
+
+    QMetaTransaction trans(_conn);
+
+    std::string query = "UPDATE QInfo SET resultBytes = ";
+    query += boost::lexical_cast<std::string>(resultBytes);
+    query += " WHERE queryId = ";
+    query += boost::lexical_cast<std::string>(queryId);
+
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    sql::SqlErrorObject errObj;
+    sql::SqlResults results;
+    if (not _conn.runQuery(query, results, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+
+    // check number of rows updated, expect exactly one
+    if (results.getAffectedRows() == 0) {
+        throw QueryIdError(ERR_LOC, queryId);
+    } else if (results.getAffectedRows() > 1) {
+        throw ConsistencyError(ERR_LOC, "More than one row updated for query ID " +
+                               boost::lexical_cast<std::string>(queryId) + ": " +
+                               boost::lexical_cast<std::string>(results.getAffectedRows()));
+    }
+
+    trans.commit();
+}
+
+// Estimate result size of a query.
+std::int64_t
+QMetaMysql::getResultSizeEstimate(std::string const& qTemplate, unsigned maxHistory) {
+
+    std::lock_guard<std::mutex> sync(_dbMutex);
+
+    QMetaTransaction trans(_conn);
+
+    // the hash column is indexed, comparing templates themselves is only
+    // needed to protect against hash collisions
+    std::string const queryTemplate = "'" + _conn.escapeString(qTemplate) + "'";
+    std::string query = "SELECT AVG(resultBytes) FROM (SELECT resultBytes FROM QInfo"
+                        " WHERE qTemplateHash = UNHEX(MD5(";
+    query += queryTemplate;
+    query += ")) AND qTemplate = ";
+    query += queryTemplate;
+    query += " AND resultBytes IS NOT NULL ORDER BY queryId DESC LIMIT ";
+    query += boost::lexical_cast<std::string>(maxHistory);
+    query += ") AS history";
+
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    sql::SqlErrorObject errObj;
+    sql::SqlResults results;
+    if (not _conn.runQuery(query, results, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+
+    // AVG() always returns one row, value is NULL if there is no history
+    std::int64_t estimate = -1;
+    sql::SqlResults::iterator rowIter = results.begin();
+    if (rowIter != results.end()) {
+        sql::SqlResults::value_type const& row = *rowIter;
+        if (row[0].first) {
+            estimate = static_cast<std::int64_t>(boost::lexical_cast<double>(row[0].first));
+        }
+    }
+
+    trans.commit();
+
+    return estimate;
+}
+
+// Save processing timeline of a traced query.
+void
+QMetaMysql::saveTrace(QueryId queryId, std::vector<QTraceSpan> const& spans) {
+
+    std::lock_guard<std::mutex> sync(_dbMutex);
+
+    QMetaTransaction trans(_conn);
+
+    // check that query ID is known, foreign key would only give a generic error
+    sql::SqlErrorObject errObj;
+    sql::SqlResults results;
+    std::string query = "SELECT queryId FROM QInfo WHERE queryId = ";
+    query += boost::lexical_cast<std::string>(queryId);
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    if (not _conn.runQuery(query, results, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+    if (results.begin() == results.end()) {
+        throw QueryIdError(ERR_LOC, queryId);
+    }
+
+    // insert spans in batches, a traced full-sky query has a span per stage
+    // for every chunk, one statement per span would take minutes
+    unsigned const batchSize = 1000;
+    std::string const qid = boost::lexical_cast<std::string>(queryId);
+    for (size_t first = 0; first < spans.size(); first += batchSize) {
+        query = "INSERT INTO QTrace (queryId, jobId, chunk, source, stage, start, duration) VALUES ";
+        size_t const last = std::min(spans.size(), first + batchSize);
+        for (size_t i = first; i != last; ++i) {
+            auto const& span = spans[i];
+            if (i != first) query += ", ";
+            query += "(" + qid;
+            query += ", " + boost::lexical_cast<std::string>(span.jobId);
+            query += ", " + boost::lexical_cast<std::string>(span.chunk);
+            query += ", '" + _conn.escapeString(span.source) + "'";
+            query += ", '" + _conn.escapeString(span.stage) + "'";
+            query += ", " + boost::lexical_cast<std::string>(span.start);
+            query += ", " + boost::lexical_cast<std::string>(span.duration);
+            query += ")";
+        }
+        LOGS(_log, LOG_LVL_DEBUG, "Inserting " << (last - first) << " trace spans for query " << queryId);
+        if (not _conn.runQuery(query, errObj)) {
+            LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query.substr(0, 200));
+            throw SqlError(ERR_LOC, errObj);
+        }
+    }
+
+    trans.commit();
+}
+
+// Get processing timeline of a traced query.
+std::vector<QTraceSpan>
+QMetaMysql::getTrace(QueryId queryId) {
+
+    std::lock_guard<std::mutex> sync(_dbMutex);
+
+    QMetaTransaction trans(_conn);
+
+    sql::SqlErrorObject errObj;
+    sql::SqlResults results;
+    std::string query = "SELECT jobId, chunk, source, stage, start, duration FROM QTrace"
+                        " WHERE queryId = ";
+    query += boost::lexical_cast<std::string>(queryId);
+    query += " ORDER BY jobId, start";
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    if (not _conn.runQuery(query, results, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+
+    std::vector<QTraceSpan> spans;
+    for (auto const& row: results) {
+        spans.emplace_back(boost::lexical_cast<int>(row[0].first),
+                           boost::lexical_cast<int>(row[1].first),
+                           row[2].first, row[3].first,
+                           boost::lexical_cast<std::uint64_t>(row[4].first),
+                           boost::lexical_cast<std::uint64_t>(row[5].first));
+    }
+
+    trans.commit();
+
+    return spans;
+}
+
 // Check that all necessary tables exist or create them
 void
 QMetaMysql::_checkDb() {
@@ -784,7 +947,7 @@ QMetaMysql::_checkDb() {
     }
 
     // check that all tables are there
-    char const* requiredTables[] = {"QCzar", "QInfo", "QTable", "QWorker", "QMetadata", "QStatsTmp"};
+    char const* requiredTables[] = {"QCzar", "QInfo", "QTable", "QWorker", "QMetadata", "QStatsTmp", "QTrace"};
     int const nTables = sizeof requiredTables / sizeof requiredTables[0];
     for (int i = 0; i != nTables; ++ i) {
         char const* const table = requiredTables[i];
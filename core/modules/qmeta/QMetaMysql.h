@@ -248,6 +248,51 @@ public:
     virtual std::vector<QueryId> getQueriesForTable(std::string const& dbName,
                                                     std::string const& tableName) override;
 
+    /**
+     *  @brief Save size of the query result.
+     *
+     *  This should be called when all data is merged into the result table,
+     *  the size is used later to estimate result size of similar queries.
+     *  This method will throw if query ID is not known.
+     *
+     *  @param queryId:     Query ID, non-negative number.
+     *  @param resultBytes: Size of the data merged into the result table.
+     */
+    void saveResultSize(QueryId queryId, std::uint64_t resultBytes) override;
+
+    /**
+     *  @brief Estimate result size of a query.
+     *
+     *  The estimate is the average result size of the most recent queries
+     *  which had the same query template.
+     *
+     *  @param qTemplate:   Query template, same as QInfo::queryTemplate().
+     *  @param maxHistory:  Maximum number of recent queries to consider.
+     *  @return: Estimated result size in bytes, negative if there is no history.
+     */
+    std::int64_t getResultSizeEstimate(std::string const& qTemplate,
+                                       unsigned maxHistory=10) override;
+
+    /**
+     *  @brief Save processing timeline of a traced query.
+     *
+     *  Spans are appended to the spans already saved for the query.
+     *  This method will throw if query ID is not known.
+     *
+     *  @param queryId:  Query ID, non-negative number.
+     *  @param spans:    Time spent by query jobs in processing stages.
+     */
+    void saveTrace(QueryId queryId, std::vector<QTraceSpan> const& spans) override;
+
+    /**
+     *  @brief Get processing timeline of a traced query.
+     *
+     *  @param queryId:  Query ID, non-negative number.
+     *  @return: Spans ordered by job ID and start time, empty if the query
+     *           was not traced.
+     */
+    std::vector<QTraceSpan> getTrace(QueryId queryId) override;
+
 protected:
 
     ///  Check that all necessary tables exist
@@ -0,0 +1,54 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QMETA_QTRACE_H
+#define LSST_QSERV_QMETA_QTRACE_H
+
+// System headers
+#include <cstdint>
+#include <string>
+
+namespace lsst {
+namespace qserv {
+namespace qmeta {
+
+/// Time spent by one job of a query in one processing stage, either on
+/// the czar or on a worker. Times are in microseconds, start is relative
+/// to the epoch, so spans from different hosts are only as comparable as
+/// the host clocks are synchronized.
+struct QTraceSpan {
+    QTraceSpan() {}
+    QTraceSpan(int jobId_, int chunk_, std::string const& source_, std::string const& stage_,
+               std::uint64_t start_, std::uint64_t duration_)
+        : jobId(jobId_), chunk(chunk_), source(source_), stage(stage_),
+          start(start_), duration(duration_) {}
+
+    int jobId{0};                ///< Job ID within the query
+    int chunk{-1};               ///< Chunk number, -1 if not known
+    std::string source;          ///< "czar" or name of the worker host
+    std::string stage;           ///< Processing stage, e.g. "sql" or "merge"
+    std::uint64_t start{0};      ///< Start of the stage
+    std::uint64_t duration{0};   ///< Time spent in the stage
+};
+
+}}} // namespace lsst::qserv::qmeta
+
+#endif // LSST_QSERV_QMETA_QTRACE_H
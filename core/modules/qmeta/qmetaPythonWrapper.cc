@@ -109,6 +109,9 @@ PYBIND11_MODULE(qmetaLib, mod) {
         .def("getQueryInfo", &QMeta::getQueryInfo)
         .def("getQueriesForDb", &QMeta::getQueriesForDb)
         .def("getQueriesForTable", &QMeta::getQueriesForTable)
+        .def("saveResultSize", &QMeta::saveResultSize)
+        .def("getResultSizeEstimate", &QMeta::getResultSizeEstimate,
+                "qTemplate"_a, "maxHistory"_a=10)
         ;
 
     // Exception classes
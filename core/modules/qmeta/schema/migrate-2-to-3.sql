@@ -0,0 +1,20 @@
+--
+-- Migration script from version 2 to version 3 of QMeta database:
+--   - QInfo table adds query template hash and result size columns,
+--     used by czar to estimate result size of new queries
+--
+
+-- -----------------------------------------------------
+-- Add new columns to table `QInfo`
+-- -----------------------------------------------------
+ALTER TABLE `QInfo` ADD COLUMN (
+  `qTemplateHash` BINARY(16) NULL COMMENT 'MD5 hash of the query template, used to find similar queries',
+  `resultBytes` BIGINT NULL COMMENT 'Size of the data merged into the result table, NULL if unknown'
+);
+ALTER TABLE `QInfo` ADD INDEX `QInfo_qTemplateHash_index` (`qTemplateHash` ASC);
+
+UPDATE `QInfo` SET `qTemplateHash` = UNHEX(MD5(`qTemplate`));
+
+
+-- Update record for schema version, migration script expects this record to exist
+UPDATE `QMetadata` SET `value` = '3' WHERE `metakey` = 'version';
@@ -0,0 +1,29 @@
+--
+-- Migration script from version 3 to version 4 of QMeta database:
+--   - QTrace table is added, it keeps timeline of processing stages
+--     of traced queries
+--
+
+-- -----------------------------------------------------
+-- Table `QTrace`
+-- -----------------------------------------------------
+CREATE TABLE IF NOT EXISTS `QTrace` (
+  `queryId` BIGINT NOT NULL COMMENT 'Query ID',
+  `jobId` INT NOT NULL COMMENT 'Job ID within the query',
+  `chunk` INT NOT NULL COMMENT 'Chunk number, -1 if not known',
+  `source` CHAR(63) NOT NULL COMMENT 'Where the span was recorded, czar or worker host name',
+  `stage` CHAR(32) NOT NULL COMMENT 'Processing stage',
+  `start` BIGINT NOT NULL COMMENT 'Start of the stage, microseconds since epoch',
+  `duration` BIGINT NOT NULL COMMENT 'Time spent in the stage, microseconds',
+  INDEX `QTrace_queryId_index` (`queryId` ASC, `jobId` ASC),
+  CONSTRAINT `QTrace_qid`
+    FOREIGN KEY (`queryId`)
+    REFERENCES `QInfo` (`queryId`)
+    ON DELETE CASCADE
+    ON UPDATE CASCADE)
+ENGINE = InnoDB
+COMMENT = 'Timeline of processing stages of traced queries';
+
+
+-- Update record for schema version, migration script expects this record to exist
+UPDATE `QMetadata` SET `value` = '4' WHERE `metakey` = 'version';
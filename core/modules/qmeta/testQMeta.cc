@@ -294,6 +294,66 @@ BOOST_AUTO_TEST_CASE(messWithQueries2) {
     BOOST_CHECK_EQUAL(queries.size(), 0U);
 }
 
+BOOST_AUTO_TEST_CASE(messWithResultSize) {
+
+    CzarId cid1 = qMeta->getCzarID("czar:1000");
+    BOOST_CHECK(cid1 != 0U);
+
+    QInfo qinfo(QInfo::SYNC, cid1, "user1", "SELECT * from Source", "SELECT * from Source_{}", "", "", "", "");
+    QMeta::TableNames tables(1, std::make_pair("TestDB", "Source"));
+    lsst::qserv::QueryId qid1 = qMeta->registerQuery(qinfo, tables);
+    lsst::qserv::QueryId qid2 = qMeta->registerQuery(qinfo, tables);
+
+    // no history yet
+    BOOST_CHECK_EQUAL(qMeta->getResultSizeEstimate("SELECT * from Source_{}"), -1);
+
+    BOOST_CHECK_THROW(qMeta->saveResultSize(99999, 1000), QueryIdError);
+    qMeta->saveResultSize(qid1, 1000);
+    qMeta->saveResultSize(qid2, 3000);
+    BOOST_CHECK_EQUAL(qMeta->getResultSizeEstimate("SELECT * from Source_{}"), 2000);
+    BOOST_CHECK_EQUAL(qMeta->getResultSizeEstimate("SELECT * from Source_{}", 1), 3000);
+    BOOST_CHECK_EQUAL(qMeta->getResultSizeEstimate("SELECT * from Object_{}"), -1);
+
+    qMeta->completeQuery(qid1, QInfo::COMPLETED);
+    qMeta->finishQuery(qid1);
+    qMeta->completeQuery(qid2, QInfo::COMPLETED);
+    qMeta->finishQuery(qid2);
+}
+
+BOOST_AUTO_TEST_CASE(messWithTrace) {
+
+    CzarId cid1 = qMeta->getCzarID("czar:1000");
+    BOOST_CHECK(cid1 != 0U);
+
+    QInfo qinfo(QInfo::SYNC, cid1, "user1", "SELECT * from Source", "SELECT * from Source_{}", "", "", "", "");
+    QMeta::TableNames tables(1, std::make_pair("TestDB", "Source"));
+    lsst::qserv::QueryId qid = qMeta->registerQuery(qinfo, tables);
+
+    BOOST_CHECK(qMeta->getTrace(qid).empty());
+    BOOST_CHECK_THROW(qMeta->saveTrace(99999, std::vector<QTraceSpan>()), QueryIdError);
+
+    std::vector<QTraceSpan> spans;
+    spans.emplace_back(1, 100, "worker-1", "sql", 2000, 500);
+    spans.emplace_back(0, 10, "czar", "request", 1000, 3000);
+    spans.emplace_back(1, 100, "czar", "request", 1000, 4000);
+    qMeta->saveTrace(qid, spans);
+    qMeta->saveTrace(qid, std::vector<QTraceSpan>(1, QTraceSpan(0, 10, "czar", "merge", 4500, 10)));
+
+    auto trace = qMeta->getTrace(qid);
+    BOOST_REQUIRE_EQUAL(trace.size(), 4U);
+    BOOST_CHECK_EQUAL(trace[0].jobId, 0);
+    BOOST_CHECK_EQUAL(trace[0].stage, "request");
+    BOOST_CHECK_EQUAL(trace[1].stage, "merge");
+    BOOST_CHECK_EQUAL(trace[2].stage, "request");
+    BOOST_CHECK_EQUAL(trace[3].source, "worker-1");
+    BOOST_CHECK_EQUAL(trace[3].chunk, 100);
+    BOOST_CHECK_EQUAL(trace[3].start, 2000U);
+    BOOST_CHECK_EQUAL(trace[3].duration, 500U);
+
+    qMeta->completeQuery(qid, QInfo::COMPLETED);
+    qMeta->finishQuery(qid);
+}
+
 BOOST_AUTO_TEST_CASE(messWithTables) {
 
     // make sure that we have czars from previous test
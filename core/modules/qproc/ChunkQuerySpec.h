@@ -70,6 +70,8 @@ public:
     DbTableSet subChunkTables;
     std::vector<int> subChunkIds;
     std::vector<std::string> queries;
+    std::string semiJoinColumn;   ///< see proto::TaskMsg::SemiJoin
+    std::string semiJoinKeyQuery; ///< empty if the queries have no semi-join
     // Consider promoting the concept of container of ChunkQuerySpec
     // in the hopes of increased code cleanliness.
     std::shared_ptr<ChunkQuerySpec> nextFragment; ///< ad-hoc linked list (consider removal)
@@ -191,12 +191,15 @@ public:
     inline SubChunksVector getCoverage(Region const& r) {
         return _chunker->getSubChunksIntersecting(r);
     }
-    ChunkSpecVector getAllChunks() const {
+    /// @return all chunks except those in 'excluded' (if provided). Excluded
+    /// chunks are filtered before their (costly) subchunk lists are computed.
+    ChunkSpecVector getAllChunks(util::ChunkSet const* excluded) const {
         Int32Vector allChunks = _chunker->getAllChunks();
         ChunkSpecVector csv;
         csv.reserve(allChunks.size());
         for(IntVector::const_iterator i=allChunks.begin(), e=allChunks.end();
             i != e; ++i) {
+            if (excluded != nullptr && excluded->contains(*i)) continue;
             csv.push_back(ChunkSpec(*i, _chunker->getAllSubChunks(*i)));
         }
         return csv;
@@ -209,14 +212,24 @@ private:
 // IndexMap implementation
 ////////////////////////////////////////////////////////////////////////
 IndexMap::IndexMap(css::StripingParams const& sp,
-                   std::shared_ptr<SecondaryIndex> si)
+                   std::shared_ptr<SecondaryIndex> si,
+                   std::shared_ptr<util::ChunkSet const> emptyChunks)
     : _pm(std::make_shared<PartitioningMap>(sp)),
-      _si(si) {
+      _si(si),
+      _emptyChunks(emptyChunks) {
 }
 
 // Compute the chunks list for the whole partitioning scheme
 ChunkSpecVector IndexMap::getAllChunks() {
-    return _pm->getAllChunks();
+    return _pm->getAllChunks(_emptyChunks.get());
+}
+
+void IndexMap::_removeEmpty(ChunkSpecVector& csv) const {
+    if (!_emptyChunks || _emptyChunks->empty()) return;
+    util::ChunkSet const& empty = *_emptyChunks;
+    csv.erase(std::remove_if(csv.begin(), csv.end(),
+                             [&empty](ChunkSpec const& cs) { return empty.contains(cs.chunkId); }),
+              csv.end());
 }
 
 //  Compute chunks coverage of spatial and secondary index constraints
@@ -263,10 +276,13 @@ ChunkSpecVector IndexMap::getChunks(query::ConstraintVector const& cv) {
         normalize(regionSpecs);
         intersectSorted(indexSpecs, regionSpecs);
         LOGS(_log, LOG_LVL_DEBUG, "merged subChunks=" << util::printable(regionSpecs));
+        _removeEmpty(indexSpecs);
         return indexSpecs;
     } else if (hasIndex) {
+        _removeEmpty(indexSpecs);
         return indexSpecs;
     } else if (hasRegion) {
+        _removeEmpty(regionSpecs);
         return regionSpecs;
     } else {
         return getAllChunks();
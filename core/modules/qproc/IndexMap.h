@@ -34,6 +34,7 @@
 #include "css/StripingParams.h"
 #include "query/Constraint.h"
 #include "qproc/ChunkSpec.h"
+#include "util/ChunkSet.h"
 
 namespace lsst {
 namespace qserv {
@@ -43,8 +44,14 @@ class SecondaryIndex;
 
 class IndexMap {
 public:
+    /**
+     *  @param sp:          partitioning parameters of the database
+     *  @param si:          secondary index of the database
+     *  @param emptyChunks: (optional) chunks to be excluded from all results
+     */
     IndexMap(css::StripingParams const& sp,
-             std::shared_ptr<SecondaryIndex> si);
+             std::shared_ptr<SecondaryIndex> si,
+             std::shared_ptr<util::ChunkSet const> emptyChunks=nullptr);
 
     /** Compute the chunks list for the whole partitioning scheme
      *
@@ -70,8 +77,12 @@ public:
 
     class PartitioningMap;
 private:
+    /// Remove empty chunks from the vector
+    void _removeEmpty(ChunkSpecVector& csv) const;
+
     std::shared_ptr<PartitioningMap> _pm;
     std::shared_ptr<SecondaryIndex> _si;
+    std::shared_ptr<util::ChunkSet const> _emptyChunks;
 };
 
 }}} // namespace lsst::qserv::qproc
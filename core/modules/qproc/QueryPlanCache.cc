@@ -0,0 +1,407 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qproc/QueryPlanCache.h"
+
+// System headers
+#include <cctype>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "css/CssAccess.h"
+#include "css/constants.h"
+#include "qproc/QuerySession.h"
+#include "query/Constraint.h"
+#include "query/QueryTemplate.h"
+#include "query/SelectStmt.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qproc.QueryPlanCache");
+
+using lsst::qserv::css::CssAccess;
+using lsst::qserv::qproc::QuerySession;
+
+// Numeric markers are MARKER_BASE + literal index, they are unlikely
+// to collide with anything else in a query.
+long long const MARKER_BASE = 987654321980000LL;
+std::size_t const MAX_LITERALS = 10000;
+char const* const STRING_MARKER = "qservLiteral_";
+
+bool isIdentChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+bool isDigit(char c) {
+    return std::isdigit(static_cast<unsigned char>(c));
+}
+
+/// @return position after the quoted text starting at pos
+std::size_t skipQuoted(std::string const& sql, std::size_t pos) {
+    char const quote = sql[pos];
+    std::size_t i = pos + 1;
+    while (i < sql.size()) {
+        if (sql[i] == '\\' && quote != '`') {
+            i += 2;
+        } else if (sql[i] == quote) {
+            // doubled quote is an escaped quote
+            if (i + 1 < sql.size() && sql[i + 1] == quote) {
+                i += 2;
+            } else {
+                return i + 1;
+            }
+        } else {
+            ++i;
+        }
+    }
+    return sql.size();
+}
+
+/// @return position after the number starting at pos
+std::size_t skipNumber(std::string const& sql, std::size_t pos) {
+    std::size_t i = pos;
+    while (i < sql.size() && (isDigit(sql[i]) || sql[i] == '.')) ++i;
+    if (i < sql.size() && (sql[i] == 'e' || sql[i] == 'E')) {
+        std::size_t j = i + 1;
+        if (j < sql.size() && (sql[j] == '+' || sql[j] == '-')) ++j;
+        if (j < sql.size() && isDigit(sql[j])) {
+            i = j;
+            while (i < sql.size() && isDigit(sql[i])) ++i;
+        }
+    }
+    return i;
+}
+
+/// @return marker -> literal map used to instantiate a plan
+std::map<std::string, std::string> makeLiteralMap(std::vector<std::string> const& markers,
+                                                  std::vector<std::string> const& literals) {
+    std::map<std::string, std::string> literalMap;
+    for (std::size_t i = 0; i < markers.size(); ++i) {
+        auto const& marker = markers[i];
+        auto const& literal = literals[i];
+        literalMap[marker] = literal;
+        if (literal.front() == '\'') {
+            // restrictors get string parameters without quotes
+            literalMap[marker.substr(1, marker.size() - 2)] = literal.substr(1, literal.size() - 2);
+        } else {
+            literalMap["-" + marker] = "-" + literal;
+        }
+    }
+    return literalMap;
+}
+
+/// @return text of everything in the session which is used to run the query
+std::string makePlanText(QuerySession& qs) {
+    std::ostringstream os;
+    for (auto const& queryTemplate : qs.makeQueryTemplates()) {
+        os << "parallel: " << queryTemplate.sqlFragment() << "\n";
+    }
+    if (qs.getPreFlightStmt() != nullptr) {
+        os << "preflight: " << qs.getPreFlightStmt()->getQueryTemplate() << "\n";
+    }
+    auto const mergeStmt = qs.getMergeStmt();
+    if (mergeStmt != nullptr) {
+        os << "merge: " << mergeStmt->getQueryTemplate() << "\n";
+    }
+    auto const constraints = qs.getConstraints();
+    if (constraints != nullptr) {
+        for (auto const& constraint : *constraints) {
+            os << "constraint: " << constraint << "\n";
+        }
+    }
+    if (not qs.getSemiJoinKeyQuery().empty()) {
+        os << "semijoin: " << qs.getSemiJoinKeyQuery() << "\n";
+    }
+    os << "stmt: " << qs.getStmt().getQueryTemplate() << "\n"
+       << "needsMerge=" << qs.needsMerge() << " hasChunks=" << qs.hasChunks()
+       << " dominantDb=" << qs.getDominantDb() << " scanRating=" << qs.getScanRating()
+       << " rowLimit=" << qs.getResultRowLimit() << " orderBy=" << qs.getProxyOrderBy();
+    return os.str();
+}
+
+/// @return text of the CSS metadata the plans depend on
+std::string makeCssText(CssAccess const& css) {
+    std::ostringstream os;
+    os << std::setprecision(17);
+    for (auto const& db : css.getDbStatus()) {
+        os << db.first << "=" << db.second << "\n";
+        if (db.second != lsst::qserv::css::KEY_STATUS_READY) continue;
+        auto const striping = css.getDbStriping(db.first);
+        os << " striping: " << striping.stripes << " " << striping.subStripes
+           << " " << striping.partitioningId << " " << striping.overlap << "\n";
+        for (auto const& table : css.getTableStatus(db.first)) {
+            os << " " << table.first << "=" << table.second << "\n";
+            if (table.second != lsst::qserv::css::KEY_STATUS_READY) continue;
+            auto const params = css.getTableParams(db.first, table.first);
+            auto const& part = params.partitioning;
+            auto const& match = params.match;
+            os << "  partitioning: " << part.partitioned << " " << part.subChunks
+               << " " << part.dirDb << "." << part.dirTable << "." << part.dirColName
+               << " " << part.latColName << " " << part.lonColName << " " << part.overlap << "\n"
+               << "  match: " << match.dirTable1 << "." << match.dirColName1
+               << " " << match.dirTable2 << "." << match.dirColName2
+               << " " << match.flagColName << " " << match.angSep << "\n"
+               << "  scan: " << params.sharedScan.lockInMem << " " << params.sharedScan.scanRating << "\n"
+               << "  schema: " << css.getTableSchema(db.first, table.first) << "\n";
+        }
+    }
+    return os.str();
+}
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace qproc {
+
+QueryPlanCache::QueryPlanCache(std::shared_ptr<css::CssAccess> const& css,
+                               mysql::MySqlConfig const& mysqlSchemaConfig,
+                               std::size_t maxEntries,
+                               std::chrono::seconds cssCheckInterval)
+    : _css(css), _mysqlSchemaConfig(mysqlSchemaConfig), _maxEntries(maxEntries),
+      _cssCheckInterval(cssCheckInterval) {
+}
+
+QueryPlanCache::Shape QueryPlanCache::makeShape(std::string const& sql) {
+    Shape shape;
+    std::string part;
+    bool inLimit = false;   // numbers of the LIMIT clause are kept
+    std::size_t i = 0;
+    while (i < sql.size()) {
+        char const c = sql[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))) ++i;
+            if (not part.empty() || not shape.literals.empty()) part += ' ';
+        } else if (c == '\'') {
+            std::size_t const end = skipQuoted(sql, i);
+            shape.literals.push_back(sql.substr(i, end - i));
+            shape.parts.push_back(part);
+            part.clear();
+            i = end;
+        } else if (c == '`' || c == '"') {
+            std::size_t const end = skipQuoted(sql, i);
+            part.append(sql, i, end - i);
+            i = end;
+        } else if (isIdentChar(c) && not isDigit(c)) {
+            std::size_t end = i;
+            while (end < sql.size() && isIdentChar(sql[end])) ++end;
+            std::string word = sql.substr(i, end - i);
+            part += word;
+            for (auto& wc : word) wc = std::toupper(static_cast<unsigned char>(wc));
+            inLimit = (word == "LIMIT" || word == "OFFSET");
+            i = end;
+        } else if (isDigit(c) || (c == '.' && i + 1 < sql.size() && isDigit(sql[i + 1]))) {
+            std::size_t end;
+            bool literal = not inLimit;
+            if (c == '0' && i + 1 < sql.size() && (sql[i + 1] == 'x' || sql[i + 1] == 'X')) {
+                end = i + 2;
+                literal = false;
+            } else {
+                end = skipNumber(sql, i);
+            }
+            if (end < sql.size() && isIdentChar(sql[end])) {
+                // identifier starting with digits, or hex literal
+                while (end < sql.size() && isIdentChar(sql[end])) ++end;
+                literal = false;
+            }
+            if (literal) {
+                shape.literals.push_back(sql.substr(i, end - i));
+                shape.parts.push_back(part);
+                part.clear();
+            } else {
+                part.append(sql, i, end - i);
+            }
+            i = end;
+        } else {
+            part += c;
+            ++i;
+        }
+    }
+    // Trailing whitespace and semicolons do not matter
+    while (not part.empty() && (part.back() == ' ' || part.back() == ';')) part.pop_back();
+    shape.parts.push_back(part);
+
+    for (std::size_t j = 0; j < shape.parts.size(); ++j) {
+        if (j > 0) shape.text += '?';
+        shape.text += shape.parts[j];
+    }
+    return shape;
+}
+
+std::shared_ptr<QuerySession> QueryPlanCache::find(std::string const& sql, std::string const& defaultDb) {
+    _checkCss();
+    Shape const shape = makeShape(sql);
+    std::string const key = defaultDb + "\n" + shape.text;
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto itr = _entries.find(key);
+        if (itr == _entries.end() || itr->second->second.plan == nullptr) {
+            ++_misses;
+            return nullptr;
+        }
+        _lru.splice(_lru.begin(), _lru, itr->second);
+        entry = itr->second->second;
+        ++_hits;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "Plan found for query shape: " << shape.text);
+    return entry.plan->copyWithLiterals(sql, makeLiteralMap(entry.markers, shape.literals));
+}
+
+void QueryPlanCache::insert(std::string const& sql, std::string const& defaultDb,
+                            std::shared_ptr<QuerySession> const& qs) {
+    if (_maxEntries == 0) return;
+    Shape const shape = makeShape(sql);
+    std::string const key = defaultDb + "\n" + shape.text;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto itr = _entries.find(key);
+        if (itr != _entries.end()) {
+            _lru.splice(_lru.begin(), _lru, itr->second);
+            return;
+        }
+    }
+
+    // Analysis of the query with markers is done without holding the lock
+    Entry entry;
+    entry.plan = _makePlan(shape, defaultDb, entry.markers, qs);
+    if (entry.plan == nullptr) {
+        LOGS(_log, LOG_LVL_DEBUG, "Query shape is not cacheable: " << shape.text);
+    }
+
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (_entries.count(key) != 0) return;
+    _lru.emplace_front(key, entry);
+    _entries[key] = _lru.begin();
+    while (_entries.size() > _maxEntries) {
+        _entries.erase(_lru.back().first);
+        _lru.pop_back();
+    }
+}
+
+void QueryPlanCache::clear() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _lru.clear();
+    _entries.clear();
+}
+
+std::size_t QueryPlanCache::size() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _entries.size();
+}
+
+std::uint64_t QueryPlanCache::hits() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _hits;
+}
+
+std::uint64_t QueryPlanCache::misses() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _misses;
+}
+
+std::shared_ptr<QuerySession const>
+QueryPlanCache::_makePlan(Shape const& shape, std::string const& defaultDb,
+                          std::vector<std::string>& markers,
+                          std::shared_ptr<QuerySession> const& qs) const {
+    if (shape.literals.size() > MAX_LITERALS) return nullptr;
+    std::string markerSql = shape.parts.front();
+    for (std::size_t i = 0; i < shape.literals.size(); ++i) {
+        std::string marker;
+        if (shape.literals[i].front() == '\'') {
+            marker = "'" + std::string(STRING_MARKER) + std::to_string(i) + "'";
+        } else {
+            marker = std::to_string(MARKER_BASE + static_cast<long long>(i));
+        }
+        markers.push_back(marker);
+        markerSql += marker + shape.parts[i + 1];
+    }
+
+    try {
+        auto plan = std::make_shared<QuerySession>(_css, _mysqlSchemaConfig, defaultDb);
+        auto stmt = plan->parseQuery(markerSql);
+        if (stmt == nullptr) return nullptr;
+        plan->analyzeQuery(markerSql, stmt);
+        if (not plan->getError().empty()) return nullptr;
+
+        // The plan is only usable if it gives back the plan of the original query
+        auto check = plan->copyWithLiterals(qs->getOriginal(), makeLiteralMap(markers, shape.literals));
+        std::string const checkText = makePlanText(*check);
+        std::string const origText = makePlanText(*qs);
+        if (checkText != origText) {
+            LOGS(_log, LOG_LVL_TRACE, "Plan mismatch, original:\n" << origText
+                 << "\nfrom markers:\n" << checkText);
+            return nullptr;
+        }
+        return plan;
+    } catch (std::exception const& exc) {
+        LOGS(_log, LOG_LVL_WARN, "Failed to make plan for query shape " << shape.text
+             << ": " << exc.what());
+    }
+    return nullptr;
+}
+
+void QueryPlanCache::_checkCss() {
+    if (_css == nullptr) return;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto const now = std::chrono::steady_clock::now();
+        if (_cssChecking || now - _lastCssCheck < _cssCheckInterval) return;
+        _cssChecking = true;
+        _lastCssCheck = now;
+    }
+
+    // Plans depend on the status, partitioning, director keys and schema
+    // of the tables. A table which is deleted and created again with
+    // the same metadata gives the same plans.
+    std::size_t signature = 0;
+    bool ok = true;
+    try {
+        signature = std::hash<std::string>()(makeCssText(*_css));
+    } catch (std::exception const& exc) {
+        LOGS(_log, LOG_LVL_WARN, "Failed to check CSS, clearing plan cache: " << exc.what());
+        ok = false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mtx);
+    _cssChecking = false;
+    if (not ok || signature != _cssSignature) {
+        if (not _entries.empty()) {
+            LOGS(_log, LOG_LVL_INFO, "CSS has changed, clearing plan cache of "
+                 << _entries.size() << " entries");
+        }
+        _lru.clear();
+        _entries.clear();
+    }
+    _cssSignature = signature;
+}
+
+}}} // namespace lsst::qserv::qproc
@@ -0,0 +1,174 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+
+#ifndef LSST_QSERV_QPROC_QUERYPLANCACHE_H
+#define LSST_QSERV_QPROC_QUERYPLANCACHE_H
+/**
+  * @file
+  *
+  * @brief In-process cache of analyzed queries
+  */
+
+// System headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Qserv headers
+#include "mysql/MySqlConfig.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace css {
+    class CssAccess;
+}
+namespace qproc {
+    class QuerySession;
+}}} // End of forward declarations
+
+namespace lsst {
+namespace qserv {
+namespace qproc {
+
+/**
+ *  QueryPlanCache is a thread-safe LRU cache of analyzed queries keyed by
+ *  the query shape: the normalized query text with literal values replaced
+ *  by placeholders. A query with a known shape skips parsing and analysis,
+ *  its session is instantiated from the cached plan with its own literals.
+ *
+ *  The cached plan is made by analyzing the query with each literal replaced
+ *  by a unique marker. A plan is only used if instantiating it with the
+ *  literals of the original query gives exactly the plan of the original
+ *  query, shapes for which this is not the case are remembered as not
+ *  cacheable.
+ *
+ *  Plans depend on CSS metadata, the cache is cleared when the status,
+ *  partitioning, director keys or schema of databases or tables in CSS
+ *  change. CSS is checked at most once per check interval.
+ */
+class QueryPlanCache {
+public:
+    typedef std::shared_ptr<QueryPlanCache> Ptr;
+
+    /// Query text split at literals
+    struct Shape {
+        std::string text;                   ///< normalized text, literals replaced with '?'
+        std::vector<std::string> parts;     ///< text around literals, one more than literals
+        std::vector<std::string> literals;  ///< literals as they appear in the query
+    };
+
+    /**
+     *  @param css:                interface to CSS, used for analysis and to detect changes
+     *  @param mysqlSchemaConfig:  connection to the database with the schema
+     *  @param maxEntries:         the maximum number of entries kept in the cache
+     *  @param cssCheckInterval:   time between checks of CSS for changes
+     */
+    QueryPlanCache(std::shared_ptr<css::CssAccess> const& css,
+                   mysql::MySqlConfig const& mysqlSchemaConfig,
+                   std::size_t maxEntries,
+                   std::chrono::seconds cssCheckInterval);
+
+    QueryPlanCache(QueryPlanCache const&) = delete;
+    QueryPlanCache& operator=(QueryPlanCache const&) = delete;
+
+    /**
+     *  Split query into its shape and literals. Whitespace is collapsed,
+     *  quoted strings and numbers are literals, except for the numbers of
+     *  the LIMIT clause which change the plan.
+     */
+    static Shape makeShape(std::string const& sql);
+
+    /**
+     *  Find the plan for a query.
+     *
+     *  @param sql:        query text
+     *  @param defaultDb:  default database of the query
+     *  @return analyzed session for the query, nullptr if not in the cache
+     */
+    std::shared_ptr<QuerySession> find(std::string const& sql, std::string const& defaultDb);
+
+    /**
+     *  Add the plan for a query which was not found in the cache.
+     *
+     *  @param sql:        query text
+     *  @param defaultDb:  default database of the query
+     *  @param qs:         session successfully analyzed for the query, not finalized yet
+     */
+    void insert(std::string const& sql, std::string const& defaultDb,
+                std::shared_ptr<QuerySession> const& qs);
+
+    /// Remove all entries
+    void clear();
+
+    std::size_t maxEntries() const { return _maxEntries; }
+
+    /// @return the current number of entries
+    std::size_t size() const;
+
+    /// @return the number of queries found in the cache since it was created
+    std::uint64_t hits() const;
+
+    /// @return the number of queries not found in the cache since it was created
+    std::uint64_t misses() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<QuerySession const> plan; ///< nullptr if the shape is not cacheable
+        std::vector<std::string> markers;         ///< markers used in place of the literals
+    };
+    typedef std::list<std::pair<std::string, Entry>> LruList;
+
+    /// @return plan made from the shape with markers, nullptr if not cacheable
+    std::shared_ptr<QuerySession const> _makePlan(Shape const& shape, std::string const& defaultDb,
+                                                  std::vector<std::string>& markers,
+                                                  std::shared_ptr<QuerySession> const& qs) const;
+
+    /// Clear the cache if CSS has changed since the last check
+    void _checkCss();
+
+    std::shared_ptr<css::CssAccess> const _css;
+    mysql::MySqlConfig const _mysqlSchemaConfig;
+    std::size_t const _maxEntries;
+    std::chrono::seconds const _cssCheckInterval;
+
+    mutable std::mutex _mtx; ///< protects all members below
+    LruList _lru; ///< most recently used entries go first
+    std::unordered_map<std::string, LruList::iterator> _entries;
+    std::uint64_t _hits = 0;
+    std::uint64_t _misses = 0;
+    std::chrono::steady_clock::time_point _lastCssCheck;
+    std::size_t _cssSignature = 0;
+    bool _cssChecking = false;
+};
+
+}}} // namespace lsst::qserv::qproc
+
+#endif // LSST_QSERV_QPROC_QUERYPLANCACHE_H
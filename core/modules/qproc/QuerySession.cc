@@ -62,21 +62,124 @@
 #include "qana/QueryMapping.h"
 #include "qana/QueryPlugin.h"
 #include "qana/ScanTablePlugin.h"
+#include "qana/SemiJoinPlugin.h"
 #include "qana/TablePlugin.h"
 #include "qana/WherePlugin.h"
 #include "qproc/QueryProcessingBug.h"
 #include "query/Constraint.h"
+#include "query/FuncExpr.h"
+#include "query/HavingClause.h"
+#include "query/OrTerm.h"
 #include "query/QsRestrictor.h"
 #include "query/QueryContext.h"
 #include "query/SelectStmt.h"
 #include "query/SelectList.h"
+#include "query/ValueExpr.h"
+#include "query/ValueFactor.h"
+#include "query/WhereClause.h"
 #include "query/typedefs.h"
 #include "util/IterableFormatter.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.qproc.QuerySession");
+
+using lsst::qserv::query::QsRestrictor;
+using lsst::qserv::query::SelectStmt;
+using lsst::qserv::query::ValueExpr;
+using lsst::qserv::query::ValueFactor;
+
+typedef std::map<std::string, std::string> LiteralMap;
+typedef std::map<QsRestrictor const*, std::shared_ptr<QsRestrictor>> RestrictorMap;
+
+/// Replace constants of the expression (recursively) found in the literal map.
+void substituteLiterals(ValueExpr& valueExpr, LiteralMap const& literals) {
+    for (auto& factorOp : valueExpr.getFactorOps()) {
+        auto const& factor = factorOp.factor;
+        if (factor == nullptr) continue;
+        switch (factor->getType()) {
+        case ValueFactor::CONST: {
+            auto itr = literals.find(factor->getConstVal());
+            if (itr != literals.end()) factor->setConstVal(itr->second);
+            break;
+        }
+        case ValueFactor::FUNCTION:
+        case ValueFactor::AGGFUNC:
+            if (factor->getFuncExpr() != nullptr) {
+                for (auto const& param : factor->getFuncExpr()->params) {
+                    if (param != nullptr) substituteLiterals(*param, literals);
+                }
+            }
+            break;
+        case ValueFactor::EXPR:
+            if (factor->getExpr() != nullptr) substituteLiterals(*factor->getExpr(), literals);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/// @return copy of the restrictor with parameters found in the literal map replaced,
+///         a restrictor shared by statements and context is copied only once.
+std::shared_ptr<QsRestrictor> copyRestrictor(std::shared_ptr<QsRestrictor> const& restrictor,
+                                             LiteralMap const& literals, RestrictorMap& copies) {
+    auto itr = copies.find(restrictor.get());
+    if (itr != copies.end()) return itr->second;
+    auto copy = std::make_shared<QsRestrictor>(*restrictor);
+    for (auto& param : copy->_params) {
+        auto lit = literals.find(param);
+        if (lit != literals.end()) param = lit->second;
+    }
+    copies[restrictor.get()] = copy;
+    return copy;
+}
+
+/// @return deep copy of the statement with literals substituted in the select list,
+///         WHERE and HAVING clauses. Other clauses are shared with the source
+///         statement and must not be modified.
+std::shared_ptr<SelectStmt> copyStmt(std::shared_ptr<SelectStmt> const& stmt,
+                                     LiteralMap const& literals, RestrictorMap& copies) {
+    if (stmt == nullptr) return nullptr;
+    auto copy = stmt->clone();
+    auto const valueExprs = copy->getSelectList().getValueExprList();
+    if (valueExprs) {
+        for (auto const& valueExpr : *valueExprs) {
+            if (valueExpr != nullptr) substituteLiterals(*valueExpr, literals);
+        }
+    }
+    if (copy->hasWhereClause()) {
+        auto& where = copy->getWhereClause();
+        // WhereClause::clone() shares the leaves of the tree, make them private
+        auto& root = where.getRootTerm();
+        if (root != nullptr) {
+            root = std::static_pointer_cast<lsst::qserv::query::OrTerm>(root->clone());
+        }
+        std::vector<std::shared_ptr<ValueExpr>> whereExprs;
+        where.findValueExprs(whereExprs);
+        for (auto const& valueExpr : whereExprs) {
+            if (valueExpr != nullptr) substituteLiterals(*valueExpr, literals);
+        }
+        auto const restrs = where.getRestrs();
+        if (restrs != nullptr) {
+            auto const sourceRestrs = *restrs;
+            where.resetRestrs();
+            for (auto const& restr : sourceRestrs) {
+                where.addQsRestrictor(copyRestrictor(restr, literals, copies));
+            }
+        }
+    }
+    if (copy->hasHaving()) {
+        std::vector<std::shared_ptr<ValueExpr>> havingExprs;
+        copy->getHaving().findValueExprs(havingExprs);
+        for (auto const& valueExpr : havingExprs) {
+            if (valueExpr != nullptr) substituteLiterals(*valueExpr, literals);
+        }
+    }
+    return copy;
 }
 
+} // anonymous namespace
+
 namespace lsst {
 namespace qserv {
 namespace qproc {
@@ -142,6 +245,14 @@ bool QuerySession::needsMerge() const {
     return _context->needsMerge;
 }
 
+std::vector<std::string> const& QuerySession::getCombineOps() const {
+    return _context->combineOps;
+}
+
+std::string const& QuerySession::getSemiJoinKeyQuery() const {
+    return _context->semiJoinKeyQuery;
+}
+
 bool QuerySession::hasChunks() const {
     return _context->hasChunks();
 }
@@ -196,6 +307,50 @@ void QuerySession::setScanInteractive() {
     }
 }
 
+int QuerySession::getScanRating() const {
+    return _context ? _context->scanInfo.scanRating : 0;
+}
+
+int QuerySession::getResultRowLimit() const {
+    if (!_stmt || !_stmt->hasLimit()) return NOTSET;
+    if (_stmt->hasOrderBy() || _stmt->hasGroupBy() || _stmt->hasHaving() || _stmt->getDistinct()) {
+        return NOTSET;
+    }
+    auto const valueExprs = _stmt->getSelectList().getValueExprList();
+    if (valueExprs) {
+        for (auto const& valueExpr : *valueExprs) {
+            if (valueExpr && valueExpr->hasAggregation()) return NOTSET;
+        }
+    }
+    return _stmt->getLimit();
+}
+
+std::shared_ptr<QuerySession>
+QuerySession::copyWithLiterals(std::string const& sql,
+                               std::map<std::string, std::string> const& literals) const {
+    auto qs = std::make_shared<QuerySession>(_css, _mysqlSchemaConfig, _defaultDb);
+    qs->_original = sql;
+    RestrictorMap copies;
+    qs->_stmt = copyStmt(_stmt, literals, copies);
+    for (auto const& stmt : _stmtParallel) {
+        qs->_stmtParallel.push_back(copyStmt(stmt, literals, copies));
+    }
+    qs->_stmtPreFlight = copyStmt(_stmtPreFlight, literals, copies);
+    qs->_stmtMerge = copyStmt(_stmtMerge, literals, copies);
+    qs->_hasMerge = _hasMerge;
+
+    qs->_context = std::make_shared<query::QueryContext>(*_context);
+    if (_context->restrictors != nullptr) {
+        qs->_context->restrictors = std::make_shared<query::QueryContext::RestrList>();
+        for (auto const& restr : *_context->restrictors) {
+            qs->_context->restrictors->push_back(copyRestrictor(restr, literals, copies));
+        }
+    }
+    qs->_context->chunkCount = 0;
+    qs->_preparePlugins();
+    return qs;
+}
+
 void QuerySession::setDummy() {
     _isDummy = true;
     // Clear out chunk counts and _chunks, and replace with dummy chunk.
@@ -227,7 +382,7 @@ QuerySession::getDbStriping() {
     return _context->getDbStriping();
 }
 
-std::shared_ptr<IntSet const>
+std::shared_ptr<util::ChunkSet const>
 QuerySession::getEmptyChunks() {
     // FIXME: do we need to catch an exception here?
     return _css->getEmptyChunks().getEmpty(_context->dominantDb);
@@ -279,6 +434,7 @@ void QuerySession::_preparePlugins() {
     _plugins->push_back(std::make_shared<qana::TablePlugin>());
     _plugins->push_back(std::make_shared<qana::MatchTablePlugin>());
     _plugins->push_back(std::make_shared<qana::QservRestrictorPlugin>());
+    _plugins->push_back(std::make_shared<qana::SemiJoinPlugin>());
     _plugins->push_back(std::make_shared<qana::PostPlugin>());
     _plugins->push_back(std::make_shared<qana::ScanTablePlugin>(_interactiveChunkLimit));
 
@@ -424,6 +580,12 @@ ChunkQuerySpec::Ptr QuerySession::buildChunkQuerySpec(query::QueryTemplate::Vect
                                       chunkSpec.subChunks.end());
         }
     }
+    if (not _context->semiJoinKeyQuery.empty()) {
+        query::QueryTemplate keyQuery;
+        keyQuery.append(_context->semiJoinKeyQuery);
+        cQSpec->semiJoinColumn = _context->semiJoinColumn;
+        cQSpec->semiJoinKeyQuery = queryMapping.apply(chunkSpec, keyQuery);
+    }
     return cQSpec;
 }
 
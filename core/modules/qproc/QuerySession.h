@@ -32,6 +32,7 @@
 
 // System headers
 #include <cstddef>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -50,6 +51,7 @@
 #include "query/Constraint.h"
 #include "query/QueryTemplate.h"
 #include "query/typedefs.h"
+#include "util/ChunkSet.h"
 
 
 // Forward declarations
@@ -97,6 +99,14 @@ public:
     void analyzeQuery(std::string const& sql, std::shared_ptr<query::SelectStmt> const& stmt);
 
     bool needsMerge() const;
+
+    /// @return how workers may combine result rows of different chunks,
+    ///         see query::QueryContext::combineOps
+    std::vector<std::string> const& getCombineOps() const;
+
+    /// @return the semi-join key query template of the parallel queries, or
+    ///         an empty string, see query::QueryContext::semiJoinKeyQuery
+    std::string const& getSemiJoinKeyQuery() const;
     bool hasChunks() const;
 
     std::shared_ptr<query::ConstraintVector> getConstraints() const;
@@ -132,7 +142,7 @@ public:
     bool containsTable(std::string const& dbName, std::string const& tableName) const;
     bool validateDominantDb() const;
     css::StripingParams getDbStriping();
-    std::shared_ptr<IntSet const> getEmptyChunks();
+    std::shared_ptr<util::ChunkSet const> getEmptyChunks();
     std::string const& getError() const { return _error; }
 
     std::shared_ptr<query::SelectStmt> getMergeStmt() const;
@@ -161,6 +171,33 @@ public:
     void setScanInteractive();
     bool getScanInteractive() const { return _scanInteractive; }
 
+    /// @return the scan rating of the slowest table scanned by the query
+    int getScanRating() const;
+
+    /**
+     *  Number of merged rows which is enough to answer the query. This is
+     *  only set for queries with LIMIT where any rows from any chunks form
+     *  a valid result, i.e. no ORDER BY, GROUP BY, HAVING, DISTINCT or
+     *  aggregation.
+     *
+     *  @return row limit, or NOTSET if all chunk results are needed.
+     */
+    int getResultRowLimit() const;
+
+    /**
+     *  Make an analyzed session for a query which differs from this one only
+     *  in literal values, without parsing and analyzing it again. Each literal
+     *  of this session's query must be a unique marker, every occurrence of
+     *  a marker in the analyzed statements and restrictors is replaced with
+     *  the literal of the new query.
+     *
+     *  @param sql:      text of the new query
+     *  @param literals: marker -> literal of the new query
+     *  @return new session, as if analyzeQuery() was called for the query
+     */
+    std::shared_ptr<QuerySession> copyWithLiterals(std::string const& sql,
+                                                   std::map<std::string, std::string> const& literals) const;
+
     /**
      *  Print query session to stream.
      *
@@ -33,6 +33,16 @@
 
 // System headers
 #include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
 
 // LSST headers
 #include "lsst/log/Log.h"
@@ -46,6 +56,8 @@
 #include "global/constants.h"
 #include "global/stringUtil.h"
 #include "qproc/ChunkSpec.h"
+#include "qproc/SecondaryIndexCache.h"
+#include "qproc/SecondaryIndexFile.h"
 #include "query/Constraint.h"
 #include "sql/SqlConnection.h"
 #include "util/IterableFormatter.h"
@@ -56,6 +68,20 @@ LOG_LOGGER _log = LOG_GET("lsst.qserv.qproc.SecondaryIndex");
 
 enum QueryType { IN, NOT_IN, BETWEEN, NOT_BETWEEN };
 
+/// The maximum number of keys in a single batched lookup statement
+std::size_t const maxKeysPerStatement = 10000;
+
+/// @return true if the literal is a decimal integer which fits into int64
+bool parseKey(std::string const& literal, std::int64_t& key) {
+    if (literal.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    long long const value = std::strtoll(literal.c_str(), &end, 10);
+    if (errno != 0 || end != literal.c_str() + literal.size()) return false;
+    key = value;
+    return true;
+}
+
 } // anonymous namespace
 
 namespace lsst {
@@ -68,12 +94,21 @@ public:
     /// Lookup an index constraint. Ignore constraints that are not "sIndex"
     /// constraints.
     virtual ChunkSpecVector lookup(query::ConstraintVector const& cv) = 0;
+
+    /// Drop cached data of a database (all databases if empty)
+    virtual void clearCache(std::string const& db) {}
 };
 
 class MySqlBackend : public SecondaryIndex::Backend {
 public:
-    MySqlBackend(mysql::MySqlConfig const& c)
-        : _sqlConnection(c, true) {
+    MySqlBackend(mysql::MySqlConfig const& c,
+                 std::size_t cacheSize,
+                 std::string const& indexFileDir)
+        : _sqlConnection(c, true),
+          _indexFileDir(indexFileDir) {
+        if (cacheSize > 0) {
+            _cache = std::make_shared<SecondaryIndexCache>(cacheSize);
+        }
     }
 
     ChunkSpecVector lookup(query::ConstraintVector const& cv) override {
@@ -84,16 +119,16 @@ public:
             ++i) {
             if (i->name == "sIndex"){
                 hasIndex = true;
-                _sqlLookup(output, i->params, IN);
+                _lookup(output, i->params, IN);
             } else if (i->name == "sIndexNotIn"){
                 hasIndex = true;
-                _sqlLookup(output, i->params, NOT_IN);
+                _lookup(output, i->params, NOT_IN);
             } else if (i->name == "sIndexBetween") {
                 hasIndex = true;
-                _sqlLookup(output, i->params, BETWEEN);
+                _lookup(output, i->params, BETWEEN);
             } else if (i->name == "sIndexNotBetween") {
                 hasIndex = true;
-                _sqlLookup(output, i->params, NOT_BETWEEN);
+                _lookup(output, i->params, NOT_BETWEEN);
             }
         }
         if (!hasIndex) {
@@ -103,8 +138,37 @@ public:
         return output;
     }
 
+    void clearCache(std::string const& db) override {
+        std::string const prefix = db.empty() ? db : sanitizeName(db) + "__";
+        if (_cache) {
+            _cache->clear(prefix.empty() ? prefix : std::string(SEC_INDEX_DB) + "." + prefix);
+        }
+        std::lock_guard<std::mutex> lock(_filesMtx);
+        for (auto itr = _files.begin(); itr != _files.end();) {
+            if (itr->first.compare(0, prefix.size(), prefix) == 0) {
+                itr = _files.erase(itr);
+            } else {
+                ++itr;
+            }
+        }
+    }
 
 private:
+    /// Results of a batched lookup shared by all queries which contributed to it
+    struct Batch {
+        std::set<std::int64_t> keys;
+        SecondaryIndexCache::EntryVector found;
+        std::exception_ptr error;   ///< set if the lookup failed
+        bool done = false;
+    };
+
+    /// Batches of an index table: at most one is being fetched while
+    /// the next one is collecting keys.
+    struct BatchQueue {
+        std::shared_ptr<Batch> open;
+        bool running = false;
+    };
+
     static std::string _buildIndexTableName(
         std::string const& db,
         std::string const& table) {
@@ -174,6 +238,203 @@ private:
     }
 
 
+    /**
+     *  Dispatch a lookup to the most efficient method available for it
+     *
+     *  @param output:      existing ChunkSpec vector
+     *  @param params:      parameters used to query secondary index
+     *  @param query_type:  Type of the lookup
+     */
+    void _lookup(ChunkSpecVector& output, StringVector const& params, QueryType const& query_type) {
+        if (params.size() < 3) {
+            throw Bug("Incorrect parameters for secondary index lookup");
+        }
+        std::string const& db = params[0];
+        std::string const& table = params[1];
+
+        // Parse keys. Non-integer keys can only be looked up with SQL.
+        std::vector<std::int64_t> keys;
+        for (auto itr = params.begin() + 3; itr != params.end(); ++itr) {
+            std::int64_t key;
+            if (!parseKey(*itr, key)) {
+                _sqlLookup(output, params, query_type);
+                return;
+            }
+            keys.push_back(key);
+        }
+
+        if (query_type == QueryType::IN || query_type == QueryType::BETWEEN) {
+            SecondaryIndexFile::Ptr const file = _getFile(db, table);
+            if (file) {
+                _fileLookup(output, *file, keys, query_type);
+                return;
+            }
+        }
+        if (query_type == QueryType::IN && _cache) {
+            _cachedLookup(output, params, keys);
+            return;
+        }
+        _sqlLookup(output, params, query_type);
+    }
+
+    /// @return the index file of a table, or nullptr if there is none
+    SecondaryIndexFile::Ptr _getFile(std::string const& db, std::string const& table) {
+        if (_indexFileDir.empty()) return nullptr;
+        std::string const name = sanitizeName(db) + "__" + sanitizeName(table);
+        std::lock_guard<std::mutex> lock(_filesMtx);
+        auto itr = _files.find(name);
+        if (itr != _files.end()) return itr->second;
+        // The absence of a file is remembered as well until the cache is cleared
+        SecondaryIndexFile::Ptr file;
+        std::string const fileName = _indexFileDir + "/" + name + ".idx";
+        if (std::ifstream(fileName).good()) {
+            try {
+                file = SecondaryIndexFile::open(fileName);
+            } catch (std::exception const& e) {
+                LOGS(_log, LOG_LVL_ERROR, "Failed to open secondary index file: " << e.what());
+            }
+        }
+        _files[name] = file;
+        return file;
+    }
+
+    /// Look up keys (IN) or a range of keys (BETWEEN) in a memory-mapped index file
+    void _fileLookup(ChunkSpecVector& output,
+                     SecondaryIndexFile const& file,
+                     std::vector<std::int64_t> const& keys,
+                     QueryType const& query_type) {
+        SecondaryIndexCache::EntryVector entries;
+        if (query_type == QueryType::IN) {
+            for (auto key: keys) {
+                auto rec = file.find(key);
+                if (rec != nullptr) {
+                    entries.emplace_back(key, SecondaryIndexCache::Location{rec->chunkId, rec->subChunkId});
+                }
+            }
+        } else {
+            if (keys.size() != 2) {
+                throw Bug("Incorrect parameters for bounded secondary index lookup ");
+            }
+            auto range = file.range(keys[0], keys[1]);
+            for (auto rec = range.first; rec != range.second; ++rec) {
+                entries.emplace_back(rec->key, SecondaryIndexCache::Location{rec->chunkId, rec->subChunkId});
+            }
+        }
+        LOGS(_log, LOG_LVL_DEBUG, "secondary lookup in " << file.fileName()
+             << " found " << entries.size() << " entries");
+        _addEntries(output, entries);
+    }
+
+    /// Look up keys (IN) in the cache, fetching missing keys from MySQL
+    void _cachedLookup(ChunkSpecVector& output,
+                       StringVector const& params,
+                       std::vector<std::int64_t> const& keys) {
+        std::string const indexTable = _buildIndexTableName(params[0], params[1]);
+        SecondaryIndexCache::EntryVector entries;
+        std::vector<std::int64_t> const missing = _cache->find(indexTable, keys, entries);
+        LOGS(_log, LOG_LVL_DEBUG, "secondary lookup in " << indexTable << ": "
+             << entries.size() << " cached, " << missing.size() << " to fetch");
+        if (!missing.empty()) {
+            SecondaryIndexCache::EntryVector const fetched = _fetch(indexTable, params[2], missing);
+            entries.insert(entries.end(), fetched.begin(), fetched.end());
+        }
+        _addEntries(output, entries);
+    }
+
+    /**
+     *  Fetch keys from MySQL as a part of a batch, and add them to the cache.
+     *  If another fetch for the same table is in progress then the keys are
+     *  added to the next batch, which is run by one of the waiting threads
+     *  when the current fetch finishes.
+     *
+     *  @return entries found for the keys
+     *  @throws the exception of the failed lookup to all contributors of the batch
+     */
+    SecondaryIndexCache::EntryVector _fetch(std::string const& indexTable,
+                                            std::string const& keyColumn,
+                                            std::vector<std::int64_t> const& keys) {
+        std::unique_lock<std::mutex> lock(_batchMtx);
+        BatchQueue& queue = _batchQueues[indexTable + "." + keyColumn];
+        if (!queue.open) queue.open = std::make_shared<Batch>();
+        std::shared_ptr<Batch> const batch = queue.open;
+        batch->keys.insert(keys.begin(), keys.end());
+        _batchCv.wait(lock, [&queue, &batch]() {
+            return batch->done || (!queue.running && queue.open == batch);
+        });
+        if (!batch->done) {
+            // This thread runs the batch on behalf of all contributors
+            queue.running = true;
+            queue.open.reset();
+            lock.unlock();
+            SecondaryIndexCache::EntryVector found;
+            std::exception_ptr error;
+            try {
+                found = _sqlFetch(indexTable, keyColumn, batch->keys);
+                _cache->insert(indexTable, found);
+            } catch (std::exception const& e) {
+                LOGS(_log, LOG_LVL_ERROR, "secondary lookup in " << indexTable << " failed: " << e.what());
+                error = std::current_exception();
+            }
+            lock.lock();
+            batch->found.swap(found);
+            batch->error = error;
+            batch->done = true;
+            queue.running = false;
+            _batchCv.notify_all();
+        }
+        // A failed lookup must fail the queries rather than match no chunks
+        if (batch->error) std::rethrow_exception(batch->error);
+
+        SecondaryIndexCache::EntryVector result;
+        std::set<std::int64_t> const wanted(keys.begin(), keys.end());
+        for (auto const& entry: batch->found) {
+            if (wanted.count(entry.first) != 0) result.push_back(entry);
+        }
+        return result;
+    }
+
+    /// Run batched lookup statements for a set of keys
+    SecondaryIndexCache::EntryVector _sqlFetch(std::string const& indexTable,
+                                               std::string const& keyColumn,
+                                               std::set<std::int64_t> const& keys) {
+        SecondaryIndexCache::EntryVector found;
+        auto itr = keys.begin();
+        while (itr != keys.end()) {
+            std::string sql = "SELECT " + keyColumn + ", " + std::string(CHUNK_COLUMN) + ", " +
+                              std::string(SUB_CHUNK_COLUMN) + " FROM " + indexTable +
+                              " WHERE " + keyColumn + " IN(";
+            for (std::size_t num = 0; itr != keys.end() && num < maxKeysPerStatement; ++itr, ++num) {
+                if (num != 0) sql += ", ";
+                sql += std::to_string(*itr);
+            }
+            sql += ")";
+            LOGS(_log, LOG_LVL_DEBUG, "batched secondary lookup: " << indexTable
+                 << " keys: " << keys.size());
+            std::shared_ptr<sql::SqlResultIter> results = _sqlConnection.getQueryIter(sql);
+            for(; not results->done(); ++(*results)) {
+                StringVector const& row = **results;
+                found.emplace_back(std::stoll(row[0]),
+                                   SecondaryIndexCache::Location{std::stoi(row[1]), std::stoi(row[2])});
+            }
+            if (results->getErrorObject().isSet()) {
+                throw std::runtime_error("secondary lookup failed: " +
+                                         results->getErrorObject().printErrMsg());
+            }
+        }
+        return found;
+    }
+
+    /// Add entries to existing ChunkSpec vector
+    static void _addEntries(ChunkSpecVector& output, SecondaryIndexCache::EntryVector const& entries) {
+        std::map<int, Int32Vector> tmp;
+        for (auto const& entry: entries) {
+            tmp[entry.second.chunkId].push_back(entry.second.subChunkId);
+        }
+        for (auto const& chunk: tmp) {
+            output.push_back(ChunkSpec(chunk.first, chunk.second));
+        }
+    }
+
     /**
      *  Add results from secondary index sql query to existing ChunkSpec vector
      *
@@ -219,6 +480,15 @@ private:
     }
 
     sql::SqlConnection _sqlConnection;
+    std::string const _indexFileDir;
+    SecondaryIndexCache::Ptr _cache;    ///< nullptr if disabled
+
+    std::mutex _filesMtx;   ///< protects _files
+    std::map<std::string, SecondaryIndexFile::Ptr> _files;  ///< "<db>__<table>" -> file
+
+    std::mutex _batchMtx;   ///< protects _batchQueues and the batches
+    std::condition_variable _batchCv;
+    std::map<std::string, BatchQueue> _batchQueues; ///< "<index table>.<key column>" -> queue
 };
 
 class FakeBackend : public SecondaryIndex::Backend {
@@ -245,8 +515,10 @@ private:
     }
 };
 
-SecondaryIndex::SecondaryIndex(mysql::MySqlConfig const& c)
-    : _backend(std::make_shared<MySqlBackend>(c)) {
+SecondaryIndex::SecondaryIndex(mysql::MySqlConfig const& c,
+                               std::size_t cacheSize,
+                               std::string const& indexFileDir)
+    : _backend(std::make_shared<MySqlBackend>(c, cacheSize, indexFileDir)) {
 }
 
 SecondaryIndex::SecondaryIndex()
@@ -261,5 +533,11 @@ ChunkSpecVector SecondaryIndex::lookup(query::ConstraintVector const& cv) {
     }
 }
 
+void SecondaryIndex::clearCache(std::string const& db) {
+    if (_backend) {
+        _backend->clearCache(db);
+    }
+}
+
 }}} // namespace lsst::qserv::qproc
 
@@ -31,8 +31,10 @@
   */
 
 // System headers
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
+#include <string>
 
 // Qserv headers
 #include "mysql/MySqlConfig.h"
@@ -48,10 +50,27 @@ namespace qproc {
  *
  *  Only one instance of this is necessary: all user queries
  *  can share a single instance.
+ *
+ *  "IN" lookups of integer keys are served from an in-process cache
+ *  (see SecondaryIndexCache). Keys missing in the cache are fetched from
+ *  MySQL in batches: lookups of the same index table issued by concurrent
+ *  queries while a fetch is in progress are merged into the next
+ *  statement. If a directory with index files is configured, and it
+ *  has a file "<db>__<table>.idx" (see SecondaryIndexFile), then "IN" and
+ *  "BETWEEN" lookups for that table are served from the file instead.
  */
 class SecondaryIndex {
 public:
-    explicit SecondaryIndex(mysql::MySqlConfig const& c);
+    /**
+     *  @param c:            connection parameters of the secondary index database
+     *  @param cacheSize:    the maximum number of entries in the lookup cache,
+     *                       0 disables the cache
+     *  @param indexFileDir: directory with memory-mapped index files, an empty
+     *                       string disables the file-based lookups
+     */
+    explicit SecondaryIndex(mysql::MySqlConfig const& c,
+                            std::size_t cacheSize=0,
+                            std::string const& indexFileDir=std::string());
 
     /** Construct a fake instance
      *
@@ -66,6 +85,12 @@ public:
      */
     ChunkSpecVector lookup(query::ConstraintVector const& cv);
 
+    /** Drop cached entries and index files of a database, or of
+     *  all databases if the name is empty. The index files are re-open
+     *  on the next lookup.
+     */
+    void clearCache(std::string const& db=std::string());
+
     class NoIndexConstraint : public std::invalid_argument {
     public:
         NoIndexConstraint()
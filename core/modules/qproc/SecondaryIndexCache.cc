@@ -0,0 +1,140 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qproc/SecondaryIndexCache.h"
+
+// System headers
+#include <algorithm>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qproc.SecondaryIndexCache");
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace qproc {
+
+SecondaryIndexCache::SecondaryIndexCache(std::size_t maxEntries)
+    : _maxEntries(maxEntries) {
+}
+
+int SecondaryIndexCache::_tableId(std::string const& table) {
+    auto itr = _tableIds.find(table);
+    if (itr != _tableIds.end()) return itr->second;
+    int const id = _tableIds.size();
+    _tableIds[table] = id;
+    return id;
+}
+
+std::vector<std::int64_t> SecondaryIndexCache::find(std::string const& table,
+                                                    std::vector<std::int64_t> const& keys,
+                                                    EntryVector& found) {
+    std::vector<std::int64_t> missing;
+    std::lock_guard<std::mutex> lock(_mtx);
+    int const tableId = _tableId(table);
+    for (auto key: keys) {
+        auto itr = _entries.find(Key{tableId, key});
+        if (itr == _entries.end()) {
+            missing.push_back(key);
+            continue;
+        }
+        // Move the entry to the front of the LRU list
+        _lru.splice(_lru.begin(), _lru, itr->second);
+        found.emplace_back(key, itr->second->second);
+    }
+    _hits += keys.size() - missing.size();
+    _misses += missing.size();
+    LOGS(_log, LOG_LVL_TRACE, "table: " << table << " keys: " << keys.size()
+         << " missing: " << missing.size());
+    return missing;
+}
+
+void SecondaryIndexCache::insert(std::string const& table, EntryVector const& entries) {
+    if (_maxEntries == 0) return;
+    std::lock_guard<std::mutex> lock(_mtx);
+    int const tableId = _tableId(table);
+    for (auto const& entry: entries) {
+        Key const key{tableId, entry.first};
+        auto itr = _entries.find(key);
+        if (itr != _entries.end()) {
+            itr->second->second = entry.second;
+            _lru.splice(_lru.begin(), _lru, itr->second);
+            continue;
+        }
+        if (_entries.size() >= _maxEntries) {
+            _entries.erase(_lru.back().first);
+            _lru.pop_back();
+        }
+        _lru.emplace_front(key, entry.second);
+        _entries[key] = _lru.begin();
+    }
+}
+
+void SecondaryIndexCache::clear(std::string const& tablePrefix) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (tablePrefix.empty()) {
+        LOGS(_log, LOG_LVL_DEBUG, "Clearing the whole cache");
+        _lru.clear();
+        _entries.clear();
+        return;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "Clearing cache for tables " << tablePrefix << "*");
+    std::vector<int> tables;
+    for (auto const& entry: _tableIds) {
+        if (entry.first.compare(0, tablePrefix.size(), tablePrefix) == 0) {
+            tables.push_back(entry.second);
+        }
+    }
+    if (tables.empty()) return;
+    for (auto itr = _lru.begin(); itr != _lru.end();) {
+        if (std::find(tables.begin(), tables.end(), itr->first.table) != tables.end()) {
+            _entries.erase(itr->first);
+            itr = _lru.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+}
+
+std::size_t SecondaryIndexCache::size() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _entries.size();
+}
+
+std::uint64_t SecondaryIndexCache::hits() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _hits;
+}
+
+std::uint64_t SecondaryIndexCache::misses() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _misses;
+}
+
+}}} // namespace lsst::qserv::qproc
@@ -0,0 +1,132 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QPROC_SECONDARYINDEXCACHE_H
+#define LSST_QSERV_QPROC_SECONDARYINDEXCACHE_H
+/**
+  * @file
+  *
+  * @brief In-process cache of secondary index entries
+  */
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace qproc {
+
+/**
+ *  SecondaryIndexCache is a thread-safe, memory-bounded LRU cache of
+ *  secondary index entries: (index table, key) -> (chunkId, subChunkId).
+ *
+ *  Only positive lookup results are cached: the location of an object
+ *  never changes once it's loaded, while a missing key may appear
+ *  when more data is loaded.
+ */
+class SecondaryIndexCache {
+public:
+    typedef std::shared_ptr<SecondaryIndexCache> Ptr;
+
+    /// Location of an object in the partitioning scheme
+    struct Location {
+        std::int32_t chunkId;
+        std::int32_t subChunkId;
+    };
+
+    /// Key/location pairs as returned by the lookups
+    typedef std::vector<std::pair<std::int64_t, Location>> EntryVector;
+
+    /// @param maxEntries: the maximum number of entries kept in the cache
+    explicit SecondaryIndexCache(std::size_t maxEntries);
+
+    SecondaryIndexCache(SecondaryIndexCache const&) = delete;
+    SecondaryIndexCache& operator=(SecondaryIndexCache const&) = delete;
+
+    /**
+     *  Look up keys of an index table
+     *
+     *  @param table:  name of the index table
+     *  @param keys:   keys to be found
+     *  @param found:  entries found in the cache are appended here
+     *  @return keys which are not in the cache
+     */
+    std::vector<std::int64_t> find(std::string const& table,
+                                   std::vector<std::int64_t> const& keys,
+                                   EntryVector& found);
+
+    /// Add entries of an index table, evicting the least recently used
+    /// entries if the cache is full.
+    void insert(std::string const& table, EntryVector const& entries);
+
+    /// Remove all entries of the index tables whose names start with
+    /// the prefix. An empty prefix clears the whole cache.
+    void clear(std::string const& tablePrefix=std::string());
+
+    std::size_t maxEntries() const { return _maxEntries; }
+
+    /// @return the current number of entries
+    std::size_t size() const;
+
+    /// @return the number of keys found in the cache since it was created
+    std::uint64_t hits() const;
+
+    /// @return the number of keys not found in the cache since it was created
+    std::uint64_t misses() const;
+
+private:
+    struct Key {
+        int table;          ///< index table identifier (see _tableId)
+        std::int64_t key;
+        bool operator==(Key const& rhs) const { return table == rhs.table && key == rhs.key; }
+    };
+    struct KeyHash {
+        std::size_t operator()(Key const& k) const {
+            return std::hash<std::int64_t>()(k.key) ^ (std::hash<int>()(k.table) << 1);
+        }
+    };
+    typedef std::list<std::pair<Key, Location>> LruList;
+
+    /// @return an identifier of the table, registering it if needed
+    int _tableId(std::string const& table);
+
+    std::size_t const _maxEntries;
+
+    mutable std::mutex _mtx; ///< protects all members below
+    std::map<std::string, int> _tableIds;
+    LruList _lru; ///< most recently used entries go first
+    std::unordered_map<Key, LruList::iterator, KeyHash> _entries;
+    std::uint64_t _hits = 0;
+    std::uint64_t _misses = 0;
+};
+
+}}} // namespace lsst::qserv::qproc
+
+#endif // LSST_QSERV_QPROC_SECONDARYINDEXCACHE_H
@@ -0,0 +1,139 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qproc/SecondaryIndexFile.h"
+
+// System headers
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qproc.SecondaryIndexFile");
+
+char const magic[4] = {'Q', 'S', 'I', 'X'};
+std::uint32_t const version = 1;
+
+struct Header {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t numRecords;
+};
+
+static_assert(sizeof(Header) == 16, "unexpected size of the index file header");
+static_assert(sizeof(lsst::qserv::qproc::SecondaryIndexFile::Record) == 16,
+              "unexpected size of the index file record");
+
+typedef lsst::qserv::qproc::SecondaryIndexFile::Record Record;
+
+bool keyLess(Record const& rec, std::int64_t key) { return rec.key < key; }
+bool lessKey(std::int64_t key, Record const& rec) { return key < rec.key; }
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace qproc {
+
+SecondaryIndexFile::Ptr SecondaryIndexFile::open(std::string const& fileName) {
+    int const fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("SecondaryIndexFile: failed to open file: " + fileName);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("SecondaryIndexFile: failed to stat file: " + fileName);
+    }
+    std::size_t const size = st.st_size;
+    if (size < sizeof(Header)) {
+        ::close(fd);
+        throw std::runtime_error("SecondaryIndexFile: file is too short: " + fileName);
+    }
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);    // the mapping keeps the file open
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error("SecondaryIndexFile: failed to map file: " + fileName);
+    }
+    // Lookups are random accesses
+    ::madvise(addr, size, MADV_RANDOM);
+    return Ptr(new SecondaryIndexFile(fileName, addr, size));
+}
+
+void SecondaryIndexFile::write(std::string const& fileName, std::vector<Record> records) {
+    std::sort(records.begin(), records.end(),
+              [](Record const& lhs, Record const& rhs) { return lhs.key < rhs.key; });
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.numRecords = records.size();
+    std::ofstream os(fileName, std::ios::binary | std::ios::trunc);
+    os.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    os.write(reinterpret_cast<char const*>(records.data()), records.size() * sizeof(Record));
+    os.flush();
+    if (!os.good()) {
+        throw std::runtime_error("SecondaryIndexFile: failed to write file: " + fileName);
+    }
+}
+
+SecondaryIndexFile::SecondaryIndexFile(std::string const& fileName, void* addr, std::size_t length)
+    : _fileName(fileName), _addr(addr), _size(length) {
+    Header const* header = static_cast<Header const*>(_addr);
+    if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != version ||
+        sizeof(Header) + header->numRecords * sizeof(Record) != _size) {
+        ::munmap(_addr, _size);
+        throw std::runtime_error("SecondaryIndexFile: not a valid index file: " + fileName);
+    }
+    _begin = reinterpret_cast<Record const*>(static_cast<char const*>(_addr) + sizeof(Header));
+    _end = _begin + header->numRecords;
+    LOGS(_log, LOG_LVL_DEBUG, "Mapped " << size() << " records from " << _fileName);
+}
+
+SecondaryIndexFile::~SecondaryIndexFile() {
+    ::munmap(_addr, _size);
+}
+
+SecondaryIndexFile::Record const* SecondaryIndexFile::find(std::int64_t key) const {
+    Record const* rec = std::lower_bound(_begin, _end, key, keyLess);
+    if (rec == _end || rec->key != key) return nullptr;
+    return rec;
+}
+
+SecondaryIndexFile::Range SecondaryIndexFile::range(std::int64_t minKey, std::int64_t maxKey) const {
+    if (maxKey < minKey) return Range(_end, _end);
+    Record const* first = std::lower_bound(_begin, _end, minKey, keyLess);
+    Record const* last = std::upper_bound(first, _end, maxKey, lessKey);
+    return Range(first, last);
+}
+
+}}} // namespace lsst::qserv::qproc
@@ -0,0 +1,111 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QPROC_SECONDARYINDEXFILE_H
+#define LSST_QSERV_QPROC_SECONDARYINDEXFILE_H
+/**
+  * @file
+  *
+  * @brief Memory-mapped file-based secondary index
+  */
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace qproc {
+
+/**
+ *  SecondaryIndexFile provides read-only access to a secondary index
+ *  stored in a compact binary file which is mapped into memory. The file
+ *  is a 16-byte header (magic "QSIX", uint32 version, uint64 number of
+ *  records) followed by fixed-size records sorted by key. Point lookups
+ *  are binary searches over the mapping, so only the pages touched by
+ *  the search are ever read from disk.
+ *
+ *  All integers are stored in the host byte order.
+ */
+class SecondaryIndexFile {
+public:
+    typedef std::shared_ptr<SecondaryIndexFile> Ptr;
+
+    struct Record {
+        std::int64_t key;
+        std::int32_t chunkId;
+        std::int32_t subChunkId;
+    };
+
+    /// A range of records [first, second)
+    typedef std::pair<Record const*, Record const*> Range;
+
+    /**
+     *  Open and map an index file
+     *
+     *  @throws std::runtime_error if the file can't be open or it's not an index file
+     */
+    static Ptr open(std::string const& fileName);
+
+    /**
+     *  Write an index file. Records will be sorted by key.
+     *
+     *  @throws std::runtime_error if the file can't be written
+     */
+    static void write(std::string const& fileName, std::vector<Record> records);
+
+    SecondaryIndexFile(SecondaryIndexFile const&) = delete;
+    SecondaryIndexFile& operator=(SecondaryIndexFile const&) = delete;
+
+    ~SecondaryIndexFile();
+
+    std::string const& fileName() const { return _fileName; }
+
+    /// @return the number of records in the index
+    std::size_t size() const { return _end - _begin; }
+
+    /// @return a pointer to the record with the key, or nullptr if none
+    Record const* find(std::int64_t key) const;
+
+    /// @return records with keys in the closed interval [minKey, maxKey]
+    Range range(std::int64_t minKey, std::int64_t maxKey) const;
+
+    /// @return all records of the index
+    Range all() const { return Range(_begin, _end); }
+
+private:
+    SecondaryIndexFile(std::string const& fileName, void* addr, std::size_t length);
+
+    std::string const _fileName;
+    void* _addr;            ///< start of the mapping
+    std::size_t _size;      ///< length of the mapping
+    Record const* _begin;   ///< first record
+    Record const* _end;     ///< one past the last record
+};
+
+}}} // namespace lsst::qserv::qproc
+
+#endif // LSST_QSERV_QPROC_SECONDARYINDEXFILE_H
@@ -67,6 +67,13 @@ std::shared_ptr<proto::TaskMsg> TaskMsgFactory::_makeMsg(ChunkQuerySpec const& c
     taskMsg->set_queryid(queryId);
     taskMsg->set_jobid(jobId);
     taskMsg->set_attemptcount(attemptCount);
+    if (_trace) {
+        // Spans are collected per user query, so the query id is the trace id.
+        taskMsg->set_traceid(queryId);
+    }
+    for (auto const& op : _combineOps) {
+        taskMsg->add_combineop(op);
+    }
     // scanTables (for shared scans)
     // check if more than 1 db in scanInfo
     std::string db;
@@ -86,6 +93,11 @@ std::shared_ptr<proto::TaskMsg> TaskMsgFactory::_makeMsg(ChunkQuerySpec const& c
 
     // per-chunk
     taskMsg->set_chunkid(chunkQuerySpec.chunkId);
+    if (!chunkQuerySpec.semiJoinKeyQuery.empty()) {
+        auto semiJoin = taskMsg->mutable_semijoin();
+        semiJoin->set_column(chunkQuerySpec.semiJoinColumn);
+        semiJoin->set_keyquery(chunkQuerySpec.semiJoinKeyQuery);
+    }
     // per-fragment
     // TODO refactor to simplify
     if (chunkQuerySpec.nextFragment.get()) {
@@ -34,6 +34,8 @@
 // System headers
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 
 // Qserv headers
 #include "global/DbTable.h"
@@ -51,7 +53,12 @@ class TaskMsgFactory {
 public:
     using Ptr = std::shared_ptr<TaskMsgFactory>;
 
-    TaskMsgFactory(uint64_t session) : _session(session) {}
+    /// @param trace: if true, workers are asked to return trace spans
+    /// @param combineOps: how workers may combine result rows of different chunks,
+    ///                    see query::QueryContext::combineOps
+    TaskMsgFactory(uint64_t session, bool trace=false,
+                   std::vector<std::string> const& combineOps=std::vector<std::string>())
+        : _session(session), _trace(trace), _combineOps(combineOps) {}
     virtual ~TaskMsgFactory() {}
 
     /// Construct a TaskMsg and serialize it to a stream
@@ -71,6 +78,8 @@ private:
 
     /// All member variable need to be thread safe.
     uint64_t const _session;
+    bool const _trace;
+    std::vector<std::string> const _combineOps;
 };
 
 }}} // namespace lsst::qserv::qproc
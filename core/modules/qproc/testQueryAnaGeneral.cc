@@ -39,6 +39,7 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <utility>
 
 // Third-party headers
 #include "boost/algorithm/string.hpp"
@@ -48,6 +49,7 @@
 #include "boost/test/included/unit_test.hpp"
 
 // Qserv headers
+#include "global/constants.h"
 #include "parser/ParseException.h"
 #include "parser/SelectParser.h"
 #include "qdisp/ChunkMeta.h"
@@ -618,6 +620,22 @@ BOOST_AUTO_TEST_CASE(ArithTwoOp) {
     queryAnaHelper.buildQuerySession(qsTest, stmt);
 }
 
+BOOST_AUTO_TEST_CASE(ResultRowLimit) {
+    // Only LIMIT queries which accept rows from any chunk can stop early
+    std::pair<std::string, int> const cases[] = {
+        {"SELECT * FROM Object WHERE iRadius_SG between 0.02 AND 0.021 LIMIT 3;", 3},
+        {"SELECT rFlux FROM Object WHERE iFlux < 0.4 ;", lsst::qserv::NOTSET},
+        {"SELECT objectId FROM Object ORDER BY objectId LIMIT 3;", lsst::qserv::NOTSET},
+        {"SELECT count(*) FROM Object LIMIT 3;", lsst::qserv::NOTSET},
+        {"SELECT objectId, COUNT(sourceId) AS c FROM Source GROUP BY objectId LIMIT 10;",
+         lsst::qserv::NOTSET}
+    };
+    for (auto const& c : cases) {
+        std::shared_ptr<QuerySession> qs = queryAnaHelper.buildQuerySession(qsTest, c.first);
+        BOOST_CHECK_EQUAL(qs->getResultRowLimit(), c.second);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(FancyArith) {
     std::string stmt = "SELECT (1+f(one))/f2(two) FROM  Object where qserv_areaspec_box(0,0,1,1);";
     queryAnaHelper.buildQuerySession(qsTest, stmt);
@@ -765,7 +783,8 @@ BOOST_AUTO_TEST_CASE(FreeIndex) {
         "WHERE s.objectIdSourceTest=o.objectIdObjTest and o.objectIdObjTest = 430209694171136;";
     std::string expected = "SELECT s.ra,s.decl,o.foo "
         "FROM LSST.Source_100 AS s,LSST.Object_100 AS o "
-        "WHERE s.objectIdSourceTest=o.objectIdObjTest AND o.objectIdObjTest=430209694171136";
+        "WHERE /*qserv_semijoin*/ TRUE "
+        "AND s.objectIdSourceTest=o.objectIdObjTest AND o.objectIdObjTest=430209694171136";
 
     auto queries = queryAnaHelper.getInternalQueries(qsTest, stmt);
     BOOST_CHECK_EQUAL(queries[0], expected);
@@ -800,6 +819,35 @@ BOOST_AUTO_TEST_CASE(SpecIndexOn) {
     BOOST_CHECK_EQUAL(queries[0], expected);
 }
 
+BOOST_AUTO_TEST_CASE(SemiJoinOn) {
+    // Object cuts are pushed down to Source, but not out of an outer join.
+    std::string stmt = "SELECT s.ra, o.foo "
+        "FROM Object o JOIN Source s ON s.objectIdSourceTest = o.objectIdObjTest "
+        "WHERE o.foo > 1 AND s.ra < 2;";
+    std::string expected = "SELECT s.ra,o.foo "
+        "FROM LSST.Object_100 AS o "
+        "JOIN LSST.Source_100 AS s ON s.objectIdSourceTest=o.objectIdObjTest "
+        "WHERE /*qserv_semijoin*/ TRUE "
+        "AND o.foo>1 AND s.ra<2";
+    auto queries = queryAnaHelper.getInternalQueries(qsTest, stmt);
+    BOOST_CHECK_EQUAL(queries[0], expected);
+    auto qs = queryAnaHelper.querySession;
+    auto spec = qs->buildChunkQuerySpec(qs->makeQueryTemplates(), ChunkSpec::makeFake(100, false));
+    BOOST_CHECK_EQUAL(spec->semiJoinColumn, "s.objectIdSourceTest");
+    BOOST_CHECK_EQUAL(spec->semiJoinKeyQuery, "SELECT DISTINCT o.objectIdObjTest "
+        "FROM LSST.Object_100 AS o WHERE (o.foo>1)");
+
+    stmt = "SELECT s.ra, o.foo "
+        "FROM Object o LEFT JOIN Source s ON s.objectIdSourceTest = o.objectIdObjTest "
+        "WHERE o.foo > 1;";
+    expected = "SELECT s.ra,o.foo "
+        "FROM LSST.Object_100 AS o "
+        "LEFT OUTER JOIN LSST.Source_100 AS s ON s.objectIdSourceTest=o.objectIdObjTest "
+        "WHERE o.foo>1";
+    queries = queryAnaHelper.getInternalQueries(qsTest, stmt);
+    BOOST_CHECK_EQUAL(queries[0], expected);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 /// table JOIN table syntax
@@ -0,0 +1,145 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+ /**
+  * @file
+  *
+  * @brief Test QueryPlanCache.
+  */
+
+// System headers
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "css/CssAccess.h"
+#include "css/KvInterface.h"
+#include "mysql/MySqlConfig.h"
+#include "qproc/QueryPlanCache.h"
+#include "qproc/QuerySession.h"
+#include "query/QsRestrictor.h"
+#include "query/QueryContext.h"
+#include "tests/QueryAnaFixture.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE QueryPlanCache
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::qproc::QueryPlanCache;
+using lsst::qserv::qproc::QuerySession;
+using lsst::qserv::tests::QueryAnaFixture;
+
+BOOST_FIXTURE_TEST_SUITE(Suite, QueryAnaFixture)
+
+BOOST_AUTO_TEST_CASE(Shape) {
+    auto shape = QueryPlanCache::makeShape(
+        "SELECT  objectId, 'a''b' FROM Object_1 \n WHERE x > -5.0e3 AND `t 1`.y = \"2\" LIMIT 10 ;");
+    BOOST_CHECK_EQUAL(shape.text,
+        "SELECT objectId, ? FROM Object_1 WHERE x > -? AND `t 1`.y = \"2\" LIMIT 10");
+    std::vector<std::string> const literals = {"'a''b'", "5.0e3"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(shape.literals.begin(), shape.literals.end(),
+                                  literals.begin(), literals.end());
+    BOOST_CHECK_EQUAL(shape.parts.size(), 3U);
+
+    // Only literals and whitespace differ
+    BOOST_CHECK_EQUAL(QueryPlanCache::makeShape("select * from T where a=1 and b='x'").text,
+                      QueryPlanCache::makeShape("select *  from T where a=22 and b='yy';").text);
+    // LIMIT, hex and identifiers are part of the shape
+    BOOST_CHECK(QueryPlanCache::makeShape("select * from T limit 1").text !=
+                QueryPlanCache::makeShape("select * from T limit 2").text);
+    BOOST_CHECK_EQUAL(QueryPlanCache::makeShape("select 0x1F, 1e from T").text,
+                      "select 0x1F, 1e from T");
+}
+
+BOOST_AUTO_TEST_CASE(Plan) {
+    QueryPlanCache cache(qsTest.css, lsst::qserv::mysql::MySqlConfig(), 10, std::chrono::seconds(3600));
+    std::string const stmt = "SELECT * FROM Object WHERE someField > 5.0;";
+    BOOST_CHECK(cache.find(stmt, "LSST") == nullptr);
+    auto qs = queryAnaHelper.buildQuerySession(qsTest, stmt);
+    BOOST_REQUIRE(qs->getError().empty());
+    cache.insert(stmt, "LSST", qs);
+    BOOST_CHECK_EQUAL(cache.size(), 1U);
+
+    // Different default database is a different plan
+    BOOST_CHECK(cache.find(stmt, "") == nullptr);
+
+    auto cached = cache.find("SELECT * FROM Object WHERE someField > 7.5", "LSST");
+    BOOST_REQUIRE(cached != nullptr);
+    BOOST_CHECK_EQUAL(cached->getOriginal(), "SELECT * FROM Object WHERE someField > 7.5");
+    queryAnaHelper.querySession = cached;
+    BOOST_CHECK_EQUAL(queryAnaHelper.buildFirstParallelQuery(),
+                      "SELECT * FROM LSST.Object_100 AS QST_1_ WHERE someField>7.5");
+    BOOST_CHECK_EQUAL(cache.hits(), 1U);
+    BOOST_CHECK_EQUAL(cache.misses(), 2U);
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(Restrictor) {
+    QueryPlanCache cache(qsTest.css, lsst::qserv::mysql::MySqlConfig(), 10, std::chrono::seconds(3600));
+    std::string const stmt = "select * from Object where qserv_areaspec_box(0,0,1,1);";
+    auto qs = queryAnaHelper.buildQuerySession(qsTest, stmt);
+    BOOST_REQUIRE(qs->getError().empty());
+    cache.insert(stmt, "LSST", qs);
+
+    auto cached = cache.find("select * from Object where qserv_areaspec_box(2,3,4,5);", "LSST");
+    BOOST_REQUIRE(cached != nullptr);
+    auto const context = cached->dbgGetContext();
+    BOOST_REQUIRE(context->restrictors);
+    auto const& r = *context->restrictors->front();
+    std::vector<std::string> const params = {"2", "3", "4", "5"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(r._params.begin(), r._params.end(),
+                                  params.begin(), params.end());
+
+    // Neither the cached plan nor the sessions made from it are modified
+    auto other = cache.find("select * from Object where qserv_areaspec_box(6,7,8,9);", "LSST");
+    BOOST_REQUIRE(other != nullptr);
+    auto const& r1 = *other->dbgGetContext()->restrictors->front();
+    std::vector<std::string> const otherParams = {"6", "7", "8", "9"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(r1._params.begin(), r1._params.end(),
+                                  otherParams.begin(), otherParams.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(r._params.begin(), r._params.end(),
+                                  params.begin(), params.end());
+}
+
+BOOST_AUTO_TEST_CASE(CssChange) {
+    QueryPlanCache cache(qsTest.css, lsst::qserv::mysql::MySqlConfig(), 10, std::chrono::seconds(0));
+    std::string const stmt = "SELECT * FROM Object WHERE someField > 5.0;";
+    BOOST_CHECK(cache.find(stmt, "LSST") == nullptr);
+    auto qs = queryAnaHelper.buildQuerySession(qsTest, stmt);
+    BOOST_REQUIRE(qs->getError().empty());
+    cache.insert(stmt, "LSST", qs);
+    BOOST_CHECK(cache.find(stmt, "LSST") != nullptr);
+
+    // Partitioning changes without a change of the table status
+    qsTest.css->getKvI()->set("/DBS/LSST/TABLES/Object/partitioning/overlap", "0.5");
+    BOOST_CHECK(cache.find(stmt, "LSST") == nullptr);
+    BOOST_CHECK_EQUAL(cache.size(), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+ /**
+  * @file
+  *
+  * @brief Test SecondaryIndexCache and SecondaryIndexFile.
+  */
+
+// System headers
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Qserv headers
+#include "qproc/SecondaryIndexCache.h"
+#include "qproc/SecondaryIndexFile.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE SecondaryIndexCache
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::qproc::SecondaryIndexCache;
+using lsst::qserv::qproc::SecondaryIndexFile;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(CacheLookup) {
+    SecondaryIndexCache cache(3);
+    cache.insert("db__Object", {{1, {100, 1}}, {2, {100, 2}}});
+    cache.insert("db__Other", {{1, {200, 1}}});
+
+    SecondaryIndexCache::EntryVector found;
+    auto missing = cache.find("db__Object", {1, 2, 3}, found);
+    BOOST_CHECK_EQUAL(found.size(), 2U);
+    BOOST_CHECK_EQUAL(found[0].second.chunkId, 100);
+    BOOST_CHECK_EQUAL(found[1].second.subChunkId, 2);
+    BOOST_CHECK(missing == std::vector<std::int64_t>{3});
+    BOOST_CHECK_EQUAL(cache.hits(), 2U);
+    BOOST_CHECK_EQUAL(cache.misses(), 1U);
+
+    found.clear();
+    cache.find("db__Other", {1}, found);
+    BOOST_CHECK_EQUAL(found.size(), 1U);
+    BOOST_CHECK_EQUAL(found[0].second.chunkId, 200);
+}
+
+BOOST_AUTO_TEST_CASE(CacheEviction) {
+    SecondaryIndexCache cache(2);
+    cache.insert("t", {{1, {1, 1}}, {2, {2, 2}}});
+
+    // Touch key 1 so that key 2 becomes the least recently used one
+    SecondaryIndexCache::EntryVector found;
+    cache.find("t", {1}, found);
+    cache.insert("t", {{3, {3, 3}}});
+    BOOST_CHECK_EQUAL(cache.size(), 2U);
+
+    found.clear();
+    auto missing = cache.find("t", {1, 2, 3}, found);
+    BOOST_CHECK(missing == std::vector<std::int64_t>{2});
+
+    cache.clear("x");
+    BOOST_CHECK_EQUAL(cache.size(), 2U);
+    cache.clear("t");
+    BOOST_CHECK_EQUAL(cache.size(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(IndexFile) {
+    std::string const fileName = "/tmp/testSecondaryIndex_" + std::to_string(::getpid()) + ".idx";
+    std::vector<SecondaryIndexFile::Record> records;
+    for (std::int64_t key = 1000; key > 0; --key) {
+        records.push_back({key * 10, static_cast<std::int32_t>(key / 100),
+                           static_cast<std::int32_t>(key % 100)});
+    }
+    SecondaryIndexFile::write(fileName, records);
+    auto file = SecondaryIndexFile::open(fileName);
+    ::unlink(fileName.c_str());
+
+    BOOST_CHECK_EQUAL(file->size(), 1000U);
+    auto rec = file->find(4560);
+    BOOST_REQUIRE(rec != nullptr);
+    BOOST_CHECK_EQUAL(rec->chunkId, 4);
+    BOOST_CHECK_EQUAL(rec->subChunkId, 56);
+    BOOST_CHECK(file->find(4561) == nullptr);
+    BOOST_CHECK(file->find(0) == nullptr);
+
+    auto range = file->range(95, 131);
+    BOOST_CHECK_EQUAL(range.second - range.first, 4);
+    BOOST_CHECK_EQUAL(range.first->key, 100);
+    range = file->range(131, 95);
+    BOOST_CHECK(range.first == range.second);
+
+    BOOST_CHECK_THROW(SecondaryIndexFile::open(fileName), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
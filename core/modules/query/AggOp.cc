@@ -84,6 +84,7 @@ public:
         parallelExpr = ValueExpr::newSimple(orig.clone());
         parallelExpr->setAlias(interName);
         arp->parallel.push_back(parallelExpr);
+        arp->combine.push_back("SUM");
 
         fe = FuncExpr::newArg1("SUM", interName);
         vf = ValueFactor::newFuncFactor(fe);
@@ -118,6 +119,7 @@ public:
         parallelExpr = ValueExpr::newSimple(orig.clone());
         parallelExpr->setAlias(interName);
         arp->parallel.push_back(parallelExpr);
+        arp->combine.push_back(accName);
 
         fe = FuncExpr::newArg1(accName, interName);
         vf = ValueFactor::newFuncFactor(fe);
@@ -147,12 +149,14 @@ public:
         ve = ValueExpr::newSimple(ValueFactor::newFuncFactor(fe));
         ve->setAlias(cAlias);
         arp->parallel.push_back(ve);
+        arp->combine.push_back("SUM");
 
         std::string sAlias = _mgr.getAggName("SUM");
         fe = FuncExpr::newLike(*origVf->getFuncExpr(), "SUM");
         ve = ValueExpr::newSimple(ValueFactor::newFuncFactor(fe));
         ve->setAlias(sAlias);
         arp->parallel.push_back(ve);
+        arp->combine.push_back("SUM");
 
         std::shared_ptr<FuncExpr> feSum;
         std::shared_ptr<FuncExpr> feCount;
@@ -30,6 +30,9 @@
 #ifndef LSST_QSERV_QUERY_AGGRECORD_H
 #define LSST_QSERV_QUERY_AGGRECORD_H
 
+// System headers
+#include <string>
+#include <vector>
 
 // Local headers
 #include "query/ValueExpr.h"
@@ -58,6 +61,10 @@ public:
     /// ValueFactor representing merge step. Not a list, because the original
     /// wasn't a list and we want the final result to correspond.
     ValueFactorPtr merge;
+    /// How partial values of each 'parallel' expression from different chunks
+    /// combine into one (SUM, MIN or MAX), used by workers to pre-aggregate.
+    /// Empty if they can't be combined.
+    std::vector<std::string> combine;
     std::ostream& printTo(std::ostream& os);
 };
 
@@ -108,6 +108,16 @@ public:
 
     bool needsMerge{false}; ///< Does this query require a merge/post-processing step?
 
+    /// How workers may combine rows of the parallel queries of different chunks,
+    /// one entry per parallel select list column: "" for a grouping column,
+    /// otherwise SUM, MIN or MAX. Empty if rows can't be combined.
+    std::vector<std::string> combineOps;
+
+    /// The semi-join filter of the parallel queries, see proto::TaskMsg::SemiJoin.
+    /// The key query is a template of the chunk queries. Empty if there is none.
+    std::string semiJoinColumn;
+    std::string semiJoinKeyQuery;
+
     css::StripingParams getDbStriping() {
         return css->getDbStriping(dominantDb); }
     bool containsDb(std::string const& dbName) {
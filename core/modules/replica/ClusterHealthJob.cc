@@ -115,6 +115,26 @@ ClusterHealthJob::Ptr ClusterHealthJob::create(unsigned int timeoutSec,
     return ClusterHealthJob::Ptr(
         new ClusterHealthJob(timeoutSec,
                              allWorkers,
+                             allWorkers
+                                ? controller->serviceProvider()->config()->allWorkers()
+                                : controller->serviceProvider()->config()->workers(),
+                             controller,
+                             parentJobId,
+                             onFinish,
+                             options));
+}
+
+
+ClusterHealthJob::Ptr ClusterHealthJob::create(unsigned int timeoutSec,
+                                               vector<string> const& workers,
+                                               Controller::Ptr const& controller,
+                                               string const& parentJobId,
+                                               CallbackType const& onFinish,
+                                               Job::Options const& options) {
+    return ClusterHealthJob::Ptr(
+        new ClusterHealthJob(timeoutSec,
+                             false, /* allWorkers */
+                             workers,
                              controller,
                              parentJobId,
                              onFinish,
@@ -124,6 +144,7 @@ ClusterHealthJob::Ptr ClusterHealthJob::create(unsigned int timeoutSec,
 
 ClusterHealthJob::ClusterHealthJob(unsigned int timeoutSec,
                                    bool allWorkers,
+                                   vector<string> const& workers,
                                    Controller::Ptr const& controller,
                                    string const& parentJobId,
                                    CallbackType const& onFinish,
@@ -136,10 +157,9 @@ ClusterHealthJob::ClusterHealthJob(unsigned int timeoutSec,
                     ? controller->serviceProvider()->config()->controllerRequestTimeoutSec()
                     : timeoutSec),
         _allWorkers(allWorkers),
+        _workers(workers),
         _onFinish(onFinish),
-        _health(allWorkers
-                ? controller->serviceProvider()->config()->allWorkers()
-                : controller->serviceProvider()->config()->workers()) {
+        _health(workers) {
 }
 
 
@@ -158,6 +178,7 @@ list<pair<string,string>> ClusterHealthJob::extendedPersistentState() const {
     list<pair<string,string>> result;
     result.emplace_back("timeout_sec", to_string(timeoutSec()));
     result.emplace_back("all_workers", allWorkers() ? "1" : "0");
+    result.emplace_back("num_workers", to_string(workers().size()));
     return result;
 }
 
@@ -200,11 +221,7 @@ void ClusterHealthJob::startImpl(util::Lock const& lock) {
     // string to be sent to a worker.
     string const testData = "123";
 
-    auto workers = allWorkers()
-        ? controller()->serviceProvider()->config()->allWorkers()
-        : controller()->serviceProvider()->config()->workers();
-
-    for (auto const& worker: workers) {
+    for (auto const& worker: workers()) {
 
         auto const replicationRequest = controller()->statusOfWorkerService(
             worker,
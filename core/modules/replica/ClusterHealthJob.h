@@ -172,6 +172,21 @@ public:
                       CallbackType const& onFinish=nullptr,
                       Job::Options const& options=defaultOptions());
 
+    /**
+     * Create a job which sends probes to the specified workers only.
+     *
+     * @param workers
+     *   the names of workers to be probed
+     *
+     * @see ClusterHealthJob::create() for the rest of the parameters
+     */
+    static Ptr create(unsigned int timeoutSec,
+                      std::vector<std::string> const& workers,
+                      Controller::Ptr const& controller,
+                      std::string const& parentJobId=std::string(),
+                      CallbackType const& onFinish=nullptr,
+                      Job::Options const& options=defaultOptions());
+
     // Default construction and copy semantics are prohibited
 
     ClusterHealthJob() = delete;
@@ -187,6 +202,9 @@ public:
     /// @return 'true' if the job probes all known workers
     bool allWorkers() const { return _allWorkers; }
 
+    /// @return the names of workers to be probed
+    std::vector<std::string> const& workers() const { return _workers; }
+
     /**
      * @return
      *   The cluster summary report
@@ -218,6 +236,7 @@ private:
     /// @see ClusterHealthJob::create()
     ClusterHealthJob(unsigned int timeoutSec,
                      bool allWorkers,
+                     std::vector<std::string> const& workers,
                      Controller::Ptr const& controller,
                      std::string const& parentJobId,
                      CallbackType const& onFinish,
@@ -245,6 +264,7 @@ private:
 
     unsigned int const _timeoutSec;
     bool         const _allWorkers;
+    std::vector<std::string> const _workers;
     CallbackType       _onFinish;
 
     /// Requests sent to the Replication workers registered by their identifiers
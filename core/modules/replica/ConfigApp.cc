@@ -262,6 +262,9 @@ ConfigApp::ConfigApp(int argc, char* argv[])
     ::addCommandOption(updateGeneralCmd, _general.databaseServicesPoolSize);
     ::addCommandOption(updateGeneralCmd, _general.workerTechnology);
     ::addCommandOption(updateGeneralCmd, _general.workerNumProcessingThreads);
+    ::addCommandOption(updateGeneralCmd, _general.workerNumChecksumThreads);
+    ::addCommandOption(updateGeneralCmd, _general.workerNumMetadataThreads);
+    ::addCommandOption(updateGeneralCmd, _general.workerNumSqlThreads);
     ::addCommandOption(updateGeneralCmd, _general.fsNumProcessingThreads);
     ::addCommandOption(updateGeneralCmd, _general.workerFsBufferSizeBytes);
 
@@ -526,6 +529,18 @@ void ConfigApp::_dumpGeneralAsTable(string const& indent) const {
     value.      push_back(_general.workerNumProcessingThreads.str(_config));
     description.push_back(_general.workerNumProcessingThreads.description);
 
+    parameter.  push_back(_general.workerNumChecksumThreads.key);
+    value.      push_back(_general.workerNumChecksumThreads.str(_config));
+    description.push_back(_general.workerNumChecksumThreads.description);
+
+    parameter.  push_back(_general.workerNumMetadataThreads.key);
+    value.      push_back(_general.workerNumMetadataThreads.str(_config));
+    description.push_back(_general.workerNumMetadataThreads.description);
+
+    parameter.  push_back(_general.workerNumSqlThreads.key);
+    value.      push_back(_general.workerNumSqlThreads.str(_config));
+    description.push_back(_general.workerNumSqlThreads.description);
+
     parameter.  push_back(_general.fsNumProcessingThreads.key);
     value.      push_back(_general.fsNumProcessingThreads.str(_config));
     description.push_back(_general.fsNumProcessingThreads.description);
@@ -706,6 +721,9 @@ int ConfigApp::_updateGeneral() {
         _general.databaseServicesPoolSize   .save(_config);
         _general.workerTechnology           .save(_config);
         _general.workerNumProcessingThreads .save(_config);
+        _general.workerNumChecksumThreads   .save(_config);
+        _general.workerNumMetadataThreads   .save(_config);
+        _general.workerNumSqlThreads        .save(_config);
         _general.fsNumProcessingThreads     .save(_config);
         _general.workerFsBufferSizeBytes    .save(_config);
     } catch (exception const& ex) {
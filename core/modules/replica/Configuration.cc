@@ -187,6 +187,9 @@ uint16_t     const Configuration::defaultXrootdPort                   = 1094;
 unsigned int const Configuration::defaultXrootdTimeoutSec             = 3600;
 string       const Configuration::defaultWorkerTechnology             = "TEST";
 size_t       const Configuration::defaultWorkerNumProcessingThreads   = 1;
+size_t       const Configuration::defaultWorkerNumChecksumThreads     = 1;
+size_t       const Configuration::defaultWorkerNumMetadataThreads     = 1;
+size_t       const Configuration::defaultWorkerNumSqlThreads          = 1;
 size_t       const Configuration::defaultFsNumProcessingThreads       = 1;
 size_t       const Configuration::defaultWorkerFsBufferSizeBytes      = 1048576;
 string       const Configuration::defaultWorkerSvcHost                = "localhost";
@@ -254,6 +257,9 @@ Configuration::Configuration()
         _xrootdTimeoutSec           (defaultXrootdTimeoutSec),
         _workerTechnology           (defaultWorkerTechnology),
         _workerNumProcessingThreads (defaultWorkerNumProcessingThreads),
+        _workerNumChecksumThreads   (defaultWorkerNumChecksumThreads),
+        _workerNumMetadataThreads   (defaultWorkerNumMetadataThreads),
+        _workerNumSqlThreads        (defaultWorkerNumSqlThreads),
         _fsNumProcessingThreads     (defaultFsNumProcessingThreads),
         _workerFsBufferSizeBytes    (defaultWorkerFsBufferSizeBytes),
         _databaseTechnology         (defaultDatabaseTechnology),
@@ -479,6 +485,9 @@ string Configuration::asString() const {
     ss << context() << "defaultXrootdTimeoutSec:              " << defaultXrootdTimeoutSec << "\n";
     ss << context() << "defaultWorkerTechnology:              " << defaultWorkerTechnology << "\n";
     ss << context() << "defaultWorkerNumProcessingThreads:    " << defaultWorkerNumProcessingThreads << "\n";
+    ss << context() << "defaultWorkerNumChecksumThreads:      " << defaultWorkerNumChecksumThreads << "\n";
+    ss << context() << "defaultWorkerNumMetadataThreads:      " << defaultWorkerNumMetadataThreads << "\n";
+    ss << context() << "defaultWorkerNumSqlThreads:           " << defaultWorkerNumSqlThreads << "\n";
     ss << context() << "defaultFsNumProcessingThreads:        " << defaultFsNumProcessingThreads << "\n";
     ss << context() << "defaultWorkerFsBufferSizeBytes:       " << defaultWorkerFsBufferSizeBytes << "\n";
     ss << context() << "defaultWorkerSvcHost:                 " << defaultWorkerSvcHost << "\n";
@@ -521,6 +530,9 @@ string Configuration::asString() const {
     ss << context() << "_xrootdTimeoutSec:                    " << _xrootdTimeoutSec << "\n";
     ss << context() << "_workerTechnology:                    " << _workerTechnology << "\n";
     ss << context() << "_workerNumProcessingThreads:          " << _workerNumProcessingThreads << "\n";
+    ss << context() << "_workerNumChecksumThreads:            " << _workerNumChecksumThreads << "\n";
+    ss << context() << "_workerNumMetadataThreads:            " << _workerNumMetadataThreads << "\n";
+    ss << context() << "_workerNumSqlThreads:                 " << _workerNumSqlThreads << "\n";
     ss << context() << "_fsNumProcessingThreads:              " << _fsNumProcessingThreads << "\n";
     ss << context() << "_workerFsBufferSizeBytes:             " << _workerFsBufferSizeBytes << "\n";
     ss << context() << "_databaseTechnology:                  " << _databaseTechnology << "\n";
@@ -962,13 +962,34 @@ public:
     virtual void setWorkerTechnology(std::string const& val) = 0;
 
 
-    /// @return the number of request processing threads in each worker service
+    /// @return the number of threads processing the replica creation requests in each worker service
     size_t workerNumProcessingThreads() const { return _workerNumProcessingThreads; }
 
     /// @param val  the new value of the parameter
     virtual void setWorkerNumProcessingThreads(size_t val) = 0;
 
 
+    /// @return the number of threads processing the replica lookup requests computing check/control sums of files in each worker service
+    size_t workerNumChecksumThreads() const { return _workerNumChecksumThreads; }
+
+    /// @param val  the new value of the parameter
+    virtual void setWorkerNumChecksumThreads(size_t val) = 0;
+
+
+    /// @return the number of threads processing the replica lookup, deletion and test requests in each worker service
+    size_t workerNumMetadataThreads() const { return _workerNumMetadataThreads; }
+
+    /// @param val  the new value of the parameter
+    virtual void setWorkerNumMetadataThreads(size_t val) = 0;
+
+
+    /// @return the number of threads processing the database queries in each worker service
+    size_t workerNumSqlThreads() const { return _workerNumSqlThreads; }
+
+    /// @param val  the new value of the parameter
+    virtual void setWorkerNumSqlThreads(size_t val) = 0;
+
+
     /// @return the number of request processing threads in each worker's file service
     size_t fsNumProcessingThreads() const { return _fsNumProcessingThreads; }
 
@@ -1020,6 +1041,9 @@ protected:
     static unsigned int const defaultXrootdTimeoutSec;
     static std::string  const defaultWorkerTechnology;
     static size_t       const defaultWorkerNumProcessingThreads;
+    static size_t       const defaultWorkerNumChecksumThreads;
+    static size_t       const defaultWorkerNumMetadataThreads;
+    static size_t       const defaultWorkerNumSqlThreads;
     static size_t       const defaultFsNumProcessingThreads;
     static size_t       const defaultWorkerFsBufferSizeBytes;
     static std::string  const defaultWorkerSvcHost;
@@ -1130,6 +1154,9 @@ protected:
     std::string  _workerTechnology;
 
     size_t _workerNumProcessingThreads;
+    size_t _workerNumChecksumThreads;
+    size_t _workerNumMetadataThreads;
+    size_t _workerNumSqlThreads;
     size_t _fsNumProcessingThreads;
     size_t _workerFsBufferSizeBytes;
 
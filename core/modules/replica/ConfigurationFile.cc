@@ -107,6 +107,9 @@ string ConfigurationFile::dump2init(Configuration::Ptr const& config) {
         << "\n"
         << "technology                 = " << config->workerTechnology() << "\n"
         << "num_svc_processing_threads = " << config->workerNumProcessingThreads() << "\n"
+        << "num_svc_checksum_threads   = " << config->workerNumChecksumThreads() << "\n"
+        << "num_svc_metadata_threads   = " << config->workerNumMetadataThreads() << "\n"
+        << "num_svc_sql_threads        = " << config->workerNumSqlThreads() << "\n"
         << "num_fs_processing_threads  = " << config->fsNumProcessingThreads() << "\n"
         << "fs_buf_size_bytes          = " << config->workerFsBufferSizeBytes() << "\n"
         << "svc_host                   = " << defaultWorkerSvcHost << "\n"
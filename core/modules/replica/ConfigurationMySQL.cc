@@ -118,6 +118,9 @@ string ConfigurationMySQL::dump2init(Configuration::Ptr const& config) {
     ::configInsert(str, "xrootd",     "request_timeout_sec",        config->xrootdTimeoutSec());
     ::configInsert(str, "worker",     "technology",                 config->workerTechnology());
     ::configInsert(str, "worker",     "num_svc_processing_threads", config->workerNumProcessingThreads());
+    ::configInsert(str, "worker",     "num_svc_checksum_threads",   config->workerNumChecksumThreads());
+    ::configInsert(str, "worker",     "num_svc_metadata_threads",   config->workerNumMetadataThreads());
+    ::configInsert(str, "worker",     "num_svc_sql_threads",        config->workerNumSqlThreads());
     ::configInsert(str, "worker",     "num_fs_processing_threads",  config->fsNumProcessingThreads());
     ::configInsert(str, "worker",     "fs_buf_size_bytes",          config->workerFsBufferSizeBytes());
     ::configInsert(str, "worker",     "svc_host",                   defaultWorkerSvcHost);
@@ -1051,6 +1054,9 @@ void ConfigurationMySQL::_loadConfigurationImpl(util::Lock const& lock,
 
         ::tryParameter(row, "worker", "technology",                 _workerTechnology) or
         ::tryParameter(row, "worker", "num_svc_processing_threads", _workerNumProcessingThreads) or
+        ::tryParameter(row, "worker", "num_svc_checksum_threads",   _workerNumChecksumThreads) or
+        ::tryParameter(row, "worker", "num_svc_metadata_threads",   _workerNumMetadataThreads) or
+        ::tryParameter(row, "worker", "num_svc_sql_threads",        _workerNumSqlThreads) or
         ::tryParameter(row, "worker", "num_fs_processing_threads",  _fsNumProcessingThreads) or
         ::tryParameter(row, "worker", "fs_buf_size_bytes",          _workerFsBufferSizeBytes) or
         ::tryParameter(row, "worker", "svc_port",                   commonWorkerSvcPort)  or
@@ -265,6 +265,30 @@ public:
              val);
     }
 
+    /// @see Configuration::setWorkerNumChecksumThreads()
+    void setWorkerNumChecksumThreads(size_t val) final {
+        _set(_workerNumChecksumThreads,
+             "worker",
+             "num_svc_checksum_threads",
+             val);
+    }
+
+    /// @see Configuration::setWorkerNumMetadataThreads()
+    void setWorkerNumMetadataThreads(size_t val) final {
+        _set(_workerNumMetadataThreads,
+             "worker",
+             "num_svc_metadata_threads",
+             val);
+    }
+
+    /// @see Configuration::setWorkerNumSqlThreads()
+    void setWorkerNumSqlThreads(size_t val) final {
+        _set(_workerNumSqlThreads,
+             "worker",
+             "num_svc_sql_threads",
+             val);
+    }
+
     /// @see Configuration::setFsNumProcessingThreads()
     void setFsNumProcessingThreads(size_t val) final {
         _set(_fsNumProcessingThreads,
@@ -511,6 +511,9 @@ void ConfigurationStore::_loadConfiguration(util::ConfigStore const& configStore
 
     ::parseKeyVal(configStore, "worker.technology",                 _workerTechnology,             defaultWorkerTechnology);
     ::parseKeyVal(configStore, "worker.num_svc_processing_threads", _workerNumProcessingThreads,   defaultWorkerNumProcessingThreads);
+    ::parseKeyVal(configStore, "worker.num_svc_checksum_threads",   _workerNumChecksumThreads,     defaultWorkerNumChecksumThreads);
+    ::parseKeyVal(configStore, "worker.num_svc_metadata_threads",   _workerNumMetadataThreads,     defaultWorkerNumMetadataThreads);
+    ::parseKeyVal(configStore, "worker.num_svc_sql_threads",        _workerNumSqlThreads,          defaultWorkerNumSqlThreads);
     ::parseKeyVal(configStore, "worker.num_fs_processing_threads",  _fsNumProcessingThreads,       defaultFsNumProcessingThreads);
     ::parseKeyVal(configStore, "worker.fs_buf_size_bytes",          _workerFsBufferSizeBytes,      defaultWorkerFsBufferSizeBytes);
 
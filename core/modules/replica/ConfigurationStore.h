@@ -163,6 +163,15 @@ public:
     /// @see Configuration::setWorkerNumProcessingThreads()
     void setWorkerNumProcessingThreads(size_t val) final { _set(_workerNumProcessingThreads, val); }
 
+    /// @see Configuration::setWorkerNumChecksumThreads()
+    void setWorkerNumChecksumThreads(size_t val) final { _set(_workerNumChecksumThreads, val); }
+
+    /// @see Configuration::setWorkerNumMetadataThreads()
+    void setWorkerNumMetadataThreads(size_t val) final { _set(_workerNumMetadataThreads, val); }
+
+    /// @see Configuration::setWorkerNumSqlThreads()
+    void setWorkerNumSqlThreads(size_t val) final { _set(_workerNumSqlThreads, val); }
+
     /// @see Configuration::setFsNumProcessingThreads()
     void setFsNumProcessingThreads(size_t val) final { _set(_fsNumProcessingThreads, val); }
 
@@ -76,6 +76,9 @@ json ConfigurationGeneralParams::toJson(Configuration::Ptr const& config) const
     result.push_back(::paramToJson(qservMasterDatabaseServicesPoolSize, config));
     result.push_back(::paramToJson(workerTechnology,            config));
     result.push_back(::paramToJson(workerNumProcessingThreads,  config));
+    result.push_back(::paramToJson(workerNumChecksumThreads,    config));
+    result.push_back(::paramToJson(workerNumMetadataThreads,    config));
+    result.push_back(::paramToJson(workerNumSqlThreads,         config));
     result.push_back(::paramToJson(fsNumProcessingThreads,      config));
     result.push_back(::paramToJson(workerFsBufferSizeBytes,     config));
 
@@ -462,7 +462,8 @@ struct ConfigurationGeneralParams {
     struct {
 
         std::string const key         = "WORKER_NUM_PROC_THREADS";
-        std::string const description = "The number of request processing threads in each worker service.";
+        std::string const description = "The number of threads processing the replica creation requests"
+                                        " in each worker service.";
         size_t            value;
 
         bool const updatable = true;
@@ -475,6 +476,57 @@ struct ConfigurationGeneralParams {
 
     } workerNumProcessingThreads;
 
+    struct {
+
+        std::string const key         = "WORKER_NUM_CHECKSUM_THREADS";
+        std::string const description = "The number of threads processing the replica lookup requests computing check/control sums of files"
+                                        " in each worker service.";
+        size_t            value;
+
+        bool const updatable = true;
+
+        void save(Configuration::Ptr const& config) {
+            if (value != 0) config->setWorkerNumChecksumThreads(value);
+        }
+        size_t      get(Configuration::Ptr const& config) const { return config->workerNumChecksumThreads(); }
+        std::string str(Configuration::Ptr const& config) const { return std::to_string(get(config)); }
+
+    } workerNumChecksumThreads;
+
+    struct {
+
+        std::string const key         = "WORKER_NUM_METADATA_THREADS";
+        std::string const description = "The number of threads processing the replica lookup, deletion and test requests"
+                                        " in each worker service.";
+        size_t            value;
+
+        bool const updatable = true;
+
+        void save(Configuration::Ptr const& config) {
+            if (value != 0) config->setWorkerNumMetadataThreads(value);
+        }
+        size_t      get(Configuration::Ptr const& config) const { return config->workerNumMetadataThreads(); }
+        std::string str(Configuration::Ptr const& config) const { return std::to_string(get(config)); }
+
+    } workerNumMetadataThreads;
+
+    struct {
+
+        std::string const key         = "WORKER_NUM_SQL_THREADS";
+        std::string const description = "The number of threads processing the database queries"
+                                        " in each worker service.";
+        size_t            value;
+
+        bool const updatable = true;
+
+        void save(Configuration::Ptr const& config) {
+            if (value != 0) config->setWorkerNumSqlThreads(value);
+        }
+        size_t      get(Configuration::Ptr const& config) const { return config->workerNumSqlThreads(); }
+        std::string str(Configuration::Ptr const& config) const { return std::to_string(get(config)); }
+
+    } workerNumSqlThreads;
+
     struct {
 
         std::string const key         = "WORKER_FS_NUM_PROC_THREADS";
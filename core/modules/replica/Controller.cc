@@ -478,11 +478,13 @@ SqlRequest::Ptr Controller::sql(std::string const& workerName,
                                 std::string const& user,
                                 std::string const& password,
                                 uint64_t maxRows,
+                                uint64_t pageSize,
                                 SqlRequestCallbackType const& onFinish,
                                 int  priority,
                                 bool keepTracking,
                                 std::string const& jobId,
-                                unsigned int requestExpirationIvalSec) {
+                                unsigned int requestExpirationIvalSec,
+                                SqlRequestPageCallbackType const& onPage) {
 
     LOGS(_log, LOG_LVL_DEBUG, _context(__func__));
 
@@ -500,12 +502,14 @@ SqlRequest::Ptr Controller::sql(std::string const& workerName,
         user,
         password,
         maxRows,
+        pageSize,
         [controller] (SqlRequest::Ptr request) {
             controller->_finish(request->id());
         },
         priority,
         keepTracking,
-        serviceProvider()->messenger()
+        serviceProvider()->messenger(),
+        onPage
     );
 
     // Register the request (along with its callback) by its unique
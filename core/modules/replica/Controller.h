@@ -157,11 +157,13 @@ public:
                       std::string const& user,
                       std::string const& password,
                       uint64_t maxRows,
+                      uint64_t pageSize,
                       SqlRequestCallbackType const& onFinish=nullptr,
                       int  priority=0,
                       bool keepTracking=true,
                       std::string const& jobId="",
-                      unsigned int requestExpirationIvalSec=0);
+                      unsigned int requestExpirationIvalSec=0,
+                      SqlRequestPageCallbackType const& onPage=nullptr);
 
     StopReplicationRequestPtr stopReplication(std::string const& workerName,
                                               std::string const& targetRequestId,
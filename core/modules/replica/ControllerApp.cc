@@ -303,6 +303,13 @@ ControllerApp::ControllerApp(int argc, char* argv[])
         " be enforced.",
         _sqlMaxRows);
 
+    sqlCmd.option(
+        "result-page-size",
+        "The number of rows in each page of the result set pulled from the worker while"
+        " the query is still being executed. If a value of the parameter is set to 0 then"
+        " the whole result set is sent by the worker upon the completion of the query.",
+        _sqlResultPageSize);
+
     sqlCmd.option(
         "tables-page-size",
         "The number of rows in the table of a query result set (0 means no pages).",
@@ -441,6 +448,7 @@ int ControllerApp::runImpl() {
             _sqlUser,
             _sqlPassword,
             _sqlMaxRows,
+            _sqlResultPageSize,
             [&] (SqlRequest::Ptr const& ptr_) {
                 ::printRequest(ptr_,
                                ptr_->responseData(),
@@ -116,6 +116,10 @@ private:
     /// of 0 won't enforce any such limit.
     uint64_t _sqlMaxRows = 0;
 
+    /// The number of rows in each page of the result set pulled from the worker
+    /// (0 means the whole result set is sent in one response)
+    uint64_t _sqlResultPageSize = 0;
+
     /// The number of rows in the table of a query result set (0 means no pages)
     size_t _sqlPageSize = 20;
 
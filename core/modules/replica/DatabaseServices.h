@@ -388,6 +388,37 @@ public:
     virtual void saveState(Request const& request,
                            Performance const& performance) = 0;
 
+    /**
+     * Save the states of many jobs and requests in a single transaction.
+     * The entries which don't exist yet are added along with their extended
+     * attributes, the states of the existing ones are updated.
+     *
+     * @param jobs
+     *   the states of jobs (parent jobs are expected to be found before
+     *   their children)
+     *
+     * @param jobHeartbeats
+     *   the heartbeat times of jobs by the job identifiers
+     *
+     * @param requests
+     *   the states of requests (their jobs must be already saved, or they
+     *   must be found in the collection of jobs)
+     *
+     * @throws database::mysql::Error
+     *   if the transaction failed, nothing gets saved then
+     */
+    virtual void saveState(std::vector<JobInfo> const& jobs,
+                           std::map<std::string, uint64_t> const& jobHeartbeats,
+                           std::vector<RequestInfo> const& requests) = 0;
+
+    /**
+     * @return
+     *   the counters of the queue of the states of jobs and requests which
+     *   are waiting to be saved (an empty object if the states are saved
+     *   as they're reported)
+     */
+    virtual nlohmann::json stateQueueInfo() = 0;
+
     /**
      * Update a state of a target request.
      *
@@ -463,6 +494,27 @@ public:
                                     size_t maxReplicas=1,
                                     bool enabledWorkersOnly=true) = 0;
 
+    /**
+     * Locate replicas of a worker which have the oldest verification
+     * timestamps. Populate a collection with up to the 'maxReplicas'
+     * if any found.
+     *
+     * @param replicas
+     *   collection of replicas (if any found)
+     *
+     * @param worker
+     *   the name of a worker
+     *
+     * @param maxReplicas
+     *   maximum number of replicas to be returned
+     *
+     * @throw std::invalid_argument
+     *   if maxReplicas is 0
+     */
+    virtual void findOldestWorkerReplicas(std::vector<ReplicaInfo>& replicas,
+                                          std::string const& worker,
+                                          size_t maxReplicas=1) = 0;
+
     /**
      * Find all replicas for the specified chunk and the database.
      *
@@ -492,6 +544,19 @@ public:
                               std::string const& database,
                               bool enabledWorkersOnly=true) = 0;
 
+    /**
+     * Find all replicas of all databases at all workers in a single read.
+     * The method is meant for building in-memory indexes of the replica
+     * placement (see class ReplicaIndex).
+     *
+     * @param replicas
+     *   collection of replicas (if any found)
+     *
+     * @throws database::mysql::Error
+     *   if the replicas couldn't be read
+     */
+    virtual void findAllReplicas(std::vector<ReplicaInfo>& replicas) = 0;
+
     /**
      * Find all replicas for the specified worker and a database (or all
      * databases if no specific one is requested).
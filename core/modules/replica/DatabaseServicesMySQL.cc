@@ -29,6 +29,7 @@
 #include <limits>
 #include <stdexcept>
 #include <list>
+#include <set>
 
 // Qserv headers
 #include "lsst/log/Log.h"
@@ -64,6 +65,43 @@ bool in(Request::ExtendedState val,
     return col.end() != find(col.begin(), col.end(), val);
 }
 
+
+/**
+ * Find which identifiers are already used in a table. The identifiers are
+ * looked up in groups to limit the length of the queries.
+ *
+ * @param conn   the connection (the transaction is expected to be open)
+ * @param table  the name of a table whose primary key is 'id'
+ * @param ids    the identifiers to be looked up
+ *
+ * @return the identifiers found in the table
+ */
+set<string> existingIds(database::mysql::Connection::Ptr const& conn,
+                        string const& table,
+                        vector<string> const& ids) {
+
+    size_t const maxIdsPerQuery = 1000;
+
+    set<string> result;
+    for (size_t begin = 0; begin < ids.size(); begin += maxIdsPerQuery) {
+        string values;
+        for (size_t i = begin, end = min(ids.size(), begin + maxIdsPerQuery); i < end; ++i) {
+            values += (values.empty() ? "" : ",") + conn->sqlValue(ids[i]);
+        }
+        conn->execute(
+            "SELECT " + conn->sqlId("id") + " FROM " + conn->sqlId(table) +
+            "  WHERE " + conn->sqlId("id") + " IN (" + values + ")");
+
+        database::mysql::Row row;
+        while (conn->next(row)) {
+            string id;
+            row.get("id", id);
+            result.insert(id);
+        }
+    }
+    return result;
+}
+
 } /// namespace
 
 namespace lsst {
@@ -414,6 +452,126 @@ void DatabaseServicesMySQL::saveState(Request const& request,
 }
 
 
+void DatabaseServicesMySQL::saveState(vector<JobInfo> const& jobs,
+                                      map<string, uint64_t> const& jobHeartbeats,
+                                      vector<RequestInfo> const& requests) {
+
+    string const context = "DatabaseServicesMySQL::" + string(__func__) + "[Batch] ";
+
+    LOGS(_log, LOG_LVL_DEBUG, context << "jobs: " << jobs.size()
+         << " jobHeartbeats: " << jobHeartbeats.size() << " requests: " << requests.size());
+
+    util::Lock lock(_mtx, context);
+
+    vector<string> jobIds;
+    for (auto&& job: jobs) jobIds.push_back(job.id);
+
+    vector<string> requestIds;
+    for (auto&& request: requests) requestIds.push_back(request.id);
+
+    // The entries which are already in the database are updated, others
+    // are inserted. The extended states are only recorded along with
+    // the new entries.
+
+    try {
+        _conn->execute(
+            [&](decltype(_conn) conn) {
+                conn->begin();
+
+                set<string> const existingJobIds = ::existingIds(conn, "job", jobIds);
+                for (auto&& job: jobs) {
+                    if (existingJobIds.count(job.id)) {
+                        conn->executeSimpleUpdateQuery(
+                            "job",
+                            conn->sqlEqual("id",          job.id),
+                            make_pair("state",            job.state),
+                            make_pair("ext_state",        job.extendedState),
+                            make_pair("begin_time",       job.beginTime),
+                            make_pair("end_time",         job.endTime));
+                        continue;
+                    }
+                    conn->executeInsertQuery(
+                        "job",
+                        job.id,
+                        job.controllerId,
+                        conn->nullIfEmpty(job.parentJobId),
+                        job.type,
+                        job.state,
+                        job.extendedState,
+                        job.beginTime,
+                        job.endTime,
+                        job.heartbeatTime,
+                        job.priority,
+                        job.exclusive,
+                        job.preemptable);
+                    for (auto&& entry: job.kvInfo) {
+                        conn->executeInsertQuery(
+                            "job_ext",
+                            job.id,
+                            entry.first,
+                            entry.second);
+                    }
+                }
+                for (auto&& entry: jobHeartbeats) {
+                    conn->executeSimpleUpdateQuery(
+                        "job",
+                        conn->sqlEqual("id",        entry.first),
+                        make_pair("heartbeat_time", entry.second));
+                }
+                set<string> const existingRequestIds = ::existingIds(conn, "request", requestIds);
+                for (auto&& request: requests) {
+                    if (existingRequestIds.count(request.id)) {
+                        conn->executeSimpleUpdateQuery(
+                            "request",
+                            conn->sqlEqual("id",        request.id),
+                            make_pair("state",          request.state),
+                            make_pair("ext_state",      request.extendedState),
+                            make_pair("server_status",  request.serverStatus),
+                            make_pair("c_create_time",  request.controllerCreateTime),
+                            make_pair("c_start_time",   request.controllerStartTime),
+                            make_pair("w_receive_time", request.workerReceiveTime),
+                            make_pair("w_start_time",   request.workerStartTime),
+                            make_pair("w_finish_time",  request.workerFinishTime),
+                            make_pair("c_finish_time",  request.controllerFinishTime));
+                        continue;
+                    }
+                    conn->executeInsertQuery(
+                        "request",
+                        request.id,
+                        request.jobId,
+                        request.name,
+                        request.worker,
+                        request.priority,
+                        request.state,
+                        request.extendedState,
+                        request.serverStatus,
+                        request.controllerCreateTime,
+                        request.controllerStartTime,
+                        request.workerReceiveTime,
+                        request.workerStartTime,
+                        request.workerFinishTime,
+                        request.controllerFinishTime);
+                    for (auto&& entry: request.kvInfo) {
+                        conn->executeInsertQuery(
+                            "request_ext",
+                            request.id,
+                            entry.first,
+                            entry.second);
+                    }
+                }
+                conn->commit();
+            }
+        );
+
+    } catch (database::mysql::Error const& ex) {
+        LOGS(_log, LOG_LVL_ERROR, context << "failed, exception: " << ex.what());
+        if (_conn->inTransaction()) _conn->rollback();
+        throw;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, context + "** DONE **");
+}
+
+
 void DatabaseServicesMySQL::updateRequestState(Request const& request,
                                                string const& targetRequestId,
                                                Performance const& targetRequestPerformance) {
@@ -745,6 +903,44 @@ void DatabaseServicesMySQL::findOldestReplicas(vector<ReplicaInfo>& replicas,
 }
 
 
+void DatabaseServicesMySQL::findOldestWorkerReplicas(vector<ReplicaInfo>& replicas,
+                                                     string const& worker,
+                                                     size_t maxReplicas) {
+
+    string const context =
+         "DatabaseServicesMySQL::" + string(__func__) + " worker=" + worker + " ";
+
+    util::Lock lock(_mtx, context);
+
+    LOGS(_log, LOG_LVL_DEBUG, context);
+
+    if (not maxReplicas) {
+        throw invalid_argument(context + "maxReplicas is not allowed to be 0");
+    }
+    try {
+        _conn->execute(
+            [&](decltype(_conn) conn) {
+                conn->begin();
+                _findReplicasImpl(
+                    lock,
+                    replicas,
+                    "SELECT * FROM " + conn->sqlId("replica") +
+                    " WHERE "        + conn->sqlEqual("worker", worker) +
+                    " ORDER BY "     + conn->sqlId("verify_time") +
+                    " ASC LIMIT "    + to_string(maxReplicas)
+                );
+                conn->rollback();
+            }
+        );
+    } catch (database::mysql::Error const& ex) {
+        LOGS(_log, LOG_LVL_ERROR, context << "failed, exception: " << ex.what());
+        if (_conn->inTransaction()) _conn->rollback();
+        throw;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, context << "** DONE ** replicas.size(): " << replicas.size());
+}
+
+
 void DatabaseServicesMySQL::findReplicas(vector<ReplicaInfo>& replicas,
                                          unsigned int chunk,
                                          string const& database,
@@ -785,6 +981,34 @@ void DatabaseServicesMySQL::findReplicas(vector<ReplicaInfo>& replicas,
 }
 
 
+void DatabaseServicesMySQL::findAllReplicas(vector<ReplicaInfo>& replicas) {
+
+    string const context = "DatabaseServicesMySQL::" + string(__func__) + " ";
+
+    LOGS(_log, LOG_LVL_DEBUG, context);
+
+    util::Lock lock(_mtx, context);
+
+    try {
+        _conn->execute(
+            [&](decltype(_conn) conn) {
+                conn->begin();
+                _findReplicasImpl(
+                    lock,
+                    replicas,
+                    "SELECT * FROM " + conn->sqlId("replica"));
+                conn->rollback();
+            }
+        );
+    } catch (database::mysql::Error const& ex) {
+        LOGS(_log, LOG_LVL_ERROR, context << "failed, exception: " << ex.what());
+        if (_conn->inTransaction()) _conn->rollback();
+        throw;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, context << "** DONE ** replicas.size(): " << replicas.size());
+}
+
+
 void DatabaseServicesMySQL::findWorkerReplicas(vector<ReplicaInfo>& replicas,
                                                string const& worker,
                                                string const& database) {
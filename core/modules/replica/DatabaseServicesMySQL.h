@@ -89,6 +89,14 @@ public:
     void saveState(Request const& request,
                    Performance const& performance) final;
 
+    /// @see DatabaseServices::saveState()
+    void saveState(std::vector<JobInfo> const& jobs,
+                   std::map<std::string, uint64_t> const& jobHeartbeats,
+                   std::vector<RequestInfo> const& requests) final;
+
+    /// @see DatabaseServices::stateQueueInfo()
+    nlohmann::json stateQueueInfo() final { return nlohmann::json::object(); }
+
     /// @see DatabaseServices::updateRequestState()
     void updateRequestState(Request const& request,
                             std::string const& targetRequestId,
@@ -107,12 +115,20 @@ public:
                             size_t maxReplicas,
                             bool enabledWorkersOnly) final;
 
+    /// @see DatabaseServices::findOldestWorkerReplicas()
+    void findOldestWorkerReplicas(std::vector<ReplicaInfo>& replicas,
+                                  std::string const& worker,
+                                  size_t maxReplicas) final;
+
     /// @see DatabaseServices::findReplicas()
     void findReplicas(std::vector<ReplicaInfo>& replicas,
                       unsigned int chunk,
                       std::string const& database,
                       bool enabledWorkersOnly) final;
 
+    /// @see DatabaseServices::findAllReplicas()
+    void findAllReplicas(std::vector<ReplicaInfo>& replicas) final;
+
     /// @see DatabaseServices::findWorkerReplicas()
     void findWorkerReplicas(std::vector<ReplicaInfo>& replicas,
                             std::string const& worker,
@@ -23,18 +23,37 @@
 #include "replica/DatabaseServicesPool.h"
 
 // System headers
+#include <algorithm>
+#include <chrono>
 #include <stdexcept>
 
 // Qserv headers
 #include "lsst/log/Log.h"
+#include "replica/Common.h"
 #include "replica/Configuration.h"
+#include "replica/Controller.h"
+#include "replica/DatabaseMySQLExceptions.h"
+#include "replica/Performance.h"
+#include "replica/QservMgtRequest.h"
+#include "replica/Request.h"
 
 using namespace std;
+using json = nlohmann::json;
 
 namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.DatabaseServicesPool");
 
+/// The maximum number of states of jobs and requests waiting to be written
+size_t const maxStateQueueSize = 100000;
+
+/// The maximum time to wait before reading the states of jobs and requests
+/// for the queued states to be written
+unsigned int const flushTimeoutSec = 30;
+
+/// The delay before writing the states again after a failed attempt
+unsigned int const retryDelaySec = 1;
+
 } /// namespace
 
 namespace lsst {
@@ -83,17 +102,83 @@ private:
 // == DatabaseServicesPool ==
 // ==========================
 
-DatabaseServicesPool::Ptr DatabaseServicesPool::create(Configuration::Ptr const& configuration) {
-    return DatabaseServicesPool::Ptr(new DatabaseServicesPool(configuration));
+bool DatabaseServicesPool::StateQueue::add(JobInfo const& info) {
+    auto const itr = jobIdx.find(info.id);
+    if (itr != jobIdx.end()) {
+        jobs[itr->second] = info;
+        return true;
+    }
+    jobIdx[info.id] = jobs.size();
+    jobs.push_back(info);
+    return false;
+}
+
+
+bool DatabaseServicesPool::StateQueue::add(string const& jobId,
+                                           uint64_t heartbeatTime) {
+    auto const itr = jobHeartbeats.find(jobId);
+    if (itr != jobHeartbeats.end()) {
+        itr->second = max(itr->second, heartbeatTime);
+        return true;
+    }
+    jobHeartbeats[jobId] = heartbeatTime;
+    return false;
+}
+
+
+bool DatabaseServicesPool::StateQueue::add(RequestInfo const& info) {
+    auto const itr = requestIdx.find(info.id);
+    if (itr != requestIdx.end()) {
+        requests[itr->second] = info;
+        return true;
+    }
+    requestIdx[info.id] = requests.size();
+    requests.push_back(info);
+    return false;
+}
+
+
+void DatabaseServicesPool::StateQueue::add(StateQueue const& queue) {
+    for (auto&& info: queue.jobs) add(info);
+    for (auto&& entry: queue.jobHeartbeats) add(entry.first, entry.second);
+    for (auto&& info: queue.requests) add(info);
 }
 
 
-DatabaseServicesPool::DatabaseServicesPool(Configuration::Ptr const& configuration)
-    :   DatabaseServices() {
+bool DatabaseServicesPool::StateQueue::has(string const& jobId,
+                                           string const& requestId) const {
+    return (not jobId.empty() and jobIdx.count(jobId) != 0) or
+           (not requestId.empty() and requestIdx.count(requestId) != 0);
+}
+
+
+DatabaseServicesPool::Ptr DatabaseServicesPool::create(Configuration::Ptr const& configuration,
+                                                       ReplicaIndex::Ptr const& replicaIndex) {
+    return DatabaseServicesPool::Ptr(new DatabaseServicesPool(configuration,
+                                                              replicaIndex));
+}
+
+
+DatabaseServicesPool::DatabaseServicesPool(Configuration::Ptr const& configuration,
+                                           ReplicaIndex::Ptr const& replicaIndex)
+    :   DatabaseServices(),
+        _configuration(configuration),
+        _replicaIndex(replicaIndex) {
 
     for (size_t i = 0; i < configuration->databaseServicesPoolSize(); ++i) {
         _availableServices.push_back(DatabaseServices::create(configuration));
     }
+    _writer = thread(&DatabaseServicesPool::_writeStates, this);
+}
+
+
+DatabaseServicesPool::~DatabaseServicesPool() {
+    {
+        unique_lock<mutex> lock(_stateMtx);
+        _stopWriter = true;
+    }
+    _stateQueued.notify_one();
+    _writer.join();
 }
 
 
@@ -108,15 +193,33 @@ void DatabaseServicesPool::saveState(ControllerIdentity const& identity,
 void DatabaseServicesPool::saveState(Job const& job,
                                       Job::Options const& options) {
 
-    ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
-    service()->saveState(job, options);
+    // The state is captured now since the job may change before it's written
+
+    JobInfo info;
+    info.id            = job.id();
+    info.controllerId  = job.controller()->identity().id;
+    info.parentJobId   = job.parentJobId();
+    info.type          = job.type();
+    info.state         = Job::state2string(job.state());
+    info.extendedState = Job::state2string(job.extendedState());
+    info.beginTime     = job.beginTime();
+    info.endTime       = job.endTime();
+    info.heartbeatTime = PerformanceUtils::now();
+    info.priority      = options.priority;
+    info.exclusive     = options.exclusive;
+    info.preemptable   = options.preemptable;
+    info.kvInfo        = job.extendedPersistentState();
+
+    _queueState([&info](StateQueue& queue) { return queue.add(info); });
 }
 
 
 void DatabaseServicesPool::updateHeartbeatTime(Job const& job) {
 
-    ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
-    service()->updateHeartbeatTime(job);
+    string const id = job.id();
+    uint64_t const heartbeatTime = PerformanceUtils::now();
+
+    _queueState([&id, heartbeatTime](StateQueue& queue) { return queue.add(id, heartbeatTime); });
 }
 
 
@@ -124,16 +227,110 @@ void DatabaseServicesPool::saveState(QservMgtRequest const& request,
                                       Performance const& performance,
                                       string const& serverError) {
 
-    ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
-    service()->saveState(request, performance, serverError);
+    string const context = "DatabaseServicesPool::" + string(__func__) + "[QservMgtRequest] ";
+
+    // Requests which haven't started yet or the ones which aren't associated
+    // with any job should be ignored.
+
+    RequestInfo info;
+    try {
+        info.jobId = request.jobId();
+    } catch (logic_error const&) {
+        LOGS(_log, LOG_LVL_DEBUG, context
+             << "ignoring the request which hasn't yet started, id=" << request.id());
+        return;
+    }
+    if (info.jobId.empty()) {
+        LOGS(_log, LOG_LVL_DEBUG, context
+             << "ignoring the request with no job set, id=" << request.id());
+        return;
+    }
+    info.id                   = request.id();
+    info.name                 = request.type();
+    info.worker               = request.worker();
+    info.priority             = 0;
+    info.state                = QservMgtRequest::state2string(request.state());
+    info.extendedState        = QservMgtRequest::state2string(request.extendedState());
+    info.serverStatus         = serverError;
+    info.controllerCreateTime = performance.c_create_time;
+    info.controllerStartTime  = performance.c_start_time;
+    info.workerReceiveTime    = performance.w_receive_time;
+    info.workerStartTime      = performance.w_start_time;
+    info.workerFinishTime     = performance.w_finish_time;
+    info.controllerFinishTime = performance.c_finish_time;
+    info.kvInfo               = request.extendedPersistentState();
+
+    _queueState([&info](StateQueue& queue) { return queue.add(info); });
 }
 
 
 void DatabaseServicesPool::saveState(Request const& request,
                                      Performance const& performance) {
 
+    string const context = "DatabaseServicesPool::" + string(__func__) + "[Request] ";
+
+    // Requests which haven't started yet or the ones which aren't associated
+    // with any job should be ignored.
+
+    RequestInfo info;
+    try {
+        info.jobId = request.jobId();
+    } catch (logic_error const&) {
+        LOGS(_log, LOG_LVL_DEBUG, context
+             << "ignoring the request which hasn't yet started, id=" << request.id());
+        return;
+    }
+    if (info.jobId.empty()) {
+        LOGS(_log, LOG_LVL_DEBUG, context
+             << "ignoring the request with no job set, id=" << request.id());
+        return;
+    }
+    info.id                   = request.id();
+    info.name                 = request.type();
+    info.worker               = request.worker();
+    info.priority             = request.priority();
+    info.state                = Request::state2string(request.state());
+    info.extendedState        = Request::state2string(request.extendedState());
+    info.serverStatus         = status2string(request.extendedServerStatus());
+    info.controllerCreateTime = performance.c_create_time;
+    info.controllerStartTime  = performance.c_start_time;
+    info.workerReceiveTime    = performance.w_receive_time;
+    info.workerStartTime      = performance.w_start_time;
+    info.workerFinishTime     = performance.w_finish_time;
+    info.controllerFinishTime = performance.c_finish_time;
+    info.kvInfo               = request.extendedPersistentState();
+
+    _queueState([&info](StateQueue& queue) { return queue.add(info); });
+}
+
+
+void DatabaseServicesPool::saveState(vector<JobInfo> const& jobs,
+                                     map<string, uint64_t> const& jobHeartbeats,
+                                     vector<RequestInfo> const& requests) {
+
     ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
-    service()->saveState(request, performance);
+    service()->saveState(jobs, jobHeartbeats, requests);
+}
+
+
+json DatabaseServicesPool::stateQueueInfo() {
+
+    unique_lock<mutex> lock(_stateMtx);
+
+    json info;
+    info["size"]                = _stateQueue.size();
+    info["max_size"]            = maxStateQueueSize;
+    info["high_water_mark"]     = _maxStateQueueSize;
+    info["num_queued"]          = _numQueuedStates;
+    info["num_written"]         = _numWrittenStates;
+    info["num_merged"]          = _numMergedStates;
+    info["num_batches"]         = _numBatches;
+    info["num_failed_batches"]  = _numFailedBatches;
+    info["num_dropped"]         = _numDroppedStates;
+    info["num_blocked_callers"] = _numBlockedCallers;
+    info["last_batch_size"]     = _lastBatchSize;
+    info["last_batch_time_ms"]  = _lastBatchTimeMs;
+    return info;
 }
 
 
@@ -141,6 +338,10 @@ void DatabaseServicesPool::updateRequestState(Request const& request,
                                               string const& targetRequestId,
                                               Performance const& targetRequestPerformance) {
 
+    // The queued state of the target request would overwrite the update
+
+    _flushStates("DatabaseServicesPool::" + string(__func__), string(), targetRequestId);
+
     ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
     service()->updateRequestState(
         request,
@@ -154,6 +355,8 @@ void DatabaseServicesPool::saveReplicaInfo(ReplicaInfo const& info) {
 
     ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
     service()->saveReplicaInfo(info);
+
+    if (nullptr != _replicaIndex) _replicaIndex->update(info);
 }
 
 
@@ -165,6 +368,10 @@ void DatabaseServicesPool::saveReplicaInfoCollection(string const& worker,
     service()->saveReplicaInfoCollection(worker,
                                          database,
                                          newReplicaInfoCollection);
+
+    if (nullptr != _replicaIndex) {
+        _replicaIndex->update(worker, database, newReplicaInfoCollection);
+    }
 }
 
 
@@ -179,6 +386,17 @@ void DatabaseServicesPool::findOldestReplicas(vector<ReplicaInfo>& replicas,
 }
 
 
+void DatabaseServicesPool::findOldestWorkerReplicas(vector<ReplicaInfo>& replicas,
+                                                    string const& worker,
+                                                    size_t maxReplicas) {
+
+    ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
+    service()->findOldestWorkerReplicas(replicas,
+                                        worker,
+                                        maxReplicas);
+}
+
+
 void DatabaseServicesPool::findReplicas(vector<ReplicaInfo>& replicas,
                                         unsigned int chunk,
                                         string const& database,
@@ -192,6 +410,13 @@ void DatabaseServicesPool::findReplicas(vector<ReplicaInfo>& replicas,
 }
 
 
+void DatabaseServicesPool::findAllReplicas(vector<ReplicaInfo>& replicas) {
+
+    ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
+    service()->findAllReplicas(replicas);
+}
+
+
 void DatabaseServicesPool::findWorkerReplicas(vector<ReplicaInfo>& replicas,
                                               string const& worker,
                                               string const& database) {
@@ -228,6 +453,13 @@ map<unsigned int, size_t> DatabaseServicesPool::actualReplicationLevel(
                                     string const& database,
                                     vector<string> const& workersToExclude) {
 
+    if (nullptr != _replicaIndex and _replicaIndex->loaded()) {
+        _assertKnown("DatabaseServicesPool::" + string(__func__) + " database=" + database + " ",
+                     database,
+                     workersToExclude);
+        return _replicaIndex->actualReplicationLevel(database,
+                                                     workersToExclude);
+    }
     ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
     return service()->actualReplicationLevel(database,
                                              workersToExclude);
@@ -237,6 +469,23 @@ map<unsigned int, size_t> DatabaseServicesPool::actualReplicationLevel(
 size_t DatabaseServicesPool::numOrphanChunks(string const& database,
                                              vector<string> const& uniqueOnWorkers) {
 
+    if (nullptr != _replicaIndex and _replicaIndex->loaded()) {
+        _assertKnown("DatabaseServicesPool::" + string(__func__) + " database=" + database + " ",
+                     database,
+                     uniqueOnWorkers);
+        // Same as the query of DatabaseServicesMySQL::numOrphanChunks()
+        vector<string> otherWorkers;
+        for (auto&& worker: _configuration->allWorkers()) {
+            if (uniqueOnWorkers.end() == find(uniqueOnWorkers.begin(),
+                                               uniqueOnWorkers.end(),
+                                               worker)) {
+                otherWorkers.push_back(worker);
+            }
+        }
+        return _replicaIndex->numOrphanChunks(database,
+                                              uniqueOnWorkers,
+                                              otherWorkers);
+    }
     ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
     return service()->numOrphanChunks(database,
                                       uniqueOnWorkers);
@@ -245,6 +494,9 @@ size_t DatabaseServicesPool::numOrphanChunks(string const& database,
 
 void DatabaseServicesPool::logControllerEvent(ControllerEvent const& event) {
 
+    // Events refer to the jobs and requests which must be already saved
+
+    _flushStates("DatabaseServicesPool::" + string(__func__), event.jobId, event.requestId);
     ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
     service()->logControllerEvent(event);
 }
@@ -281,6 +533,7 @@ list<ControllerInfo> DatabaseServicesPool::controllers(uint64_t fromTimeStamp,
 
 
 RequestInfo DatabaseServicesPool::request(string const& id) {
+    _flushStates("DatabaseServicesPool::" + string(__func__));
     ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
     return service()->request(id);
 }
@@ -290,6 +543,7 @@ list<RequestInfo> DatabaseServicesPool::requests(string const& jobId,
                                                  uint64_t fromTimeStamp,
                                                  uint64_t toTimeStamp,
                                                  size_t maxEntries) {
+    _flushStates("DatabaseServicesPool::" + string(__func__));
     ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
     return service()->requests(jobId,
                                fromTimeStamp,
@@ -299,6 +553,7 @@ list<RequestInfo> DatabaseServicesPool::requests(string const& jobId,
 
 
 JobInfo DatabaseServicesPool::job(string const& id) {
+    _flushStates("DatabaseServicesPool::" + string(__func__));
     ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
     return service()->job(id);
 }
@@ -309,6 +564,7 @@ list<JobInfo> DatabaseServicesPool::jobs(string const& controllerId,
                                          uint64_t fromTimeStamp,
                                          uint64_t toTimeStamp,
                                          size_t maxEntries) {
+    _flushStates("DatabaseServicesPool::" + string(__func__));
     ServiceAllocator service(shared_from_base<DatabaseServicesPool>());
     return service()->jobs(controllerId,
                            parentJobId,
@@ -326,10 +582,10 @@ DatabaseServices::Ptr DatabaseServicesPool::_allocateService() {
 
     unique_lock<mutex> lock(_mtx);
 
-    auto self = shared_from_base<DatabaseServicesPool>();
+    // The pool isn't shared when the states are written by the destructor
 
-    _available.wait(lock, [self]() {
-        return not self->_availableServices.empty();
+    _available.wait(lock, [this]() {
+        return not _availableServices.empty();
     });
     
     // Get the next request and move it between queues.
@@ -373,4 +629,225 @@ void DatabaseServicesPool::_releaseService(DatabaseServices::Ptr const& service)
     _available.notify_one();
 }
 
+
+void DatabaseServicesPool::_queueState(function<bool(StateQueue&)> const& add) {
+
+    unique_lock<mutex> lock(_stateMtx);
+
+    if (_stateQueue.size() >= maxStateQueueSize) {
+        ++_numBlockedCallers;
+        _stateDequeued.wait(lock, [this]() {
+            return _stateQueue.size() < maxStateQueueSize;
+        });
+    }
+    if (add(_stateQueue)) ++_numMergedStates;
+    ++_numQueuedStates;
+    _maxStateQueueSize = max(_maxStateQueueSize, _stateQueue.size());
+
+    lock.unlock();
+    _stateQueued.notify_one();
+}
+
+
+void DatabaseServicesPool::_flushStates(string const& context) {
+
+    unique_lock<mutex> lock(_stateMtx);
+
+    uint64_t const numQueuedStates = _numQueuedStates;
+    bool const written = _stateWritten.wait_for(lock, chrono::seconds(flushTimeoutSec), [&]() {
+        return _numWrittenStates >= numQueuedStates;
+    });
+    if (not written) {
+        LOGS(_log, LOG_LVL_WARN, context << "  the queued states of jobs and requests"
+             << " weren't written in " << flushTimeoutSec << " seconds");
+    }
+}
+
+
+void DatabaseServicesPool::_flushStates(string const& context,
+                                        string const& jobId,
+                                        string const& requestId) {
+
+    unique_lock<mutex> lock(_stateMtx);
+
+    bool const written = _stateWritten.wait_for(lock, chrono::seconds(flushTimeoutSec), [&]() {
+        return not (_stateQueue.has(jobId, requestId) or _stateBatch.has(jobId, requestId));
+    });
+    if (not written) {
+        LOGS(_log, LOG_LVL_WARN, context << "  the queued states of job '" << jobId
+             << "' or request '" << requestId << "' weren't written in "
+             << flushTimeoutSec << " seconds");
+    }
+}
+
+
+void DatabaseServicesPool::_writeStates() {
+
+    string const context = "DatabaseServicesPool::" + string(__func__) + "  ";
+
+    unique_lock<mutex> lock(_stateMtx);
+
+    while (true) {
+        _stateQueued.wait(lock, [this]() {
+            return _stopWriter or _stateQueue.size() > 0;
+        });
+        if (_stateQueue.size() == 0) break;
+
+        // The states which are reported while the batch is being written
+        // are collected by the emptied queue
+
+        swap(_stateBatch, _stateQueue);
+        StateQueue const& batch = _stateBatch;
+        uint64_t const numQueuedStates = _numQueuedStates;
+
+        lock.unlock();
+        _stateDequeued.notify_all();
+
+        // Only the batches which failed due to the lost connections to the database
+        // are written again. If a batch fails for another reason, such as a state
+        // which can't be stored, its states are written one at a time.
+
+        uint64_t const beginTime = PerformanceUtils::now();
+        bool success = true;
+        bool retry = false;
+        size_t numDropped = 0;
+        try {
+            auto const service = _allocateService();
+            try {
+                try {
+                    service->saveState(batch.jobs, batch.jobHeartbeats, batch.requests);
+                } catch (database::mysql::ConnectError const&) {
+                    throw;
+                } catch (database::mysql::ConnectTimeout const&) {
+                    throw;
+                } catch (database::mysql::MaxReconnectsExceeded const&) {
+                    throw;
+                } catch (exception const& ex) {
+                    LOGS(_log, LOG_LVL_ERROR, context << "failed to write " << batch.size()
+                         << " states, writing them one at a time, exception: " << ex.what());
+                    success = false;
+                    numDropped = _writeEachState(*service, batch, context);
+                }
+            } catch (...) {
+                _releaseService(service);
+                throw;
+            }
+            _releaseService(service);
+        } catch (database::mysql::ConnectError const& ex) {
+            LOGS(_log, LOG_LVL_ERROR, context << "failed to write " << batch.size()
+                 << " states, exception: " << ex.what());
+            success = false;
+            retry = true;
+        } catch (database::mysql::ConnectTimeout const& ex) {
+            LOGS(_log, LOG_LVL_ERROR, context << "failed to write " << batch.size()
+                 << " states, exception: " << ex.what());
+            success = false;
+            retry = true;
+        } catch (database::mysql::MaxReconnectsExceeded const& ex) {
+            LOGS(_log, LOG_LVL_ERROR, context << "failed to write " << batch.size()
+                 << " states, exception: " << ex.what());
+            success = false;
+            retry = true;
+        } catch (exception const& ex) {
+            LOGS(_log, LOG_LVL_ERROR, context << "failed to write " << batch.size()
+                 << " states, exception: " << ex.what());
+            success = false;
+            numDropped = batch.size();
+        }
+        uint64_t const endTime = PerformanceUtils::now();
+
+        lock.lock();
+
+        ++_numBatches;
+        _lastBatchSize   = batch.size();
+        _lastBatchTimeMs = endTime - beginTime;
+
+        if (not success) {
+            ++_numFailedBatches;
+            if (retry and not _stopWriter) {
+
+                // Put the states back in front of the ones reported since then,
+                // and try again after a delay
+
+                _stateBatch.add(_stateQueue);
+                swap(_stateBatch, _stateQueue);
+                _stateBatch = StateQueue();
+                _stateQueued.wait_for(lock, chrono::seconds(retryDelaySec), [this]() {
+                    return _stopWriter;
+                });
+                continue;
+            }
+            if (retry) numDropped = batch.size();
+            if (numDropped != 0) {
+                LOGS(_log, LOG_LVL_ERROR, context << "dropping " << numDropped
+                     << " states of jobs and requests");
+            }
+            _numDroppedStates += numDropped;
+        }
+        _stateBatch = StateQueue();
+        _numWrittenStates = numQueuedStates;
+        _stateWritten.notify_all();
+    }
+}
+
+
+size_t DatabaseServicesPool::_writeEachState(DatabaseServices& service,
+                                             StateQueue const& batch,
+                                             string const& context) {
+
+    // Connection errors are passed to the caller, other errors only drop
+    // the state which caused them. Jobs go first since the requests refer to them.
+
+    size_t numDropped = 0;
+    auto const write = [&](string const& what, function<void()> const& save) {
+        try {
+            save();
+        } catch (database::mysql::ConnectError const&) {
+            throw;
+        } catch (database::mysql::ConnectTimeout const&) {
+            throw;
+        } catch (database::mysql::MaxReconnectsExceeded const&) {
+            throw;
+        } catch (exception const& ex) {
+            LOGS(_log, LOG_LVL_ERROR, context << "dropping the state of " << what
+                 << ", exception: " << ex.what());
+            ++numDropped;
+        }
+    };
+    map<string, uint64_t> const noHeartbeats;
+    vector<JobInfo> const noJobs;
+    vector<RequestInfo> const noRequests;
+    for (auto&& info: batch.jobs) {
+        write("job " + info.id, [&]() {
+            service.saveState(vector<JobInfo>(1, info), noHeartbeats, noRequests);
+        });
+    }
+    for (auto&& entry: batch.jobHeartbeats) {
+        write("the heartbeat of job " + entry.first, [&]() {
+            service.saveState(noJobs, map<string, uint64_t>{entry}, noRequests);
+        });
+    }
+    for (auto&& info: batch.requests) {
+        write("request " + info.id, [&]() {
+            service.saveState(noJobs, noHeartbeats, vector<RequestInfo>(1, info));
+        });
+    }
+    return numDropped;
+}
+
+
+void DatabaseServicesPool::_assertKnown(string const& context,
+                                        string const& database,
+                                        vector<string> const& workers) const {
+
+    if (not _configuration->isKnownDatabase(database)) {
+        throw invalid_argument(context + "unknown database");
+    }
+    for (auto&& worker: workers) {
+        if (not _configuration->isKnownWorker(worker)) {
+            throw invalid_argument(context + "unknown worker: " + worker);
+        }
+    }
+}
+
 }}} // namespace lsst::qserv::replica
@@ -29,11 +29,17 @@
 
 // System headers
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <list>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
 
 // Qserv headers
 #include "replica/DatabaseServices.h"
+#include "replica/ReplicaIndex.h"
 
 // This header declarations
 namespace lsst {
@@ -43,6 +49,17 @@ namespace replica {
 /**
   * Class DatabaseServicesPool is a pool of service objects.
   *
+  * The states of jobs and requests (including the heartbeats of jobs) aren't
+  * saved by the callers. They're put into a write-behind queue instead, where
+  * the states reported for the same job or request are merged, so that only
+  * the latest one is saved. The queue is written in batches (one transaction
+  * per batch) by a dedicated thread. The callers are blocked if the queue is
+  * full. The queue is written before reading the states of jobs and requests.
+  * Logging an event, or updating the state of a request, only waits for
+  * the states of the job and the request it refers to if they're queued.
+  * If a batch fails for a reason other than a lost connection to the database,
+  * its states are written one at a time, and only the failing ones are dropped.
+  *
   * @see class DatabaseServices
   */
 class DatabaseServicesPool : public DatabaseServices {
@@ -62,10 +79,18 @@ public:
      * @param configuration
      *   the configuration service
      *
+     * @param replicaIndex
+     *   (optional) the index of replicas to be kept current with the replicas
+     *   saved through the pool. Once the index is loaded the replication levels
+     *   and the numbers of orphan chunks are computed from the index. Replicas
+     *   saved by other processes don't reach the index, the results may be
+     *   off while the command line job tools are changing the replicas.
+     *
      * @return
      *   pointer to the created object
      */
-    static Ptr create(ConfigurationPtr const& configuration);
+    static Ptr create(ConfigurationPtr const& configuration,
+                      ReplicaIndex::Ptr const& replicaIndex=nullptr);
 
     // Default construction and copy semantics are prohibited
 
@@ -73,7 +98,8 @@ public:
     DatabaseServicesPool(DatabaseServicesPool const&) = delete;
     DatabaseServicesPool& operator=(DatabaseServicesPool const&) = delete;
 
-    ~DatabaseServicesPool() override = default;
+    /// Write the queued states of jobs and requests, then stop the thread
+    ~DatabaseServicesPool() override;
 
     /// @see DatabaseServices::saveState()
     void saveState(ControllerIdentity const& identity,
@@ -95,6 +121,14 @@ public:
     void saveState(Request const& request,
                    Performance const& performance) final;
 
+    /// @see DatabaseServices::saveState()
+    void saveState(std::vector<JobInfo> const& jobs,
+                   std::map<std::string, uint64_t> const& jobHeartbeats,
+                   std::vector<RequestInfo> const& requests) final;
+
+    /// @see DatabaseServices::stateQueueInfo()
+    nlohmann::json stateQueueInfo() final;
+
     /// @see DatabaseServices::updateRequestState()
     void updateRequestState(Request const& request,
                             std::string const& targetRequestId,
@@ -113,12 +147,20 @@ public:
                             size_t maxReplicas,
                             bool enabledWorkersOnly) final;
 
+    /// @see DatabaseServices::findOldestWorkerReplicas()
+    void findOldestWorkerReplicas(std::vector<ReplicaInfo>& replicas,
+                                  std::string const& worker,
+                                  size_t maxReplicas) final;
+
     /// @see DatabaseServices::findReplicas()
     void findReplicas(std::vector<ReplicaInfo>& replicas,
                       unsigned int chunk,
                       std::string const& database,
                       bool enabledWorkersOnly) final;
 
+    /// @see DatabaseServices::findAllReplicas()
+    void findAllReplicas(std::vector<ReplicaInfo>& replicas) final;
+
     /// @see DatabaseServices::findWorkerReplicas()
     void findWorkerReplicas(std::vector<ReplicaInfo>& replicas,
                             std::string const& worker,
@@ -180,13 +222,50 @@ public:
                             size_t maxEntries) final;
 
 private:
+
+    /// The states of jobs and requests waiting to be saved. The states are
+    /// kept in the order in which the jobs and requests were first reported.
+    struct StateQueue {
+
+        std::vector<JobInfo> jobs;
+        std::map<std::string, size_t> jobIdx;
+
+        std::map<std::string, uint64_t> jobHeartbeats;
+
+        std::vector<RequestInfo> requests;
+        std::map<std::string, size_t> requestIdx;
+
+        /// @return the total number of the states
+        size_t size() const { return jobs.size() + jobHeartbeats.size() + requests.size(); }
+
+        /// Add or replace the state of a job. @return 'true' if replaced.
+        bool add(JobInfo const& info);
+
+        /// Add or replace the heartbeat of a job. @return 'true' if replaced.
+        bool add(std::string const& jobId, uint64_t heartbeatTime);
+
+        /// Add or replace the state of a request. @return 'true' if replaced.
+        bool add(RequestInfo const& info);
+
+        /// Add (replace) all states of another queue after the ones of this queue
+        void add(StateQueue const& queue);
+
+        /// @return 'true' if the queue has the state of the job or of the request,
+        ///   empty identifiers are ignored
+        bool has(std::string const& jobId, std::string const& requestId) const;
+    };
+
     /**
      * Construct the object.
      *
      * @param configuration
      *   the configuration service
+     *
+     * @param replicaIndex
+     *   the index of replicas (if any)
      */
-    explicit DatabaseServicesPool(ConfigurationPtr const& configuration);
+    DatabaseServicesPool(ConfigurationPtr const& configuration,
+                         ReplicaIndex::Ptr const& replicaIndex);
 
     /**
      * Allocate the next available service object.
@@ -214,6 +293,94 @@ private:
      */
     void _releaseService(DatabaseServices::Ptr const& service);
 
+    /**
+     * Validate parameters of the replica placement queries in the same way
+     * as the database services do.
+     *
+     * @param context
+     *   the context of the query for error reporting
+     *
+     * @param database
+     *   the name of a database
+     *
+     * @param workers
+     *   the names of workers
+     *
+     * @throws std::invalid_argument
+     *   if the database or any of the workers is unknown
+     */
+    void _assertKnown(std::string const& context,
+                      std::string const& database,
+                      std::vector<std::string> const& workers) const;
+
+    /**
+     * Wait until there is room in the queue of the states, then add a state
+     * to the queue.
+     *
+     * @param add
+     *   the function adding the state, it returns 'true' if the state
+     *   replaced an earlier one
+     */
+    void _queueState(std::function<bool(StateQueue&)> const& add);
+
+    /**
+     * Wait until the states which were queued before calling the method
+     * are written (or until the timeout expires).
+     *
+     * @param context
+     *   the context of the operation for logging
+     */
+    void _flushStates(std::string const& context);
+
+    /**
+     * Wait until the states of a job and of a request are written (or until
+     * the timeout expires). The method doesn't wait if neither of them is queued.
+     *
+     * @param context
+     *   the context of the operation for logging
+     *
+     * @param jobId
+     *   the identifier of a job (ignored if empty)
+     *
+     * @param requestId
+     *   the identifier of a request (ignored if empty)
+     */
+    void _flushStates(std::string const& context,
+                      std::string const& jobId,
+                      std::string const& requestId);
+
+    /// Write the queued states in batches until the pool gets destroyed
+    void _writeStates();
+
+    /**
+     * Write the states of a batch one at a time, the ones which can't
+     * be written are dropped.
+     *
+     * @param service
+     *   the service for writing the states
+     *
+     * @param batch
+     *   the states to be written
+     *
+     * @param context
+     *   the context of the operation for logging
+     *
+     * @return
+     *   the number of the dropped states
+     *
+     * @throws database::mysql::ConnectError
+     *   (and other exceptions reporting the lost connections to the database)
+     *   for the whole batch to be written again
+     */
+    size_t _writeEachState(DatabaseServices& service,
+                           StateQueue const& batch,
+                           std::string const& context);
+
+    /// The configuration service
+    ConfigurationPtr const _configuration;
+
+    /// The index of replicas (if any)
+    ReplicaIndex::Ptr const _replicaIndex;
 
     /// Service objects which are available
     std::list<DatabaseServices::Ptr> _availableServices;
@@ -229,6 +396,44 @@ private:
     /// The condition variable for notifying clients waiting for the next
     /// available service.
     std::condition_variable _available;
+
+    /// The queue of the states of jobs and requests waiting to be written
+    StateQueue _stateQueue;
+
+    /// The states being written by the writer thread. The collection is only
+    /// modified by the writer thread while holding the mutex.
+    StateQueue _stateBatch;
+
+    /// Set by the destructor to stop the thread writing the states
+    bool _stopWriter = false;
+
+    // Counters of the queue of the states
+
+    uint64_t _numQueuedStates = 0;      ///< also the sequence number of the last queued state
+    uint64_t _numWrittenStates = 0;     ///< the sequence number of the last written state
+    uint64_t _numMergedStates = 0;
+    uint64_t _numBatches = 0;
+    uint64_t _numFailedBatches = 0;
+    uint64_t _numDroppedStates = 0;
+    uint64_t _numBlockedCallers = 0;
+    size_t   _maxStateQueueSize = 0;
+    size_t   _lastBatchSize = 0;
+    uint64_t _lastBatchTimeMs = 0;
+
+    /// The mutex guarding the queue of the states and its counters
+    mutable std::mutex _stateMtx;
+
+    /// Notifies the writer on new states, and on the destruction of the pool
+    std::condition_variable _stateQueued;
+
+    /// Notifies the callers waiting for room in the queue
+    std::condition_variable _stateDequeued;
+
+    /// Notifies the callers waiting for the states to be written
+    std::condition_variable _stateWritten;
+
+    /// The thread writing the states (started by the constructor)
+    std::thread _writer;
 };
 
 }}} // namespace lsst::qserv::replica
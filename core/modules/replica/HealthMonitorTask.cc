@@ -23,6 +23,7 @@
 #include "replica/HealthMonitorTask.h"
 
 // System headers
+#include <algorithm>
 #include <map>
 
 // Qserv headers
@@ -41,7 +42,9 @@ HealthMonitorTask::Ptr HealthMonitorTask::create(
         WorkerEvictCallbackType const& onWorkerEvictTimeout,
         unsigned int workerEvictTimeoutSec,
         unsigned int workerResponseTimeoutSec,
-        unsigned int healthProbeIntervalSec) {
+        unsigned int healthProbeIntervalSec,
+        HeartbeatMonitor::Ptr const& heartbeatMonitor,
+        unsigned int fullProbeIntervalSec) {
     return Ptr(
         new HealthMonitorTask(
             controller,
@@ -49,7 +52,9 @@ HealthMonitorTask::Ptr HealthMonitorTask::create(
             onWorkerEvictTimeout,
             workerEvictTimeoutSec,
             workerResponseTimeoutSec,
-            healthProbeIntervalSec
+            healthProbeIntervalSec,
+            heartbeatMonitor,
+            fullProbeIntervalSec
         )
     );
 }
@@ -67,11 +72,15 @@ void HealthMonitorTask::onStart() {
 
     util::Lock lock(_mtx, context);
 
+    uint64_t const nowMs = PerformanceUtils::now();
     for (auto&& worker: serviceProvider()->config()->allWorkers()) {
         _workerServiceNoResponseSec[worker]["qserv"] = 0;
         _workerServiceNoResponseSec[worker]["replication"] = 0;
+        _prevProbeTimeMs[worker]["qserv"] = nowMs;
+        _prevProbeTimeMs[worker]["replication"] = nowMs;
     }
-    _prevUpdateTimeMs = PerformanceUtils::now();
+    _prevFullProbeTimeMs = 0;
+    _prevJobProbeTimeMs.clear();
 }
 
 
@@ -81,11 +90,46 @@ bool HealthMonitorTask::onRun() {
 
     string const parentJobId;  // no parent jobs
 
+    auto const newUpdateTimeMs = PerformanceUtils::now();
+
+    // Only the workers whose heartbeats are overdue are probed in between
+    // the full probes. Each probe is a job which gets recorded along with its
+    // events, hence a worker isn't probed again within the probe interval.
+
+    auto workers = serviceProvider()->config()->allWorkers();
+    if (nullptr != _heartbeatMonitor) {
+        if (newUpdateTimeMs - _prevFullProbeTimeMs < 1000 * _fullProbeIntervalSec) {
+            auto const overdue = _heartbeatMonitor->overdue(workers);
+            {
+                util::Lock lock(_mtx, context);
+                for (auto&& worker: workers) {
+                    if (find(overdue.begin(), overdue.end(), worker) == overdue.end()) {
+                        _updateDelay(lock, worker, "replication", true, newUpdateTimeMs);
+                    }
+                }
+            }
+            workers.clear();
+            for (auto&& worker: overdue) {
+                if (newUpdateTimeMs - _prevJobProbeTimeMs[worker] >= 1000 * _healthProbeIntervalSec) {
+                    workers.push_back(worker);
+                }
+            }
+            if (workers.empty()) return true;
+            info("heartbeats are overdue at " + to_string(workers.size()) + " workers");
+        } else {
+            _prevFullProbeTimeMs = newUpdateTimeMs;
+        }
+    }
+
     // Probe hosts. Wait for completion or expiration of the job
     // before analyzing its findings.
 
     info("ClusterHealthJob");
 
+    for (auto&& worker: workers) {
+        _prevJobProbeTimeMs[worker] = newUpdateTimeMs;
+    }
+
     _numFinishedJobs = 0;
 
     auto self = shared_from_base<HealthMonitorTask>();
@@ -94,7 +138,7 @@ bool HealthMonitorTask::onRun() {
     jobs.emplace_back(
         ClusterHealthJob::create(
             _workerResponseTimeoutSec,
-            true, /* allWorkers */
+            workers,
             controller(),
             parentJobId,
             [self](ClusterHealthJob::Ptr const& job) {
@@ -108,42 +152,15 @@ bool HealthMonitorTask::onRun() {
     track<ClusterHealthJob>(ClusterHealthJob::typeName(), jobs, _numFinishedJobs);
     _logFinishedEvent(jobs[0]);
 
-    // Compute the actual delay which will also include the wait time since
-    // the previous invocation of this method (onRun()).
-
-    auto newUpdateTimeMs = PerformanceUtils::now();
-    unsigned int workerResponseDelaySec = (newUpdateTimeMs - _prevUpdateTimeMs) / 1000;
-    _prevUpdateTimeMs = newUpdateTimeMs;
-
     // Update non-response intervals for both services
     {
         util::Lock lock(_mtx, context);
 
         for (auto&& entry: jobs[0]->clusterHealth().qserv()) {
-
-            auto worker = entry.first;
-            auto responded = entry.second;
-
-            if (responded) {
-                _workerServiceNoResponseSec[worker]["qserv"] = 0;
-            } else {
-                _workerServiceNoResponseSec[worker]["qserv"] += workerResponseDelaySec;
-                info("no response from Qserv at worker '" +worker + "' for " +
-                     to_string(_workerServiceNoResponseSec[worker]["qserv"]) + " seconds");
-            }
+            _updateDelay(lock, entry.first, "qserv", entry.second, newUpdateTimeMs);
         }
         for (auto&& entry: jobs[0]->clusterHealth().replication()) {
-
-            auto worker = entry.first;
-            auto responded = entry.second;
-
-            if (responded) {
-                _workerServiceNoResponseSec[worker]["replication"] = 0;
-            } else {
-                _workerServiceNoResponseSec[worker]["replication"] += workerResponseDelaySec;
-                info("no response from Replication at worker '" + worker + "' for " +
-                     to_string(_workerServiceNoResponseSec[worker]["replication"]) + " seconds");
-            }
+            _updateDelay(lock, entry.first, "replication", entry.second, newUpdateTimeMs);
         }
     }
 
@@ -230,17 +247,52 @@ HealthMonitorTask::HealthMonitorTask(
         WorkerEvictCallbackType const& onWorkerEvictTimeout,
         unsigned int workerEvictTimeoutSec,
         unsigned int workerResponseTimeoutSec,
-        unsigned int healthProbeIntervalSec)
+        unsigned int healthProbeIntervalSec,
+        HeartbeatMonitor::Ptr const& heartbeatMonitor,
+        unsigned int fullProbeIntervalSec)
     :   Task(controller,
              "HEALTH-MONITOR  ",
              onTerminated,
-             healthProbeIntervalSec
+             nullptr == heartbeatMonitor ? healthProbeIntervalSec : 1
         ),
         _onWorkerEvictTimeout(onWorkerEvictTimeout),
         _workerEvictTimeoutSec(workerEvictTimeoutSec),
         _workerResponseTimeoutSec(workerResponseTimeoutSec),
-        _numFinishedJobs(0),
-        _prevUpdateTimeMs(0) {
+        _healthProbeIntervalSec(healthProbeIntervalSec),
+        _heartbeatMonitor(heartbeatMonitor),
+        _fullProbeIntervalSec(fullProbeIntervalSec),
+        _numFinishedJobs(0) {
+}
+
+
+void HealthMonitorTask::_updateDelay(util::Lock const& lock,
+                                     string const& worker,
+                                     string const& service,
+                                     bool responded,
+                                     uint64_t nowMs) {
+
+    // The time of the previous probe of a worker which was added to
+    // the Configuration after the task started is unknown.
+
+    auto&& prevProbeTimeMs = _prevProbeTimeMs[worker][service];
+    if (prevProbeTimeMs == 0) prevProbeTimeMs = nowMs;
+
+    auto&& delaySec = _workerServiceNoResponseSec[worker][service];
+    if (responded) {
+        delaySec = 0;
+        prevProbeTimeMs = nowMs;
+        return;
+    }
+
+    // The service hasn't been responding since the previous probe. Only the whole
+    // seconds are counted, the rest is carried over to the next probe.
+
+    uint64_t const ivalSec = (nowMs - prevProbeTimeMs) / 1000;
+    delaySec += ivalSec;
+    prevProbeTimeMs += 1000 * ivalSec;
+
+    info("no response from " + string(service == "qserv" ? "Qserv" : "Replication") +
+         " at worker '" + worker + "' for " + to_string(delaySec) + " seconds");
 }
 
 
@@ -28,6 +28,7 @@
 
 // Qserv headers
 #include "replica/ClusterHealthJob.h"
+#include "replica/HeartbeatMonitor.h"
 #include "replica/Task.h"
 #include "util/Mutex.h"
 
@@ -40,6 +41,13 @@ namespace replica {
  * Class HealthMonitorTask represents a task which monitors a status of
  * the Replication and Qserv worker services and report worker(s) eligible
  * for eviction if they're not responding within the specified timeout.
+ *
+ * If the heartbeats of the workers are monitored (see class HeartbeatMonitor)
+ * then the task checks them every second, and only the workers whose heartbeats
+ * are overdue get probed, though not more often than at the interval of
+ * the health probes. The Replication services of the other workers are
+ * known to be up. All workers (including the Qserv services) are still probed
+ * at the interval of the full probes.
  */
 class HealthMonitorTask : public Task {
 
@@ -100,7 +108,15 @@ public:
      * @param healthProbeIntervalSec
      *   the number of seconds to wait between iterations of the inner monitoring
      *   loop. This parameter determines a frequency of probes sent to the worker
-     *   services.
+     *   services. If the heartbeats are monitored it's the minimum interval
+     *   between probes of a worker whose heartbeats are overdue.
+     *
+     * @param heartbeatMonitor
+     *   (optional) the monitor of the workers' heartbeats
+     *
+     * @param fullProbeIntervalSec
+     *   (optional) the number of seconds between probes of all workers if
+     *   the heartbeats are monitored
      *
      * @return
      *   the smart pointer to a new object
@@ -110,7 +126,9 @@ public:
                       WorkerEvictCallbackType const& onWorkerEvictTimeout,
                       unsigned int workerEvictTimeoutSec,
                       unsigned int workerResponseTimeoutSec,
-                      unsigned int healthProbeIntervalSec);
+                      unsigned int healthProbeIntervalSec,
+                      HeartbeatMonitor::Ptr const& heartbeatMonitor=nullptr,
+                      unsigned int fullProbeIntervalSec=0);
 
     /// @return delays (seconds) in getting responses from the worker services
     WorkerResponseDelay workerResponseDelay() const;
@@ -135,7 +153,33 @@ private:
                         WorkerEvictCallbackType const& onWorkerEvictTimeout,
                         unsigned int workerEvictTimeoutSec,
                         unsigned int workerResponseTimeoutSec,
-                        unsigned int healthProbeIntervalSec);
+                        unsigned int healthProbeIntervalSec,
+                        HeartbeatMonitor::Ptr const& heartbeatMonitor,
+                        unsigned int fullProbeIntervalSec);
+
+    /**
+     * Update the non-response interval of a service of a worker
+     *
+     * @param lock
+     *   a lock on HealthMonitorTask::_mtx must be acquired before calling this method
+     *
+     * @param worker
+     *   the name of a worker
+     *
+     * @param service
+     *   the name of a service ('qserv', 'replication')
+     *
+     * @param responded
+     *   'true' if the service responded to the probe
+     *
+     * @param nowMs
+     *   the time of the probe
+     */
+    void _updateDelay(util::Lock const& lock,
+                      std::string const& worker,
+                      std::string const& service,
+                      bool responded,
+                      uint64_t nowMs);
 
     /**
      * Log a persistent event on the started job
@@ -160,6 +204,10 @@ private:
 
     unsigned int const _workerEvictTimeoutSec;
     unsigned int const _workerResponseTimeoutSec;
+    unsigned int const _healthProbeIntervalSec;
+
+    HeartbeatMonitor::Ptr const _heartbeatMonitor;
+    unsigned int          const _fullProbeIntervalSec;
 
     /// The thread-safe counter of the finished jobs
     std::atomic<size_t> _numFinishedJobs;
@@ -172,8 +220,16 @@ private:
     /// reach the "eviction" threshold. Then trigger worker eviction sequence.
     WorkerResponseDelay _workerServiceNoResponseSec;
 
-    /// Last time the workers response delays were updated
-    uint64_t _prevUpdateTimeMs;
+    /// Last time the services of each worker were probed
+    std::map<std::string,           // worker
+             std::map<std::string,  // service ('qserv', 'replication')
+                      uint64_t>> _prevProbeTimeMs;
+
+    /// Last time all workers were probed
+    uint64_t _prevFullProbeTimeMs = 0;
+
+    /// Last time each worker was probed by a ClusterHealthJob
+    std::map<std::string, uint64_t> _prevJobProbeTimeMs;
 };
     
 }}} // namespace lsst::qserv::replica
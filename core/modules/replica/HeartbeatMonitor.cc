@@ -0,0 +1,263 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "replica/HeartbeatMonitor.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+
+// Third party headers
+#include <boost/bind.hpp>
+
+// Qserv headers
+#include "lsst/log/Log.h"
+#include "replica/Configuration.h"
+#include "replica/Performance.h"
+#include "replica/protocol.pb.h"
+
+using namespace std;
+using boost::asio::ip::udp;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.HeartbeatMonitor");
+
+/// The maximum size of a datagram
+size_t const maxDatagramSize = 64 * 1024;
+
+/// The minimum interval (milliseconds) between resolving the host name of a worker
+uint64_t const resolveIntervalMs = 60 * 1000;
+
+/// The weights of the latest interval and its deviation in the smoothed values
+double const ivalGain    = 0.125;
+double const ivalDevGain = 0.25;
+
+} /// namespace
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+HeartbeatMonitor::Ptr HeartbeatMonitor::create(ServiceProvider::Ptr const& serviceProvider,
+                                               uint16_t port) {
+    return HeartbeatMonitor::Ptr(
+        new HeartbeatMonitor(
+            serviceProvider,
+            port));
+}
+
+
+HeartbeatMonitor::HeartbeatMonitor(ServiceProvider::Ptr const& serviceProvider,
+                                   uint16_t port)
+    :   _serviceProvider(serviceProvider),
+        _port(port),
+        _socket(
+            serviceProvider->io_service(),
+            udp::endpoint(
+                udp::v4(),
+                port)),
+        _resolver(serviceProvider->io_service()),
+        _buf(maxDatagramSize) {
+}
+
+
+void HeartbeatMonitor::start() {
+    string const context = "HeartbeatMonitor::" + string(__func__);
+    LOGS(_log, LOG_LVL_INFO, context << " port: " << _port);
+    {
+        util::Lock lock(_mtx, context);
+        uint64_t const nowMs = PerformanceUtils::now();
+        for (auto&& worker: _serviceProvider->config()->allWorkers()) {
+            _resolve(lock, worker, nowMs);
+        }
+    }
+    _beginReceive();
+}
+
+
+vector<string> HeartbeatMonitor::overdue(vector<string> const& workers) const {
+
+    util::Lock lock(_mtx, "HeartbeatMonitor::" + string(__func__));
+
+    uint64_t const nowMs = PerformanceUtils::now();
+
+    vector<string> result;
+    for (auto&& worker: workers) {
+        auto const itr = _workers.find(worker);
+        if ((itr == _workers.end()) or (nowMs > itr->second.lastTimeMs + _deadlineMs(itr->second))) {
+            result.push_back(worker);
+        }
+    }
+    return result;
+}
+
+
+void HeartbeatMonitor::_beginReceive() {
+    _socket.async_receive_from(
+        boost::asio::buffer(_buf),
+        _sender,
+        boost::bind(
+            &HeartbeatMonitor::_handleReceive,
+            shared_from_this(),
+            boost::asio::placeholders::error,
+            boost::asio::placeholders::bytes_transferred
+        )
+    );
+}
+
+
+void HeartbeatMonitor::_handleReceive(boost::system::error_code const& ec,
+                                      size_t bytes) {
+
+    string const context = "HeartbeatMonitor::" + string(__func__) + " ";
+
+    if (ec == boost::asio::error::operation_aborted) return;
+
+    if (ec.value() != 0) {
+        LOGS(_log, LOG_LVL_WARN, context << "failed to receive a heartbeat, error: " << ec.message());
+        _beginReceive();
+        return;
+    }
+    ProtocolWorkerHeartbeat message;
+    if (not message.ParseFromArray(_buf.data(), bytes)) {
+        LOGS(_log, LOG_LVL_WARN, context << "invalid heartbeat from: " << _sender);
+        _beginReceive();
+        return;
+    }
+    if (not _serviceProvider->config()->isKnownWorker(message.worker())) {
+        LOGS(_log, LOG_LVL_WARN, context << "heartbeat of an unknown worker: " << message.worker()
+             << " from: " << _sender);
+        _beginReceive();
+        return;
+    }
+    {
+        util::Lock lock(_mtx, context);
+
+        uint64_t const nowMs = PerformanceUtils::now();
+        if (not _fromWorkerHost(lock, message.worker(), nowMs)) {
+            LOGS(_log, LOG_LVL_WARN, context << "heartbeat of worker: " << message.worker()
+                 << " from an unresolved or different host: " << _sender);
+            _beginReceive();
+            return;
+        }
+        auto&& state = _workers[message.worker()];
+
+        // The interval since the previous heartbeat is only meaningful if none
+        // was lost or reordered, and the worker service didn't restart.
+
+        if ((state.numReceived > 0) and (message.seq() == state.seq + 1)) {
+            double const ivalMs = nowMs - state.lastTimeMs;
+            if (state.numReceived == 1) {
+                state.smoothedIvalMs = ivalMs;
+                state.ivalDevMs      = ivalMs / 2;
+            } else {
+                state.ivalDevMs      += ivalDevGain * (abs(ivalMs - state.smoothedIvalMs) - state.ivalDevMs);
+                state.smoothedIvalMs += ivalGain    * (ivalMs - state.smoothedIvalMs);
+            }
+        }
+        if (state.numReceived == 0) {
+            LOGS(_log, LOG_LVL_INFO, context << "first heartbeat of worker: " << message.worker()
+                 << " from: " << _sender);
+        }
+        state.lastTimeMs = nowMs;
+        state.seq        = message.seq();
+        state.intervalMs = message.interval_ms();
+        state.numReceived++;
+    }
+    _beginReceive();
+}
+
+
+bool HeartbeatMonitor::_fromWorkerHost(util::Lock const& lock,
+                                       string const& worker,
+                                       uint64_t nowMs) {
+
+    auto&& host = _workerAddresses[worker];
+    if (host.addresses.end() != find(host.addresses.begin(),
+                                     host.addresses.end(),
+                                     _sender.address())) {
+        return true;
+    }
+    if (not host.resolving and
+        ((host.resolveTimeMs == 0) or (nowMs - host.resolveTimeMs >= resolveIntervalMs))) {
+        _resolve(lock, worker, nowMs);
+    }
+    return false;
+}
+
+
+void HeartbeatMonitor::_resolve(util::Lock const& lock,
+                                string const& worker,
+                                uint64_t nowMs) {
+
+    auto&& host = _workerAddresses[worker];
+    host.resolving     = true;
+    host.resolveTimeMs = nowMs;
+
+    string const svcHost = _serviceProvider->config()->workerInfo(worker).svcHost;
+    _resolver.async_resolve(
+        udp::resolver::query(udp::v4(), svcHost, to_string(_port)),
+        boost::bind(
+            &HeartbeatMonitor::_resolved,
+            shared_from_this(),
+            boost::asio::placeholders::error,
+            boost::asio::placeholders::iterator,
+            worker,
+            svcHost
+        )
+    );
+}
+
+
+void HeartbeatMonitor::_resolved(boost::system::error_code const& ec,
+                                 udp::resolver::iterator itr,
+                                 string const& worker,
+                                 string const& svcHost) {
+
+    string const context = "HeartbeatMonitor::" + string(__func__) + " ";
+
+    if (ec == boost::asio::error::operation_aborted) return;
+
+    util::Lock lock(_mtx, context);
+
+    auto&& host = _workerAddresses[worker];
+    host.resolving = false;
+
+    if (ec.value() != 0) {
+        LOGS(_log, LOG_LVL_WARN, context << "failed to resolve the host of worker: " << worker
+             << " host: " << svcHost << ", error: " << ec.message());
+        return;
+    }
+    host.addresses.clear();
+    for (; itr != udp::resolver::iterator(); ++itr) {
+        host.addresses.push_back(itr->endpoint().address());
+    }
+}
+
+
+uint64_t HeartbeatMonitor::_deadlineMs(WorkerState const& state) {
+    uint64_t const adaptiveMs = static_cast<uint64_t>(state.smoothedIvalMs + 4 * state.ivalDevMs);
+    return max(2 * static_cast<uint64_t>(state.intervalMs), adaptiveMs);
+}
+
+}}} // namespace lsst::qserv::replica
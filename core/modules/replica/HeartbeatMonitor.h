@@ -0,0 +1,231 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_REPLICA_HEARTBEATMONITOR_H
+#define LSST_QSERV_REPLICA_HEARTBEATMONITOR_H
+
+// System headers
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Third party headers
+#include <boost/asio.hpp>
+
+// Qserv headers
+#include "replica/ServiceProvider.h"
+#include "util/Mutex.h"
+
+// This header declarations
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+/**
+ * Class HeartbeatMonitor receives heartbeats pushed by the worker services
+ * (see class HeartbeatSender) over UDP, and tells which workers are overdue
+ * with their heartbeats.
+ *
+ * The deadline for the next heartbeat of a worker adapts to the intervals
+ * between the heartbeats actually received from the worker, in the same way
+ * TCP computes its retransmission timeout: the smoothed interval plus four
+ * times its smoothed deviation. The deadline is never shorter than twice
+ * the interval announced by the worker, so that a single lost datagram
+ * doesn't make the worker overdue.
+ *
+ * Heartbeats are only accepted from the addresses the host names of the workers'
+ * services (see WorkerInfo::svcHost) resolve to. The names are resolved
+ * asynchronously, so that a slow DNS lookup never delays the other users
+ * of the BOOST ASIO service. The heartbeats of a worker are ignored until
+ * its host name is resolved.
+ *
+ * The datagrams are received asynchronously by the threads of the service
+ * provider's BOOST ASIO service.
+ */
+class HeartbeatMonitor : public std::enable_shared_from_this<HeartbeatMonitor> {
+
+public:
+
+    /// The pointer type for instances of the class
+    typedef std::shared_ptr<HeartbeatMonitor> Ptr;
+
+    /**
+     * Static factory method is needed to prevent issue with the lifespan
+     * and memory management of instances created otherwise (as values or via
+     * low-level pointers).
+     *
+     * @param serviceProvider
+     *   for accessing the Configuration and the BOOST ASIO service
+     *
+     * @param port
+     *   the UDP port where the heartbeats are received
+     *
+     * @return
+     *   pointer to the created object
+     */
+    static Ptr create(ServiceProvider::Ptr const& serviceProvider,
+                      uint16_t port);
+
+    // Default construction and copy semantics are prohibited
+
+    HeartbeatMonitor() = delete;
+    HeartbeatMonitor(HeartbeatMonitor const&) = delete;
+    HeartbeatMonitor& operator=(HeartbeatMonitor const&) = delete;
+
+    ~HeartbeatMonitor() = default;
+
+    /// @return the UDP port where the heartbeats are received
+    uint16_t port() const { return _port; }
+
+    /// Begin resolving the host names of the workers and receiving heartbeats
+    void start();
+
+    /**
+     * @param workers
+     *   the names of workers
+     *
+     * @return
+     *   the workers (in the same order) from which no heartbeat has been
+     *   received, or whose next heartbeat is overdue
+     */
+    std::vector<std::string> overdue(std::vector<std::string> const& workers) const;
+
+private:
+
+    /// The heartbeats of a worker
+    struct WorkerState {
+
+        /// The time (milliseconds) when the last heartbeat was received
+        uint64_t lastTimeMs = 0;
+
+        /// The sequence number of the last heartbeat
+        uint64_t seq = 0;
+
+        /// The interval (milliseconds) between heartbeats announced by the worker
+        uint32_t intervalMs = 0;
+
+        /// The smoothed interval (milliseconds) between the received heartbeats
+        double smoothedIvalMs = 0;
+
+        /// The smoothed deviation (milliseconds) of the intervals
+        double ivalDevMs = 0;
+
+        /// The number of heartbeats received
+        uint64_t numReceived = 0;
+    };
+
+    /// The addresses of the host of a worker
+    struct WorkerAddresses {
+
+        /// The time (milliseconds) when the host name was last resolved
+        uint64_t resolveTimeMs = 0;
+
+        /// Is the host name being resolved?
+        bool resolving = false;
+
+        /// The addresses the host name resolved to
+        std::vector<boost::asio::ip::address> addresses;
+    };
+
+    /// @see HeartbeatMonitor::create()
+    HeartbeatMonitor(ServiceProvider::Ptr const& serviceProvider,
+                     uint16_t port);
+
+    /// Begin receiving the next datagram
+    void _beginReceive();
+
+    /// Process a received datagram and begin receiving the next one
+    void _handleReceive(boost::system::error_code const& ec,
+                        size_t bytes);
+
+    /**
+     * Check if the last datagram was sent from the host of a worker. If the sender
+     * doesn't match then the host name is resolved again (though not more often
+     * than once a minute).
+     *
+     * @param lock
+     *   the lock on HeartbeatMonitor::_mtx
+     *
+     * @param worker
+     *   the name of a worker
+     *
+     * @param nowMs
+     *   the current time
+     *
+     * @return
+     *   'true' if the sender's address is one of the worker's host
+     */
+    bool _fromWorkerHost(util::Lock const& lock,
+                         std::string const& worker,
+                         uint64_t nowMs);
+
+    /**
+     * Begin resolving the host name of a worker's service
+     *
+     * @param lock
+     *   the lock on HeartbeatMonitor::_mtx
+     *
+     * @param worker
+     *   the name of a worker
+     *
+     * @param nowMs
+     *   the current time
+     */
+    void _resolve(util::Lock const& lock,
+                  std::string const& worker,
+                  uint64_t nowMs);
+
+    /// Store the addresses the host name of a worker resolved to
+    void _resolved(boost::system::error_code const& ec,
+                   boost::asio::ip::udp::resolver::iterator itr,
+                   std::string const& worker,
+                   std::string const& svcHost);
+
+    /// @return the deadline (milliseconds since the last heartbeat) for the next one
+    static uint64_t _deadlineMs(WorkerState const& state);
+
+    // Input parameters
+
+    ServiceProvider::Ptr const _serviceProvider;
+    uint16_t             const _port;
+
+    boost::asio::ip::udp::socket   _socket;
+    boost::asio::ip::udp::endpoint _sender;
+    boost::asio::ip::udp::resolver _resolver;
+
+    /// The buffer for receiving datagrams
+    std::vector<char> _buf;
+
+    /// The heartbeats by the names of workers
+    std::map<std::string, WorkerState> _workers;
+
+    /// The addresses of the workers' hosts by the names of workers
+    std::map<std::string, WorkerAddresses> _workerAddresses;
+
+    /// The mutex for enforcing thread safety of the class's public API
+    /// and internal operations.
+    mutable util::Mutex _mtx;
+};
+
+}}} // namespace lsst::qserv::replica
+
+#endif // LSST_QSERV_REPLICA_HEARTBEATMONITOR_H
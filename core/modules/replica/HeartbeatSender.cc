@@ -0,0 +1,105 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "replica/HeartbeatSender.h"
+
+// Qserv headers
+#include "lsst/log/Log.h"
+#include "replica/protocol.pb.h"
+
+using namespace std;
+using boost::asio::ip::udp;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.HeartbeatSender");
+
+} /// namespace
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+HeartbeatSender::HeartbeatSender(string const& worker,
+                                 string const& host,
+                                 uint16_t port,
+                                 unsigned int intervalMs)
+    :   _worker(worker),
+        _host(host),
+        _port(port),
+        _intervalMs(intervalMs),
+        _socket(_io_service) {
+}
+
+
+void HeartbeatSender::send() {
+
+    string const context = "HeartbeatSender::" + string(__func__) + " ";
+
+    ProtocolWorkerHeartbeat message;
+    message.set_worker(_worker);
+    message.set_seq(_seq++);
+    message.set_interval_ms(_intervalMs);
+
+    string data;
+    message.SerializeToString(&data);
+
+    if (not _resolve()) return;
+
+    boost::system::error_code ec;
+    _socket.send_to(boost::asio::buffer(data), _endpoint, 0, ec);
+    if (ec.value() != 0) {
+        LOGS(_log, LOG_LVL_WARN, context << "failed to send a heartbeat to "
+             << _host << ":" << _port << ", error: " << ec.message());
+        _resolved = false;
+    }
+}
+
+
+bool HeartbeatSender::_resolve() {
+
+    if (_resolved) return true;
+
+    string const context = "HeartbeatSender::" + string(__func__) + " ";
+
+    boost::system::error_code ec;
+    udp::resolver resolver(_io_service);
+    auto const itr = resolver.resolve(udp::resolver::query(udp::v4(), _host, to_string(_port)), ec);
+    if ((ec.value() != 0) or (itr == udp::resolver::iterator())) {
+        LOGS(_log, LOG_LVL_WARN, context << "failed to resolve " << _host << ":" << _port
+             << ", error: " << ec.message());
+        return false;
+    }
+    _endpoint = *itr;
+
+    if (not _socket.is_open()) {
+        _socket.open(udp::v4(), ec);
+        if (ec.value() != 0) {
+            LOGS(_log, LOG_LVL_WARN, context << "failed to open a socket, error: " << ec.message());
+            return false;
+        }
+    }
+    _resolved = true;
+    return true;
+}
+
+}}} // namespace lsst::qserv::replica
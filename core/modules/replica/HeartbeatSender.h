@@ -0,0 +1,109 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_REPLICA_HEARTBEATSENDER_H
+#define LSST_QSERV_REPLICA_HEARTBEATSENDER_H
+
+// System headers
+#include <cstdint>
+#include <string>
+
+// Third party headers
+#include <boost/asio.hpp>
+
+// This header declarations
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+/**
+ * Class HeartbeatSender pushes heartbeats of a worker service to the Master
+ * Controller (see class HeartbeatMonitor). Each heartbeat is a single UDP
+ * datagram carrying the name of the worker, the sequence number of
+ * the heartbeat, and the interval before the next one will be sent.
+ *
+ * Heartbeats are sent on a best effort basis. Failures to resolve the address
+ * of the Controller, or to send a datagram, are logged and otherwise ignored.
+ * The address is resolved again after each failure.
+ */
+class HeartbeatSender {
+
+public:
+
+    // Default construction and copy semantics are prohibited
+
+    HeartbeatSender() = delete;
+    HeartbeatSender(HeartbeatSender const&) = delete;
+    HeartbeatSender& operator=(HeartbeatSender const&) = delete;
+
+    /**
+     * @param worker
+     *   the name of a worker
+     *
+     * @param host
+     *   the host name (or the IP address) of the Master Controller
+     *
+     * @param port
+     *   the UDP port of the Master Controller's heartbeat monitor
+     *
+     * @param intervalMs
+     *   the interval (milliseconds) between heartbeats
+     */
+    HeartbeatSender(std::string const& worker,
+                    std::string const& host,
+                    uint16_t port,
+                    unsigned int intervalMs);
+
+    ~HeartbeatSender() = default;
+
+    /// @return the interval (milliseconds) between heartbeats
+    unsigned int intervalMs() const { return _intervalMs; }
+
+    /// Send the next heartbeat
+    void send();
+
+private:
+
+    /// @return 'true' if the address of the Controller has been resolved
+    bool _resolve();
+
+    // Input parameters
+
+    std::string  const _worker;
+    std::string  const _host;
+    uint16_t     const _port;
+    unsigned int const _intervalMs;
+
+    boost::asio::io_service      _io_service;
+    boost::asio::ip::udp::socket _socket;
+
+    /// The address of the Controller (if resolved)
+    boost::asio::ip::udp::endpoint _endpoint;
+
+    /// Set after the address of the Controller has been resolved
+    bool _resolved = false;
+
+    /// The sequence number of the next heartbeat
+    uint64_t _seq = 0;
+};
+
+}}} // namespace lsst::qserv::replica
+
+#endif // LSST_QSERV_REPLICA_HEARTBEATSENDER_H
@@ -506,11 +506,15 @@ void HttpProcessor::_getReplicationLevel(qhttp::Request::Ptr const& req,
 
     util::Lock lock(_replicationLevelMtx, "HttpProcessor::" + string(__func__));
 
-    // Check if a cached report can be used
+    // Check if a cached report can be used. The cache is only needed before
+    // the index of replicas is loaded. After that the replication levels are
+    // computed from the index (see DatabaseServicesPool) and the report is
+    // always fresh.
     //
     // TODO: add a cache control parameter to the class's constructor
 
-    if (not _replicationLevelReport.empty()) {
+    bool const useCache = not controller()->serviceProvider()->replicaIndex()->loaded();
+    if (useCache and not _replicationLevelReport.empty()) {
         uint64_t lastReportAgeMs = PerformanceUtils::now() - _replicationLevelReportTimeMs;
         if (lastReportAgeMs < 240 * 1000) {
             resp->send(_replicationLevelReport, "application/json");
@@ -824,6 +828,11 @@ void HttpProcessor::_getControllerInfo(qhttp::Request::Ptr const& req,
         bool const isCurrent = controllerInfo.id == controller()->identity().id;
         resultJson["controller"] = controllerInfo.toJson(isCurrent);
 
+        // The queue of the states of jobs and requests is only known to
+        // the current Controller
+
+        if (isCurrent) resultJson["state_queue"] = dbSvc->stateQueueInfo();
+
         // Pull the Controller log data if requested
         
         json jsonLog = json::array();
@@ -1042,6 +1051,9 @@ void HttpProcessor::_updateGeneralConfig(qhttp::Request::Ptr const& req,
         ::saveConfigParameter(general.databaseServicesPoolSize,    req->query, config, logger);
         ::saveConfigParameter(general.workerTechnology,            req->query, config, logger);
         ::saveConfigParameter(general.workerNumProcessingThreads,  req->query, config, logger);
+        ::saveConfigParameter(general.workerNumChecksumThreads,    req->query, config, logger);
+        ::saveConfigParameter(general.workerNumMetadataThreads,    req->query, config, logger);
+        ::saveConfigParameter(general.workerNumSqlThreads,         req->query, config, logger);
         ::saveConfigParameter(general.fsNumProcessingThreads,      req->query, config, logger);
         ::saveConfigParameter(general.workerFsBufferSizeBytes,     req->query, config, logger);
 
@@ -1330,18 +1342,21 @@ void HttpProcessor::_sqlQuery(qhttp::Request::Ptr const& req,
         auto const user     = body.required("user");
         auto const password = body.required("password");
         auto const maxRows  = stoull(body.optional("max_rows", "0"));
+        auto const pageSize = stoull(body.optional("page_size", "0"));
 
         _debug(string(__func__) + " worker="   + worker);
         _debug(string(__func__) + " query="    + query);
         _debug(string(__func__) + " user="     + user);
         _debug(string(__func__) + " maxRows="  + to_string(maxRows));
+        _debug(string(__func__) + " pageSize=" + to_string(pageSize));
 
         auto const request = controller()->sql(
             worker,
             query,
             user,
             password,
-            maxRows
+            maxRows,
+            pageSize
         );
         request->wait();
 
@@ -41,6 +41,8 @@ namespace {
  */
 struct {
     unsigned int const healthProbeIntervalSec   = 60;
+    unsigned int const fullProbeIntervalSec     = 600;
+    uint16_t     const heartbeatPort            = 0;
     unsigned int const replicationIntervalSec   = 60;
     unsigned int const workerResponseTimeoutSec = 60;
     unsigned int const workerEvictTimeoutSec    = 3600 ;
@@ -89,6 +91,8 @@ MasterControllerHttpApp::MasterControllerHttpApp(int argc, char* argv[])
             true /* enableServiceProvider */
         ),
         _healthProbeIntervalSec  (::defaultOptions.healthProbeIntervalSec),
+        _fullProbeIntervalSec    (::defaultOptions.fullProbeIntervalSec),
+        _heartbeatPort           (::defaultOptions.heartbeatPort),
         _replicationIntervalSec  (::defaultOptions.replicationIntervalSec),
         _workerResponseTimeoutSec(::defaultOptions.workerResponseTimeoutSec),
         _workerEvictTimeoutSec   (::defaultOptions.workerEvictTimeoutSec),
@@ -103,8 +107,21 @@ MasterControllerHttpApp::MasterControllerHttpApp(int argc, char* argv[])
 
     parser().option(
         "health-probe-interval",
-        "Interval (seconds) between iterations of the health monitoring probes.",
+        "Interval (seconds) between iterations of the health monitoring probes."
+        " The option is ignored if the heartbeats of workers are monitored.",
         _healthProbeIntervalSec
+    ).option(
+        "heartbeat-port",
+        "The UDP port for receiving the heartbeats of workers. If the heartbeats are"
+        " monitored then only the workers whose heartbeats are overdue are probed by"
+        " the health monitor, except for the periodic full probes. The heartbeats"
+        " won't be monitored if the value is 0.",
+        _heartbeatPort
+    ).option(
+        "health-full-probe-interval",
+        "Interval (seconds) between probes of all workers (including the ones whose"
+        " heartbeats are on time) if the heartbeats of workers are monitored.",
+        _fullProbeIntervalSec
     ).option(
         "replication-interval",
         "Interval (seconds) between running the linear sequence of"
@@ -168,6 +185,18 @@ int MasterControllerHttpApp::runImpl() {
 
     _logControllerStartedEvent();
 
+    // Read the replica placement once. From now on the index is kept current
+    // by the database services as replicas are found, created or deleted.
+
+    serviceProvider()->replicaIndex()->load(*(serviceProvider()->databaseServices()));
+    LOGS(_log, LOG_LVL_INFO, _name() << " replica index loaded, replicas: "
+         << serviceProvider()->replicaIndex()->numReplicas());
+
+    if (_heartbeatPort != 0) {
+        _heartbeatMonitor = HeartbeatMonitor::create(serviceProvider(), _heartbeatPort);
+        _heartbeatMonitor->start();
+    }
+
     // These tasks should be running in parallel
 
     auto self = shared_from_base<MasterControllerHttpApp>();
@@ -194,7 +223,9 @@ int MasterControllerHttpApp::runImpl() {
         },
         _workerEvictTimeoutSec,
         _workerResponseTimeoutSec,
-        _healthProbeIntervalSec
+        _healthProbeIntervalSec,
+        _heartbeatMonitor,
+        _fullProbeIntervalSec
     );
     _healthMonitorTask->start();
 
@@ -284,6 +315,8 @@ void MasterControllerHttpApp::_logControllerStartedEvent() const {
     event.kvInfo.emplace_back("host",                              _controller->identity().host);
     event.kvInfo.emplace_back("pid",                     to_string(_controller->identity().pid));
     event.kvInfo.emplace_back("health-probe-interval",   to_string(_healthProbeIntervalSec));
+    event.kvInfo.emplace_back("heartbeat-port",          to_string(_heartbeatPort));
+    event.kvInfo.emplace_back("health-full-probe-interval", to_string(_fullProbeIntervalSec));
     event.kvInfo.emplace_back("replication-interval",    to_string(_replicationIntervalSec));
     event.kvInfo.emplace_back("worker-response-timeout", to_string(_workerResponseTimeoutSec));
     event.kvInfo.emplace_back("worker-evict-timeout",    to_string(_workerEvictTimeoutSec));
@@ -29,6 +29,7 @@
 #include "replica/Controller.h"
 #include "replica/DeleteWorkerTask.h"
 #include "replica/HealthMonitorTask.h"
+#include "replica/HeartbeatMonitor.h"
 #include "replica/HttpProcessor.h"
 #include "replica/OneWayFailer.h"
 #include "replica/ReplicationTask.h"
@@ -158,6 +159,8 @@ private:
     // Command line parameters
 
     unsigned int _healthProbeIntervalSec;
+    unsigned int _fullProbeIntervalSec;
+    uint16_t     _heartbeatPort;
     unsigned int _replicationIntervalSec;
     unsigned int _workerResponseTimeoutSec;
     unsigned int _workerEvictTimeoutSec;
@@ -175,6 +178,9 @@ private:
     /// The controller for launching operations with the Replication system services
     Controller::Ptr _controller;
 
+    /// The monitor of the workers' heartbeats (if enabled)
+    HeartbeatMonitor::Ptr _heartbeatMonitor;
+
     // Control threads
 
     HealthMonitorTask::Ptr _healthMonitorTask;
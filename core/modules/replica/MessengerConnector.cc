@@ -24,6 +24,7 @@
 
 // System headers
 #include <stdexcept>
+#include <vector>
 
 // Third party headers
 #include <boost/bind.hpp>
@@ -41,6 +42,16 @@ namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.MessengerConnector");
 
+/// The maximum number of requests sent to a worker whose responses
+/// have not been received yet
+size_t const maxRequestsInFlight = 256;
+
+/// The maximum number of requests sent together in one write
+size_t const maxRequestsPerWrite = 64;
+
+/// Requests larger than this are sent in a write of their own
+size_t const maxBatchedRequestBytes = 4096;
+
 } /// namespace
 
 namespace lsst {
@@ -80,6 +91,7 @@ MessengerConnector::MessengerConnector(ServiceProvider::Ptr const& serviceProvid
         _resolver(io_service),
         _socket(io_service),
         _timer(io_service),
+        _receiving(false),
         _inBuffer(serviceProvider->config()->requestBufferSizeBytes()) {
 }
 
@@ -109,12 +121,14 @@ void MessengerConnector::stop() {
                 _socket.close();
                 _timer.cancel();
     
-                // Make sure the current request's owner gets notified
-    
-                if (_currentRequest != nullptr) {
-                    requests2notify.push_back(_currentRequest);
-                    _currentRequest = nullptr;
-                }
+                // Make sure the owners of the requests which are being sent, or
+                // which are waiting for responses get notified
+
+                for (auto&& request: _sending)  if (request.ptr) requests2notify.push_back(request.ptr);
+                for (auto&& request: _inFlight) if (request.ptr) requests2notify.push_back(request.ptr);
+                _sending.clear();
+                _inFlight.clear();
+                _receiving = false;
 
                 // Also cancel the queued requests and notify their owners
                 
@@ -149,13 +163,12 @@ void MessengerConnector::cancel(string const& id) {
         }
     );
 
-    // Also, if the request is already being processed then terminate all
-    // communications with a worker. This will automatically abort the request.
+    // Also, if the request is already being sent, or it's waiting for
+    // a response, then forget about the request. The response will be
+    // read and discarded.
 
-    if (_currentRequest and (_currentRequest->id() == id)) {
-        _currentRequest = nullptr;
-        if (_state == STATE_COMMUNICATING) _restart(lock);
-    }
+    for (auto&& request: _sending)  if (request.id == id) request.ptr = nullptr;
+    for (auto&& request: _inFlight) if (request.id == id) request.ptr = nullptr;
 }
 
 
@@ -208,10 +221,11 @@ void MessengerConnector::_sendImpl(MessageWrapperBase::Ptr const& ptr) {
 }
 
 
-void MessengerConnector::_restart(util::Lock const& lock) {
+void MessengerConnector::_restart(util::Lock const& lock,
+                                  list<MessageWrapperBase::Ptr>& requests2notify) {
 
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  _sending.size=" << _sending.size() << "  _inFlight.size=" << _inFlight.size());
 
     // Cancel any asynchronous operation(s) if not in the initial state
 
@@ -234,6 +248,21 @@ void MessengerConnector::_restart(util::Lock const& lock) {
             throw logic_error(
                     "MessengerConnector::" + string(__func__) + "  incomplete implementation");
     }
+
+    // Requests which were being sent will be the first ones to be served after
+    // restarting the communication. Responses to the outstanding requests
+    // are lost.
+
+    for (auto itr = _sending.rbegin(); itr != _sending.rend(); ++itr) {
+        if (itr->ptr) _requests.push_front(itr->ptr);
+    }
+    for (auto&& request: _inFlight) {
+        if (request.ptr) requests2notify.push_back(request.ptr);
+    }
+    _sending.clear();
+    _inFlight.clear();
+    _receiving = false;
+
     _resolve(lock);
 }
 
@@ -241,7 +270,7 @@ void MessengerConnector::_restart(util::Lock const& lock) {
 void MessengerConnector::_resolve(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  _inFlight.size=" << _inFlight.size());
 
     if (_state != STATE_INITIAL) return;
 
@@ -266,7 +295,7 @@ void MessengerConnector::_resolved(boost::system::error_code const& ec,
                                    boost::asio::ip::tcp::resolver::iterator iter) {
 
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  _inFlight.size=" << _inFlight.size());
 
     if (_isAborted(ec)) return;
 
@@ -284,7 +313,7 @@ void MessengerConnector::_connect(util::Lock const& lock,
                                   boost::asio::ip::tcp::resolver::iterator iter) {
 
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  _inFlight.size=" << _inFlight.size());
 
     boost::asio::async_connect(
         _socket,
@@ -303,7 +332,7 @@ void MessengerConnector::_connected(boost::system::error_code const& ec,
                                     boost::asio::ip::tcp::resolver::iterator iter) {
 
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  _inFlight.size=" << _inFlight.size());
 
     if (_isAborted(ec)) return;
 
@@ -321,7 +350,7 @@ void MessengerConnector::_connected(boost::system::error_code const& ec,
 void MessengerConnector::_waitBeforeRestart(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  _inFlight.size=" << _inFlight.size());
 
     // Always need to set the interval before launching the timer.
 
@@ -339,7 +368,7 @@ void MessengerConnector::_waitBeforeRestart(util::Lock const& lock) {
 void MessengerConnector::_awakenForRestart(boost::system::error_code const& ec) {
 
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         << "  _inFlight.size=" << _inFlight.size()
          << "  _requests.size=" << _requests.size());
 
     if (_isAborted(ec)) return;
@@ -348,34 +377,53 @@ void MessengerConnector::_awakenForRestart(boost::system::error_code const& ec)
 
     if (_state != STATE_CONNECTING) return;
 
-    _restart(lock);
+    // No requests could have been sent while connecting, hence there is
+    // nobody to be notified.
+
+    list<MessageWrapperBase::Ptr> requests2notify;
+    _restart(lock, requests2notify);
 }
 
 
 void MessengerConnector::_sendRequest(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  _inFlight.size=" << _inFlight.size() << "  _requests.size=" << _requests.size());
 
     // Check if there is an outstanding send request
 
-    if (_currentRequest) return;
+    if (not _sending.empty()) return;
 
-    // Pull a request (if any) from the from of the queue
+    // Pull requests (if any) from the front of the queue. Small requests
+    // are batched together while large ones are sent one at a time.
 
-    if (_requests.empty()) return;
+    size_t batchBytes = 0;
+    while (not _requests.empty() and
+           _inFlight.size() + _sending.size() < ::maxRequestsInFlight and
+           _sending.size() < ::maxRequestsPerWrite) {
 
-    _currentRequest = _requests.front();
-    _requests.pop_front();
+        MessageWrapperBase::Ptr const ptr = _requests.front();
+        size_t const bytes = ptr->requestBufferPtr()->size();
+        if (not _sending.empty() and batchBytes + bytes > ::maxBatchedRequestBytes) break;
 
-    // Send the message
+        _sending.push_back(SentRequest{ptr->id(), ptr, string(ptr->requestBufferPtr()->data(), bytes)});
+        _requests.pop_front();
+        batchBytes += bytes;
+    }
+    if (_sending.empty()) return;
+
+    // Send the messages
 
+    vector<boost::asio::const_buffer> buffers;
+    for (auto&& request: _sending) {
+        buffers.emplace_back(
+            request.data.data(),
+            request.data.size()
+        );
+    }
     boost::asio::async_write(
         _socket,
-        boost::asio::buffer(
-            _currentRequest->requestBufferPtr()->data(),
-            _currentRequest->requestBufferPtr()->size()
-        ),
+        buffers,
         boost::bind(
             &MessengerConnector::_requestSent,
             shared_from_this(),
@@ -390,52 +438,52 @@ void MessengerConnector::_requestSent(boost::system::error_code const& ec,
                                       size_t bytes_transferred) {
 
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  _sending.size=" << _sending.size() << "  _inFlight.size=" << _inFlight.size());
 
-    util::Lock lock(_mtx, _context() + __func__);
+    // The notifications if any should be happening outside the lock guard
+    // to prevent deadlocks
 
-    // Check if the request was cancelled while still in flight.
-    // If that happens then _currentRequest should already be nullified
-    // and request removed from all data structures.
+    list<MessageWrapperBase::Ptr> requests2notify;
+    {
+        util::Lock lock(_mtx, _context() + __func__);
 
-    if (_isAborted(ec)) {
-        LOGS(_log, LOG_LVL_DEBUG, _context() << __func__ << "  _isAborted -> restart");
+        // The operation can only be aborted (or be left behind by the previous
+        // connection) by stopping or restarting the connector, and these operations
+        // take care of the requests.
 
-        _restart(lock);
-        return;
-    }
-    if (_currentRequest) {
+        if (_isAborted(ec)) return;
+        if (_state != STATE_COMMUNICATING) return;
 
-        // The request is still valid
         if (ec.value() != 0) {
 
-            // If something bad happened along the line then make sure this request
-            // will be the first to be served before restarting the communication.
+            // If something bad happened along the line then make sure the requests
+            // will be the first to be served after restarting the communication.
 
-            _requests.push_front(_currentRequest);
-            _currentRequest = nullptr;
+            LOGS(_log, LOG_LVL_DEBUG, _context() << __func__ << "  failed -> restart");
 
-            LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-                 << "  request is valid, but failed -> restart");
-
-            _restart(lock);
+            _restart(lock, requests2notify);
 
         } else {
 
-            // Go wait for a server response
+            // Go wait for the server responses while sending the next batch
+            // of requests (if any)
+
+            for (auto&& request: _sending) request.data.clear();
+            _inFlight.splice(_inFlight.end(), _sending);
             _receiveResponse(lock);
+            _sendRequest(lock);
         }
-
-    } else {
-        LOGS(_log, LOG_LVL_DEBUG, _context() << __func__ << "  no current request (cancelled?)");
     }
+    for (auto&& ptr: requests2notify) ptr->parseAndNotify();
 }
 
 
 void MessengerConnector::_receiveResponse(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  _inFlight.size=" << _inFlight.size());
+
+    if (_receiving or _inFlight.empty()) return;
 
     // Start with receiving the fixed length frame carrying
     // the size (in bytes) the length of the subsequent message.
@@ -462,6 +510,7 @@ void MessengerConnector::_receiveResponse(util::Lock const& lock) {
             boost::asio::placeholders::bytes_transferred
         )
     );
+    _receiving = true;
 }
 
 
@@ -469,7 +518,7 @@ void MessengerConnector::_responseReceived(boost::system::error_code const& ec,
                                            size_t bytes_transferred) {
 
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         << "  _inFlight.size=" << _inFlight.size()
          << " error_code=" << ec);
 
     // The notification if any should be happening outside the lock guard
@@ -481,93 +530,68 @@ void MessengerConnector::_responseReceived(boost::system::error_code const& ec,
     // in the input queue. The simplest approach would be probably launch
     // the notification in a separate (new) thread.
 
-    MessageWrapperBase::Ptr request2notify;
+    list<MessageWrapperBase::Ptr> requests2notify;
     {
         util::Lock lock(_mtx, _context() + __func__);
 
-        // Check if the request was cancelled while still in flight.
-        // If that happens then _currentRequest should already be nullified
-        // and request removed from all data structures.
-
-        if (_isAborted(ec)) {
-            _restart(lock);
-            return;
-        }
-
-        if (_currentRequest) {
-
-            // At this point we're done with the current request, regardless of its completion
-            // status, or any failures to pull or digest the response data. Hence, removing
-            // completely it and getting ready to notify a caller.
+        // The operation can only be aborted (or be left behind by the previous
+        // connection) by stopping or restarting the connector, and these operations
+        // take care of the requests.
 
-            swap(request2notify, _currentRequest);
+        if (_isAborted(ec)) return;
+        if (_state != STATE_COMMUNICATING) return;
 
-            // The request is still valid
-            if (ec.value() != 0) {
+        _receiving = false;
 
-                // Failed to get any response from a worker
-                _restart(lock);
-
-            } else {
+        if ((ec.value() != 0) or _inFlight.empty()) {
 
-                // Receive response header into the temporary buffer
-                if (_syncReadVerifyHeader(lock,
-                                          _inBuffer,
-                                          _inBuffer.parseLength(),
-                                          request2notify->id()).value() != 0) {
+            // Failed to get any response from a worker
+            _restart(lock, requests2notify);
 
-                    // Failed to receive the header
-                    _restart(lock);
+        } else {
 
-                } else {
+            // The response is for the oldest outstanding request. The request is
+            // done regardless of its completion status, or any failures to pull
+            // or digest the response data.
+            //
+            // The response to a cancelled request still needs to be read in order
+            // to get to the next one. It's read into the temporary buffer.
 
-                    // Read the response frame
+            SentRequest const request = _inFlight.front();
+            _inFlight.pop_front();
 
-                    size_t bytes;
-                    if (_syncReadFrame(lock,
+            size_t bytes;
+            if ((_syncReadVerifyHeader(lock,
                                        _inBuffer,
-                                       bytes).value() != 0) {
-
-                        // Failed to read the frame
-                        _restart(lock);
-
-                    } else {
+                                       _inBuffer.parseLength(),
+                                       request.id).value() != 0) or
+                (_syncReadFrame(lock,
+                                _inBuffer,
+                                bytes).value() != 0) or
+                (_syncReadMessageImpl(lock,
+                                      request.ptr ? request.ptr->responseBuffer() : _inBuffer,
+                                      bytes).value() != 0)) {
+
+                // Failed to read the response
+                if (request.ptr) requests2notify.push_back(request.ptr);
+                _restart(lock, requests2notify);
 
-                        LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-                             << "  _currentRequest=" << request2notify->id()
-                             << " bytes=" << bytes);
-
-                        // Receive response body into a buffer inside the wrapper
-
-                        if (_syncReadMessageImpl(lock,
-                                                 request2notify->responseBuffer(),
-                                                 bytes).value() != 0) {
-
-                            // Failed to read the message body
-                            _restart(lock);
-
-                        } else {
+            } else {
 
-                            // Finally, success!
-                            request2notify->setSuccess(true);
+                LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
+                     << "  id=" << request.id << " bytes=" << bytes
+                     << (request.ptr ? "" : " (cancelled)"));
 
-                            // Initiate the next request (if any) processing
-                            _sendRequest(lock);
-                        }
-                    }
+                // Finally, success!
+                if (request.ptr) {
+                    request.ptr->setSuccess(true);
+                    requests2notify.push_back(request.ptr);
                 }
-            }
 
-        } else {
+                // Keep receiving responses, and sending more requests since
+                // there is room for one more.
 
-            // We're here because there is no '_currentRequest'.
-            // The request submission had a chance to finish (successfully or not)
-            // before the cancellation attempt was made. So, we just forget about
-            // this request and send no notification to a caller.
-
-            if (ec.value() != 0) {
-                _restart(lock);
-            } else {
+                _receiveResponse(lock);
                 _sendRequest(lock);
             }
         }
@@ -576,7 +600,7 @@ void MessengerConnector::_responseReceived(boost::system::error_code const& ec,
     // Sending notifications (if requested) outsize the lock guard to avoid
     // deadlocks.
 
-    if (request2notify) request2notify->parseAndNotify();
+    for (auto&& ptr: requests2notify) ptr->parseAndNotify();
 }
 
 
@@ -597,7 +621,7 @@ boost::system::error_code MessengerConnector::_syncReadFrame(util::Lock const& l
         ec
     );
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         << "  _inFlight.size=" << _inFlight.size()
          << " error_code=" << ec);
 
     if (ec.value() == 0) bytes = buf.parseLength();
@@ -642,7 +666,7 @@ boost::system::error_code MessengerConnector::_syncReadMessageImpl(util::Lock co
         ec
     );
     LOGS(_log, LOG_LVL_DEBUG, _context() << __func__
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         << "  _inFlight.size=" << _inFlight.size()
          << " error_code=" << ec);
 
     return ec;
@@ -673,7 +697,14 @@ MessageWrapperBase::Ptr MessengerConnector::_find(util::Lock const& lock,
                            return ptr->id() == id;
                        });
 
-    return _requests.end() == itr ? MessageWrapperBase::Ptr() : *itr;
+    if (_requests.end() != itr) return *itr;
+
+    for (auto&& sent: {&_sending, &_inFlight}) {
+        for (auto&& request: *sent) {
+            if (request.ptr and (request.id == id)) return request.ptr;
+        }
+    }
+    return MessageWrapperBase::Ptr();
 }
 
 }}} // namespace lsst::qserv::replica
@@ -208,6 +208,21 @@ private:
  * messages to and from worker services. It provides connection multiplexing and
  * automatic reconnects.
  *
+ * NOTES ON PIPELINING:
+ *
+ * - requests are sent without waiting for the responses to the previously
+ *   sent ones. Up to a limited number of requests can be outstanding at a time.
+ *
+ * - the queued requests which are small enough are sent together in a single
+ *   write (one network frame), the worker reads them one by one.
+ *
+ * - the worker service processes requests of a connection in the order they
+ *   are received, and it responds in the same order. Each response is matched
+ *   by the identifier in its header against the oldest outstanding request.
+ *
+ * - cancelling an outstanding request doesn't interrupt the communication.
+ *   The response is read and discarded when it arrives.
+ *
  * NOTES ON THREAD SAFETY:
  *
  * - in the implementation of this class a mutex is used to prevent race conditions
@@ -301,10 +316,8 @@ public:
      * Cancel an outstanding transaction
      *
      * If this call succeeds there won't be any 'onFinish' callback made
-     * as provided to the 'onFinish' method in method 'send'.
-     *
-     * The method may throw std::logic_error if the Messenger doesn't have
-     * a transaction registered with the specified transaction 'id'.
+     * as provided to the 'onFinish' method in method 'send'. If the request
+     * has already been sent then its response will be ignored.
      *
      * @param id
      *   a unique identifier of a request
@@ -351,11 +364,32 @@ private:
     /// @return the string representation of the connector's state
     static std::string _state2string(State state);
 
+    /**
+     * A request which has been (or is being) sent to a worker. The pointer
+     * to the request's wrapper is reset if the request gets cancelled. The entry
+     * is still kept since the worker's response will need to be read.
+     */
+    struct SentRequest {
+
+        /// A unique identifier of the request
+        std::string id;
+
+        /// The request's wrapper (nullptr if the request was cancelled)
+        MessageWrapperBase::Ptr ptr;
+
+        /// A copy of the serialized request which is kept until the request
+        /// is sent. The copy is needed since the owner of the request may reuse
+        /// its buffer after cancelling the request.
+        std::string data;
+    };
+
     /**
      * Restart the whole operation from scratch.
      *
-     * Cancel any asynchronous operation(s) if not in the initial state
-     * w/o notifying a subscriber.
+     * Cancel any asynchronous operation(s) if not in the initial state.
+     * Requests which are being sent are put back into the queue to be sent
+     * again once the connection is restored. The outstanding requests
+     * whose responses have not been received are reported as failed.
      *
      * @note
      *   This method is called internally when there is a doubt that
@@ -363,8 +397,13 @@ private:
      *
      * @param lock
      *   a lock on MessengerConnector::_mtx must be acquired before calling this method
+     *
+     * @param requests2notify
+     *   the collection to be extended with the failed requests whose subscribers
+     *   are to be notified after releasing the lock
      */
-    void _restart(util::Lock const& lock);
+    void _restart(util::Lock const& lock,
+                  std::list<MessageWrapperBase::Ptr>& requests2notify);
 
     /**
      * Start resolving the destination worker host & port
@@ -426,8 +465,9 @@ private:
     void _awakenForRestart(boost::system::error_code const& ec);
 
     /**
-     * Lookup for the next available request and begin sending it
-     * unless there is another ongoing request at a time of the call.
+     * Begin sending the next batch of the queued requests (if any) unless
+     * another batch is being sent, or the limit for the number of outstanding
+     * requests has been reached.
      * 
      * @param lock
      *   a lock on MessengerConnector::_mtx must be acquired before calling this method
@@ -447,7 +487,8 @@ private:
                       size_t bytes_transferred);
 
     /**
-     * Begin receiving a response
+     * Begin receiving a response unless one is being received, or there
+     * are no outstanding requests.
      * 
      * @param lock
      *   a lock on MessengerConnector::_mtx must be acquired before calling this method
@@ -561,7 +602,8 @@ private:
     std::string _context() const;
 
     /**
-     * Find a request matching the specified identifier
+     * Find a request matching the specified identifier among the queued,
+     * being sent or outstanding (not cancelled) requests.
      *
      * @param lock
      *   a lock on MessengerConnector::_mtx must be acquired before calling this method
@@ -607,9 +649,14 @@ private:
     /// The queue (FIFO) of requests
     std::list<MessageWrapperBase::Ptr> _requests;
 
-    /// The currently processed (being sent) request (if any, otherwise
-    /// the pointer is set to nullptr)
-    MessageWrapperBase::Ptr _currentRequest;
+    /// The batch of requests which is being sent
+    std::list<SentRequest> _sending;
+
+    /// Requests which have been sent, in the order they were sent
+    std::list<SentRequest> _inFlight;
+
+    /// Set while a response is being received
+    bool _receiving;
 
     /// The intermediate buffer for messages received from a worker
     ProtocolBuffer _inBuffer;
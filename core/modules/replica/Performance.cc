@@ -23,6 +23,7 @@
 #include "replica/Performance.h"
 
 // System headers
+#include <algorithm>
 #include <chrono>
 #include <stdexcept>
 
@@ -133,4 +134,32 @@ ostream& operator<<(ostream& os, WorkerPerformance const& p) {
     return os;
 }
 
+
+void WorkerQueuePerformance::update(WorkerPerformance const& performance) {
+    uint64_t const waitTime =
+        performance.start_time > performance.receive_time ?
+        performance.start_time - performance.receive_time : 0;
+    ++num_requests;
+    total_wait_time += waitTime;
+    max_wait_time = max(max_wait_time, waitTime);
+}
+
+
+unique_ptr<ProtocolQueuePerformance> WorkerQueuePerformance::info() const {
+    auto ptr = make_unique<ProtocolQueuePerformance>();
+    ptr->set_num_requests(num_requests);
+    ptr->set_total_wait_time(total_wait_time);
+    ptr->set_max_wait_time(max_wait_time);
+    return ptr;
+}
+
+
+ostream& operator<<(ostream& os, WorkerQueuePerformance const& p) {
+    os  << "WorkerQueuePerformance "
+        << " requests:"     << p.num_requests
+        << " wait.avg.sec:" << (p.num_requests ? p.total_wait_time/1000./p.num_requests : 0.)
+        << " wait.max.sec:" << p.max_wait_time/1000.;
+    return os;
+}
+
 }}} // namespace lsst::qserv::replica
\ No newline at end of file
@@ -36,6 +36,7 @@ namespace lsst {
 namespace qserv {
 namespace replica {
     class ProtocolPerformance;
+    class ProtocolQueuePerformance;
 }}}  // Forward declarations
 
 // This header declarations
@@ -152,6 +153,40 @@ public:
 
 std::ostream& operator<<(std::ostream& os, WorkerPerformance const&p);
 
+/**
+ * Class WorkerQueuePerformance is worker-side value class with the queue wait
+ * time counters of a class of requests.
+ *
+ * All time counters are expressed in milliseconds.
+ */
+class WorkerQueuePerformance {
+
+public:
+
+    WorkerQueuePerformance() = default;
+
+    WorkerQueuePerformance(WorkerQueuePerformance const&) = default;
+    WorkerQueuePerformance& operator=(WorkerQueuePerformance const&) = default;
+
+    ~WorkerQueuePerformance() = default;
+
+    /**
+     * Account for a request whose execution has started
+     *
+     * @param performance
+     *   the performance counters of the request
+     */
+    void update(WorkerPerformance const& performance);
+
+    std::unique_ptr<ProtocolQueuePerformance> info() const;
+
+    uint64_t num_requests    = 0;   /// Requests whose execution was started
+    uint64_t total_wait_time = 0;   /// Total time spent by the requests in the queue
+    uint64_t max_wait_time   = 0;   /// Longest time spent by a request in the queue
+};
+
+std::ostream& operator<<(std::ostream& os, WorkerQueuePerformance const&p);
+
 }}} // namespace lsst::qserv::replica
 
 #endif // LSST_QSERV_REPLICA_PERFORMANCE_H
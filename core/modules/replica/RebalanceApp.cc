@@ -52,11 +52,13 @@ void printPlan(RebalanceJobResult const& r) {
          << "  totalWorkers:    " << r.totalWorkers    << "  (not counting workers which failed to report chunks)\n"
          << "  totalGoodChunks: " << r.totalGoodChunks << "  (good chunks reported by the precursor job)\n"
          << "  avgChunks:       " << r.avgChunks       << "\n"
+         << "  planBytes:       " << r.planBytes       << "  (the total number of bytes to be moved)\n"
          << "\n";
 
     vector<unsigned int> columnChunk;
     vector<string>       columnSourceWorker;
     vector<string>       columnDestinationWorker;
+    vector<uint64_t>     columnBytes;
 
     for (auto&& chunkEntry: r.plan) {
         auto const chunkNumber = chunkEntry.first;
@@ -68,6 +70,7 @@ void printPlan(RebalanceJobResult const& r) {
             columnChunk            .push_back(chunkNumber);
             columnSourceWorker     .push_back(sourceWorker);
             columnDestinationWorker.push_back(destinationWorker);
+            columnBytes            .push_back(r.chunkSizes.at(chunkNumber).at(sourceWorker));
         }
     }
     util::ColumnTablePrinter table("", "  ", false);
@@ -75,6 +78,7 @@ void printPlan(RebalanceJobResult const& r) {
     table.addColumn("chunk",              columnChunk );
     table.addColumn("source worker",      columnSourceWorker,      util::ColumnTablePrinter::LEFT);
     table.addColumn("destination worker", columnDestinationWorker, util::ColumnTablePrinter::LEFT);
+    table.addColumn("bytes",              columnBytes);
 
     table.print(cout, false, false);
 
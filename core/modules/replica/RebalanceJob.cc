@@ -25,7 +25,6 @@
 // System headers
 #include <algorithm>
 #include <limits>
-#include <set>
 #include <stdexcept>
 
 // Qserv headers
@@ -312,6 +311,7 @@ void RebalanceJob::_onPrecursorJobFinish() {
             worker2chunks[worker] = map<unsigned int,bool>();
         }
     }
+    _replicaData.chunkSizes.clear();
     for (auto chunk: replicaData.chunks.chunkNumbers()) {
 
         // skip the special chunk which must be present on all workers
@@ -324,6 +324,11 @@ void RebalanceJob::_onPrecursorJobFinish() {
 
             for (auto&& worker: databaseMap.workerNames()) {
                 worker2chunks[worker][chunk] = true;
+
+                uint64_t& size = _replicaData.chunkSizes[chunk][worker];
+                for (auto&& fileInfo: databaseMap.worker(worker).fileInfo()) {
+                    size += fileInfo.size;
+                }
             }
         }
     }
@@ -445,14 +450,33 @@ void RebalanceJob::_onPrecursorJobFinish() {
     //   flag for this job could be introduced to let a caller know about
     //   this situation.
     //
+    // - the number of chunks to be moved from each source worker is fixed by
+    //   the average. Hence the smallest chunks of a source worker are moved
+    //   first, which minimizes the number of bytes to be moved. When several
+    //   destination workers have the same number of available slots the one
+    //   with the fewest bytes planned to be moved in is selected.
+    //
     // ATTENTION: this algorithm may need to be optimized for performance
 
     _replicaData.plan.clear();
+    _replicaData.planBytes = 0;
+
+    map<string, uint64_t> destinationBytes;
 
     for (auto&& sourceWorkerEntry: sourceWorkers) {
 
         string               const& sourceWorker   = sourceWorkerEntry.first;
-        vector<unsigned int> const& chunks         = sourceWorkerEntry.second;
+        vector<unsigned int>        chunks         = sourceWorkerEntry.second;
+
+        auto&& chunkSizes = _replicaData.chunkSizes;
+        stable_sort(
+            chunks.begin(),
+            chunks.end(),
+            [&chunkSizes, &sourceWorker] (unsigned int a,
+                                          unsigned int b) {
+                return chunkSizes[a][sourceWorker] < chunkSizes[b][sourceWorker];
+            }
+        );
 
         // This number (below) will get decremented in the chunks loop later when
         // looking for chunks to be moved elsewhere.
@@ -467,13 +491,15 @@ void RebalanceJob::_onPrecursorJobFinish() {
             if (not numExtraChunks) break;
 
             // Always sort the collection in the descending order to make sure
-            // least populated workers are considered first
+            // least populated workers are considered first, and then by the bytes
+            // to be moved in (ascending order)
             sort(
                 destinationWorkers.begin(),
                 destinationWorkers.end(),
-                [] (pair<string, size_t> const& a,
-                    pair<string, size_t> const& b) {
-                    return b.second < a.second;
+                [&destinationBytes] (pair<string, size_t> const& a,
+                                     pair<string, size_t> const& b) {
+                    if (b.second != a.second) return b.second < a.second;
+                    return destinationBytes[a.first] < destinationBytes[b.first];
                 }
             );
 
@@ -498,12 +524,20 @@ void RebalanceJob::_onPrecursorJobFinish() {
                 worker2chunks[destinationWorker][chunk] = true;
                 numSlots--;
 
+                uint64_t const size = _replicaData.chunkSizes[chunk][sourceWorker];
+                destinationBytes[destinationWorker] += size;
+                _replicaData.planBytes += size;
+
                 --numExtraChunks;
                 break;
             }
         }
     }
 
+    LOGS(_log, LOG_LVL_DEBUG, context() << __func__
+         << "  planned moves: " << _replicaData.plan.size()
+         << " planBytes: " << _replicaData.planBytes);
+
     // Finish right away if the 'estimate' mode requested.
     if (estimateOnly()) {
         finish(lock, ExtendedState::SUCCESS);
@@ -554,16 +588,10 @@ void RebalanceJob::_onPrecursorJobFinish() {
     }
 
     // Otherwise start the first batch of jobs. The number of jobs in
-    // the batch is determined by the number of source workers in
-    // the above prepared plan multiplied by the number of worker-side
-    // processing threads.
+    // the batch is limited by the number of worker-side processing threads
+    // at both ends of the transfers (see RebalanceJob::_launchNextJobs()).
 
-    set<string> uniqueDestinationWorkers;
-    for (auto&& ptr: _jobs) {
-        uniqueDestinationWorkers.insert(ptr->destinationWorker());
-    }
-    size_t const numJobs = uniqueDestinationWorkers.size() *
-        controller()->serviceProvider()->config()->workerNumProcessingThreads();
+    size_t const numJobs = _jobs.size();
 
     size_t const numJobsLaunched = _launchNextJobs(lock, numJobs);
     if (0 != numJobsLaunched) {
@@ -631,9 +659,10 @@ void RebalanceJob::_onJobFinish(MoveReplicaJob::Ptr const& job) {
         }
     }
 
-    // Try to submit one more job
+    // Try to submit more jobs. More than one job may be launched if
+    // the workers of the finished job were the only ones which were busy.
 
-    size_t const numJobsLaunched = _launchNextJobs(lock, 1);
+    size_t const numJobsLaunched = _launchNextJobs(lock, _jobs.size());
     if (numJobsLaunched != 0) {
         _numLaunched += numJobsLaunched;
     } else {
@@ -654,61 +683,95 @@ size_t RebalanceJob::_launchNextJobs(util::Lock const& lock,
 
     LOGS(_log, LOG_LVL_DEBUG, context() << __func__ << "  numJobs=" << numJobs);
 
-    // Compute the number of jobs which are already active at both ends
-    // (destination and source workers).
+    // The maximum number of concurrent transfers at each worker
+
+    size_t const maxJobsPerWorker =
+        max(size_t(1), controller()->serviceProvider()->config()->workerNumProcessingThreads());
 
-    map<string, size_t> numAtDest;
-    map<string, size_t> numAtSrc;
+    // Compute the number of jobs and bytes which are already being moved
+    // by the workers (at both ends of transfers), and the bytes which are
+    // yet to be moved from the source workers.
 
+    map<string, size_t>   numAtWorker;
+    map<string, uint64_t> bytesAtWorker;
+    map<string, uint64_t> bytesPendingAtSrc;
+
+    auto const jobBytes = [&] (MoveReplicaJob::Ptr const& ptr) -> uint64_t {
+        return _replicaData.chunkSizes[ptr->chunk()][ptr->sourceWorker()];
+    };
     for (auto&& ptr: _activeJobs) {
-        numAtDest[ptr->destinationWorker()]++;
-        numAtSrc [ptr->sourceWorker()]++;
+        uint64_t const bytes = jobBytes(ptr);
+        numAtWorker  [ptr->destinationWorker()]++;
+        numAtWorker  [ptr->sourceWorker()]++;
+        bytesAtWorker[ptr->destinationWorker()] += bytes;
+        bytesAtWorker[ptr->sourceWorker()]      += bytes;
+    }
+    for (auto&& ptr: _jobs) {
+        bytesPendingAtSrc[ptr->sourceWorker()] += jobBytes(ptr);
     }
-    
+
     // Try to fulfill the request (to submit the given number of jobs)
     // by evaluating best candidates using an algorithm explained
     // within the loop below.
-    
+
     size_t numJobsLaunched = 0;
     for (size_t i = 0; i < numJobs; ++i) {
 
         // THE LOAD BALANCING ALGORITHM:
         //
         //   The algorithms evaluates candidates (pairs of (dstWorker,srcWorker))
-        //   to find the one which allows more even spread of load among the destination
-        //   and source workers. For each pair of the workers the algorithm computes
-        //   a 'load' which is just a sum of the on-going activities at both ends of
-        //   the proposed transfer:
+        //   which have free transfer slots at both ends. Since the network links of
+        //   workers are shared by the concurrent transfers, the candidate which adds
+        //   to the fewest bytes being moved at its ends is selected:
         //
-        //     load := numAtDest[destWorker] + numAtSrc[srcWorker]
+        //     load := bytesAtWorker[destWorker] + bytesAtWorker[srcWorker]
         //
-        //   A part which has the lowest number will be selected.
+        //   Ties are resolved in favor of the source workers with the most bytes
+        //   left to be moved, and then of the largest chunks. This starts the long
+        //   tails of the schedule first, so that they overlap with shorter transfers.
 
-        size_t minLoad = numeric_limits<unsigned long long>::max();
         MoveReplicaJob::Ptr job;
-
-        for (auto&& ptr: _jobs) {            
-            size_t const load = numAtDest[ptr->destinationWorker()] +
-                                numAtSrc [ptr->sourceWorker()];
-            if (load <= minLoad) {
-                minLoad = load;
+        uint64_t minLoad = numeric_limits<uint64_t>::max();
+        uint64_t maxPending = 0;
+        uint64_t maxBytes = 0;
+
+        for (auto&& ptr: _jobs) {
+            if (numAtWorker[ptr->destinationWorker()] >= maxJobsPerWorker) continue;
+            if (numAtWorker[ptr->sourceWorker()]      >= maxJobsPerWorker) continue;
+
+            uint64_t const load    = bytesAtWorker[ptr->destinationWorker()] +
+                                     bytesAtWorker[ptr->sourceWorker()];
+            uint64_t const pending = bytesPendingAtSrc[ptr->sourceWorker()];
+            uint64_t const bytes   = jobBytes(ptr);
+
+            if ((nullptr == job) or
+                (load < minLoad) or
+                (load == minLoad and pending > maxPending) or
+                (load == minLoad and pending == maxPending and bytes > maxBytes)) {
                 job = ptr;
+                minLoad = load;
+                maxPending = pending;
+                maxBytes = bytes;
             }
         }
-        if (nullptr != job) {
+        if (nullptr == job) break;
 
-            // Update occupancy of the worker nodes at both ends
-            numAtDest[job->destinationWorker()]++;
-            numAtSrc [job->sourceWorker()]++;
+        // Update occupancy of the worker nodes at both ends
 
-            // Move the job into another queue
-            _activeJobs.push_back(job);
-            _jobs.remove(job);
+        uint64_t const bytes = jobBytes(job);
+        numAtWorker  [job->destinationWorker()]++;
+        numAtWorker  [job->sourceWorker()]++;
+        bytesAtWorker[job->destinationWorker()] += bytes;
+        bytesAtWorker[job->sourceWorker()]      += bytes;
+        bytesPendingAtSrc[job->sourceWorker()]  -= bytes;
 
-            // Let it run
-            job->start();
-            numJobsLaunched++;
-        }
+        // Move the job into another queue
+        _activeJobs.push_back(job);
+        _jobs.remove(job);
+
+        // Let it run
+        job->start();
+        numJobsLaunched++;
     }
     return numJobsLaunched;
 }
@@ -78,11 +78,18 @@ struct RebalanceJobResult {
              std::map<std::string,          // source worker
                       std::string>> plan;   // destination worker
 
+    /// The sizes (bytes) of the chunk replicas, summed over all databases
+    /// of the family, which are used for planning and scheduling the moves.
+    std::map<unsigned int,                  // chunk
+             std::map<std::string,          // worker
+                      uint64_t>> chunkSizes;
+
     // Parameters of the planner
 
     size_t totalWorkers    = 0;     /// not counting workers which failed to report chunks
     size_t totalGoodChunks = 0;     /// good chunks reported by the precursor job
     size_t avgChunks       = 0;     /// per worker average
+    uint64_t planBytes     = 0;     /// the total number of bytes to be moved by the plan
 };
 
 /**
@@ -255,7 +262,10 @@ private:
      *
      * This method implements a load balancing algorithm which tries to
      * prevent excessive use of resources by controllers and to avoid
-     * "hot spots" or under-utilization at workers.
+     * "hot spots" or under-utilization at workers. The number of concurrent
+     * transfers at each worker is limited by the number of the worker's
+     * processing threads, and the jobs are picked to even out the bytes which
+     * are being transferred by the workers (and their network links).
      *
      * @param lock
      *   a lock on Job::_mtx must be acquired before calling this method
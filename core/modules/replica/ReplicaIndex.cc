@@ -0,0 +1,264 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "replica/ReplicaIndex.h"
+
+// System headers
+#include <set>
+
+// Qserv headers
+#include "lsst/log/Log.h"
+#include "replica/Common.h"
+#include "replica/DatabaseServices.h"
+
+using namespace std;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.ReplicaIndex");
+
+} /// namespace
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+ReplicaIndex::Ptr ReplicaIndex::create() {
+    return ReplicaIndex::Ptr(new ReplicaIndex());
+}
+
+
+void ReplicaIndex::load(DatabaseServices& databaseServices) {
+
+    string const context = "ReplicaIndex::" + string(__func__) + " ";
+
+    LOGS(_log, LOG_LVL_DEBUG, context);
+
+    {
+        util::Lock lock(_mtx, context);
+        _loading = true;
+        _pendingUpdates.clear();
+    }
+
+    // Updates are recorded while reading since the replicas which are read
+    // may or may not include them.
+
+    vector<ReplicaInfo> replicas;
+    try {
+        databaseServices.findAllReplicas(replicas);
+    } catch (exception const& ex) {
+        LOGS(_log, LOG_LVL_ERROR, context << "failed, exception: " << ex.what());
+        util::Lock lock(_mtx, context);
+        _loading = false;
+        _pendingUpdates.clear();
+        throw;
+    }
+
+    util::Lock lock(_mtx, context);
+
+    _databases.clear();
+    for (auto&& replica: replicas) {
+        _update(lock, replica);
+    }
+    for (auto&& update: _pendingUpdates) {
+        update(lock);
+    }
+    LOGS(_log, LOG_LVL_DEBUG, context << "** DONE ** replicas.size(): " << replicas.size()
+         << " pending updates: " << _pendingUpdates.size());
+
+    _pendingUpdates.clear();
+    _loading = false;
+    _loaded  = true;
+}
+
+
+bool ReplicaIndex::loaded() const {
+    util::Lock lock(_mtx, "ReplicaIndex::" + string(__func__));
+    return _loaded;
+}
+
+
+size_t ReplicaIndex::numReplicas() const {
+
+    util::Lock lock(_mtx, "ReplicaIndex::" + string(__func__));
+
+    size_t num = 0;
+    for (auto&& databaseEntry: _databases) {
+        for (auto&& chunkEntry: databaseEntry.second) {
+            num += chunkEntry.second.size();
+        }
+    }
+    return num;
+}
+
+
+void ReplicaIndex::update(ReplicaInfo const& info) {
+
+    util::Lock lock(_mtx, "ReplicaIndex::" + string(__func__));
+
+    if (_loading) {
+        _pendingUpdates.push_back(
+            [this, info] (util::Lock const& lock) {
+                _update(lock, info);
+            }
+        );
+    }
+    if (_loaded) _update(lock, info);
+}
+
+
+void ReplicaIndex::update(string const& worker,
+                          string const& database,
+                          ReplicaInfoCollection const& infoCollection) {
+
+    util::Lock lock(_mtx, "ReplicaIndex::" + string(__func__));
+
+    if (_loading) {
+        _pendingUpdates.push_back(
+            [this, worker, database, infoCollection] (util::Lock const& lock) {
+                _update(lock, worker, database, infoCollection);
+            }
+        );
+    }
+    if (_loaded) _update(lock, worker, database, infoCollection);
+}
+
+
+map<unsigned int, size_t> ReplicaIndex::actualReplicationLevel(
+                                    string const& database,
+                                    vector<string> const& workersToExclude) const {
+
+    util::Lock lock(_mtx, "ReplicaIndex::" + string(__func__));
+
+    map<unsigned int, size_t> result;
+
+    auto const databaseItr = _databases.find(database);
+    if (databaseItr == _databases.end()) return result;
+
+    set<string> const excluded(workersToExclude.begin(), workersToExclude.end());
+    for (auto&& chunkEntry: databaseItr->second) {
+        if (chunkEntry.first == overflowChunkNumber) continue;
+
+        unsigned int level = 0;
+        for (auto&& workerEntry: chunkEntry.second) {
+            if (not excluded.count(workerEntry.first)) ++level;
+        }
+        if (level > 0) ++result[level];
+    }
+    return result;
+}
+
+
+size_t ReplicaIndex::numOrphanChunks(string const& database,
+                                     vector<string> const& uniqueOnWorkers,
+                                     vector<string> const& otherWorkers) const {
+
+    util::Lock lock(_mtx, "ReplicaIndex::" + string(__func__));
+
+    size_t result = 0;
+
+    auto const databaseItr = _databases.find(database);
+    if (databaseItr == _databases.end() or uniqueOnWorkers.empty() or otherWorkers.empty()) {
+        return result;
+    }
+    set<string> const unique(uniqueOnWorkers.begin(), uniqueOnWorkers.end());
+    set<string> const other(otherWorkers.begin(), otherWorkers.end());
+    for (auto&& chunkEntry: databaseItr->second) {
+        if (chunkEntry.first == overflowChunkNumber) continue;
+
+        size_t numUnique = 0;
+        bool onOther = false;
+        for (auto&& workerEntry: chunkEntry.second) {
+            if (other.count(workerEntry.first)) {
+                onOther = true;
+                break;
+            }
+            if (unique.count(workerEntry.first)) ++numUnique;
+        }
+        if (not onOther) result += numUnique;
+    }
+    return result;
+}
+
+
+ReplicaIndex::ChunkReplicas ReplicaIndex::chunkReplicas(string const& database) const {
+
+    util::Lock lock(_mtx, "ReplicaIndex::" + string(__func__));
+
+    auto const databaseItr = _databases.find(database);
+    if (databaseItr == _databases.end()) return ChunkReplicas();
+    return databaseItr->second;
+}
+
+
+void ReplicaIndex::_update(util::Lock const& lock,
+                           ReplicaInfo const& info) {
+
+    if (info.status() == ReplicaInfo::Status::COMPLETE) {
+        _databases[info.database()][info.chunk()][info.worker()] = info;
+        return;
+    }
+
+    auto const databaseItr = _databases.find(info.database());
+    if (databaseItr == _databases.end()) return;
+
+    auto&& chunks = databaseItr->second;
+    auto const chunkItr = chunks.find(info.chunk());
+    if (chunkItr == chunks.end()) return;
+
+    chunkItr->second.erase(info.worker());
+    if (chunkItr->second.empty()) {
+        chunks.erase(chunkItr);
+        if (chunks.empty()) _databases.erase(databaseItr);
+    }
+}
+
+
+void ReplicaIndex::_update(util::Lock const& lock,
+                           string const& worker,
+                           string const& database,
+                           ReplicaInfoCollection const& infoCollection) {
+
+    // Forget all replicas of the worker in the database, then add the ones
+    // which are reported.
+
+    auto const databaseItr = _databases.find(database);
+    if (databaseItr != _databases.end()) {
+        auto&& chunks = databaseItr->second;
+        for (auto chunkItr = chunks.begin(); chunkItr != chunks.end();) {
+            chunkItr->second.erase(worker);
+            if (chunkItr->second.empty()) {
+                chunkItr = chunks.erase(chunkItr);
+            } else {
+                ++chunkItr;
+            }
+        }
+        if (chunks.empty()) _databases.erase(databaseItr);
+    }
+    for (auto&& info: infoCollection) {
+        if (info.worker() == worker and info.database() == database) {
+            _update(lock, info);
+        }
+    }
+}
+
+}}} // namespace lsst::qserv::replica
@@ -0,0 +1,215 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_REPLICA_REPLICAINDEX_H
+#define LSST_QSERV_REPLICA_REPLICAINDEX_H
+
+// System headers
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "replica/ReplicaInfo.h"
+#include "util/Mutex.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace replica {
+    class DatabaseServices;
+}}} // Forward declarations
+
+// This header declarations
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+/**
+ * Class ReplicaIndex is a thread-safe in-memory copy of the replica
+ * placement recorded in the persistent state of the system (table 'replica'
+ * and its files), organized by databases and chunks.
+ *
+ * The index is loaded once with a single read of all replicas, and it's kept
+ * current afterwards by applying the same updates as the ones which are made
+ * to the persistent state (see DatabaseServicesPool). Until the index is
+ * loaded it's empty, and the queries on the replica placement should be
+ * sent to the database services.
+ *
+ * @note
+ *   only the updates made through the DatabaseServicesPool of this process
+ *   reach the index. Replicas saved by other processes, such as the command
+ *   line job tools, are missing from it until it's loaded again. The index
+ *   is meant for the monitoring queries of the Master Controller, the exact
+ *   placement should be read from the database services.
+ */
+class ReplicaIndex {
+
+public:
+
+    /// The pointer type for instances of the class
+    typedef std::shared_ptr<ReplicaIndex> Ptr;
+
+    /// Replicas of a chunk by the names of workers
+    typedef std::map<std::string, ReplicaInfo> WorkerReplicas;
+
+    /// Replicas of chunks of a database by the chunk numbers
+    typedef std::map<unsigned int, WorkerReplicas> ChunkReplicas;
+
+    /// @return a new, not loaded index
+    static Ptr create();
+
+    // Copy semantics is prohibited
+
+    ReplicaIndex(ReplicaIndex const&) = delete;
+    ReplicaIndex& operator=(ReplicaIndex const&) = delete;
+
+    ~ReplicaIndex() = default;
+
+    /**
+     * Read all replicas from the persistent state and replace the contents
+     * of the index with them. Updates made while the replicas are read are
+     * applied after that, so none is lost.
+     *
+     * @param databaseServices
+     *   the services used for reading the replicas
+     *
+     * @throws database::mysql::Error
+     *   if the replicas couldn't be read, the index stays as before then
+     */
+    void load(DatabaseServices& databaseServices);
+
+    /// @return 'true' if the index has been loaded
+    bool loaded() const;
+
+    /// @return the total number of replicas in the index
+    size_t numReplicas() const;
+
+    /**
+     * Update a replica in the same way as DatabaseServices::saveReplicaInfo()
+     * does: complete replicas are added or replaced, others are removed.
+     *
+     * @param info
+     *   a replica to be added/updated or deleted
+     */
+    void update(ReplicaInfo const& info);
+
+    /**
+     * Resync replicas of a worker and a database in the same way as
+     * DatabaseServices::saveReplicaInfoCollection() does.
+     *
+     * @param worker
+     *   worker name
+     *
+     * @param database
+     *   database name
+     *
+     * @param infoCollection
+     *   all replicas found at the worker, replicas of other workers or
+     *   databases are ignored
+     */
+    void update(std::string const& worker,
+                std::string const& database,
+                ReplicaInfoCollection const& infoCollection);
+
+    /**
+     * @return
+     *   a map of the number of chunks (values) by the replication level
+     *   (keys), see DatabaseServices::actualReplicationLevel()
+     *
+     * @param database
+     *   the name of a database
+     *
+     * @param workersToExclude
+     *   workers whose replicas are not counted
+     */
+    std::map<unsigned int, size_t> actualReplicationLevel(
+                                        std::string const& database,
+                                        std::vector<std::string> const& workersToExclude =
+                                            std::vector<std::string>()) const;
+
+    /**
+     * @return
+     *   the number of replicas of chunks of a database on the specified workers
+     *   which have no replicas on any of the other workers, see
+     *   DatabaseServices::numOrphanChunks()
+     *
+     * @param database
+     *   the name of a database
+     *
+     * @param uniqueOnWorkers
+     *   the workers where to look for the chunks
+     *
+     * @param otherWorkers
+     *   the workers whose replicas make a chunk not to be an orphan, usually
+     *   the workers of the configuration which are not in 'uniqueOnWorkers'.
+     *   Replicas on workers in neither collection are ignored, and nothing
+     *   is counted if this collection is empty.
+     */
+    size_t numOrphanChunks(std::string const& database,
+                           std::vector<std::string> const& uniqueOnWorkers,
+                           std::vector<std::string> const& otherWorkers) const;
+
+    /**
+     * @return
+     *   a copy of the replicas of a database, including the 'overflow'
+     *   chunk if it has any
+     *
+     * @param database
+     *   the name of a database
+     */
+    ChunkReplicas chunkReplicas(std::string const& database) const;
+
+private:
+
+    /// @see ReplicaIndex::create()
+    ReplicaIndex() = default;
+
+    /// Implement ReplicaIndex::update(ReplicaInfo const&) with a lock held
+    void _update(util::Lock const& lock,
+                 ReplicaInfo const& info);
+
+    /// Implement ReplicaIndex::update(worker,database,infoCollection) with a lock held
+    void _update(util::Lock const& lock,
+                 std::string const& worker,
+                 std::string const& database,
+                 ReplicaInfoCollection const& infoCollection);
+
+    /// Replicas of the databases by the database names
+    std::map<std::string, ChunkReplicas> _databases;
+
+    /// Set once the index has been loaded
+    bool _loaded = false;
+
+    /// Set while the replicas are read by ReplicaIndex::load()
+    bool _loading = false;
+
+    /// Updates made while loading, to be applied after the replicas are read
+    std::vector<std::function<void(util::Lock const&)>> _pendingUpdates;
+
+    /// The mutex for enforcing thread safety of the class's public API
+    mutable util::Mutex _mtx;
+};
+
+}}} // namespace lsst::qserv::replica
+
+#endif // LSST_QSERV_REPLICA_REPLICAINDEX_H
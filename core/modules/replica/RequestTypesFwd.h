@@ -79,10 +79,12 @@ typedef std::function<void(EchoRequestPtr)> EchoRequestCallbackType;
 /////////////////////////////////////////////////
 
 class SqlRequest;
+struct SqlResultSet;
 
 typedef std::shared_ptr<SqlRequest> SqlRequestPtr;
 
 typedef std::function<void(SqlRequestPtr)> SqlRequestCallbackType;
+typedef std::function<void(SqlRequestPtr, SqlResultSet const&)> SqlRequestPageCallbackType;
 
 ////////////////////////////////////
 // Replication request management //
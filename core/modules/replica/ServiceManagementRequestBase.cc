@@ -59,6 +59,22 @@ void dumpRequestInfo(ostream& os,
     }
 }
 
+void dumpQueueInfo(ostream& os,
+                   vector<ProtocolServiceQueue> const& queues) {
+
+    for (auto&& q : queues) {
+        auto&& p = q.performance();
+        os  << "\n"
+            << "    class:              " << q.name() << "\n"
+            << "    threads:            " << q.num_threads() << "\n"
+            << "    new requests:       " << q.num_new_requests() << "\n"
+            << "    in-progress:        " << q.num_in_progress_requests() << "\n"
+            << "    started requests:   " << p.num_requests() << "\n"
+            << "    avg wait time [ms]: " << (p.num_requests() ? p.total_wait_time() / p.num_requests() : 0) << "\n"
+            << "    max wait time [ms]: " << p.max_wait_time() << "\n";
+    }
+}
+
 } /// namespace
 
 namespace lsst {
@@ -120,6 +136,9 @@ void ServiceState::set(ProtocolServiceResponse const& message) {
     for (int num = message.finished_requests_size(), idx = 0; idx < num; ++idx) {
        finishedRequests.emplace_back(message.finished_requests(idx));
     }
+    for (int num = message.queues_size(), idx = 0; idx < num; ++idx) {
+       queues.emplace_back(message.queues(idx));
+    }
 }
 
 
@@ -136,6 +155,9 @@ ostream& operator<<(ostream& os, ServiceState const& ss) {
         << "    total in-progress requests: " << ss.numInProgressRequests << "\n"
         << "    total finished requests:    " << ss.numFinishedRequests << "\n";
 
+    os  << "\n  Queues:\n";
+    ::dumpQueueInfo(os, ss.queues);
+
     os  << "\n  New:\n";
     ::dumpRequestInfo(os, ss.newRequests);
 
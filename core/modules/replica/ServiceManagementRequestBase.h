@@ -75,6 +75,9 @@ struct ServiceState {
     std::vector<ProtocolServiceResponseInfo> inProgressRequests;
     std::vector<ProtocolServiceResponseInfo> finishedRequests;
 
+    /// The queues of the classes of requests
+    std::vector<ProtocolServiceQueue> queues;
+
     /// @return string representation of the state
     std::string state2string() const;
 
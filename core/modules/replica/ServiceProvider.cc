@@ -66,7 +66,9 @@ ServiceProvider::Ptr ServiceProvider::create(string const& configUrl) {
 
 ServiceProvider::ServiceProvider(string const& configUrl)
     :   _configuration(Configuration::load(configUrl)),
-        _databaseServices(DatabaseServicesPool::create(_configuration)) {
+        _replicaIndex(ReplicaIndex::create()),
+        _databaseServices(DatabaseServicesPool::create(_configuration,
+                                                       _replicaIndex)) {
 }
 
 
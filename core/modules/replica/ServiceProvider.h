@@ -33,6 +33,8 @@
 // Qserv headers
 #include "qhttp/Server.h"
 #include "replica/ChunkLocker.h"
+#include "replica/ReplicaIndex.h"
+#include "replica/WorkerChunkInventory.h"
 #include "util/Mutex.h"
 
 // Forward declarations
@@ -117,9 +119,20 @@ public:
     /// @return a reference to the database services
     DatabaseServicesPtr const& databaseServices() const { return _databaseServices; }
 
+    /**
+     * @return
+     *   a reference to the index of replicas kept current by the database
+     *   services. The index needs to be loaded by the application before
+     *   it's used.
+     */
+    ReplicaIndex::Ptr const& replicaIndex() const { return _replicaIndex; }
+
     /// @return a reference to the local (process) chunk locking services
     ChunkLocker& chunkLocker() { return _chunkLocker; }
 
+    /// @return a reference to the local (process) inventory of chunk files at workers
+    WorkerChunkInventory& chunkInventory() { return _chunkInventory; }
+
     /// @return a reference to the Qserv notification services
     QservMgtServicesPtr const& qservMgtServices() const { return _qservMgtServices; }
 
@@ -188,6 +201,10 @@ private:
     /// URL passed into the constructor of the class).
     ConfigurationPtr const _configuration;
 
+    /// The in-memory index of replicas (must be constructed before
+    /// the database services which keep it current)
+    ReplicaIndex::Ptr const _replicaIndex;
+
     /// Database services
     DatabaseServicesPtr const _databaseServices;
 
@@ -195,6 +212,10 @@ private:
     /// operations to ensure consistency of the operations.
     ChunkLocker _chunkLocker;
 
+    /// For finding chunk files at workers without scanning their data
+    /// directories each time.
+    WorkerChunkInventory _chunkInventory;
+
     /// Qserv management services
     QservMgtServicesPtr _qservMgtServices;
 
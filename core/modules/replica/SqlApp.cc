@@ -23,8 +23,10 @@
 #include "replica/SqlApp.h"
 
 // System headers
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 
 // Qserv headers
@@ -95,6 +97,21 @@ SqlApp::SqlApp(int argc, char* argv[])
         " result sets which might be accidentally initiated by users.",
         _maxRows);
 
+    parser().option(
+        "result-page-size",
+        "The number of rows in each page of the result sets pulled from workers while"
+        " the query is still being executed. If a value of the parameter is set to 0 then"
+        " each worker will send its whole result set upon the completion of the query.",
+        _resultPageSize);
+
+    parser().option(
+        "output-file",
+        "The name of a file where the rows of the result sets will be written (one row"
+        " per line, the name of a worker and the values of the cells separated by tabs,"
+        " NULL is written as \\N) as they arrive from the workers. If the file is specified"
+        " then only the status of the query at each worker will be printed.",
+        _outputFile);
+
     parser().option(
         "worker-response-timeout",
         "Maximum timeout (seconds) to wait before queries would finish."
@@ -118,13 +135,39 @@ int SqlApp::runImpl() {
         serviceProvider()->config()->setControllerRequestTimeoutSec(_timeoutSec);
     }
 
+    // Rows are written into the output file (if requested) as they arrive
+
+    ofstream outputFile;
+    SqlJob::PageCallbackType onPage;
+    if (not _outputFile.empty()) {
+        outputFile.open(_outputFile);
+        if (not outputFile.good()) {
+            throw invalid_argument("failed to open the output file: " + _outputFile);
+        }
+        onPage = [&outputFile] (SqlJob::Ptr const& job,
+                                string const& worker,
+                                SqlResultSet const& page) {
+            for (auto&& row: page.rows) {
+                outputFile << worker;
+                for (size_t i = 0; i < row.cells.size(); ++i) {
+                    outputFile << "\t" << (row.nulls[i] ? "\\N" : row.cells[i]);
+                }
+                outputFile << "\n";
+            }
+        };
+    }
     auto const job = SqlJob::create(
         _query,
         _mysqlUser,
         _mysqlPassword,
         _maxRows,
+        _resultPageSize,
         _allWorkers,
-        Controller::create(serviceProvider())
+        Controller::create(serviceProvider()),
+        string(),   /* parentJobId */
+        nullptr,    /* onFinish */
+        SqlJob::defaultOptions(),
+        onPage
     );
     job->start();
     job->wait();
@@ -141,6 +184,11 @@ int SqlApp::runImpl() {
             cout << "worker: " << worker << ",  error: " << resultSet.error << endl;
             continue;
         }
+        if (not _outputFile.empty()) {
+            cout << "worker: " << worker << ",  performance [sec]: "
+                 << to_string(resultSet.performanceSec) << endl;
+            continue;
+        }
         string const caption =
             "worker: " + worker + ",  performance [sec]: " + to_string(resultSet.performanceSec);
         string const indent = "";
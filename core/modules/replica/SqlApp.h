@@ -67,6 +67,10 @@ private:
                                 /// This is not the same as SQL's 'LIMIT <num-rows>'.
     bool _allWorkers = false;   /// send the query to all workers regardless of their status
 
+    uint64_t _resultPageSize = 0;   /// rows per page pulled from the workers (0 for no pages)
+
+    std::string _outputFile;    /// the file where the rows are written as they arrive
+
     unsigned int _timeoutSec = 300; /// When waiting for the completion of the queries
 
     size_t _pageSize = 100; /// Rows per page in the printout
@@ -61,21 +61,25 @@ SqlJob::Ptr SqlJob::create(string const& query,
                            string const& user,
                            string const& password,
                            uint64_t maxRows,
+                           uint64_t pageSize,
                            bool allWorkers,
                            Controller::Ptr const& controller,
                            string const& parentJobId,
                            CallbackType const& onFinish,
-                           Job::Options const& options) {
+                           Job::Options const& options,
+                           PageCallbackType const& onPage) {
     return SqlJob::Ptr(
         new SqlJob(query,
                    user,
                    password,
                    maxRows,
+                   pageSize,
                    allWorkers,
                    controller,
                    parentJobId,
                    onFinish,
-                   options));
+                   options,
+                   onPage));
 }
 
 
@@ -83,18 +87,22 @@ SqlJob::SqlJob(string const& query,
                string const& user,
                string const& password,
                uint64_t maxRows,
+               uint64_t pageSize,
                bool allWorkers,
                Controller::Ptr const& controller,
                string const& parentJobId,
                CallbackType const& onFinish,
-               Job::Options const& options)
+               Job::Options const& options,
+               PageCallbackType const& onPage)
     :   Job(controller, parentJobId, "SQL", options),
         _query     (query),
         _user      (user),
         _password  (password),
         _maxRows   (maxRows),
+        _pageSize  (pageSize),
         _allWorkers(allWorkers),
-        _onFinish  (onFinish) {
+        _onFinish  (onFinish),
+        _onPage    (onPage) {
 }
 
 
@@ -115,6 +123,7 @@ list<pair<string,string>> SqlJob::extendedPersistentState() const {
     result.emplace_back("query",                 query());
     result.emplace_back("user",                  user());
     result.emplace_back("max_rows",    to_string(maxRows()));
+    result.emplace_back("page_size",   to_string(pageSize()));
     result.emplace_back("all_workers",    string(allWorkers() ? "1" : "0"));
     return result;
 }
@@ -170,12 +179,18 @@ void SqlJob::startImpl(util::Lock const& lock) {
                 user(),
                 password(),
                 maxRows(),
+                pageSize(),
                 [self] (SqlRequest::Ptr request) {
                     self->_onRequestFinish(request);
                 },
                 options(lock).priority,
                 true,   /* keepTracking*/
-                id()    /* jobId */
+                id(),   /* jobId */
+                0,      /* requestExpirationIvalSec */
+                nullptr == _onPage ? SqlRequest::PageCallbackType() :
+                    [self] (SqlRequest::Ptr request, SqlResultSet const& page) {
+                        self->_onRequestPage(request, page);
+                    }
             )
         );
         _numLaunched++;
@@ -241,6 +256,14 @@ void SqlJob::_onRequestFinish(SqlRequest::Ptr const& request) {
     _resultData.workers   [request->worker()] = requestSucceeded;
     _resultData.resultSets[request->worker()] = request->responseData();
 
+    // The whole result set is passed to the page callback if it wasn't
+    // pulled in pages.
+
+    if ((nullptr != _onPage) and (pageSize() == 0) and requestSucceeded) {
+        _onRequestPage(request, request->responseData());
+        _resultData.resultSets[request->worker()].rows.clear();
+    }
+
     // Evaluate the completion condition
 
     _numFinished++;
@@ -252,4 +275,21 @@ void SqlJob::_onRequestFinish(SqlRequest::Ptr const& request) {
     }
 }
 
+
+
+void SqlJob::_onRequestPage(SqlRequest::Ptr const& request,
+                            SqlResultSet const& page) {
+
+    LOGS(_log, LOG_LVL_DEBUG, context() << __func__ << "  worker=" << request->worker()
+         << " rows=" << page.rows.size());
+
+    if (state() == State::FINISHED) return;
+
+    util::Lock lock(_pageMtx, context() + __func__);
+
+    if (state() == State::FINISHED) return;
+
+    _onPage(shared_from_base<SqlJob>(), request->worker(), page);
+}
+
 }}} // namespace lsst::qserv::replica
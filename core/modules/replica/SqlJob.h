@@ -32,6 +32,7 @@
 #include "replica/Job.h"
 #include "replica/SqlRequest.h"
 #include "replica/SqlResultSet.h"
+#include "util/Mutex.h"
 
 // This header declarations
 namespace lsst {
@@ -55,6 +56,11 @@ struct SqlJobResult {
  * Class SqlJob represents a tool which will broadcast the same query to all
  * worker databases of a setup. Result sets are collected in the above defined
  * data structure.
+ *
+ * If the page callback is provided then the rows of the result sets are passed
+ * to the client as they arrive from the workers (in pages if the page size is
+ * specified) instead of being collected, so that large result sets never
+ * have to be kept in memory. The callback is never called concurrently.
  */
 class SqlJob : public Job  {
 
@@ -66,6 +72,10 @@ public:
     /// The function type for notifications on the completion of the request
     typedef std::function<void(Ptr)> CallbackType;
 
+    /// The function type for notifications on pages of result sets
+    /// received from the workers
+    typedef std::function<void(Ptr, std::string const&, SqlResultSet const&)> PageCallbackType;
+
     /// @return default options object for this type of a request
     static Job::Options const& defaultOptions();
 
@@ -93,6 +103,11 @@ public:
      *   restrictions will still apply. The later includes the maximum size of the Google Protobuf
      *   objects, the amount of available memory, etc.
      *
+     * @param pageSize
+     *   the number of rows in each page of the result sets pulled from the workers
+     *   while the query is still being executed. If the value is 0 then each worker
+     *   sends its whole result set upon the completion of the query.
+     *
      * @param allWorkers
      *   engage all known workers regardless of their status. If the flag
      *   is set to 'false' then only 'ENABLED' workers which are not in
@@ -110,6 +125,12 @@ public:
      * @param options
      *   (optional) defines the job priority, etc.
      *
+     * @param onPage
+     *   (optional) callback function to be called on each page of the result sets
+     *   with the name of the worker the page came from. Only the first page of each
+     *   worker carries the field definitions. The rows passed to the callback are not
+     *   stored in the result of the job.
+     *
      * @return
      *   pointer to the created object
      */
@@ -117,11 +138,13 @@ public:
                       std::string const& user,
                       std::string const& password,
                       uint64_t maxRows,
+                      uint64_t pageSize,
                       bool allWorkers,
                       Controller::Ptr const& controller,
                       std::string const& parentJobId=std::string(),
                       CallbackType const& onFinish=nullptr,
-                      Job::Options const& options=defaultOptions());
+                      Job::Options const& options=defaultOptions(),
+                      PageCallbackType const& onPage=nullptr);
 
     // Default construction and copy semantics are prohibited
 
@@ -137,7 +160,8 @@ public:
     std::string const& user()     const { return _user; }
     std::string const& password() const { return _password; }
 
-    uint64_t maxRows() const { return _maxRows; }
+    uint64_t maxRows()  const { return _maxRows; }
+    uint64_t pageSize() const { return _pageSize; }
 
     bool allWorkers() const { return _allWorkers; }
 
@@ -181,11 +205,13 @@ private:
            std::string const& user,
            std::string const& password,
            uint64_t maxRows,
+           uint64_t pageSize,
            bool allWorkers,
            Controller::Ptr const& controller,
            std::string const& parentJobId,
            CallbackType const& onFinish,
-           Job::Options const& options);
+           Job::Options const& options,
+           PageCallbackType const& onPage);
 
     /**
      * The callback function to be invoked on a completion of requests
@@ -193,6 +219,13 @@ private:
      */
     void _onRequestFinish(SqlRequest::Ptr const& request);
 
+    /**
+     * The callback function to be invoked on pages of the result sets
+     * received by requests.
+     */
+    void _onRequestPage(SqlRequest::Ptr const& request,
+                        SqlResultSet const& page);
+
 
     // Input parameters
 
@@ -200,8 +233,10 @@ private:
     std::string  const _user;
     std::string  const _password;
     uint64_t     const _maxRows;
+    uint64_t     const _pageSize;
     bool         const _allWorkers;
     CallbackType       _onFinish;       /// @note is reset when the job finishes
+    PageCallbackType   _onPage;
 
     /// A collection of requests implementing the operation
     std::vector<SqlRequest::Ptr> _requests;
@@ -215,6 +250,10 @@ private:
 
     /// The result of the operation (gets updated as requests are finishing)
     SqlJobResult _resultData;
+
+    /// The mutex for serializing calls to the page callback. The job's mutex
+    /// isn't held while the callback is called.
+    util::Mutex _pageMtx;
 };
 
 }}} // namespace lsst::qserv::replica
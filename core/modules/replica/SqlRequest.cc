@@ -55,10 +55,12 @@ SqlRequest::Ptr SqlRequest::create(ServiceProvider::Ptr const& serviceProvider,
                                    std::string const& user,
                                    std::string const& password,
                                    uint64_t maxRows,
+                                   uint64_t pageSize,
                                    CallbackType const& onFinish,
                                    int priority,
                                    bool keepTracking,
-                                   shared_ptr<Messenger> const& messenger) {
+                                   shared_ptr<Messenger> const& messenger,
+                                   PageCallbackType const& onPage) {
     return SqlRequest::Ptr(
         new SqlRequest(serviceProvider,
                        io_service,
@@ -67,10 +69,12 @@ SqlRequest::Ptr SqlRequest::create(ServiceProvider::Ptr const& serviceProvider,
                        user,
                        password,
                        maxRows,
+                       pageSize,
                        onFinish,
                        priority,
                        keepTracking,
-                       messenger));
+                       messenger,
+                       onPage));
 }
 
 
@@ -81,10 +85,12 @@ SqlRequest::SqlRequest(ServiceProvider::Ptr const& serviceProvider,
                          std::string const& user,
                          std::string const& password,
                          uint64_t maxRows,
+                         uint64_t pageSize,
                          CallbackType const& onFinish,
                          int  priority,
                          bool keepTracking,
-                         shared_ptr<Messenger> const& messenger)
+                         shared_ptr<Messenger> const& messenger,
+                         PageCallbackType const& onPage)
     :   RequestMessenger(serviceProvider,
                          io_service,
                          "SQL",
@@ -97,7 +103,9 @@ SqlRequest::SqlRequest(ServiceProvider::Ptr const& serviceProvider,
         _user(user),
         _password(password),
         _maxRows(maxRows),
-        _onFinish(onFinish) {
+        _pageSize(pageSize),
+        _onFinish(onFinish),
+        _onPage(onPage) {
 }
 
 
@@ -110,7 +118,7 @@ void SqlRequest::startImpl(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << __func__
          << "  worker: " << worker() << " query: " << query() << " user: " << user()
-         << " maxRows: " << maxRows());
+         << " maxRows: " << maxRows() << " pageSize: " << pageSize());
 
     // Serialize the Request message header and the request itself into
     // the network buffer.
@@ -130,6 +138,7 @@ void SqlRequest::startImpl(util::Lock const& lock) {
     message.set_user(user());
     message.set_password(password());
     message.set_max_rows(maxRows());
+    message.set_page_size(pageSize());
 
     buffer()->serialize(message);
 
@@ -181,6 +190,7 @@ void SqlRequest::_awaken(boost::system::error_code const& ec) {
     ProtocolRequestStatus message;
     message.set_id(id());
     message.set_queued_type(ProtocolQueuedRequestType::SQL);
+    message.set_page(_nextPage);
 
     buffer()->serialize(message);
 
@@ -222,44 +232,128 @@ void SqlRequest::_analyze(bool success,
 
     if (state() == State::FINISHED) return;
 
+    SqlResultSet page;
+    PageCallbackType onPage;
+    {
+        util::Lock lock(_mtx, context() + __func__);
+
+        if (state() == State::FINISHED) return;
+
+        if (not success) {
+            finish(lock, CLIENT_ERROR);
+            return;
+        }
+
+        // Always use  the latest status reported by the remote server
+
+        setExtendedServerStatus(lock, replica::translate(message.status_ext()));
+
+        // Performance counters are updated from either of two sources,
+        // depending on the availability of the 'target' performance counters
+        // filled in by the 'STATUS' queries. If the later is not available
+        // then fallback to the one of the current request.
+
+        if (message.has_target_performance()) {
+            mutablePerformance().update(message.target_performance());
+        } else {
+            mutablePerformance().update(message.performance());
+        }
+
+        // Always extract extended data regardless of the completion status
+        // reported by the worker service.
+
+        if (pageSize() == 0) {
+            _responseData.set(message);
+        } else if (_analyzePage(lock, message, page)) {
+            onPage = _onPage;
+        }
+        _responseData.performanceSec =
+            (PerformanceUtils::now() - performance(lock).c_create_time) / 1000.;
+
+        // Extract target request type-specific parameters from the response
+        if (message.has_request()) {
+            _targetRequestParams = SqlRequestParams(message.request());
+        }
+        if (nullptr == onPage) {
+            _analyzeStatus(lock, message);
+            return;
+        }
+    }
+
+    // The page is passed to the client w/o holding the lock. The next page is
+    // requested only after that, so the client receives the pages in order.
+
+    onPage(shared_from_base<SqlRequest>(), page);
+
+    if (state() == State::FINISHED) return;
+
     util::Lock lock(_mtx, context() + __func__);
 
     if (state() == State::FINISHED) return;
 
-    if (not success) {
-        finish(lock, CLIENT_ERROR);
-        return;
-    }
+    _analyzeStatus(lock, message);
+}
+
+
+bool SqlRequest::_analyzePage(util::Lock const& lock,
+                              ProtocolResponseSql const& message,
+                              SqlResultSet& page) {
+
+    _responseData.error       = message.error();
+    _responseData.charSetName = message.char_set_name();
+    _responseData.hasResult   = message.has_result();
+
+    // The page isn't ready if the worker hasn't read its rows yet
+
+    bool const pageReady =
+        ((message.status() == ProtocolStatus::SUCCESS) or
+         (message.status() == ProtocolStatus::IN_PROGRESS)) and
+        (message.page() == _nextPage) and
+        ((message.rows_size() > 0) or not message.more_pages());
 
-    // Always use  the latest status reported by the remote server
+    if (not pageReady) return false;
 
-    setExtendedServerStatus(lock, replica::translate(message.status_ext()));
+    LOGS(_log, LOG_LVL_DEBUG, context() << __func__ << "  page: " << _nextPage
+         << " rows: " << message.rows_size());
 
-    // Performance counters are updated from either of two sources,
-    // depending on the availability of the 'target' performance counters
-    // filled in by the 'STATUS' queries. If the later is not available
-    // then fallback to the one of the current request.
+    ++_nextPage;
 
-    if (message.has_target_performance()) {
-        mutablePerformance().update(message.target_performance());
+    // Pull the next page right away
+
+    _currentTimeIvalMsec = 10;
+
+    if (nullptr == _onPage) {
+        _responseData.append(message);
+        return false;
+    }
+    if (_nextPage > 1) {
+        page.error       = message.error();
+        page.charSetName = message.char_set_name();
+        page.hasResult   = message.has_result();
+        for (int i = 0; i < message.rows_size(); ++i) {
+            page.rows.emplace_back(message.rows(i));
+        }
     } else {
-        mutablePerformance().update(message.performance());
+        page.append(message);
+        _responseData.fields = page.fields;
     }
+    return true;
+}
 
-    // Always extract extended data regardless of the completion status
-    // reported by the worker service.
 
-    _responseData.set(message);
-    _responseData.performanceSec =
-        (PerformanceUtils::now() - performance(lock).c_create_time) / 1000.;
+void SqlRequest::_analyzeStatus(util::Lock const& lock,
+                                ProtocolResponseSql const& message) {
 
-    // Extract target request type-specific parameters from the response
-    if (message.has_request()) {
-        _targetRequestParams = SqlRequestParams(message.request());
-    }
     switch (message.status()) {
 
         case ProtocolStatus::SUCCESS:
+
+            // The remaining pages of the result set are still to be pulled
+
+            if ((pageSize() != 0) and message.more_pages()) {
+                _wait(lock);
+                break;
+            }
             finish(lock, SUCCESS);
             break;
 
@@ -302,6 +396,7 @@ void SqlRequest::notify(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << __func__);
 
+    _onPage = nullptr;
     notifyDefaultImpl<SqlRequest>(lock, _onFinish);
 }
 
@@ -317,6 +412,7 @@ list<pair<string,string>> SqlRequest::extendedPersistentState() const {
     result.emplace_back("query",    query());
     result.emplace_back("user",     user());
     result.emplace_back("max_rows", to_string(maxRows()));
+    result.emplace_back("page_size", to_string(pageSize()));
     return result;
 }
 
@@ -53,6 +53,12 @@ namespace replica {
  *
  * In case of a successful completion of a request an object of this request class
  * will receive a result set (if any) of the query.
+ *
+ * If the page size is specified then the result set is pulled from the worker
+ * one page at a time, while the query is still being executed. The pages are
+ * either merged into the result set of the request, or (if the page callback is
+ * provided) passed to the client in their original order as they arrive, and not
+ * retained by the request.
  */
 class SqlRequest : public RequestMessenger  {
 
@@ -64,6 +70,9 @@ public:
     /// The function type for notifications on the completion of the request
     typedef std::function<void(Ptr)> CallbackType;
 
+    /// The function type for notifications on pages of the result set
+    typedef std::function<void(Ptr, SqlResultSet const&)> PageCallbackType;
+
     // Default construction and copy semantics are prohibited
 
     SqlRequest() = delete;
@@ -78,7 +87,8 @@ public:
     std::string const& user()     const { return _user; }
     std::string const& password() const { return _password; }
 
-    uint64_t maxRows() const { return _maxRows; }
+    uint64_t maxRows()  const { return _maxRows; }
+    uint64_t pageSize() const { return _pageSize; }
 
     /// @return target request specific parameters
     SqlRequestParams const& targetRequestParams() const { return _targetRequestParams; }
@@ -128,6 +138,10 @@ public:
      *   restrictions will still apply. The later includes the maximum size of the Google Protobuf
      *   objects, the amount of available memory, etc.
      *
+     * @param pageSize
+     *   the number of rows in each page of the result set. If the value is 0 then
+     *   the whole result set is sent by the worker in one response.
+     *
      * @param onFinish
      *   (optional) callback function to call upon completion of the request
      *
@@ -140,6 +154,10 @@ public:
      * @param messenger
      *   interface for communicating with workers
      *
+     * @param onPage
+     *   (optional) callback function to call on each page of the result set. The page
+     *   doesn't include the field definitions unless it's the first one.
+     *
      * @return
      *   pointer to the created object
      */
@@ -150,10 +168,12 @@ public:
                       std::string const& user,
                       std::string const& password,
                       uint64_t maxRows,
+                      uint64_t pageSize,
                       CallbackType const& onFinish,
                       int  priority,
                       bool keepTracking,
-                      std::shared_ptr<Messenger> const& messenger);
+                      std::shared_ptr<Messenger> const& messenger,
+                      PageCallbackType const& onPage=nullptr);
 
     /// @see Request::extendedPersistentState()
     std::list<std::pair<std::string,std::string>> extendedPersistentState() const override;
@@ -179,10 +199,12 @@ private:
                std::string const& user,
                std::string const& password,
                uint64_t maxRows,
+               uint64_t pageSize,
                CallbackType const& onFinish,
                int  priority,
                bool keepTracking,
-               std::shared_ptr<Messenger> const& messenger);
+               std::shared_ptr<Messenger> const& messenger,
+               PageCallbackType const& onPage);
 
     /**
      * Start the timer before attempting the previously failed
@@ -221,13 +243,50 @@ private:
     void _analyze(bool success,
                   ProtocolResponseSql const& message);
 
+    /**
+     * Process a page of the result set (if any) carried by a response
+     *
+     * @param lock
+     *   a lock on Request::_mtx must be acquired before calling this method
+     *
+     * @param message
+     *   response from a worker
+     *
+     * @param page
+     *   the page to be passed to the page callback (if the one is set)
+     *
+     * @return
+     *   'true' if the page needs to be passed to the page callback
+     */
+    bool _analyzePage(util::Lock const& lock,
+                      ProtocolResponseSql const& message,
+                      SqlResultSet& page);
+
+    /**
+     * Finish the request, or keep tracking it, depending on the status
+     * reported by the worker
+     *
+     * @param lock
+     *   a lock on Request::_mtx must be acquired before calling this method
+     *
+     * @param message
+     *   response from a worker
+     */
+    void _analyzeStatus(util::Lock const& lock,
+                        ProtocolResponseSql const& message);
+
     // Input parameters
 
     std::string const _query;
     std::string const _user;
     std::string const _password;
     uint64_t    const _maxRows;
+    uint64_t    const _pageSize;
     CallbackType      _onFinish;    /// @note is reset when the request finishes
+    PageCallbackType  _onPage;      /// @note is reset when the request finishes
+
+    /// The number of the next page of the result set to be pulled from the worker
+    uint64_t _nextPage = 0;
 
     /// Request-specific parameters of the target request
     SqlRequestParams _targetRequestParams;
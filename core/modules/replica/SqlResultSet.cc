@@ -131,6 +131,23 @@ void SqlResultSet::set(ProtocolResponseSql const& message) {
     for (int i = 0; i < message.rows_size(); ++i) {
         rows.emplace_back(message.rows(i));
     }
+}
+
+
+void SqlResultSet::append(ProtocolResponseSql const& message) {
+
+    error = message.error();
+    charSetName = message.char_set_name();
+    hasResult = message.has_result();
+
+    if (fields.empty()) {
+        for (int i = 0; i < message.fields_size(); ++i) {
+            fields.emplace_back(message.fields(i));
+        }
+    }
+    for (int i = 0; i < message.rows_size(); ++i) {
+        rows.emplace_back(message.rows(i));
+    }
 }    
 
 
@@ -135,6 +135,17 @@ struct SqlResultSet {
      */
     void set(ProtocolResponseSql const& message);
 
+    /**
+     * Carry over the description of the result set from the input protocol
+     * message (the fields only if they haven't been set yet), and append
+     * the rows of the message to the ones received before. The method is used
+     * for merging pages of result sets.
+     *
+     * @param message
+     *   input message to be parsed
+     */
+    void append(ProtocolResponseSql const& message);
+
     /**
      * Translate the structure into JSON
      *
@@ -68,15 +68,28 @@ VerifyApp::VerifyApp(int argc, char* argv[])
 
     parser().option(
         "max-replicas",
-        "The maximum number of replicas to be processed simultaneously.",
+        "The maximum number of replicas to be processed simultaneously at each worker.",
         _maxReplicas
     );
 
+    parser().option(
+        "max-bytes-per-sec",
+        "The maximum number of bytes per second to be read at each worker when"
+        " computing check/control sums. The default value of 0 means no limit.",
+        _maxBytesPerSec
+    );
+
     parser().flag(
         "compute-check-sum",
         "Also compute and store in the database check/control sums for"
         " all files of the found replica.",
         _computeCheckSum);
+
+    parser().flag(
+        "yield-to-qserv",
+        "Process one replica at a time, at a quarter of the maximum byte rate,"
+        " at workers where Qserv is running shared scans.",
+        _yieldToQserv);
 }
 
 
@@ -88,6 +101,8 @@ int VerifyApp::runImpl() {
     auto const job = VerifyJob::create (
         _maxReplicas,
         _computeCheckSum,
+        _maxBytesPerSec,
+        _yieldToQserv,
         [] (VerifyJob::Ptr const& job,
             ReplicaDiff const& selfReplicaDiff,
             vector<ReplicaDiff> const& otherReplicaDiff) {
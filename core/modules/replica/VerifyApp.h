@@ -70,13 +70,20 @@ private:
     /// @see VerifyApp::create()
     VerifyApp(int argc, char* argv[]);
 
-    /// The maximum number of replicas to be processed simultaneously
+    /// The maximum number of replicas to be processed simultaneously at each worker
     size_t _maxReplicas = 1;
 
     /// Automatically compute and store in the database check/control sums of
     /// the replica's files.
     bool _computeCheckSum  = false;
 
+    /// The maximum number of bytes per second to be read at each worker
+    /// when computing the check/control sums (0 for no limit)
+    size_t _maxBytesPerSec = 0;
+
+    /// Lower the limits at workers where Qserv is running scans
+    bool _yieldToQserv = false;
+
 };
 
 }}} // namespace lsst::qserv::replica
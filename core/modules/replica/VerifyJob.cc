@@ -23,20 +23,62 @@
 #include "replica/VerifyJob.h"
 
 // System headers
+#include <algorithm>
 #include <stdexcept>
 #include <thread>
 
+// Third party headers
+#include <boost/bind.hpp>
+
 // Qserv headers
 #include "lsst/log/Log.h"
+#include "replica/Configuration.h"
 #include "replica/DatabaseServices.h"
+#include "replica/Performance.h"
+#include "replica/QservMgtServices.h"
 #include "replica/ServiceProvider.h"
 
 using namespace std;
+using json = nlohmann::json;
 
 namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.VerifyJob");
 
+/// The interval (seconds) between runs of the scheduler
+unsigned int const timerIvalSec = 1;
+
+/// The interval (seconds) between requests for the status of Qserv
+unsigned int const qservProbeIvalSec = 30;
+
+/// The reduction of the byte rate at workers where Qserv is running scans
+double const qservBusyRateDivisor = 4;
+
+/// The number of replicas pulled from the database for each worker is
+/// this times the maximum number of replicas verified simultaneously
+size_t const replicasPerPull = 4;
+
+/// @return the total size of the files of a replica
+uint64_t replicaSize(lsst::qserv::replica::ReplicaInfo const& replica) {
+    uint64_t size = 0;
+    for (auto&& file: replica.fileInfo()) size += file.size;
+    return size;
+}
+
+/// @return the number of tasks of the shared scan schedulers of a Qserv worker
+/// @throws std::exception if the status has an unexpected structure
+size_t numScanTasks(json const& info) {
+    size_t num = 0;
+    auto const& queries = info.at("processor").at("queries");
+    if (not queries.count("blend_scheduler")) return num;
+    for (auto&& scheduler: queries.at("blend_scheduler").at("schedulers")) {
+        if (scheduler.at("name") == "SchedGroup") continue;
+        num += scheduler.at("num_tasks_in_flight").get<size_t>()
+            +  scheduler.at("num_tasks_in_queue").get<size_t>();
+    }
+    return num;
+}
+
 } /// namespace
 
 namespace lsst {
@@ -187,6 +229,8 @@ string VerifyJob::typeName() { return "VerifyJob"; }
 
 VerifyJob::Ptr VerifyJob::create(size_t maxReplicas,
                                  bool computeCheckSum,
+                                 uint64_t maxBytesPerSec,
+                                 bool yieldToQserv,
                                  CallbackTypeOnDiff const& onReplicaDifference,
                                  Controller::Ptr const& controller,
                                  string const& parentJobId,
@@ -195,6 +239,8 @@ VerifyJob::Ptr VerifyJob::create(size_t maxReplicas,
     return VerifyJob::Ptr(
         new VerifyJob(maxReplicas,
                       computeCheckSum,
+                      maxBytesPerSec,
+                      yieldToQserv,
                       onReplicaDifference,
                       controller,
                       parentJobId,
@@ -205,6 +251,8 @@ VerifyJob::Ptr VerifyJob::create(size_t maxReplicas,
 
 VerifyJob::VerifyJob(size_t maxReplicas,
                      bool computeCheckSum,
+                     uint64_t maxBytesPerSec,
+                     bool yieldToQserv,
                      CallbackTypeOnDiff const& onReplicaDifference,
                      Controller::Ptr const& controller,
                      string const& parentJobId,
@@ -216,6 +264,8 @@ VerifyJob::VerifyJob(size_t maxReplicas,
             options),
         _maxReplicas(maxReplicas),
         _computeCheckSum(computeCheckSum),
+        _maxBytesPerSec(maxBytesPerSec),
+        _yieldToQserv(yieldToQserv),
         _onFinish(onFinish),
         _onReplicaDifference(onReplicaDifference) {
 
@@ -229,6 +279,8 @@ list<pair<string,string>> VerifyJob::extendedPersistentState() const {
     list<pair<string,string>> result;
     result.emplace_back("max_replicas",      to_string(maxReplicas()));
     result.emplace_back("compute_check_sum", computeCheckSum() ? "1" : "0");
+    result.emplace_back("max_bytes_per_sec", to_string(maxBytesPerSec()));
+    result.emplace_back("yield_to_qserv",    yieldToQserv() ? "1" : "0");
     return result;
 }
 
@@ -237,16 +289,15 @@ void VerifyJob::startImpl(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << __func__);
 
-    auto self = shared_from_base<VerifyJob>();
-
-    // Launch the first batch of requests
+    // Launch the first batch of requests at all workers
 
-    vector<ReplicaInfo> replicas;
-    _nextReplicas(lock,
-                  replicas,
-                  maxReplicas());
-
-    if (replicas.empty()) {
+    _budgetTime = PerformanceUtils::now();
+    size_t numLaunched = 0;
+    for (auto&& worker: controller()->serviceProvider()->config()->workers()) {
+        _workers[worker].budgetBytes = maxBytesPerSec();
+        numLaunched += _launch(lock, worker);
+    }
+    if (0 == numLaunched) {
 
         // In theory this should never happen unless the installation
         // doesn't have a single chunk.
@@ -257,22 +308,8 @@ void VerifyJob::startImpl(util::Lock const& lock) {
         setState(lock, State::FINISHED, ExtendedState::FAILED);
         return;
     }
-    for (ReplicaInfo const& replica: replicas) {
-        auto request = controller()->findReplica(
-            replica.worker(),
-            replica.database(),
-            replica.chunk(),
-            [self] (FindRequest::Ptr request) {
-                self->_onRequestFinish(request);
-            },
-            options(lock).priority,     /* inherited from the one of the current job */
-            computeCheckSum(),
-            true,                       /* keepTracking*/
-            id()                        /* jobId */
-        );
-        _replicas[request->id()] = replica;
-        _requests[request->id()] = request;
-    }
+    _startTimer(lock);
+
     setState(lock, State::IN_PROGRESS);
 }
 
@@ -281,6 +318,8 @@ void VerifyJob::cancelImpl(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << __func__);
 
+    if (_timerPtr) _timerPtr->cancel();
+
     // To ensure no lingering "side effects" will be left after cancelling this
     // job the request cancellation should be also followed (where it makes a sense)
     // by stopping the request at corresponding worker service.
@@ -299,6 +338,7 @@ void VerifyJob::cancelImpl(util::Lock const& lock) {
     }
     _replicas.clear();
     _requests.clear();
+    _workers.clear();
 }
 
 
@@ -326,7 +366,9 @@ void VerifyJob::_onRequestFinish(FindRequest::Ptr const& request) {
     ReplicaDiff         selfReplicaDiff;    // against the previous state of the current replica
     vector<ReplicaDiff> otherReplicaDiff;   // against other known replicas
 
-    auto self = shared_from_base<VerifyJob>();
+    auto&& workerState = _workers[request->worker()];
+    auto const key = make_pair(request->database(), request->chunk());
+    workerState.inFlight.erase(key);
 
     if (request->extendedState() == Request::ExtendedState::SUCCESS) {
 
@@ -374,36 +416,88 @@ void VerifyJob::_onRequestFinish(FindRequest::Ptr const& request) {
 
     } else {
 
-        // Report the error and keep going
+        // Report the error and keep going. The replica won't be pulled from
+        // the database again until the worker has no other replicas to be
+        // verified.
 
         LOGS(_log, LOG_LVL_ERROR, context() << "failed request " << request->context()
              << " worker: "   << request->worker()
              << " database: " << request->database()
              << " chunk: "    << request->chunk());
+
+        workerState.failed.insert(key);
     }
 
-    // Remove the processed replica, fetch another one and begin processing it
+    // Remove the processed replica and begin processing the next ones
 
     _replicas.erase(request->id());
     _requests.erase(request->id());
 
-    vector<ReplicaInfo> replicas;
-    _nextReplicas(lock,
-                  replicas,
-                  1);
+    _launch(lock, request->worker());
 
-    if (0 == replicas.size()) {
+    // The callback is being made asynchronously in a separate thread
+    // to avoid blocking the current thread.
 
-        LOGS(_log, LOG_LVL_ERROR, context() << __func__
-             << "  ** no replicas found in the database **");
+    if (_onReplicaDifference) {
+        auto self = shared_from_base<VerifyJob>();
+        thread notifier([self, selfReplicaDiff, otherReplicaDiff]() {
+            self->_onReplicaDifference(self, selfReplicaDiff, otherReplicaDiff);
+        });
+        notifier.detach();
+    }
+}
+
+
+void VerifyJob::_onQservStatus(GetStatusQservMgtRequest::Ptr const& request) {
+
+    LOGS(_log, LOG_LVL_DEBUG, context() << __func__ << "  worker=" << request->worker());
+
+    if (state() == State::FINISHED) return;
+
+    util::Lock lock(_mtx, context() + __func__);
 
-        // In theory this should never happen unless all replicas are gone
-        // from the installation.
+    if (state() == State::FINISHED) return;
 
-        finish(lock, ExtendedState::FAILED);
-        return;        
+    // Qserv is assumed not to be running scans if its status is not known
+
+    auto&& workerState = _workers[request->worker()];
+    workerState.qservProbing = false;
+    workerState.qservBusy = false;
+    if (request->extendedState() == QservMgtRequest::ExtendedState::SUCCESS) {
+        try {
+            workerState.qservBusy = numScanTasks(request->info()) != 0;
+        } catch (exception const& ex) {
+            LOGS(_log, LOG_LVL_WARN, context() << __func__ << "  worker=" << request->worker()
+                 << " failed to parse the status of Qserv, ex: " << ex.what());
+        }
     }
-    for (ReplicaInfo const& replica: replicas) {
+}
+
+
+size_t VerifyJob::_launch(util::Lock const& lock,
+                          string const& worker) {
+
+    auto&& workerState = _workers[worker];
+
+    size_t const maxInFlight = workerState.qservBusy ? 1 : maxReplicas();
+    bool const limitBytes = computeCheckSum() and maxBytesPerSec() != 0;
+
+    auto self = shared_from_base<VerifyJob>();
+
+    size_t numLaunched = 0;
+    while (workerState.inFlight.size() < maxInFlight) {
+
+        if (workerState.replicas.empty()) {
+            _nextReplicas(lock, worker);
+            if (workerState.replicas.empty()) break;
+        }
+        if (limitBytes and workerState.budgetBytes <= 0) break;
+
+        ReplicaInfo const replica = workerState.replicas.front();
+        workerState.replicas.pop_front();
+
+        if (limitBytes) workerState.budgetBytes -= replicaSize(replica);
+
         auto request = controller()->findReplica(
             replica.worker(),
             replica.database(),
@@ -411,36 +505,116 @@ void VerifyJob::_onRequestFinish(FindRequest::Ptr const& request) {
             [self] (FindRequest::Ptr request) {
                 self->_onRequestFinish(request);
             },
-            options(lock).priority, /* inherited from the one of the current job */
+            options(lock).priority,     /* inherited from the one of the current job */
             computeCheckSum(),
-            true,                   /* keepTracking*/
-            id()                    /* jobId */
+            true,                       /* keepTracking*/
+            id()                        /* jobId */
         );
         _replicas[request->id()] = replica;
         _requests[request->id()] = request;
+        workerState.inFlight.emplace(replica.database(), replica.chunk());
+        ++numLaunched;
     }
-
-    // The callback is being made asynchronously in a separate thread
-    // to avoid blocking the current thread.
-
-    if (_onReplicaDifference) {
-        auto self = shared_from_base<VerifyJob>();
-        thread notifier([self, selfReplicaDiff, otherReplicaDiff]() {
-            self->_onReplicaDifference(self, selfReplicaDiff, otherReplicaDiff);
-        });
-        notifier.detach();
-    }
+    return numLaunched;
 }
 
 
 void VerifyJob::_nextReplicas(util::Lock const& lock,
-                              vector<ReplicaInfo>& replicas,
-                              size_t numReplicas) {
+                              string const& worker) {
+
+    auto&& workerState = _workers[worker];
 
-    controller()->serviceProvider()->databaseServices()->findOldestReplicas(
+    // Pull enough replicas to have some left after skipping the ones
+    // which are being verified, or which failed to be verified.
+
+    size_t const numReplicas =
+        workerState.inFlight.size() + workerState.failed.size() + replicasPerPull * maxReplicas();
+
+    vector<ReplicaInfo> replicas;
+    controller()->serviceProvider()->databaseServices()->findOldestWorkerReplicas(
         replicas,
+        worker,
         numReplicas
     );
+    for (auto&& replica: replicas) {
+        auto const key = make_pair(replica.database(), replica.chunk());
+        if (workerState.inFlight.count(key) or workerState.failed.count(key)) continue;
+        workerState.replicas.push_back(replica);
+    }
+
+    // Give the failed replicas another chance once nothing else is left
+
+    if (workerState.replicas.empty()) workerState.failed.clear();
+}
+
+
+void VerifyJob::_startTimer(util::Lock const& lock) {
+
+    // The timer needs to be initialized each time a new interval
+    // is about to begin. Otherwise it will immediately expire when
+    // async_wait() will be called.
+    _timerPtr.reset(
+        new boost::asio::deadline_timer(
+            controller()->io_service(),
+            boost::posix_time::seconds(timerIvalSec)));
+
+    _timerPtr->async_wait(
+        boost::bind(
+            &VerifyJob::_onTimer,
+            shared_from_base<VerifyJob>(),
+            boost::asio::placeholders::error
+        )
+    );
+}
+
+
+void VerifyJob::_onTimer(boost::system::error_code const& ec) {
+
+    // Ignore this event if the timer was aborted
+    if (ec == boost::asio::error::operation_aborted) return;
+
+    if (state() == State::FINISHED) return;
+
+    util::Lock lock(_mtx, context() + __func__);
+
+    if (state() == State::FINISHED) return;
+
+    uint64_t const now = PerformanceUtils::now();
+
+    // Restore the budgets. No more than one second worth of bytes is allowed
+    // to be accumulated by idle workers.
+
+    double const elapsedSec = (now - _budgetTime) / 1000.;
+    _budgetTime = now;
+    for (auto&& entry: _workers) {
+        auto&& workerState = entry.second;
+        double const rate = workerState.qservBusy ?
+            maxBytesPerSec() / qservBusyRateDivisor : maxBytesPerSec();
+        workerState.budgetBytes = min(workerState.budgetBytes + rate * elapsedSec, rate);
+    }
+
+    // Check if Qserv is running scans at the workers
+
+    if (yieldToQserv() and now - _qservProbeTime >= qservProbeIvalSec * 1000) {
+        _qservProbeTime = now;
+        auto self = shared_from_base<VerifyJob>();
+        for (auto&& entry: _workers) {
+            auto&& workerState = entry.second;
+            if (workerState.qservProbing) continue;
+            auto const request = controller()->serviceProvider()->qservMgtServices()->status(
+                entry.first,
+                id(),
+                [self] (GetStatusQservMgtRequest::Ptr request) {
+                    self->_onQservStatus(request);
+                }
+            );
+            workerState.qservProbing = request != nullptr;
+        }
+    }
+    for (auto&& entry: _workers) {
+        _launch(lock, entry.first);
+    }
+    _startTimer(lock);
 }
 
 }}} // namespace lsst::qserv::replica
@@ -23,11 +23,20 @@
 
 // System headers
 #include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <utility>
+
+// Third party headers
+#include <boost/asio.hpp>
 
 // Qserv headers
 #include "replica/Job.h"
 #include "replica/FindRequest.h"
+#include "replica/GetStatusQservMgtRequest.h"
 
 // This header declarations
 namespace lsst {
@@ -136,6 +145,17 @@ std::ostream& operator<<(std::ostream& os, ReplicaDiff const& ri);
   *
   * Any differences will get reported to a subscriber via a specific callback
   * function. The new status of a replica will be also recorded within the database.
+  *
+  * Replicas are verified at all workers in parallel, each worker going over its
+  * own replicas in the order of their verification timestamps (the oldest ones
+  * first). The number of replicas verified simultaneously at each worker is
+  * limited, and so is (optionally) the rate at which the bytes of the replicas
+  * are read when the check/control sums are computed. If requested, the limits
+  * are lowered at workers where Qserv is running scans.
+  *
+  * Since the verification timestamps are updated in the database after each
+  * replica is verified, a pass over all replicas of the cluster interrupted
+  * by a restart of the job resumes from where it stopped.
   */
 class VerifyJob : public Job  {
 
@@ -164,12 +184,21 @@ public:
      * low-level pointers).
      *
      * @param maxReplicas
-     *   maximum number of replicas to process simultaneously
+     *   maximum number of replicas to process simultaneously at each worker
      *   (must be greater than 0).
      *
      * @param computeCheckSum
      *   compute check/control sum on each file if set to 'true'
      *
+     * @param maxBytesPerSec
+     *   maximum number of bytes per second of the replicas to be read at each
+     *   worker when computing the check/control sums (0 for no limit)
+     *
+     * @param yieldToQserv
+     *   if set to 'true' then only one replica at a time is processed, and
+     *   at a quarter of the 'maxBytesPerSec' rate, at workers where Qserv is
+     *   running scans
+     *
      @ @param onReplicaDifference
      *   callback function to be called when two replicas won't match
      *
@@ -193,6 +222,8 @@ public:
      */
     static Ptr create(size_t maxReplicas,
                       bool computeCheckSum,
+                      uint64_t maxBytesPerSec,
+                      bool yieldToQserv,
                       CallbackTypeOnDiff const& onReplicaDifference,
                       Controller::Ptr const& controller,
                       std::string const& parentJobId=std::string(),
@@ -207,12 +238,18 @@ public:
 
     ~VerifyJob() final = default;
 
-    /// @return maximum number of replicas to be allowed processed simultaneously
+    /// @return maximum number of replicas to be allowed processed simultaneously at each worker
     size_t maxReplicas() const { return _maxReplicas; }
 
     /// @return true if file check/control sums need to be recomputed
     bool computeCheckSum() const { return _computeCheckSum; }
 
+    /// @return maximum number of bytes per second to be read at each worker (0 for no limit)
+    uint64_t maxBytesPerSec() const { return _maxBytesPerSec; }
+
+    /// @return true if the limits are lowered at workers where Qserv is running scans
+    bool yieldToQserv() const { return _yieldToQserv; }
+
     /// @see Job::extendedPersistentState()
     std::list<std::pair<std::string,std::string>> extendedPersistentState() const override;
 
@@ -232,12 +269,38 @@ private:
     /// @see VerifyJob::create()
     VerifyJob(size_t maxReplicas,
               bool computeCheckSum,
+              uint64_t maxBytesPerSec,
+              bool yieldToQserv,
               CallbackTypeOnDiff const& onReplicaDifference,
               Controller::Ptr const& controller,
               std::string const& parentJobId,
               CallbackType const& onFinish,
               Job::Options const& options);
 
+    /// The replica verification state of a worker
+    struct WorkerState {
+
+        /// Replicas pulled from the database which are waiting to be verified
+        std::list<ReplicaInfo> replicas;
+
+        /// Replicas (databases and chunks) which are being verified
+        std::set<std::pair<std::string, unsigned int>> inFlight;
+
+        /// Replicas (databases and chunks) whose verification failed. They're
+        /// skipped until the worker has no other replicas to be verified.
+        std::set<std::pair<std::string, unsigned int>> failed;
+
+        /// The number of bytes which can be read before exceeding the limit
+        /// (the value may go negative when a big replica gets verified)
+        double budgetBytes = 0;
+
+        /// Set if Qserv was found running scans at the worker
+        bool qservBusy = false;
+
+        /// Set while the status of Qserv at the worker is being requested
+        bool qservProbing = false;
+    };
+
     /**
      * The callback function to be invoked on a completion of each request.
      *
@@ -247,27 +310,61 @@ private:
     void _onRequestFinish(FindRequest::Ptr const& request);
 
     /**
-     * Find the next replicas to be inspected.
+     * The callback function to be invoked on a completion of each Qserv
+     * status request.
+     *
+     * @param request
+     *   a pointer to a request
+     */
+    void _onQservStatus(GetStatusQservMgtRequest::Ptr const& request);
+
+    /**
+     * Launch as many verification requests at a worker as the limits allow.
      *
      * @param lock
      *   the lock on Job::_mtx must be acquired by a caller of the method
      *
-     * @param replicas
-     *   a collection of replicas returned from the database
+     * @param worker
+     *   the name of a worker
+     *
+     * @return
+     *   the number of requests launched
+     */
+    size_t _launch(util::Lock const& lock,
+                   std::string const& worker);
+
+    /**
+     * Pull the next replicas of a worker to be verified from the database.
+     * Replicas which are being verified are skipped.
+     *
+     * @param lock
+     *   the lock on Job::_mtx must be acquired by a caller of the method
      *
-     * @param numReplicas
-     *   a desired number of replicas to be pulled from the database
-     *   for processing.
+     * @param worker
+     *   the name of a worker
      */
     void _nextReplicas(util::Lock const& lock,
-                       std::vector<ReplicaInfo>& replicas,
-                       size_t numReplicas);
+                       std::string const& worker);
+
+    /// Start (or restart) the scheduling timer
+    void _startTimer(util::Lock const& lock);
 
+    /**
+     * The scheduling timer's handler. Restore the budgets of the workers,
+     * request the status of Qserv (if needed) and launch more requests.
+     *
+     * @param ec
+     *   the error code to be checked to see if the time was aborted
+     *   by the explicit cancellation of the job.
+     */
+    void _onTimer(boost::system::error_code const& ec);
 
     // Input parameters
 
-    size_t const _maxReplicas;
-    bool   const _computeCheckSum;
+    size_t   const _maxReplicas;
+    bool     const _computeCheckSum;
+    uint64_t const _maxBytesPerSec;
+    bool     const _yieldToQserv;
 
     /// Client-defined function to be called upon the completion of the job
     /// @note is reset when the job finishes
@@ -276,12 +373,24 @@ private:
     /// Client-defined function to be called when two replicas won't match
     CallbackTypeOnDiff _onReplicaDifference;
 
-    /// The current (last) batch if replicas which are being inspected.
-    /// The replicas are registered by the corresponding request IDs.
+    /// The replicas which are being inspected registered by the corresponding
+    /// request IDs.
     std::map<std::string, ReplicaInfo> _replicas;
 
-    /// The current (last) batch of requests registered by their IDs
+    /// The requests which are in progress registered by their IDs
     std::map<std::string, FindRequest::Ptr> _requests;
+
+    /// The verification state of the workers by their names
+    std::map<std::string, WorkerState> _workers;
+
+    /// The time (milliseconds) when the budgets of the workers were restored
+    uint64_t _budgetTime = 0;
+
+    /// The time (milliseconds) when the status of Qserv was requested
+    uint64_t _qservProbeTime = 0;
+
+    /// The scheduling timer
+    std::unique_ptr<boost::asio::deadline_timer> _timerPtr;
 };
 
 }}} // namespace lsst::qserv::replica
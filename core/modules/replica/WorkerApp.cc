@@ -23,10 +23,13 @@
 #include "replica/WorkerApp.h"
 
 // System headers
+#include <memory>
 #include <thread>
 
 // Qserv headers
 #include "replica/FileServer.h"
+#include "replica/HeartbeatSender.h"
+#include "replica/Performance.h"
 #include "replica/ServiceProvider.h"
 #include "replica/WorkerProcessor.h"
 #include "replica/WorkerRequestFactory.h"
@@ -70,6 +73,23 @@ WorkerApp::WorkerApp(int argc, char* argv[])
         "worker",
         "The name of a worker.",
         _worker);
+
+    parser().option(
+        "heartbeat-host",
+        "The host name (or the IP address) of the Master Controller where the heartbeats"
+        " of the worker service will be sent.",
+        _heartbeatHost);
+
+    parser().option(
+        "heartbeat-port",
+        "The UDP port of the Master Controller's heartbeat monitor. The heartbeats"
+        " won't be sent if the value is 0.",
+        _heartbeatPort);
+
+    parser().option(
+        "heartbeat-interval",
+        "The interval (milliseconds) between heartbeats.",
+        _heartbeatIntervalMs);
 }
 
 
@@ -89,11 +109,28 @@ int WorkerApp::runImpl() {
         fileSvr->run();
     });
 
-    // Print the 'heartbeat' report every 5 seconds
+    // Push heartbeats to the Master Controller (if requested), and print
+    // the 'heartbeat' report every 5 seconds
+
+    unique_ptr<HeartbeatSender> heartbeatSender;
+    if ((_heartbeatPort != 0) and not _heartbeatHost.empty()) {
+        heartbeatSender.reset(
+            new HeartbeatSender(_worker, _heartbeatHost, _heartbeatPort, _heartbeatIntervalMs));
+    }
+    unsigned int const reportIvalMs = 5000;
+    unsigned int const ivalMs = nullptr == heartbeatSender ? reportIvalMs : _heartbeatIntervalMs;
+
+    uint64_t prevReportTimeMs = PerformanceUtils::now();
 
-    util::BlockPost blockPost(5000, 5001);
+    util::BlockPost blockPost(ivalMs, ivalMs + 1);
     while (true) {
         blockPost.wait();
+        if (nullptr != heartbeatSender) heartbeatSender->send();
+
+        uint64_t const nowMs = PerformanceUtils::now();
+        if (nowMs - prevReportTimeMs < reportIvalMs) continue;
+        prevReportTimeMs = nowMs;
+
         LOGS(_log, LOG_LVL_INFO, "HEARTBEAT"
             << "  worker: " << reqProcSvr->worker()
             << "  processor.state: " << reqProcSvr->processor()->state2string()
@@ -81,6 +81,15 @@ private:
 
     /// The name of a worker
     std::string _worker;
+
+    /// The host of the Master Controller where the heartbeats are sent
+    std::string _heartbeatHost;
+
+    /// The UDP port of the Master Controller's heartbeat monitor (0 if no heartbeats are sent)
+    uint16_t _heartbeatPort = 0;
+
+    /// The interval (milliseconds) between heartbeats
+    unsigned int _heartbeatIntervalMs = 1000;
 };
 
 }}} // namespace lsst::qserv::replica
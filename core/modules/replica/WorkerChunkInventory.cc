@@ -0,0 +1,298 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "replica/WorkerChunkInventory.h"
+
+// System headers
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <tuple>
+#include <unistd.h>
+
+// Third party headers
+#include <boost/filesystem.hpp>
+
+// Qserv headers
+#include "lsst/log/Log.h"
+#include "replica/FileUtils.h"
+
+using namespace std;
+namespace fs = boost::filesystem;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.WorkerChunkInventory");
+
+/// Events on files of a watched directory which require checking the files.
+/// IN_MODIFY is needed for files kept open by the server, such as the table files
+/// written by mysqld, which never report IN_CLOSE_WRITE.
+uint32_t const fileEvents =
+    IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+/// Events after which the watch of a directory is lost
+uint32_t const selfEvents = IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT | IN_IGNORED;
+
+} /// namespace
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+WorkerChunkInventory::~WorkerChunkInventory() {
+    if (_fd != -1) close(_fd);
+}
+
+
+bool WorkerChunkInventory::files(ChunkFiles& chunkFiles,
+                                 string const& worker,
+                                 string const& database) {
+
+    string const context =
+        "WorkerChunkInventory::" + string(__func__) + " worker=" + worker +
+        " database=" + database + " ";
+
+    util::Lock lock(_mtx, context);
+
+    _readEvents(lock);
+
+    auto const itr = _entries.find(Key(worker, database));
+    if (itr == _entries.end()) return false;
+
+    auto&& entry = itr->second;
+    if (not entry.valid) return false;
+
+    LOGS(_log, LOG_LVL_DEBUG, context << "changedFiles: " << entry.changedFiles.size()
+         << " changedChunks: " << entry.changedChunks.size());
+
+    if (not _update(lock, entry)) return false;
+
+    chunkFiles.clear();
+    for (auto&& chunkEntry: entry.files) {
+        auto&& fileInfoCollection = chunkFiles[chunkEntry.first];
+        for (auto&& fileEntry: chunkEntry.second) {
+            fileInfoCollection.push_back(fileEntry.second);
+        }
+    }
+    return true;
+}
+
+
+void WorkerChunkInventory::watch(string const& worker,
+                                 DatabaseInfo const& databaseInfo,
+                                 string const& dataDir) {
+
+    string const context =
+        "WorkerChunkInventory::" + string(__func__) + " worker=" + worker +
+        " database=" + databaseInfo.name + " ";
+
+    util::Lock lock(_mtx, context);
+
+    if (not _initialized) {
+        _initialized = true;
+        _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (_fd == -1) {
+            LOGS(_log, LOG_LVL_WARN, context << "inotify_init1 failed, error: "
+                 << strerror(errno) << ", directories will be scanned each time");
+        }
+    }
+    if (_fd == -1) return;
+
+    // Events which are still queued will be superseded by the scan
+
+    _readEvents(lock);
+
+    Key const key(worker, databaseInfo.name);
+    auto&& entry = _entries[key];
+
+    entry.databaseInfo = databaseInfo;
+    entry.valid = false;
+    entry.files.clear();
+    entry.changedFiles.clear();
+    entry.changedChunks.clear();
+
+    if (entry.wd != -1 and entry.dataDir == dataDir) return;
+    if (entry.wd != -1) _invalidate(lock, entry);
+
+    entry.dataDir = dataDir;
+    entry.wd = inotify_add_watch(_fd, dataDir.c_str(), fileEvents | selfEvents | IN_ONLYDIR);
+    if (entry.wd == -1) {
+        LOGS(_log, LOG_LVL_WARN, context << "inotify_add_watch failed for: " << dataDir
+             << ", error: " << strerror(errno));
+        return;
+    }
+    _wd2key[entry.wd] = key;
+}
+
+
+void WorkerChunkInventory::load(string const& worker,
+                                string const& database,
+                                ChunkFiles const& chunkFiles) {
+
+    string const context =
+        "WorkerChunkInventory::" + string(__func__) + " worker=" + worker +
+        " database=" + database + " ";
+
+    util::Lock lock(_mtx, context);
+
+    auto const itr = _entries.find(Key(worker, database));
+    if (itr == _entries.end()) return;
+
+    auto&& entry = itr->second;
+    if (entry.wd == -1) return;
+
+    entry.files.clear();
+    for (auto&& chunkEntry: chunkFiles) {
+        for (auto&& fileInfo: chunkEntry.second) {
+            entry.files[chunkEntry.first][fileInfo.name] = fileInfo;
+        }
+    }
+    entry.valid = true;
+
+    LOGS(_log, LOG_LVL_DEBUG, context << "chunks: " << entry.files.size());
+}
+
+
+void WorkerChunkInventory::chunkChanged(string const& worker,
+                                        string const& database,
+                                        unsigned int chunk) {
+
+    util::Lock lock(_mtx, "WorkerChunkInventory::" + string(__func__));
+
+    auto const itr = _entries.find(Key(worker, database));
+    if (itr == _entries.end()) return;
+
+    itr->second.changedChunks.insert(chunk);
+}
+
+
+void WorkerChunkInventory::_readEvents(util::Lock const& lock) {
+
+    if (_fd == -1) return;
+
+    string const context = "WorkerChunkInventory::" + string(__func__) + " ";
+
+    alignas(struct inotify_event) char buf[64 * 1024];
+    while (true) {
+        ssize_t const len = read(_fd, buf, sizeof buf);
+        if (len == -1 and errno == EINTR) continue;
+        if (len <= 0) {
+            if (len == -1 and errno != EAGAIN) {
+                LOGS(_log, LOG_LVL_ERROR, context << "read failed, error: " << strerror(errno));
+            }
+            break;
+        }
+        for (char const* ptr = buf; ptr < buf + len;) {
+            auto const event = reinterpret_cast<struct inotify_event const*>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+
+                // Events were lost, all inventories are affected
+
+                LOGS(_log, LOG_LVL_WARN, context << "event queue overflow");
+                for (auto&& entry: _entries) entry.second.valid = false;
+                continue;
+            }
+            auto const keyItr = _wd2key.find(event->wd);
+            if (keyItr == _wd2key.end()) continue;
+
+            auto&& entry = _entries[keyItr->second];
+            if (event->mask & selfEvents) {
+                LOGS(_log, LOG_LVL_DEBUG, context << "watch lost for: " << entry.dataDir);
+                _invalidate(lock, entry);
+            } else if (event->len > 0) {
+                entry.changedFiles.insert(event->name);
+            }
+        }
+    }
+}
+
+
+void WorkerChunkInventory::_invalidate(util::Lock const& lock,
+                                       Entry& entry) {
+    if (entry.wd != -1) {
+        _wd2key.erase(entry.wd);
+        inotify_rm_watch(_fd, entry.wd);
+        entry.wd = -1;
+    }
+    entry.valid = false;
+}
+
+
+bool WorkerChunkInventory::_update(util::Lock const& lock,
+                                   Entry& entry) {
+
+    string const context = "WorkerChunkInventory::" + string(__func__) + " ";
+
+    for (auto chunk: entry.changedChunks) {
+        for (auto&& name: FileUtils::partitionedFiles(entry.databaseInfo, chunk)) {
+            entry.changedFiles.insert(name);
+        }
+    }
+    entry.changedChunks.clear();
+
+    for (auto&& name: entry.changedFiles) {
+
+        tuple<string, unsigned int, string> parsed;
+        if (not FileUtils::parsePartitionedFile(parsed, name, entry.databaseInfo)) continue;
+
+        unsigned int const chunk = get<1>(parsed);
+        fs::path const file = fs::path(entry.dataDir) / name;
+
+        boost::system::error_code ec;
+        fs::file_status const stat = fs::status(file, ec);
+        if (stat.type() == fs::file_not_found) {
+            auto const chunkItr = entry.files.find(chunk);
+            if (chunkItr != entry.files.end()) {
+                chunkItr->second.erase(name);
+                if (chunkItr->second.empty()) entry.files.erase(chunkItr);
+            }
+            continue;
+        }
+        uint64_t const size = fs::file_size(file, ec);
+        if (ec.value() == 0) {
+            time_t const mtime = fs::last_write_time(file, ec);
+            if (ec.value() == 0) {
+                entry.files[chunk][name] = ReplicaInfo::FileInfo({
+                    name,
+                    size,
+                    mtime,
+                    "",     /* cs is never computed for this type of requests */
+                    0,      /* beginTransferTime */
+                    0,      /* endTransferTime */
+                    size    /* inSize */
+                });
+                continue;
+            }
+        }
+        LOGS(_log, LOG_LVL_DEBUG, context << "failed to check file: " << file.string()
+             << ", error: " << ec.message());
+        entry.changedFiles.clear();
+        _invalidate(lock, entry);
+        return false;
+    }
+    entry.changedFiles.clear();
+    return true;
+}
+
+}}} // namespace lsst::qserv::replica
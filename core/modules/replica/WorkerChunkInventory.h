@@ -0,0 +1,218 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_REPLICA_WORKERCHUNKINVENTORY_H
+#define LSST_QSERV_REPLICA_WORKERCHUNKINVENTORY_H
+
+// System headers
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+// Qserv headers
+#include "replica/Configuration.h"
+#include "replica/ReplicaInfo.h"
+#include "util/Mutex.h"
+
+// This header declarations
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+/**
+ * Class WorkerChunkInventory keeps the files of the partitioned tables
+ * found in the data directories of workers, grouped by chunks, so that
+ * the directories don't need to be scanned each time the replicas are
+ * looked for.
+ *
+ * The inventory of a worker's database is built by a full scan of its data
+ * directory made by the user of the class (see WorkerFindAllRequestPOSIX).
+ * Prior to the scan the directory is put under watch (Linux 'inotify'),
+ * after the scan the files are loaded into the inventory. From then on
+ * only the files reported as changed by the watch, or belonging to chunks
+ * reported as changed by the replica creation and deletion requests
+ * (see WorkerChunkInventory::chunkChanged()), are checked again when the
+ * inventory is read.
+ *
+ * If the watch isn't available, or it's lost (the directory was removed or
+ * renamed, or the kernel's event queue overflowed), the inventory is
+ * invalidated and a full scan of the directory is required.
+ */
+class WorkerChunkInventory {
+
+public:
+
+    /// Files of the partitioned tables by the chunk numbers
+    typedef std::map<unsigned int, ReplicaInfo::FileInfoCollection> ChunkFiles;
+
+    // Copy semantics is prohibited
+
+    WorkerChunkInventory(WorkerChunkInventory const&) = delete;
+    WorkerChunkInventory& operator=(WorkerChunkInventory const&) = delete;
+
+    WorkerChunkInventory() = default;
+
+    ~WorkerChunkInventory();
+
+    /**
+     * Get the files of a database at a worker if the inventory is valid.
+     * The files reported as changed since the previous call are checked
+     * (and the inventory updated) before that.
+     *
+     * @param chunkFiles
+     *   collection of files (if the inventory is valid)
+     *
+     * @param worker
+     *   the name of a worker
+     *
+     * @param database
+     *   the name of a database
+     *
+     * @return
+     *   'false' if the directory needs to be scanned, and the inventory
+     *   loaded (see methods WorkerChunkInventory::watch() and
+     *   WorkerChunkInventory::load())
+     */
+    bool files(ChunkFiles& chunkFiles,
+               std::string const& worker,
+               std::string const& database);
+
+    /**
+     * Begin the inventory of a database at a worker by putting its data
+     * directory under watch. The method is called right before scanning
+     * the directory, so that no change made during the scan is missed.
+     *
+     * @param worker
+     *   the name of a worker
+     *
+     * @param databaseInfo
+     *   the description of a database
+     *
+     * @param dataDir
+     *   the data directory of the database at the worker
+     */
+    void watch(std::string const& worker,
+               DatabaseInfo const& databaseInfo,
+               std::string const& dataDir);
+
+    /**
+     * Complete the inventory of a database at a worker with the results
+     * of a scan of its data directory. Nothing is loaded unless the directory
+     * is under watch (see WorkerChunkInventory::watch()).
+     *
+     * @param worker
+     *   the name of a worker
+     *
+     * @param database
+     *   the name of a database
+     *
+     * @param chunkFiles
+     *   all files found in the data directory
+     */
+    void load(std::string const& worker,
+              std::string const& database,
+              ChunkFiles const& chunkFiles);
+
+    /**
+     * Notify the inventory on files of a chunk which were created, modified
+     * or deleted by the worker. The files will be checked when the inventory
+     * is read next time.
+     *
+     * @param worker
+     *   the name of a worker
+     *
+     * @param database
+     *   the name of a database
+     *
+     * @param chunk
+     *   the number of a chunk
+     */
+    void chunkChanged(std::string const& worker,
+                      std::string const& database,
+                      unsigned int chunk);
+
+private:
+
+    /// The inventory of a database at a worker
+    struct Entry {
+
+        /// The description of the database
+        DatabaseInfo databaseInfo;
+
+        /// The data directory of the database at the worker
+        std::string dataDir;
+
+        /// The watch descriptor (-1 if the directory isn't under watch)
+        int wd = -1;
+
+        /// Set when the files of the directory have been loaded
+        bool valid = false;
+
+        /// Files by the chunk numbers and file names
+        std::map<unsigned int, std::map<std::string, ReplicaInfo::FileInfo>> files;
+
+        /// Names of files which have changed since they were loaded
+        std::set<std::string> changedFiles;
+
+        /// Chunks which have changed since they were loaded
+        std::set<unsigned int> changedChunks;
+    };
+
+    /// The key of an entry: a worker and a database
+    typedef std::pair<std::string, std::string> Key;
+
+    /// Read all events which are available from the watch and dispatch
+    /// them to the entries.
+    void _readEvents(util::Lock const& lock);
+
+    /// Remove the watch of an entry (if any) and invalidate it
+    void _invalidate(util::Lock const& lock,
+                     Entry& entry);
+
+    /**
+     * Check the changed files of an entry and update its files
+     *
+     * @return
+     *   'false' if a file couldn't be checked, the entry gets invalidated then
+     */
+    bool _update(util::Lock const& lock,
+                 Entry& entry);
+
+    /// The inotify descriptor (-1 if it's not open or it couldn't be open)
+    int _fd = -1;
+
+    /// Set after the first attempt to open the inotify descriptor
+    bool _initialized = false;
+
+    /// The entries by workers and databases
+    std::map<Key, Entry> _entries;
+
+    /// The keys of the entries by their watch descriptors
+    std::map<int, Key> _wd2key;
+
+    /// The mutex for enforcing thread safety of the class's public API
+    /// and internal operations.
+    util::Mutex _mtx;
+};
+
+}}} // namespace lsst::qserv::replica
+
+#endif // LSST_QSERV_REPLICA_WORKERCHUNKINVENTORY_H
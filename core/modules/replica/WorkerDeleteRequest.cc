@@ -201,6 +201,7 @@ bool WorkerDeleteRequestPOSIX::execute() {
                         ExtendedCompletionStatus::EXT_STATUS_FILE_DELETE,
                         "failed to delete file: " + file.string());
         }
+        _serviceProvider->chunkInventory().chunkChanged(worker(), database(), chunk());
     }
     if (errorContext.failed) {
         setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
@@ -34,6 +34,7 @@
 #include "replica/FileUtils.h"
 #include "replica/Performance.h"
 #include "replica/ServiceProvider.h"
+#include "replica/WorkerChunkInventory.h"
 
 using namespace std;
 namespace fs = boost::filesystem;
@@ -172,16 +173,20 @@ bool WorkerFindAllRequestPOSIX::execute() {
     WorkerInfo   const workerInfo    = _serviceProvider->config()->workerInfo(worker());
     DatabaseInfo const databaseInfo  = _serviceProvider->config()->databaseInfo(database());
 
-    // Scan the data directory to find all files which match the expected pattern(s)
-    // and group them by their chunk number
+    // Scan the data directory (unless the inventory of its files is current) to
+    // find all files which match the expected pattern(s) and group them by their
+    // chunk number
 
     WorkerRequest::ErrorContext errorContext;
     boost::system::error_code   ec;
 
-    map<unsigned int, ReplicaInfo::FileInfoCollection> chunk2fileInfoCollection;
+    WorkerChunkInventory::ChunkFiles chunk2fileInfoCollection;
     {
         util::Lock dataFolderLock(_mtxDataFolderOperations, context(__func__));
 
+        auto&& inventory = _serviceProvider->chunkInventory();
+        bool const scan = not inventory.files(chunk2fileInfoCollection, worker(), database());
+
         fs::path        const dataDir = fs::path(workerInfo.dataDir) / database();
         fs::file_status const stat    = fs::status(dataDir, ec);
         errorContext = errorContext
@@ -193,57 +198,66 @@ bool WorkerFindAllRequestPOSIX::execute() {
                     not fs::exists(stat),
                     ExtendedCompletionStatus::EXT_STATUS_NO_FOLDER,
                     "the directory does not exists: " + dataDir.string());
-        try {
-            for (fs::directory_entry &entry: fs::directory_iterator(dataDir)) {
-                tuple<string, unsigned int, string> parsed;
-                if (FileUtils::parsePartitionedFile(
-                        parsed,
-                        entry.path().filename().string(),
-                        databaseInfo)) {
-
-                    LOGS(_log, LOG_LVL_DEBUG, context(__func__)
-                        << "  database: " << database()
-                        << "  file: "     << entry.path().filename()
-                        << "  table: "    << get<0>(parsed)
-                        << "  chunk: "    << get<1>(parsed)
-                        << "  ext: "      << get<2>(parsed));
-
-                    uint64_t const size = fs::file_size(entry.path(), ec);
-                    errorContext = errorContext
-                        or reportErrorIf(
-                                ec.value() != 0,
-                                ExtendedCompletionStatus::EXT_STATUS_FILE_SIZE,
-                                "failed to read file size: " + entry.path().string());
-
-                    time_t const mtime = fs::last_write_time(entry.path(), ec);
-                    errorContext = errorContext
-                        or reportErrorIf(
-                                ec.value() != 0,
-                                ExtendedCompletionStatus::EXT_STATUS_FILE_MTIME,
-                                "failed to read file mtime: " + entry.path().string());
-
-                    unsigned const chunk = get<1>(parsed);
-
-                    chunk2fileInfoCollection[chunk].emplace_back(
-                        ReplicaInfo::FileInfo({
+        if (scan and not errorContext.failed) {
+
+            // Changes made while scanning will be reported by the watch
+
+            inventory.watch(worker(), databaseInfo, dataDir.string());
+            try {
+                for (fs::directory_entry &entry: fs::directory_iterator(dataDir)) {
+                    tuple<string, unsigned int, string> parsed;
+                    if (FileUtils::parsePartitionedFile(
+                            parsed,
                             entry.path().filename().string(),
-                            size,
-                            mtime,
-                            "",     /* cs is never computed for this type of requests */
-                            0,      /* beginTransferTime */
-                            0,      /* endTransferTime */
-                            size    /* inSize */
-                        })
-                    );
+                            databaseInfo)) {
+
+                        LOGS(_log, LOG_LVL_DEBUG, context(__func__)
+                            << "  database: " << database()
+                            << "  file: "     << entry.path().filename()
+                            << "  table: "    << get<0>(parsed)
+                            << "  chunk: "    << get<1>(parsed)
+                            << "  ext: "      << get<2>(parsed));
+
+                        uint64_t const size = fs::file_size(entry.path(), ec);
+                        errorContext = errorContext
+                            or reportErrorIf(
+                                    ec.value() != 0,
+                                    ExtendedCompletionStatus::EXT_STATUS_FILE_SIZE,
+                                    "failed to read file size: " + entry.path().string());
+
+                        time_t const mtime = fs::last_write_time(entry.path(), ec);
+                        errorContext = errorContext
+                            or reportErrorIf(
+                                    ec.value() != 0,
+                                    ExtendedCompletionStatus::EXT_STATUS_FILE_MTIME,
+                                    "failed to read file mtime: " + entry.path().string());
+
+                        unsigned const chunk = get<1>(parsed);
+
+                        chunk2fileInfoCollection[chunk].emplace_back(
+                            ReplicaInfo::FileInfo({
+                                entry.path().filename().string(),
+                                size,
+                                mtime,
+                                "",     /* cs is never computed for this type of requests */
+                                0,      /* beginTransferTime */
+                                0,      /* endTransferTime */
+                                size    /* inSize */
+                            })
+                        );
+                    }
                 }
+            } catch (fs::filesystem_error const& ex) {
+                errorContext = errorContext
+                    or reportErrorIf(
+                            true,
+                            ExtendedCompletionStatus::EXT_STATUS_FOLDER_READ,
+                            "failed to read the directory: " + dataDir.string() +
+                            ", error: " + string(ex.what()));
+            }
+            if (not errorContext.failed) {
+                inventory.load(worker(), database(), chunk2fileInfoCollection);
             }
-        } catch (fs::filesystem_error const& ex) {
-            errorContext = errorContext
-                or reportErrorIf(
-                        true,
-                        ExtendedCompletionStatus::EXT_STATUS_FOLDER_READ,
-                        "failed to read the directory: " + dataDir.string() +
-                        ", error: " + string(ex.what()));
         }
     }
     if (errorContext.failed) {
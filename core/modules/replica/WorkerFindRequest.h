@@ -111,6 +111,11 @@ public:
 
     bool computeCheckSum() const { return _computeCheckSum; }
 
+    /// @see WorkerRequest::requestClass()
+    RequestClass requestClass() const override {
+        return computeCheckSum() ? CLASS_CHECKSUM : CLASS_METADATA;
+    }
+
     /**
      * Extract request status into the Protobuf response object.
      *
@@ -141,19 +141,30 @@ void WorkerProcessor::run() {
 
     if (_state == STATE_IS_STOPPED) {
 
-        size_t const numThreads = _serviceProvider->config()->workerNumProcessingThreads();
-        if (not numThreads) {
-            throw out_of_range(
-                    _classMethodContext(__func__) +
-                    "invalid configuration parameter for the number of processing threads. "
-                    "The value of the parameter must be greater than 0");
+        auto const config = _serviceProvider->config();
+        map<WorkerRequest::RequestClass, size_t> const numThreads = {
+            {WorkerRequest::CLASS_BULK_TRANSFER, config->workerNumProcessingThreads()},
+            {WorkerRequest::CLASS_CHECKSUM,      config->workerNumChecksumThreads()},
+            {WorkerRequest::CLASS_METADATA,      config->workerNumMetadataThreads()},
+            {WorkerRequest::CLASS_SQL,           config->workerNumSqlThreads()}
+        };
+        for (auto&& entry: numThreads) {
+            if (not entry.second) {
+                throw out_of_range(
+                        _classMethodContext(__func__) +
+                        "invalid configuration parameter for the number of processing threads"
+                        " of class " + WorkerRequest::requestClass2string(entry.first) +
+                        ". The value of the parameter must be greater than 0");
+            }
         }
 
         // Create threads if needed
         if (_threads.empty()) {
             auto const self = shared_from_this();
-            for (size_t i=0; i < numThreads; ++i) {
-                _threads.push_back(WorkerProcessorThread::create(self));
+            for (auto&& entry: numThreads) {
+                for (size_t i=0; i < entry.second; ++i) {
+                    _threads.push_back(WorkerProcessorThread::create(self, entry.first));
+                }
             }
         }
 
@@ -199,7 +210,9 @@ void WorkerProcessor::drain() {
     // Collect identifiers of requests to be affected by the operation
     list<string> ids;
 
-    for (auto&& ptr: _newRequests)        ids.push_back(ptr->id());
+    for (auto&& entry: _newRequests) {
+        for (auto&& ptr: entry.second)    ids.push_back(ptr->id());
+    }
     for (auto&& ptr: _inProgressRequests) ids.push_back(ptr->id());
 
     for (auto&& id: ids) _dequeueOrCancelImpl(lock, id);
@@ -223,8 +236,10 @@ void WorkerProcessor::enqueueForReplication(
     // existing requests in the active (non-completed) queues. A reason why we're ignoring
     // the completed is that this replica may have already been deleted from this worker.
 
-    for (auto&& ptr: _newRequests) {
-        if (::ifDuplicateRequest(response, ptr, request)) return;
+    for (auto&& entry: _newRequests) {
+        for (auto&& ptr: entry.second) {
+            if (::ifDuplicateRequest(response, ptr, request)) return;
+        }
     }
     for (auto&& ptr: _inProgressRequests) {
         if (::ifDuplicateRequest(response, ptr,request)) return;
@@ -242,7 +257,7 @@ void WorkerProcessor::enqueueForReplication(
             request.chunk(),
             request.worker()
         );
-        _newRequests.push(ptr);
+        _enqueue(lock, ptr);
 
         response.set_status(ProtocolStatus::QUEUED);
         response.set_status_ext(ProtocolStatusExt::NONE);
@@ -275,8 +290,10 @@ void WorkerProcessor::enqueueForDeletion(string const& id,
     // existing requests in the active (non-completed) queues. A reason why we're ignoring
     // the completed is that this replica may have already been deleted from this worker.
 
-    for (auto&& ptr : _newRequests) {
-        if (::ifDuplicateRequest(response, ptr, request)) return;
+    for (auto&& entry : _newRequests) {
+        for (auto&& ptr : entry.second) {
+            if (::ifDuplicateRequest(response, ptr, request)) return;
+        }
     }
     for (auto&& ptr : _inProgressRequests) {
         if (::ifDuplicateRequest(response, ptr, request)) return;
@@ -293,7 +310,7 @@ void WorkerProcessor::enqueueForDeletion(string const& id,
             request.database(),
             request.chunk()
         );
-        _newRequests.push(ptr);
+        _enqueue(lock, ptr);
 
         response.set_status(ProtocolStatus::QUEUED);
         response.set_status_ext(ProtocolStatusExt::NONE);
@@ -335,7 +352,7 @@ void WorkerProcessor::enqueueForFind(string const& id,
             request.chunk(),
             request.compute_cs()
         );
-        _newRequests.push(ptr);
+        _enqueue(lock, ptr);
     
         response.set_status(ProtocolStatus::QUEUED);
         response.set_status_ext(ProtocolStatusExt::NONE);
@@ -373,7 +390,7 @@ void WorkerProcessor::enqueueForFindAll(string const& id,
             request.priority(),
             request.database()
         );
-        _newRequests.push(ptr);
+        _enqueue(lock, ptr);
     
         response.set_status(ProtocolStatus::QUEUED);
         response.set_status_ext(ProtocolStatusExt::NONE);
@@ -430,7 +447,7 @@ void WorkerProcessor::enqueueForEcho(string const& id,
             request.data(),
             request.delay()
         );
-        _newRequests.push(ptr);
+        _enqueue(lock, ptr);
     
         response.set_status(ProtocolStatus::QUEUED);
         response.set_status_ext(ProtocolStatusExt::NONE);
@@ -471,9 +488,10 @@ void WorkerProcessor::enqueueForSql(std::string const& id,
             request.query(),
             request.user(),
             request.password(),
-            request.max_rows()
+            request.max_rows(),
+            request.page_size()
         );
-        _newRequests.push(ptr);
+        _enqueue(lock, ptr);
     
         response.set_status(ProtocolStatus::QUEUED);
         response.set_status_ext(ProtocolStatusExt::NONE);
@@ -503,28 +521,30 @@ WorkerRequest::Ptr WorkerProcessor::_dequeueOrCancelImpl(util::Lock const& lock,
     // input collection while retaining a valid copy of the pointer to be placed
     // into the next stage  collection.
 
-    for (auto ptr: _newRequests) {
-        if (ptr->id() == id) {
+    for (auto&& entry: _newRequests) {
+        for (auto ptr: entry.second) {
+            if (ptr->id() == id) {
 
-            // Cancel it and move it into the final queue in case if a client
-            // won't be able to receive the desired status of the request due to
-            // a protocol failure, etc.
+                // Cancel it and move it into the final queue in case if a client
+                // won't be able to receive the desired status of the request due to
+                // a protocol failure, etc.
 
-            ptr->cancel();
+                ptr->cancel();
 
-            switch (ptr->status()) {
+                switch (ptr->status()) {
 
-                case WorkerRequest::STATUS_CANCELLED: {
+                    case WorkerRequest::STATUS_CANCELLED: {
 
-                    _newRequests.remove(id);
-                    _finishedRequests.push_back(ptr);
+                        entry.second.remove(id);
+                        _finishedRequests.push_back(ptr);
 
-                    return ptr;
+                        return ptr;
+                    }
+                    default:
+                        throw logic_error(
+                                _classMethodContext(__func__) + "  unexpected request status " +
+                                WorkerRequest::status2string(ptr->status()) + " in new requests");
                 }
-                default:
-                    throw logic_error(
-                            _classMethodContext(__func__) + "  unexpected request status " +
-                            WorkerRequest::status2string(ptr->status()) + " in new requests");
             }
         }
     }
@@ -600,6 +620,29 @@ WorkerRequest::Ptr WorkerProcessor::_dequeueOrCancelImpl(util::Lock const& lock,
 }
 
 
+void WorkerProcessor::checkStatus(ProtocolRequestStatus const& request,
+                                  ProtocolResponseSql& response) {
+
+    util::Lock lock(_mtx, _context(__func__));
+
+    // Set this response unless an exact request (same type and identifier)
+    // will be found.
+    setDefaultResponse(response,
+                       ProtocolStatus::BAD,
+                       ProtocolStatusExt::INVALID_ID);
+
+    if (WorkerRequest::Ptr const ptr = _checkStatusImpl(lock, request.id())) {
+        auto const sqlPtr = dynamic_pointer_cast<WorkerSqlRequest>(ptr);
+        if (not sqlPtr) return;
+
+        sqlPtr->setInfo(response, request.page());
+
+        response.set_status(             translate(ptr->status()));
+        response.set_status_ext(replica::translate(ptr->extendedStatus()));
+    }
+}
+
+
 WorkerRequest::Ptr WorkerProcessor::_checkStatusImpl(util::Lock const& lock,
                                                      string const& id) {
 
@@ -607,18 +650,20 @@ WorkerRequest::Ptr WorkerProcessor::_checkStatusImpl(util::Lock const& lock,
 
     // Still waiting in the queue?
 
-    for (auto&& ptr: _newRequests) {
-        if (ptr->id() == id) {
-            switch (ptr->status()) {
+    for (auto&& entry: _newRequests) {
+        for (auto&& ptr: entry.second) {
+            if (ptr->id() == id) {
+                switch (ptr->status()) {
 
-                // This state requirement is strict for the non-active requests
-                case WorkerRequest::STATUS_NONE:
-                    return ptr;
+                    // This state requirement is strict for the non-active requests
+                    case WorkerRequest::STATUS_NONE:
+                        return ptr;
 
-                default:
-                    throw logic_error(
-                            _classMethodContext(__func__) + "  unexpected request status " +
-                            WorkerRequest::status2string(ptr->status()) + " in new requests");
+                    default:
+                        throw logic_error(
+                                _classMethodContext(__func__) + "  unexpected request status " +
+                                WorkerRequest::status2string(ptr->status()) + " in new requests");
+                }
             }
         }
     }
@@ -710,14 +755,36 @@ void WorkerProcessor::setServiceResponse(
             response.set_service_state(ProtocolServiceResponse::SUSPENDED);
             break;
     }
-    response.set_num_new_requests(        _newRequests.size());
+    response.set_num_new_requests(        _numNewRequests(lock));
     response.set_num_in_progress_requests(_inProgressRequests.size());
     response.set_num_finished_requests(   _finishedRequests.size());
 
+    // Report on the queues of all classes which have threads
+
+    map<WorkerRequest::RequestClass, size_t> numThreads;
+    for (auto&& t: _threads) ++numThreads[t->requestClass()];
+
+    map<WorkerRequest::RequestClass, size_t> numInProgressRequests;
+    for (auto&& request: _inProgressRequests) ++numInProgressRequests[request->requestClass()];
+
+    for (auto&& entry: numThreads) {
+        auto const requestClass = entry.first;
+        auto const newRequestsItr = _newRequests.find(requestClass);
+        auto queue = response.add_queues();
+        queue->set_name(WorkerRequest::requestClass2string(requestClass));
+        queue->set_num_threads(entry.second);
+        queue->set_num_new_requests(
+            newRequestsItr == _newRequests.end() ? 0 : newRequestsItr->second.size());
+        queue->set_num_in_progress_requests(numInProgressRequests[requestClass]);
+        queue->set_allocated_performance(_queuePerformance[requestClass].info().release());
+    }
+
     if (extendedReport) {
-        for (auto&& request: _newRequests) {
-            _setServiceResponseInfo(request,
-                                    response.add_new_requests());
+        for (auto&& entry: _newRequests) {
+            for (auto&& request: entry.second) {
+                _setServiceResponseInfo(request,
+                                        response.add_new_requests());
+            }
         }
         for (auto&& request: _inProgressRequests) {
             _setServiceResponseInfo(request,
@@ -759,7 +826,7 @@ void WorkerProcessor::_setServiceResponseInfo(
 
 size_t WorkerProcessor::numNewRequests() const {
     util::Lock lock(_mtx, _context(__func__));
-    return _newRequests.size();
+    return _numNewRequests(lock);
 }
 
 
@@ -802,15 +869,24 @@ WorkerRequest::Ptr WorkerProcessor::_fetchNextForProcessing(
         {
             util::Lock lock(_mtx, _context(__func__));
 
-            if (not _newRequests.empty()) {
+            // Requests of the thread's own class go first. Then the short ones
+            // of the METADATA class, so that all threads help with those.
 
-                WorkerRequest::Ptr request = _newRequests.top();
-                _newRequests.pop();
+            for (auto requestClass: {processorThread->requestClass(),
+                                     WorkerRequest::CLASS_METADATA}) {
 
-                request->start();
-                _inProgressRequests.push_back(request);
+                auto&& newRequests = _newRequests[requestClass];
+                if (not newRequests.empty()) {
 
-                return request;
+                    WorkerRequest::Ptr request = newRequests.top();
+                    newRequests.pop();
+
+                    request->start();
+                    _inProgressRequests.push_back(request);
+                    _queuePerformance[request->requestClass()].update(request->performance());
+
+                    return request;
+                }
             }
         }
         totalElapsedTime += blockPost.wait();
@@ -839,7 +915,7 @@ void WorkerProcessor::_processingRefused(WorkerRequest::Ptr const& request) {
             return ptr->id() == request->id();
         }
     );
-    _newRequests.push(request);
+    _enqueue(lock, request);
 }
 
 
@@ -881,6 +957,19 @@ void WorkerProcessor::_processorThreadStopped(WorkerProcessorThread::Ptr const&
 }
 
 
+void WorkerProcessor::_enqueue(util::Lock const& lock,
+                               WorkerRequest::Ptr const& request) {
+    _newRequests[request->requestClass()].push(request);
+}
+
+
+size_t WorkerProcessor::_numNewRequests(util::Lock const& lock) const {
+    size_t num = 0;
+    for (auto&& entry: _newRequests) num += entry.second.size();
+    return num;
+}
+
+
 void WorkerProcessor::_setInfo(WorkerRequest::Ptr const& request,
                                ProtocolResponseReplicate& response) {
 
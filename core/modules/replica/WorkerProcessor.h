@@ -24,6 +24,7 @@
 // System headers
 #include <algorithm>
 #include <list>
+#include <map>
 #include <memory>
 #include <queue>
 #include <stdexcept>
@@ -32,6 +33,7 @@
 
 // Qserv headers
 #include "replica/protocol.pb.h"
+#include "replica/Performance.h"
 #include "replica/ServiceProvider.h"
 #include "replica/WorkerProcessorThread.h"
 #include "replica/WorkerRequest.h"
@@ -52,6 +54,12 @@ namespace replica {
 /**
   * Class WorkerProcessor is a front-end interface for processing
   * requests from remote clients within worker-side services.
+  *
+  * Requests are queued (by their priorities) and processed separately for each
+  * class of requests (see WorkerRequest::RequestClass), each class having its own
+  * pool of threads. This prevents long requests (such as replica creation) from
+  * delaying short ones (such as replica lookups). Threads which have nothing
+  * to do also take requests of the METADATA class, whose processing is short.
   */
 class WorkerProcessor : public std::enable_shared_from_this<WorkerProcessor> {
 
@@ -129,8 +137,8 @@ public:
      *
      * @param serviceProvider
      *   provider is needed to access the Configuration of a setup
-     *   in order to get a number of the processing threads to be launched
-     *   by the processor.
+     *   in order to get the numbers of the processing threads of each class
+     *   to be launched by the processor.
      *
      * @param requestFactory
      *   reference to a factory of requests (for instantiating request objects)
@@ -366,6 +374,13 @@ public:
         }
     }
 
+    /**
+     * Return the status of an on-going query along with the page of its result
+     * set requested by a client (if the result set is sent in pages)
+     */
+    void checkStatus(ProtocolRequestStatus const& request,
+                     ProtocolResponseSql& response);
+
     /**
      * Fill in processor's state and counters into a response object to be sent
      * back to a remote client.
@@ -404,7 +419,8 @@ private:
     static ProtocolStatus translate(WorkerRequest::CompletionStatus status);
 
     /**
-     * Return the next request which is ready to be processed
+     * Return the next request of the thread's class (or of the METADATA class
+     * if there are none) which is ready to be processed
      * and if then one found assign it to the specified thread. The request
      * will be removed from the ready-to-be-processed queue.
      *
@@ -614,6 +630,22 @@ private:
      */
     void _processorThreadStopped(WorkerProcessorThread::Ptr const& processorThread);
 
+    /**
+     * Put a request into the ready-to-be-processed queue of its class
+     *
+     * @param lock
+     *   lock on WorkerProcessor::_mtx which must be acquired before calling
+     *   this method
+     *
+     * @param request
+     *   a pointer to the request
+     */
+    void _enqueue(util::Lock const& lock,
+                  WorkerRequest::Ptr const& request);
+
+    /// @return the number of ready-to-be-processed requests of all classes
+    size_t _numNewRequests(util::Lock const& lock) const;
+
     std::string _context(std::string const& func=std::string()) const { return "PROCESSOR  " + func; }
 
 
@@ -629,7 +661,11 @@ private:
 
     mutable util::Mutex _mtx;   /// Mutex guarding the queues
 
-    PriorityQueueType _newRequests;
+    /// The ready-to-be-processed requests by their classes
+    std::map<WorkerRequest::RequestClass, PriorityQueueType> _newRequests;
+
+    /// The queue wait time counters by the classes of requests
+    std::map<WorkerRequest::RequestClass, WorkerQueuePerformance> _queuePerformance;
 
     CollectionType _inProgressRequests;
     CollectionType _finishedRequests;
@@ -42,16 +42,19 @@ namespace lsst {
 namespace qserv {
 namespace replica {
 
-WorkerProcessorThread::Ptr WorkerProcessorThread::create(WorkerProcessorPtr const& processor) {
+WorkerProcessorThread::Ptr WorkerProcessorThread::create(WorkerProcessorPtr const& processor,
+                                                         WorkerRequest::RequestClass requestClass) {
     static unsigned int id = 0;
     return WorkerProcessorThread::Ptr(
-        new WorkerProcessorThread(processor, id++));
+        new WorkerProcessorThread(processor, requestClass, id++));
 }
 
 
 WorkerProcessorThread::WorkerProcessorThread(WorkerProcessorPtr const& processor,
+                                             WorkerRequest::RequestClass requestClass,
                                              unsigned int id)
     :   _processor(processor),
+        _requestClass(requestClass),
         _id(id),
         _stop(false) {
 }
@@ -26,6 +26,9 @@
 #include <memory>
 #include <thread>
 
+// Qserv headers
+#include "replica/WorkerRequest.h"
+
 // Forward declarations
 namespace lsst {
 namespace qserv {
@@ -40,7 +43,8 @@ namespace replica {
 
 /**
   * Class WorkerProcessorThread is a thread-based request processing engine
-  * for replication requests within worker-side services.
+  * for replication requests within worker-side services. Each thread is
+  * dedicated to a class of requests (see WorkerRequest::RequestClass).
   */
 class WorkerProcessorThread : public std::enable_shared_from_this<WorkerProcessorThread> {
 
@@ -62,10 +66,14 @@ public:
      *   will be used for making call backs to the processor on the completed
      *   or rejected requests.
      *
+     * @param requestClass
+     *   the class of requests to be processed by the thread
+     *
      * @return
      *   pointer to the created object 
      */
-    static Ptr create(WorkerProcessorPtr const& processor);
+    static Ptr create(WorkerProcessorPtr const& processor,
+                      WorkerRequest::RequestClass requestClass);
 
     // Default construction and copy semantics are prohibited
 
@@ -78,6 +86,9 @@ public:
     /// @return identifier of this thread object
     unsigned int id() const { return _id; }
 
+    /// @return the class of requests processed by the thread
+    WorkerRequest::RequestClass requestClass() const { return _requestClass; }
+
     /// @return 'true' if the processing thread is still running
     bool isRunning() const;
 
@@ -105,6 +116,7 @@ private:
 
     /// @see WorkerProcessorThread::create()
     WorkerProcessorThread(WorkerProcessorPtr const& processor,
+                          WorkerRequest::RequestClass requestClass,
                           unsigned int id);
 
     /**
@@ -116,6 +128,8 @@ private:
 
     WorkerProcessorPtr const _processor;
 
+    WorkerRequest::RequestClass const _requestClass;
+
     /// The identifier of this thread object   
     unsigned int const _id;
 
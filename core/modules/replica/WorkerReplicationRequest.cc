@@ -25,7 +25,11 @@
 // System headers
 #include <cerrno>
 #include <cstring>
+#include <fcntl.h>
 #include <stdexcept>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 // Qserv headers
 #include "lsst/log/Log.h"
@@ -42,6 +46,75 @@ namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.WorkerReplicationRequest");
 
+// The request for sharing the extents of a file (reflink) isn't defined
+// by the older kernel headers
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+
+/// The most bytes copied locally by one call to WorkerReplicationRequestFS::execute()
+/// unless the file extents are shared, so that the request can be cancelled
+/// or inspected between the calls
+size_t const localCopyRangeBytes = 256 * 1024 * 1024;
+
+/// Copy up to 'len' bytes between files within the kernel (no wrapper
+/// for the system call is provided by the older C libraries)
+ssize_t copyFileRange(int inFd, int outFd, size_t len) {
+#ifdef SYS_copy_file_range
+    return syscall(SYS_copy_file_range, inFd, nullptr, outFd, nullptr, len, 0);
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+/**
+ * Make a copy of a local file w/o moving its content through the user space.
+ * The extents of the input file are shared with the output one (reflink)
+ * if the file system supports that (Btrfs, XFS, etc.), which is nearly
+ * instantaneous. Otherwise the content gets copied by the kernel, or by
+ * the server of a network file system (NFS 4.2, etc.).
+ *
+ * @param inFile   the input file
+ * @param outFile  the output file (created, or overwritten in place to keep
+ *                 the disk space reserved for it)
+ * @param error    the error message (if the operation failed)
+ *
+ * @return 'false' if the file couldn't be copied this way
+ */
+bool cloneFile(fs::path const& inFile,
+               fs::path const& outFile,
+               string& error) {
+
+    int const inFd = open(inFile.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (inFd == -1) {
+        error = "failed to open input file: " + inFile.string() + ", error: " + strerror(errno);
+        return false;
+    }
+    int const outFd = open(outFile.string().c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (outFd == -1) {
+        error = "failed to open output file: " + outFile.string() + ", error: " + strerror(errno);
+        close(inFd);
+        return false;
+    }
+    bool success = true;
+    if (ioctl(outFd, FICLONE, inFd) != 0) {
+        while (true) {
+            ssize_t const num = copyFileRange(inFd, outFd, 1024 * 1024 * 1024);
+            if (num == -1 and errno == EINTR) continue;
+            if (num == -1) {
+                error = "failed to copy file: " + inFile.string() + " into: " + outFile.string() +
+                        ", error: " + strerror(errno);
+                success = false;
+            }
+            if (num <= 0) break;
+        }
+    }
+    close(inFd);
+    close(outFd);
+    return success;
+}
+
 } /// namespace
 
 namespace lsst {
@@ -355,7 +428,14 @@ bool WorkerReplicationRequestPOSIX::execute () {
         fs::path const inFile  = file2inFile [file];
         fs::path const tmpFile = file2tmpFile[file];
 
-        fs::copy_file(inFile, tmpFile, ec);
+        // Fall back to the plain copy if the files can't be cloned
+
+        string error;
+        if (not ::cloneFile(inFile, tmpFile, error)) {
+            LOGS(_log, LOG_LVL_DEBUG, context(__func__) << "  " << error);
+            fs::remove(tmpFile, ec);
+            fs::copy_file(inFile, tmpFile, ec);
+        }
         errorContext = errorContext
             or reportErrorIf(
                     ec.value() != 0,
@@ -399,6 +479,7 @@ bool WorkerReplicationRequestPOSIX::execute () {
                         ExtendedCompletionStatus::EXT_STATUS_FILE_MTIME,
                         "failed to set the mtime of output file: " + outFile.string());
         }
+        _serviceProvider->chunkInventory().chunkChanged(worker(), database(), chunk());
     }
     if (errorContext.failed) {
         setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
@@ -459,6 +540,9 @@ WorkerReplicationRequestFS::WorkerReplicationRequestFS(
         _initialized(false),
         _files(FileUtils::partitionedFiles(_databaseInfo, chunk)),
         _tmpFilePtr(nullptr),
+        _local(false),
+        _inFd(-1),
+        _outFd(-1),
         _buf(0),
         _bufSize(serviceProvider->config()->workerFsBufferSizeBytes()) {
 }
@@ -674,18 +758,25 @@ bool WorkerReplicationRequestFS::execute () {
             return true;
         }
 
-        // Allocate the record buffer
-        _buf = new uint8_t[_bufSize];
-        if (not _buf) {
-            throw runtime_error(
-                    "WorkerReplicationRequestFS::" + string(__func__) +
-                    "  buffer allocation failed");
+        // Skip the file server if the files of the source worker are visible
+        // at this worker (same host, shared or multi-disk storage). The files
+        // are copied by the next calls.
+
+        if (_canCopyLocally()) {
+            _local   = true;
+            _fileItr = _files.begin();
+            return false;
         }
+        if (not _openFileServer(lock)) return true;
+    }
 
-        // Setup the iterator for the name of the very first file to be copied
-        _fileItr = _files.begin();
+    // Copy the next range of the current file locally, or fall back to
+    // the file server if that fails
 
-        if (not _openFiles(lock)) return true;
+    if (_local) {
+        if (_copyLocally(lock)) return false;
+        if (_local) return _finalize(lock);
+        if (not _openFileServer(lock)) return true;
     }
 
     // Copy the next record from the currently open remote file
@@ -777,6 +868,135 @@ bool WorkerReplicationRequestFS::execute () {
 }
 
 
+bool WorkerReplicationRequestFS::_canCopyLocally() const {
+
+    fs::path const inDir = fs::path(_inWorkerInfo.dataDir) / database();
+
+    // The files found locally must be the ones reported by the file server
+    // of the source worker
+
+    boost::system::error_code ec;
+    for (auto&& file: _files) {
+        fs::path const inFile = inDir / file;
+        uintmax_t const size  = fs::file_size(inFile, ec);
+        if (ec.value() != 0 or size != _file2descr.at(file).inSizeBytes) return false;
+        time_t const mtime = fs::last_write_time(inFile, ec);
+        if (ec.value() != 0 or mtime != _file2descr.at(file).mtime) return false;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, context(__func__)
+         << "  sourceWorker: " << sourceWorker()
+         << "  database: "     << database()
+         << "  chunk: "        << chunk()
+         << "  inDir: "        << inDir.string());
+    return true;
+}
+
+
+bool WorkerReplicationRequestFS::_copyLocally(util::Lock const& lock) {
+
+    if (_files.end() == _fileItr) return false;
+
+    fs::path const inFile = fs::path(_inWorkerInfo.dataDir) / database() / *_fileItr;
+    auto&& descr = _file2descr[*_fileItr];
+
+    // Fall back to the file server. The temporary files keep their size,
+    // and they will be overwritten by the file server's payload.
+
+    auto const fallBack = [&](string const& error) -> bool {
+        LOGS(_log, LOG_LVL_WARN, context(__func__) << "  " << error
+             << ", falling back to the file server of worker: " << _inWorkerInfo.name);
+        _closeLocalFiles();
+        for (auto&& entry: _file2descr) {
+            entry.second.outSizeBytes      = 0;
+            entry.second.local             = false;
+            entry.second.beginTransferTime = 0;
+            entry.second.endTransferTime   = 0;
+        }
+        _local = false;
+        return false;
+    };
+
+    if (_inFd == -1) {
+        descr.beginTransferTime = PerformanceUtils::now();
+        _inFd = open(inFile.string().c_str(), O_RDONLY | O_CLOEXEC);
+        if (_inFd == -1) {
+            return fallBack("failed to open input file: " + inFile.string() + ", error: " + strerror(errno));
+        }
+        // The file was pre-sized by the initialization phase, and it's not
+        // truncated to keep the space reserved
+        _outFd = open(descr.tmpFile.string().c_str(), O_WRONLY | O_CLOEXEC);
+        if (_outFd == -1) {
+            return fallBack("failed to open temporary file: " + descr.tmpFile.string() +
+                            ", error: " + strerror(errno));
+        }
+        if (ioctl(_outFd, FICLONE, _inFd) == 0) descr.outSizeBytes = descr.inSizeBytes;
+    }
+
+    // Copy one range of the file per call
+
+    if (descr.outSizeBytes < descr.inSizeBytes) {
+        size_t const len = min(descr.inSizeBytes - descr.outSizeBytes, localCopyRangeBytes);
+        ssize_t const num = copyFileRange(_inFd, _outFd, len);
+        if (num == -1 and errno == EINTR) return true;
+        if (num == -1) {
+            return fallBack("failed to copy file: " + inFile.string() + " into: " + descr.tmpFile.string() +
+                            ", error: " + strerror(errno));
+        }
+        if (num == 0) return fallBack("short read of input file: " + inFile.string());
+        descr.outSizeBytes   += num;
+        descr.endTransferTime = PerformanceUtils::now();
+        _updateInfo(lock);
+        if (descr.outSizeBytes < descr.inSizeBytes) return true;
+    }
+    _closeLocalFiles();
+
+    // Verify the copy, and make sure the input file wasn't modified
+    // while it was copied
+
+    boost::system::error_code ec;
+    bool const success = (fs::file_size(descr.tmpFile, ec) == descr.inSizeBytes) and (ec.value() == 0)
+                     and (fs::file_size(inFile, ec)        == descr.inSizeBytes) and (ec.value() == 0)
+                     and (fs::last_write_time(inFile, ec)  == descr.mtime)       and (ec.value() == 0);
+    if (not success) return fallBack("the copy doesn't match input file: " + inFile.string());
+
+    descr.local           = true;
+    descr.endTransferTime = PerformanceUtils::now();
+    _updateInfo(lock);
+
+    ++_fileItr;
+    return _files.end() != _fileItr;
+}
+
+
+void WorkerReplicationRequestFS::_closeLocalFiles() {
+    if (_inFd != -1) {
+        close(_inFd);
+        _inFd = -1;
+    }
+    if (_outFd != -1) {
+        close(_outFd);
+        _outFd = -1;
+    }
+}
+
+
+bool WorkerReplicationRequestFS::_openFileServer(util::Lock const& lock) {
+
+    // Allocate the record buffer
+    _buf = new uint8_t[_bufSize];
+    if (not _buf) {
+        throw runtime_error(
+                "WorkerReplicationRequestFS::" + string(__func__) +
+                "  buffer allocation failed");
+    }
+
+    // Setup the iterator for the name of the very first file to be copied
+    _fileItr = _files.begin();
+
+    return _openFiles(lock);
+}
+
+
 bool WorkerReplicationRequestFS::_openFiles(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, context(__func__)
@@ -872,6 +1092,7 @@ bool WorkerReplicationRequestFS::_finalize(util::Lock const& lock) {
                     ExtendedCompletionStatus::EXT_STATUS_FILE_MTIME,
                     "failed to change 'mtime' of file: " + tmpFile.string());
     }
+    _serviceProvider->chunkInventory().chunkChanged(worker(), database(), chunk());
 
     if (errorContext.failed) {
         setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
@@ -894,7 +1115,7 @@ void WorkerReplicationRequestFS::_updateInfo(util::Lock const& lock) {
                 file,
                 _file2descr[file].outSizeBytes,
                 _file2descr[file].mtime,
-                to_string(_file2descr[file].cs),
+                _file2descr[file].local ? "" : to_string(_file2descr[file].cs),
                 _file2descr[file].beginTransferTime,
                 _file2descr[file].endTransferTime,
                 _file2descr[file].inSizeBytes
@@ -926,6 +1147,9 @@ void WorkerReplicationRequestFS::_releaseResources(util::Lock const& lock) {
     // Drop a connection to the remote server
     _inFilePtr.reset();
 
+    // Close the files being copied locally
+    _closeLocalFiles();
+
     // Close the output file
     if (_tmpFilePtr) {
         fflush(_tmpFilePtr);
@@ -117,6 +117,9 @@ public:
 
     std::string const& sourceWorker() const { return _sourceWorker; }
 
+    /// @see WorkerRequest::requestClass()
+    RequestClass requestClass() const override { return CLASS_BULK_TRANSFER; }
+
     /**
      * Extract request status into the Protobuf response object.
      *
@@ -206,6 +209,16 @@ protected:
   * the replication requests based on the direct manipulation of local files
   * on a POSIX file system and for reading remote files using the built-into-worker
   * simple file server.
+  *
+  * If the files of the source worker are visible at the destination (both
+  * workers run on the same host, or they share a file system) the files are
+  * copied locally w/o involving the file server. Their extents are shared
+  * (reflink) if the file system allows that, or they're copied by the kernel
+  * otherwise. Hard links aren't used since a replica made this way would share
+  * the content (and any later in-place modification) with its source.
+  * Like the file server's payload, the files are copied in bounded steps,
+  * one per call of execute(), so that the request can be cancelled or
+  * inspected while it's copying.
   */
 class WorkerReplicationRequestFS : public WorkerReplicationRequest {
 
@@ -267,6 +280,42 @@ private:
      */
     bool _openFiles(util::Lock const& lock);
 
+    /**
+     * Allocate the record buffer and open the first file to be pulled from
+     * the file server of the source worker.
+     *
+     * @param lock
+     *   lock which must be acquired before calling this method
+     *
+     * @return
+     *   'false' in case of any error
+     */
+    bool _openFileServer(util::Lock const& lock);
+
+    /**
+     * @return
+     *   'true' if the files are visible at the data directory of the source
+     *   worker, and they match the ones reported by its file server
+     */
+    bool _canCopyLocally() const;
+
+    /**
+     * Copy the next range of the file at _fileItr locally (or the whole file
+     * if its extents can be shared). The copy of each file is verified. If
+     * anything fails _local is reset, and the files need to be pulled from
+     * the file server.
+     *
+     * @param lock
+     *   lock which must be acquired before calling this method
+     *
+     * @return
+     *   'true' if there is more to copy
+     */
+    bool _copyLocally(util::Lock const& lock);
+
+    /// Close the files being copied locally (if any)
+    void _closeLocalFiles();
+
     /**
      * The final stage to be executed just once after copying the content
      * of the remote files into the local temporary ones. It will rename
@@ -332,6 +381,13 @@ private:
     /// The file pointer for the temporary output file
     std::FILE* _tmpFilePtr;
 
+    /// Set while the files are copied locally, see _copyLocally()
+    bool _local;
+
+    /// The descriptors of the input and temporary file being copied locally
+    int _inFd;
+    int _outFd;
+
     /// The FileDescr structure encapsulates various parameters of a file
     struct FileDescr {
 
@@ -348,6 +404,10 @@ private:
         /// Control sum computed locally while copying the file
         uint64_t cs = 0;
 
+        /// Set if the file was copied locally (the control sum isn't
+        /// computed then)
+        bool local = false;
+
         /// The absolute path of a temporary file at a local directory.
         boost::filesystem::path tmpFile;
 
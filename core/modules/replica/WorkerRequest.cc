@@ -70,6 +70,18 @@ string WorkerRequest::status2string(CompletionStatus status) {
 }
 
 
+string WorkerRequest::requestClass2string(RequestClass requestClass) {
+    switch (requestClass) {
+        case CLASS_BULK_TRANSFER: return "BULK_TRANSFER";
+        case CLASS_CHECKSUM:      return "CHECKSUM";
+        case CLASS_METADATA:      return "METADATA";
+        case CLASS_SQL:           return "SQL";
+    }
+    throw logic_error(
+            "WorkerRequest::" + string(__func__) + "  unhandled class: " + to_string(requestClass));
+}
+
+
 string WorkerRequest::status2string(CompletionStatus status,
                                     ExtendedCompletionStatus extendedStatus) {
     return status2string(status) + "::" + replica::status2string(extendedStatus);
@@ -80,6 +80,18 @@ public:
     static std::string status2string(CompletionStatus status,
                                      ExtendedCompletionStatus extendedStatus);
 
+    /// Classes of requests which are queued and processed by separate
+    /// pools of threads at worker services (see WorkerProcessor)
+    enum RequestClass {
+        CLASS_BULK_TRANSFER,    /// replica creation
+        CLASS_CHECKSUM,         /// replica lookup computing check/control sums
+        CLASS_METADATA,         /// replica lookup, deletion and tests
+        CLASS_SQL               /// database queries
+    };
+
+    /// @return the string representation of the class
+    static std::string requestClass2string(RequestClass requestClass);
+
     // Default construction and copy semantics are prohibited
 
     WorkerRequest() = delete;
@@ -108,6 +120,10 @@ public:
     /// @return the performance info
     const WorkerPerformance& performance() const { return _performance; }
 
+    /// @return the class of the request, which is CLASS_METADATA unless
+    ///   overridden by a subclass
+    virtual RequestClass requestClass() const { return CLASS_METADATA; }
+
     /**
      * This method is called from the initial state STATUS_NONE in order
      * to prepare the request for processing (to respond to methods 'execute',
@@ -168,7 +168,8 @@ public:
                                          string const& query,
                                          string const& user,
                                          string const& password,
-                                         size_t maxRows) const final {
+                                         size_t maxRows,
+                                         size_t pageSize) const final {
         return WorkerSqlRequest::create(
             _serviceProvider,
             worker,
@@ -177,7 +178,8 @@ public:
             query,
             user,
             password,
-            maxRows);
+            maxRows,
+            pageSize);
     }
 };
 
@@ -293,7 +295,8 @@ public:
                                          string const& query,
                                          string const& user,
                                          string const& password,
-                                         size_t maxRows) const final {
+                                         size_t maxRows,
+                                         size_t pageSize) const final {
         return WorkerSqlRequestPOSIX::create(
             _serviceProvider,
             worker,
@@ -302,7 +305,8 @@ public:
             query,
             user,
             password,
-            maxRows);
+            maxRows,
+            pageSize);
     }
 };
 
@@ -419,7 +423,8 @@ public:
                                          string const& query,
                                          string const& user,
                                          string const& password,
-                                         size_t maxRows) const final {
+                                         size_t maxRows,
+                                         size_t pageSize) const final {
         return WorkerSqlRequestFS::create(
             _serviceProvider,
             worker,
@@ -428,7 +433,8 @@ public:
             query,
             user,
             password,
-            maxRows);
+            maxRows,
+            pageSize);
     }
 };
 
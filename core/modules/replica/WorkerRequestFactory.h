@@ -164,7 +164,8 @@ public:
             std::string const& query,
             std::string const& user,
             std::string const& password,
-            size_t maxRows) const = 0;
+            size_t maxRows,
+            size_t pageSize) const = 0;
  
 protected:
 
@@ -319,7 +320,8 @@ public:
             std::string const& query,
             std::string const& user,
             std::string const& password,
-            size_t maxRows) const final {
+            size_t maxRows,
+            size_t pageSize) const final {
 
         return _ptr->createSqlRequest(
             worker,
@@ -328,7 +330,8 @@ public:
             query,
             user,
             password,
-            maxRows);
+            maxRows,
+            pageSize);
     }
 
 protected:
@@ -23,7 +23,9 @@
 #include "replica/WorkerSqlRequest.h"
 
 // System headers
+#include <chrono>
 #include <stdexcept>
+#include <thread>
 
 // Qserv headers
 #include "replica/Configuration.h"
@@ -39,6 +41,16 @@ namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.WorkerSqlRequest");
 
+/// The maximum number of pages waiting to be requested by a client
+size_t const maxBufferedPages = 4;
+
+/// The delay before checking again if a client has requested the pages
+unsigned int const pageWaitIvalMs = 10;
+
+/// The maximum time the client may take to request the next page before
+/// the request fails
+unsigned int const pageRequestTimeoutSec = 300;
+
 } /// namespace
 
 namespace lsst {
@@ -52,7 +64,8 @@ WorkerSqlRequest::Ptr WorkerSqlRequest::create(ServiceProvider::Ptr const& servi
                                                std::string const& query,
                                                std::string const& user,
                                                std::string const& password,
-                                               size_t maxRows) {
+                                               size_t maxRows,
+                                               size_t pageSize) {
     return WorkerSqlRequest::Ptr(
         new WorkerSqlRequest(serviceProvider,
                              worker,
@@ -61,7 +74,8 @@ WorkerSqlRequest::Ptr WorkerSqlRequest::create(ServiceProvider::Ptr const& servi
                              query,
                              user,
                              password,
-                             maxRows));
+                             maxRows,
+                             pageSize));
 }
 
 
@@ -72,7 +86,8 @@ WorkerSqlRequest::WorkerSqlRequest(ServiceProvider::Ptr const& serviceProvider,
                                    std::string const& query,
                                    std::string const& user,
                                    std::string const& password,
-                                   size_t maxRows)
+                                   size_t maxRows,
+                                   size_t pageSize)
     :   WorkerRequest(serviceProvider,
                       worker,
                       "SQL",
@@ -81,18 +96,46 @@ WorkerSqlRequest::WorkerSqlRequest(ServiceProvider::Ptr const& serviceProvider,
         _query(query),
         _user(user),
         _password(password),
-        _maxRows(maxRows) {
+        _maxRows(maxRows),
+        _pageSize(pageSize) {
 }
 
 
-void WorkerSqlRequest::setInfo(ProtocolResponseSql& response) const {
+void WorkerSqlRequest::setInfo(ProtocolResponseSql& response,
+                               uint64_t page) const {
 
-    LOGS(_log, LOG_LVL_DEBUG, context(__func__));
+    LOGS(_log, LOG_LVL_DEBUG, context(__func__) << "  page: " << page);
 
     util::Lock lock(_mtx, context(__func__));
 
     response.set_allocated_target_performance(performance().info().release());
 
+    if (pageSize() != 0) {
+
+        // The description of the result set is sent along with each page
+
+        response.set_error(            _response.error());
+        response.set_char_set_name(    _response.char_set_name());
+        response.set_has_result(       _response.has_result());
+        *(response.mutable_fields()) = _response.fields();
+
+        // The pages preceding the requested one were received by the client
+
+        while (not _pages.empty() and _firstPage < page) {
+            _pages.pop_front();
+            ++_firstPage;
+        }
+        _pageRequestTime = PerformanceUtils::now();
+
+        response.set_page(page);
+        if (not _pages.empty() and _firstPage == page) {
+            *(response.mutable_rows()) = _pages.front().rows();
+        }
+        bool const lastPage = _eof and (page + 1 >= _numPages);
+        response.set_more_pages(not lastPage and status() != STATUS_FAILED);
+        return;
+    }
+
     // Carry over the result of the query only after the request
     // has finished (or failed).
     switch (status()) {
@@ -114,36 +157,63 @@ bool WorkerSqlRequest::execute() {
 
     LOGS(_log, LOG_LVL_DEBUG, context(__func__));
 
-    util::Lock lock(_mtx, context(__func__));
+    bool wait = false;
+    {
+        util::Lock lock(_mtx, context(__func__));
 
-    switch (status()) {
+        switch (status()) {
 
-        case STATUS_IN_PROGRESS:
-            break;
+            case STATUS_IN_PROGRESS:
+                break;
 
-        case STATUS_IS_CANCELLING:
+            case STATUS_IS_CANCELLING:
 
-            // Abort the operation right away
+                // Abort the operation right away
 
-            setStatus(lock, STATUS_CANCELLED);
-            throw WorkerRequestCancelled();
+                if ((nullptr != _conn) and _conn->inTransaction()) _conn->rollback();
+                _conn.reset();
+                _pages.clear();
 
-        default:
-            throw logic_error(
-                    "WorkerSqlRequest::" + context(__func__) + "  not allowed while in state: " +
-                    WorkerRequest::status2string(status()));
+                setStatus(lock, STATUS_CANCELLED);
+                throw WorkerRequestCancelled();
+
+            default:
+                throw logic_error(
+                        "WorkerSqlRequest::" + context(__func__) + "  not allowed while in state: " +
+                        WorkerRequest::status2string(status()));
+        }
+        if (pageSize() == 0) {
+            _executeAll(lock);
+            return true;
+        }
+        if (_executePage(lock, wait)) return true;
     }
 
+    // Let the client request the pages w/o holding the lock
+
+    if (wait) this_thread::sleep_for(chrono::milliseconds(pageWaitIvalMs));
+    return false;
+}
+
+
+database::mysql::Connection::Ptr WorkerSqlRequest::_connect() {
+
+    auto const workerInfo = serviceProvider()->config()->workerInfo(worker());
+    return database::mysql::Connection::open(
+        database::mysql::ConnectionParams(
+            workerInfo.dbHost,
+            workerInfo.dbPort,
+            user(),
+            password(),
+            ""));
+}
+
+
+void WorkerSqlRequest::_executeAll(util::Lock const& lock) {
+
     database::mysql::Connection::Ptr conn;
     try {
-        auto const workerInfo = serviceProvider()->config()->workerInfo(worker());
-        conn = database::mysql::Connection::open(
-            database::mysql::ConnectionParams(
-                workerInfo.dbHost,
-                workerInfo.dbPort,
-                user(),
-                password(),
-                ""));
+        conn = _connect();
 
         auto self = shared_from_base<WorkerSqlRequest>();
         conn->execute([self](decltype(conn) const& conn_) {
@@ -180,10 +250,113 @@ bool WorkerSqlRequest::execute() {
 
     }
     if ((nullptr != conn) and conn->inTransaction()) conn->rollback();
+}
+
+
+bool WorkerSqlRequest::_executePage(util::Lock const& lock,
+                                    bool& wait) {
+    try {
+
+        // The query is executed (w/o reconnects, since the rows are read
+        // in many steps) when the first page is needed
+
+        if (nullptr == _conn) {
+            _conn = _connect();
+            _conn->begin();
+            _conn->execute(query());
+
+            _response.set_char_set_name(_conn->charSetName());
+            _response.set_has_result(_conn->hasResult());
+            if (_conn->hasResult()) {
+                for (size_t i = 0; i < _conn->numFields(); ++i) {
+                    _conn->exportField(_response.add_fields(), i);
+                }
+            }
+            _pageRequestTime = PerformanceUtils::now();
+        }
+        if (_pages.size() >= maxBufferedPages) {
+            if (PerformanceUtils::now() - _pageRequestTime > 1000 * pageRequestTimeoutSec) {
+                _fail(lock, "the pages weren't requested by the client in " +
+                      to_string(pageRequestTimeoutSec) + " seconds", EXT_STATUS_NONE);
+                return true;
+            }
+            wait = true;
+            return false;
+        }
+
+        // Read the next page
+
+        ProtocolResponseSql page;
+        if (_conn->hasResult()) {
+            database::mysql::Row row;
+            while (page.rows_size() < static_cast<int>(pageSize())) {
+                if (not _conn->next(row)) {
+                    _eof = true;
+                    break;
+                }
+                if ((_maxRows != 0) and (_numRows >= _maxRows)) {
+                    _fail(lock, "WorkerSqlRequest::" + context(__func__) + "  maxRows=" +
+                          to_string(_maxRows) + " limit exceeded", EXT_STATUS_LARGE_RESULT);
+                    return true;
+                }
+                ++_numRows;
+                row.exportRow(page.add_rows());
+            }
+        } else {
+            _eof = true;
+        }
+
+        // The client always gets at least one (possibly empty) page
+
+        if ((page.rows_size() > 0) or (_numPages == 0)) {
+            _pages.push_back(page);
+            ++_numPages;
+        }
+        if (not _eof) return false;
+
+        _conn->commit();
+        _conn.reset();
+
+        LOGS(_log, LOG_LVL_DEBUG, context(__func__)
+             << " char_set_name: " << _response.char_set_name()
+             << " has_result: " << (_response.has_result() ? 1 : 0)
+             << " #fields: " << _response.fields_size()
+             << " #rows: " << _numRows
+             << " #pages: " << _numPages);
+
+        setStatus(lock, STATUS_SUCCEEDED);
+        return true;
+
+    } catch(database::mysql::Error const& ex) {
+        LOGS(_log, LOG_LVL_ERROR, context(__func__) << "  MySQL error: " << ex.what());
+        _fail(lock, ex.what(), EXT_STATUS_MYSQL_ERROR);
+
+    } catch (invalid_argument const& ex) {
+        LOGS(_log, LOG_LVL_ERROR, context(__func__) << "  no such worker: " << worker());
+        _fail(lock, "No such worker in the Configuration, worker: " + worker(), EXT_STATUS_INVALID_PARAM);
+
+    } catch (exception const& ex) {
+        LOGS(_log, LOG_LVL_ERROR, context(__func__) << "  exception: " << ex.what());
+        _fail(lock, "Exception: " + string(ex.what()), EXT_STATUS_NONE);
+    }
     return true;
 }
 
 
+void WorkerSqlRequest::_fail(util::Lock const& lock,
+                             string const& error,
+                             ExtendedCompletionStatus extendedStatus) {
+
+    LOGS(_log, LOG_LVL_ERROR, context(__func__) << "  " << error);
+
+    if ((nullptr != _conn) and _conn->inTransaction()) _conn->rollback();
+    _conn.reset();
+
+    _response.set_error(error);
+    setStatus(lock, STATUS_FAILED, extendedStatus);
+}
+
+
 void WorkerSqlRequest::_setResponse(database::mysql::Connection::Ptr const& conn) {
 
     LOGS(_log, LOG_LVL_DEBUG, context(__func__));
@@ -22,6 +22,8 @@
 #define LSST_QSERV_REPLICA_WORKERSQLREQUEST_H
 
 // System headers
+#include <deque>
+#include <memory>
 #include <string>
 
 // Qserv headers
@@ -52,6 +54,13 @@ namespace replica {
  *   formed query then the corresponding MySQL error will be recorded
  *   and report to a caller in the reponse structure which is set
  *   by method WorkerSqlRequest::setInfo().
+ *
+ * If the page size is specified then the result set is read from the database
+ * (which sends the rows w/o buffering them) only as the pages are requested by
+ * the client. Only a few pages are buffered by the request. The connection to
+ * the database (and the processing thread) is kept by the request until
+ * all rows are read, the request gets cancelled, or the client stops
+ * requesting the pages for a while.
  */
 class WorkerSqlRequest : public WorkerRequest {
 
@@ -95,6 +104,9 @@ public:
      *   restrictions will still apply. The later includes the maximum size of the Google Protobuf
      *   objects, the amount of available memory, etc.
      *
+     * @param pageSize
+     *   (optional) the number of rows in each page of the result set. If the value
+     *   is 0 then the result set is sent to a client in one response.
      *
      * @return
      *   pointer to the created object
@@ -106,7 +118,8 @@ public:
                       std::string const& query,
                       std::string const& user,
                       std::string const& password,
-                      size_t maxRows=0);
+                      size_t maxRows=0,
+                      size_t pageSize=0);
 
     // Default construction and copy semantics are prohibited
 
@@ -122,15 +135,25 @@ public:
     std::string const& user()     const { return _user; }
     std::string const& password() const { return _password; }
 
-    size_t maxRows() const { return _maxRows; }
+    size_t maxRows()  const { return _maxRows; }
+    size_t pageSize() const { return _pageSize; }
+
+    /// @see WorkerRequest::requestClass()
+    RequestClass requestClass() const override { return CLASS_SQL; }
 
     /**
      * Extract request status into the Protobuf response object.
      *
      * @param response
      *   Protobuf response to be initialized
+     *
+     * @param page
+     *   (optional) the page of the result set expected by the client. The previous
+     *   pages are released. The parameter is ignored unless the result set is sent
+     *   in pages.
      */
-    void setInfo(ProtocolResponseSql& response) const;
+    void setInfo(ProtocolResponseSql& response,
+                 uint64_t page=0) const;
 
     /// @see WorkerRequest::execute
     bool execute() override;
@@ -145,10 +168,54 @@ protected:
                      std::string const& query,
                      std::string const& user,
                      std::string const& password,
-                     size_t maxRows);
+                     size_t maxRows,
+                     size_t pageSize);
 
 private:
 
+    /// @return a new connection to the worker's database
+    std::shared_ptr<database::mysql::Connection> _connect();
+
+    /**
+     * Execute the query, and read the whole result set into the response.
+     *
+     * @param lock
+     *   a lock on WorkerRequest::_mtx must be acquired before calling this method
+     */
+    void _executeAll(util::Lock const& lock);
+
+    /**
+     * Begin executing the query if needed, then read the next page of its result set
+     * unless enough pages are already waiting to be requested by the client.
+     *
+     * @param lock
+     *   a lock on WorkerRequest::_mtx must be acquired before calling this method
+     *
+     * @param wait
+     *   is set if the client needs to request the pages before reading more rows
+     *
+     * @return
+     *   'true' if the request has finished (all rows were read, or it failed)
+     */
+    bool _executePage(util::Lock const& lock,
+                      bool& wait);
+
+    /**
+     * Report a failure of the query and release the connection.
+     *
+     * @param lock
+     *   a lock on WorkerRequest::_mtx must be acquired before calling this method
+     *
+     * @param error
+     *   the error to be reported to the client
+     *
+     * @param extendedStatus
+     *   the extended completion status of the request
+     */
+    void _fail(util::Lock const& lock,
+               std::string const& error,
+               ExtendedCompletionStatus extendedStatus);
+
     /**
      * INitialize the Protobuf response object.
      * 
@@ -167,9 +234,32 @@ private:
     std::string const _user;
     std::string const _password;
     size_t      const _maxRows;
+    size_t      const _pageSize;
 
-    /// Cached result to be sent to a client
+    /// Cached result to be sent to a client. If the result set is sent in
+    /// pages then the rows are stored in WorkerSqlRequest::_pages.
     mutable ProtocolResponseSql _response;
+
+    /// The connection whose result set is being read (pages only)
+    std::shared_ptr<database::mysql::Connection> _conn;
+
+    /// The pages (rows only) which haven't been received by the client yet
+    mutable std::deque<ProtocolResponseSql> _pages;
+
+    /// The number of the first page in WorkerSqlRequest::_pages
+    mutable uint64_t _firstPage = 0;
+
+    /// The total number of pages read from the database
+    uint64_t _numPages = 0;
+
+    /// The total number of rows read from the database
+    size_t _numRows = 0;
+
+    /// Set after reading the last row of the result set
+    bool _eof = false;
+
+    /// The last time (milliseconds) the pages were requested by the client
+    mutable uint64_t _pageRequestTime = 0;
 };
 
 /// Class WorkerSqlRequest provides an actual implementation
@@ -344,6 +344,7 @@ CREATE TABLE IF NOT EXISTS `replica` (
 
   PRIMARY KEY (`id`) ,
   KEY         (`worker`,`database`) ,
+  KEY         (`worker`,`verify_time`) ,
   UNIQUE  KEY (`worker`,`database`,`chunk`) ,
 
   CONSTRAINT `replica_fk_1`
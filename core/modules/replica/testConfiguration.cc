@@ -76,6 +76,9 @@ BOOST_AUTO_TEST_CASE(ConfigurationTest) {
         {"xrootd.request_timeout_sec",        "400"},
         {"worker.technology",                 "POSIX"},
         {"worker.num_svc_processing_threads", "4"},
+        {"worker.num_svc_checksum_threads",   "3"},
+        {"worker.num_svc_metadata_threads",   "2"},
+        {"worker.num_svc_sql_threads",        "6"},
         {"worker.num_fs_processing_threads",  "5"},
         {"worker.fs_buf_size_bytes",          "1024"},
         {"worker.svc_port",                   "51000"},
@@ -517,6 +520,9 @@ BOOST_AUTO_TEST_CASE(ConfigurationTest) {
 
         BOOST_CHECK(config->workerTechnology()           == "POSIX");
         BOOST_CHECK(config->workerNumProcessingThreads() == 4);
+        BOOST_CHECK(config->workerNumChecksumThreads()   == 3);
+        BOOST_CHECK(config->workerNumMetadataThreads()   == 2);
+        BOOST_CHECK(config->workerNumSqlThreads()        == 6);
         BOOST_CHECK(config->fsNumProcessingThreads()     == 5);
         BOOST_CHECK(config->workerFsBufferSizeBytes()    == 1024);
 
@@ -578,6 +584,15 @@ BOOST_AUTO_TEST_CASE(ConfigurationTest) {
         config->setWorkerNumProcessingThreads(5);
         BOOST_CHECK(config->workerNumProcessingThreads() == 5);
 
+        config->setWorkerNumChecksumThreads(4);
+        BOOST_CHECK(config->workerNumChecksumThreads() == 4);
+
+        config->setWorkerNumMetadataThreads(3);
+        BOOST_CHECK(config->workerNumMetadataThreads() == 3);
+
+        config->setWorkerNumSqlThreads(7);
+        BOOST_CHECK(config->workerNumSqlThreads() == 7);
+
         config->setFsNumProcessingThreads(6);
         BOOST_CHECK(config->fsNumProcessingThreads() == 6);
 
@@ -67,6 +67,7 @@
 #include "sql/SqlErrorObject.h"
 #include "sql/statement.h"
 #include "util/IterableFormatter.h"
+#include "util/Metrics.h"
 #include "util/StringHash.h"
 
 namespace { // File-scope helpers
@@ -77,6 +78,14 @@ using lsst::qserv::mysql::MySqlConfig;
 using lsst::qserv::rproc::InfileMergerConfig;
 using lsst::qserv::rproc::InfileMergerError;
 using lsst::qserv::util::ErrorCode;
+using lsst::qserv::util::MetricsRegistry;
+
+auto const mergeSeconds = MetricsRegistry::instance().histogram(
+    "qserv_czar_merge_seconds", "Time to load a result message into the result table");
+auto const mergeRows = MetricsRegistry::instance().counter(
+    "qserv_czar_merge_rows_total", "Result rows loaded into result tables");
+auto const mergeBytes = MetricsRegistry::instance().counter(
+    "qserv_czar_merge_bytes_total", "Result bytes loaded into result tables");
 
 /// @return a timestamp id for use in generating temporary result table names.
 std::string getTimeStampId() {
@@ -119,6 +128,9 @@ InfileMerger::InfileMerger(InfileMergerConfig const& c)
     // about every 50,000 rows.
     _sizeCheckRowCount = -100*(_maxResultTableSizeMB);  //  100 = 1,000,000/10,000
     _checkSizeEveryXRows = 10*_maxResultTableSizeMB;
+    // Wide rows can fill the table long before the row based check kicks in,
+    // so also check after every 10% of the maximum size has been received.
+    _checkSizeEveryXBytes = static_cast<std::int64_t>(_maxResultTableSizeMB)*1048576/10;
     LOGS(_log, LOG_LVL_DEBUG, "InfileMerger maxResultTableSizeMB=" << _maxResultTableSizeMB
                               << " sizeCheckRowCount=" << _sizeCheckRowCount
                               << " checkSizeEveryXRows=" << _checkSizeEveryXRows);
@@ -186,6 +198,8 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> response) {
         return true;
     }
     _sizeCheckRowCount += response->result.row_size();
+    _sizeCheckBytes += response->protoHeader.size();
+    _resultBytes += response->protoHeader.size();
 
     bool ret = false;
     // Add columns to rows in virtFile.
@@ -208,13 +222,19 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> response) {
     auto end = std::chrono::system_clock::now();
     auto mergeDur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
     LOGS(_log, LOG_LVL_DEBUG, queryIdJobStr << " mergeDur=" << mergeDur.count());
+    mergeSeconds->record(std::chrono::duration<double>(end - start).count());
+    if (ret) {
+        mergeRows->add(response->result.row_size());
+        mergeBytes->add(response->protoHeader.size());
+    }
     /// Check the size of the result table.
-    if (_sizeCheckRowCount >= _checkSizeEveryXRows) {
+    if (_sizeCheckRowCount >= _checkSizeEveryXRows || _sizeCheckBytes >= _checkSizeEveryXBytes) {
         auto tSize = _getResultTableSizeMB();
         LOGS(_log, LOG_LVL_DEBUG, queryIdJobStr << "checking ResultTableSize " << _mergeTable
                                   << " " << tSize
                                   << " max=" << _maxResultTableSizeMB);
         _sizeCheckRowCount = 0;
+        _sizeCheckBytes = 0;
         if (tSize > _maxResultTableSizeMB) {
             // Try deleting invalid rows if there are any, then check size again
             bool validResult = _invalidJobAttemptMgr.holdMergingForRowDelete("Checking size");
@@ -368,7 +388,11 @@ bool InfileMerger::makeResultsTableForQuery(query::SelectStmt const& stmt, std::
         return false;
     }
     LOGS(_log, LOG_LVL_DEBUG, "InfileMerger extracted schema: " << schema);
+    return makeResultsTable(schema, errMsg);
+}
+
 
+bool InfileMerger::makeResultsTable(sql::Schema schema, std::string& errMsg) {
     _addJobIdColumnToSchema(schema);
 
     std::string createStmt = sql::formCreateTable(_mergeTable, schema);
@@ -383,6 +407,7 @@ bool InfileMerger::makeResultsTableForQuery(query::SelectStmt const& stmt, std::
         _error = InfileMergerError(util::ErrorCode::CREATE_TABLE, "Error creating table:" + _mergeTable);
         _isFinished = true; // Cannot continue.
         LOGS(_log, LOG_LVL_ERROR, _getQueryIdStr() << "InfileMerger sql error: " << _error.getMsg());
+        errMsg = _error.getMsg();
         return false;
     }
 
@@ -30,6 +30,8 @@
 /// (see individual class documentation for more information)
 
 // System headers
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -186,12 +188,17 @@ public:
     bool finalize();
     /// Check if the object has completed all processing.
     bool isFinished() const;
+    /// @return the number of bytes of result data received from workers so far.
+    std::uint64_t getResultBytes() const { return _resultBytes; }
 
     bool prepScrub(int jobId, int attempt);
     bool scrubResults(int jobId, int attempt);
     int makeJobIdAttempt(int jobId, int attemptCount);
 
     bool makeResultsTableForQuery(query::SelectStmt const& stmt, std::string& errMsg);
+    /// Create the merge table for results with the given schema, the job id
+    /// column is added by this method.
+    bool makeResultsTable(sql::Schema schema, std::string& errMsg);
 
 private:
     bool _applyMysql(std::string const& query);
@@ -260,6 +267,9 @@ private:
 
     int _sizeCheckRowCount{0}; ///< Number of rows read since last size check.
     int _checkSizeEveryXRows{1000}; ///< Check the size of the result table after every x number of rows.
+    std::int64_t _sizeCheckBytes{0}; ///< Bytes received since last size check.
+    std::int64_t _checkSizeEveryXBytes{0}; ///< Check the size of the result table after every x bytes.
+    std::atomic<std::uint64_t> _resultBytes{0}; ///< Total bytes of result data received.
     size_t _maxResultTableSizeMB{5000}; ///< Max result table size.
 };
 
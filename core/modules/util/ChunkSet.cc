@@ -0,0 +1,551 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/ChunkSet.h"
+
+// System headers
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+char const magic[4] = {'Q', 'C', 'S', '1'};
+
+std::size_t const numWords = 1024;     // 65536 bits per bitmap block
+
+std::uint16_t const kindArray  = 0;
+std::uint16_t const kindBitmap = 1;
+
+inline std::uint16_t highBits(int chunk) { return static_cast<std::uint32_t>(chunk) >> 16; }
+inline std::uint16_t lowBits(int chunk)  { return static_cast<std::uint32_t>(chunk) & 0xFFFF; }
+inline int makeChunk(std::uint16_t key, std::uint32_t low) {
+    return static_cast<int>((static_cast<std::uint32_t>(key) << 16) | low);
+}
+
+/// Read a POD value from a buffer, advancing the offset
+template <typename T>
+void readValue(char const* data, std::size_t size, std::size_t& offset, T& value) {
+    if (offset + sizeof(T) > size) {
+        throw std::invalid_argument("ChunkSet::fromBuffer  unexpected end of the buffer");
+    }
+    std::memcpy(&value, data + offset, sizeof(T));
+    offset += sizeof(T);
+}
+
+template <typename T>
+void writeValue(std::ostream& os, T const& value) {
+    os.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+/// Closes a file descriptor and unmaps memory when going out of scope
+struct MappedFile {
+    int fd = -1;
+    void* addr = MAP_FAILED;
+    std::size_t size = 0;
+    ~MappedFile() {
+        if (addr != MAP_FAILED) ::munmap(addr, size);
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+} // namespace
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/////////////////////////////////////////
+//          ChunkSet::Block            //
+/////////////////////////////////////////
+
+bool ChunkSet::Block::contains(std::uint16_t low) const {
+    if (isBitmap()) return bitmap[low >> 6] & (std::uint64_t(1) << (low & 63));
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+
+bool ChunkSet::Block::insert(std::uint16_t low) {
+    if (isBitmap()) {
+        std::uint64_t& word = bitmap[low >> 6];
+        std::uint64_t const mask = std::uint64_t(1) << (low & 63);
+        if (word & mask) return false;
+        word |= mask;
+        ++cardinality;
+        return true;
+    }
+    auto itr = std::lower_bound(array.begin(), array.end(), low);
+    if (itr != array.end() and *itr == low) return false;
+    array.insert(itr, low);
+    ++cardinality;
+    optimize();
+    return true;
+}
+
+
+bool ChunkSet::Block::erase(std::uint16_t low) {
+    if (isBitmap()) {
+        std::uint64_t& word = bitmap[low >> 6];
+        std::uint64_t const mask = std::uint64_t(1) << (low & 63);
+        if (not (word & mask)) return false;
+        word &= ~mask;
+        --cardinality;
+        optimize();
+        return true;
+    }
+    auto itr = std::lower_bound(array.begin(), array.end(), low);
+    if (itr == array.end() or *itr != low) return false;
+    array.erase(itr);
+    --cardinality;
+    return true;
+}
+
+
+void ChunkSet::Block::optimize() {
+    if (isBitmap()) {
+        if (cardinality > maxArraySize) return;
+        std::vector<std::uint16_t> values;
+        values.reserve(cardinality);
+        for (std::size_t i = 0; i < numWords; ++i) {
+            for (std::uint64_t word = bitmap[i]; word != 0; word &= word - 1) {
+                values.push_back(static_cast<std::uint16_t>((i << 6) + __builtin_ctzll(word)));
+            }
+        }
+        array.swap(values);
+        std::vector<std::uint64_t>().swap(bitmap);
+    } else {
+        if (cardinality <= maxArraySize) return;
+        bitmap = words();
+        std::vector<std::uint16_t>().swap(array);
+    }
+}
+
+
+std::vector<std::uint64_t> ChunkSet::Block::words() const {
+    if (isBitmap()) return bitmap;
+    std::vector<std::uint64_t> result(numWords, 0);
+    for (std::uint16_t low: array) {
+        result[low >> 6] |= std::uint64_t(1) << (low & 63);
+    }
+    return result;
+}
+
+
+void ChunkSet::Block::assignWords(std::vector<std::uint64_t>&& w) {
+    std::uint32_t num = 0;
+    for (std::uint64_t word: w) num += __builtin_popcountll(word);
+    cardinality = num;
+    array.clear();
+    bitmap = std::move(w);
+    optimize();
+}
+
+
+/////////////////////////////////////////
+//     ChunkSet::const_iterator        //
+/////////////////////////////////////////
+
+int ChunkSet::const_iterator::operator*() const {
+    Block const& block = _set->_blocks[_block];
+    if (block.isBitmap()) return makeChunk(block.key, _pos);
+    return makeChunk(block.key, block.array[_pos]);
+}
+
+
+ChunkSet::const_iterator& ChunkSet::const_iterator::operator++() {
+    Block const& block = _set->_blocks[_block];
+    if (block.isBitmap()) {
+        _pos = ChunkSet::_nextBit(block, _pos + 1);
+        if (_pos < 65536) return *this;
+    } else {
+        if (++_pos < block.array.size()) return *this;
+    }
+    // Move to the first element of the next block
+    *this = const_iterator(_set, _block + 1, 0);
+    if (_block < _set->_blocks.size()) {
+        Block const& next = _set->_blocks[_block];
+        if (next.isBitmap()) _pos = ChunkSet::_nextBit(next, 0);
+    }
+    return *this;
+}
+
+
+/////////////////////////////////////////
+//              ChunkSet               //
+/////////////////////////////////////////
+
+ChunkSet::ChunkSet(std::initializer_list<int> chunks) {
+    for (int chunk: chunks) insert(chunk);
+}
+
+
+std::size_t ChunkSet::_findBlock(std::uint16_t key) const {
+    auto itr = std::lower_bound(
+        _blocks.begin(), _blocks.end(), key,
+        [](Block const& block, std::uint16_t k) { return block.key < k; });
+    if (itr == _blocks.end() or itr->key != key) return _blocks.size();
+    return itr - _blocks.begin();
+}
+
+
+std::uint32_t ChunkSet::_nextBit(Block const& block, std::uint32_t bit) {
+    if (bit >= 65536) return 65536;
+    std::size_t i = bit >> 6;
+    std::uint64_t word = block.bitmap[i] & (~std::uint64_t(0) << (bit & 63));
+    while (word == 0) {
+        if (++i == numWords) return 65536;
+        word = block.bitmap[i];
+    }
+    return (i << 6) + __builtin_ctzll(word);
+}
+
+
+bool ChunkSet::insert(int chunk) {
+    std::uint16_t const key = highBits(chunk);
+    auto itr = std::lower_bound(
+        _blocks.begin(), _blocks.end(), key,
+        [](Block const& block, std::uint16_t k) { return block.key < k; });
+    if (itr == _blocks.end() or itr->key != key) {
+        itr = _blocks.insert(itr, Block());
+        itr->key = key;
+    }
+    return itr->insert(lowBits(chunk));
+}
+
+
+std::size_t ChunkSet::erase(int chunk) {
+    std::size_t const idx = _findBlock(highBits(chunk));
+    if (idx == _blocks.size()) return 0;
+    if (not _blocks[idx].erase(lowBits(chunk))) return 0;
+    if (_blocks[idx].cardinality == 0) _blocks.erase(_blocks.begin() + idx);
+    return 1;
+}
+
+
+bool ChunkSet::contains(int chunk) const {
+    std::size_t const idx = _findBlock(highBits(chunk));
+    if (idx == _blocks.size()) return false;
+    return _blocks[idx].contains(lowBits(chunk));
+}
+
+
+ChunkSet::const_iterator ChunkSet::find(int chunk) const {
+    std::size_t const idx = _findBlock(highBits(chunk));
+    if (idx == _blocks.size()) return end();
+    Block const& block = _blocks[idx];
+    std::uint16_t const low = lowBits(chunk);
+    if (block.isBitmap()) {
+        if (not block.contains(low)) return end();
+        return const_iterator(this, idx, low);
+    }
+    auto itr = std::lower_bound(block.array.begin(), block.array.end(), low);
+    if (itr == block.array.end() or *itr != low) return end();
+    return const_iterator(this, idx, itr - block.array.begin());
+}
+
+
+ChunkSet::const_iterator ChunkSet::begin() const {
+    if (_blocks.empty()) return end();
+    Block const& block = _blocks.front();
+    return const_iterator(this, 0, block.isBitmap() ? _nextBit(block, 0) : 0);
+}
+
+
+std::size_t ChunkSet::size() const {
+    std::size_t num = 0;
+    for (auto&& block: _blocks) num += block.cardinality;
+    return num;
+}
+
+
+std::size_t ChunkSet::memoryUsage() const {
+    std::size_t num = sizeof(*this) + _blocks.capacity() * sizeof(Block);
+    for (auto&& block: _blocks) {
+        num += block.array.capacity() * sizeof(std::uint16_t)
+            +  block.bitmap.capacity() * sizeof(std::uint64_t);
+    }
+    return num;
+}
+
+
+std::vector<int> ChunkSet::toVector() const {
+    std::vector<int> result;
+    result.reserve(size());
+    std::copy(begin(), end(), std::back_inserter(result));
+    return result;
+}
+
+
+ChunkSet& ChunkSet::operator|=(ChunkSet const& rhs) {
+    std::vector<Block> result;
+    result.reserve(_blocks.size() + rhs._blocks.size());
+    auto l = _blocks.begin(), lEnd = _blocks.end();
+    auto r = rhs._blocks.begin(), rEnd = rhs._blocks.end();
+    while (l != lEnd or r != rEnd) {
+        if (r == rEnd or (l != lEnd and l->key < r->key)) {
+            result.push_back(std::move(*l++));
+        } else if (l == lEnd or r->key < l->key) {
+            result.push_back(*r++);
+        } else {
+            Block block;
+            block.key = l->key;
+            if (not l->isBitmap() and not r->isBitmap()) {
+                std::set_union(l->array.begin(), l->array.end(),
+                               r->array.begin(), r->array.end(),
+                               std::back_inserter(block.array));
+                block.cardinality = block.array.size();
+                block.optimize();
+            } else {
+                std::vector<std::uint64_t> w = l->words();
+                if (r->isBitmap()) {
+                    for (std::size_t i = 0; i < numWords; ++i) w[i] |= r->bitmap[i];
+                } else {
+                    for (std::uint16_t low: r->array) w[low >> 6] |= std::uint64_t(1) << (low & 63);
+                }
+                block.assignWords(std::move(w));
+            }
+            result.push_back(std::move(block));
+            ++l;
+            ++r;
+        }
+    }
+    _blocks.swap(result);
+    return *this;
+}
+
+
+ChunkSet& ChunkSet::operator&=(ChunkSet const& rhs) {
+    std::vector<Block> result;
+    auto l = _blocks.begin(), lEnd = _blocks.end();
+    auto r = rhs._blocks.begin(), rEnd = rhs._blocks.end();
+    while (l != lEnd and r != rEnd) {
+        if (l->key < r->key) {
+            ++l;
+        } else if (r->key < l->key) {
+            ++r;
+        } else {
+            Block block;
+            block.key = l->key;
+            if (not l->isBitmap() or not r->isBitmap()) {
+                // At least one side is sparse: probe its elements in the other side
+                Block const& sparse = l->isBitmap() ? *r : *l;
+                Block const& other  = l->isBitmap() ? *l : *r;
+                for (std::uint16_t low: sparse.array) {
+                    if (other.contains(low)) block.array.push_back(low);
+                }
+                block.cardinality = block.array.size();
+            } else {
+                std::vector<std::uint64_t> w(numWords);
+                for (std::size_t i = 0; i < numWords; ++i) w[i] = l->bitmap[i] & r->bitmap[i];
+                block.assignWords(std::move(w));
+            }
+            if (block.cardinality != 0) result.push_back(std::move(block));
+            ++l;
+            ++r;
+        }
+    }
+    _blocks.swap(result);
+    return *this;
+}
+
+
+ChunkSet& ChunkSet::operator-=(ChunkSet const& rhs) {
+    std::vector<Block> result;
+    result.reserve(_blocks.size());
+    auto r = rhs._blocks.begin(), rEnd = rhs._blocks.end();
+    for (auto&& block: _blocks) {
+        while (r != rEnd and r->key < block.key) ++r;
+        if (r == rEnd or r->key != block.key) {
+            result.push_back(std::move(block));
+            continue;
+        }
+        if (not block.isBitmap()) {
+            std::vector<std::uint16_t> values;
+            for (std::uint16_t low: block.array) {
+                if (not r->contains(low)) values.push_back(low);
+            }
+            block.array.swap(values);
+            block.cardinality = block.array.size();
+        } else {
+            std::vector<std::uint64_t> w;
+            w.swap(block.bitmap);
+            if (r->isBitmap()) {
+                for (std::size_t i = 0; i < numWords; ++i) w[i] &= ~r->bitmap[i];
+            } else {
+                for (std::uint16_t low: r->array) w[low >> 6] &= ~(std::uint64_t(1) << (low & 63));
+            }
+            block.assignWords(std::move(w));
+        }
+        if (block.cardinality != 0) result.push_back(std::move(block));
+    }
+    _blocks.swap(result);
+    return *this;
+}
+
+
+bool ChunkSet::operator==(ChunkSet const& rhs) const {
+    if (_blocks.size() != rhs._blocks.size()) return false;
+    for (std::size_t i = 0; i < _blocks.size(); ++i) {
+        Block const& l = _blocks[i];
+        Block const& r = rhs._blocks[i];
+        // Both blocks are kept in the canonical form defined by the cardinality
+        if (l.key != r.key or l.cardinality != r.cardinality or
+            l.array != r.array or l.bitmap != r.bitmap) return false;
+    }
+    return true;
+}
+
+
+void ChunkSet::write(std::ostream& os) const {
+    os.write(magic, sizeof(magic));
+    writeValue(os, static_cast<std::uint32_t>(_blocks.size()));
+    for (auto&& block: _blocks) {
+        writeValue(os, block.key);
+        writeValue(os, block.isBitmap() ? kindBitmap : kindArray);
+        writeValue(os, block.cardinality);
+    }
+    for (auto&& block: _blocks) {
+        if (block.isBitmap()) {
+            os.write(reinterpret_cast<char const*>(block.bitmap.data()),
+                     block.bitmap.size() * sizeof(std::uint64_t));
+        } else {
+            os.write(reinterpret_cast<char const*>(block.array.data()),
+                     block.array.size() * sizeof(std::uint16_t));
+        }
+    }
+}
+
+
+void ChunkSet::save(std::string const& fileName) const {
+    std::ofstream os(fileName, std::ios::binary | std::ios::trunc);
+    if (not os.good()) {
+        throw std::runtime_error("ChunkSet::save  failed to open file: " + fileName);
+    }
+    write(os);
+    os.flush();
+    if (not os.good()) {
+        throw std::runtime_error("ChunkSet::save  failed to write file: " + fileName);
+    }
+}
+
+
+ChunkSet ChunkSet::fromBuffer(char const* data, std::size_t size) {
+    if (size < sizeof(magic) or std::memcmp(data, magic, sizeof(magic)) != 0) {
+        throw std::invalid_argument("ChunkSet::fromBuffer  not a binary chunk set");
+    }
+    std::size_t offset = sizeof(magic);
+    std::uint32_t numBlocks;
+    readValue(data, size, offset, numBlocks);
+
+    ChunkSet result;
+    result._blocks.resize(numBlocks);
+    std::vector<std::uint16_t> kinds(numBlocks);
+    for (std::uint32_t i = 0; i < numBlocks; ++i) {
+        Block& block = result._blocks[i];
+        readValue(data, size, offset, block.key);
+        readValue(data, size, offset, kinds[i]);
+        readValue(data, size, offset, block.cardinality);
+        if ((i > 0 and block.key <= result._blocks[i-1].key) or
+            block.cardinality == 0 or block.cardinality > 65536 or
+            (kinds[i] != kindArray and kinds[i] != kindBitmap)) {
+            throw std::invalid_argument("ChunkSet::fromBuffer  corrupt block descriptor");
+        }
+    }
+    for (std::uint32_t i = 0; i < numBlocks; ++i) {
+        Block& block = result._blocks[i];
+        std::size_t const bytes = kinds[i] == kindBitmap ?
+            numWords * sizeof(std::uint64_t) : block.cardinality * sizeof(std::uint16_t);
+        if (offset + bytes > size) {
+            throw std::invalid_argument("ChunkSet::fromBuffer  unexpected end of the buffer");
+        }
+        if (kinds[i] == kindBitmap) {
+            block.bitmap.resize(numWords);
+            std::memcpy(block.bitmap.data(), data + offset, bytes);
+        } else {
+            block.array.resize(block.cardinality);
+            std::memcpy(block.array.data(), data + offset, bytes);
+        }
+        offset += bytes;
+        // Tolerate files written with a different form selection threshold
+        block.optimize();
+    }
+    return result;
+}
+
+
+ChunkSet ChunkSet::load(std::string const& fileName) {
+    MappedFile file;
+    file.fd = ::open(fileName.c_str(), O_RDONLY);
+    if (file.fd < 0) {
+        throw std::runtime_error("ChunkSet::load  failed to open file: " + fileName);
+    }
+    struct stat st;
+    if (::fstat(file.fd, &st) != 0) {
+        throw std::runtime_error("ChunkSet::load  failed to stat file: " + fileName);
+    }
+    file.size = st.st_size;
+    if (file.size == 0) {
+        throw std::invalid_argument("ChunkSet::load  empty file: " + fileName);
+    }
+    file.addr = ::mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+    if (file.addr == MAP_FAILED) {
+        throw std::runtime_error("ChunkSet::load  failed to map file: " + fileName);
+    }
+    ::madvise(file.addr, file.size, MADV_SEQUENTIAL);
+    return fromBuffer(static_cast<char const*>(file.addr), file.size);
+}
+
+
+bool ChunkSet::isBinaryFile(std::string const& fileName) {
+    std::ifstream is(fileName, std::ios::binary);
+    char buf[sizeof(magic)];
+    if (not is.read(buf, sizeof(buf))) return false;
+    return std::memcmp(buf, magic, sizeof(magic)) == 0;
+}
+
+
+ChunkSet operator|(ChunkSet lhs, ChunkSet const& rhs) { return lhs |= rhs; }
+ChunkSet operator&(ChunkSet lhs, ChunkSet const& rhs) { return lhs &= rhs; }
+ChunkSet operator-(ChunkSet lhs, ChunkSet const& rhs) { return lhs -= rhs; }
+
+
+std::ostream& operator<<(std::ostream& os, ChunkSet const& chunks) {
+    os << "[";
+    bool first = true;
+    for (int chunk: chunks) {
+        if (not first) os << ", ";
+        os << chunk;
+        first = false;
+    }
+    os << "]";
+    return os;
+}
+
+}}} // namespace lsst::qserv::util
@@ -0,0 +1,245 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_CHUNKSET_H
+#define LSST_QSERV_UTIL_CHUNKSET_H
+
+/// ChunkSet.h declares:
+///
+/// class ChunkSet
+/// (see individual class documentation for more information)
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iosfwd>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// This header declarations
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/**
+ * ChunkSet is a compact set of chunk numbers modelled after "roaring"
+ * bitmaps. The 32-bit space of chunk numbers is split into blocks of
+ * 65536 values keyed by the upper 16 bits of a number. Each non-empty block
+ * is stored either as a sorted array of the lower 16 bits (sparse blocks of
+ * up to 4096 elements) or as a 65536-bit bitmap (dense blocks). This gives
+ * O(log N) membership tests, fast block-wise union, intersection and
+ * difference, and a memory footprint of at most 8 KB per 65536 chunks.
+ *
+ * The class mimics the parts of the std::set<int> interface which are used
+ * throughout Qserv (insert, erase, count, find, iteration), so it can be
+ * used as a drop-in replacement for chunk lists.
+ *
+ * Iteration goes over elements in the increasing order of their unsigned
+ * 32-bit representation. Chunk numbers are non-negative in Qserv, hence
+ * for all practical purposes this is the natural order of chunks.
+ *
+ * The set also has a compact binary representation which can be written
+ * to a file with ChunkSet::save() and loaded back via a read-only memory
+ * mapping of the file with ChunkSet::load(). The format (all integers are
+ * in the host byte order):
+ * @code
+ *   char[4]  magic "QCS1"
+ *   uint32   number of blocks
+ *   repeated for each block:
+ *     uint16   key (upper 16 bits of the chunk numbers)
+ *     uint16   kind (0: sorted array, 1: bitmap)
+ *     uint32   cardinality
+ *   repeated for each block:
+ *     uint16[cardinality] for arrays, or uint64[1024] for bitmaps
+ * @endcode
+ *
+ * THREAD SAFETY NOTE: the class is not thread-safe. Const methods may be
+ * called concurrently.
+ */
+class ChunkSet {
+
+public:
+
+    /// Forward iterator over the chunk numbers of a set
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef int value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef int const* pointer;
+        typedef int reference;
+
+        const_iterator() = default;
+
+        int operator*() const;
+        const_iterator& operator++();
+        const_iterator operator++(int) { const_iterator tmp(*this); ++(*this); return tmp; }
+
+        bool operator==(const_iterator const& rhs) const {
+            return _set == rhs._set and _block == rhs._block and _pos == rhs._pos;
+        }
+        bool operator!=(const_iterator const& rhs) const { return not operator==(rhs); }
+
+    private:
+        friend class ChunkSet;
+        const_iterator(ChunkSet const* set, std::size_t block, std::uint32_t pos)
+            :   _set(set), _block(block), _pos(pos) {}
+
+        ChunkSet const* _set = nullptr;
+        std::size_t     _block = 0; ///< index of the current block
+        std::uint32_t   _pos = 0;   ///< array index, or bit number in a bitmap
+    };
+    typedef const_iterator iterator;
+
+    /// The maximum number of elements stored in a block in the array form
+    static std::size_t const maxArraySize = 4096;
+
+    ChunkSet() = default;
+    ChunkSet(ChunkSet const&) = default;
+    ChunkSet(ChunkSet&&) = default;
+    ChunkSet& operator=(ChunkSet const&) = default;
+    ChunkSet& operator=(ChunkSet&&) = default;
+    ~ChunkSet() = default;
+
+    ChunkSet(std::initializer_list<int> chunks);
+
+    template <typename Iterator>
+    ChunkSet(Iterator first, Iterator last) {
+        for (; first != last; ++first) insert(*first);
+    }
+
+    /// @return 'true' if the chunk was not in the set before the operation
+    bool insert(int chunk);
+
+    /// @return the number of removed elements (0 or 1)
+    std::size_t erase(int chunk);
+
+    /// @return 'true' if the chunk is in the set
+    bool contains(int chunk) const;
+
+    /// @return the number of occurences of the chunk in the set (0 or 1)
+    std::size_t count(int chunk) const { return contains(chunk) ? 1 : 0; }
+
+    /// @return an iterator pointing to the chunk, or end() if none
+    const_iterator find(int chunk) const;
+
+    const_iterator begin() const;
+    const_iterator end() const { return const_iterator(this, _blocks.size(), 0); }
+
+    /// @return the total number of elements in the set
+    std::size_t size() const;
+
+    bool empty() const { return _blocks.empty(); }
+
+    void clear() { _blocks.clear(); }
+
+    /// @return the number of bytes used to store elements of the set
+    std::size_t memoryUsage() const;
+
+    /// @return elements of the set in the iteration order
+    std::vector<int> toVector() const;
+
+    // Set algebra
+
+    ChunkSet& operator|=(ChunkSet const& rhs);
+    ChunkSet& operator&=(ChunkSet const& rhs);
+    ChunkSet& operator-=(ChunkSet const& rhs);
+
+    bool operator==(ChunkSet const& rhs) const;
+    bool operator!=(ChunkSet const& rhs) const { return not operator==(rhs); }
+
+    // Binary serialization
+
+    /// Write the binary representation of the set into a stream
+    void write(std::ostream& os) const;
+
+    /**
+     * Write the binary representation of the set into a file
+     *
+     * @throws std::runtime_error if the file couldn't be written
+     */
+    void save(std::string const& fileName) const;
+
+    /**
+     * Decode a set from an in-memory binary representation
+     *
+     * @throws std::invalid_argument if the buffer isn't a valid representation
+     */
+    static ChunkSet fromBuffer(char const* data, std::size_t size);
+
+    /**
+     * Load a set from a binary file. The file is mapped into memory
+     * rather than read through a stream.
+     *
+     * @throws std::runtime_error if the file couldn't be open or mapped
+     * @throws std::invalid_argument if the file isn't a valid representation
+     */
+    static ChunkSet load(std::string const& fileName);
+
+    /// @return 'true' if the file starts with the magic of the binary format
+    static bool isBinaryFile(std::string const& fileName);
+
+private:
+
+    /// A block of up to 65536 elements sharing the same upper 16 bits
+    struct Block {
+        std::uint16_t key = 0;
+        std::uint32_t cardinality = 0;
+        std::vector<std::uint16_t> array;   ///< sorted values (sparse blocks)
+        std::vector<std::uint64_t> bitmap;  ///< 1024 words (dense blocks)
+
+        bool isBitmap() const { return not bitmap.empty(); }
+        bool contains(std::uint16_t low) const;
+        bool insert(std::uint16_t low);
+        bool erase(std::uint16_t low);
+
+        /// Switch between the array and the bitmap forms based on the cardinality
+        void optimize();
+
+        /// @return a copy of the block's elements in the bitmap form
+        std::vector<std::uint64_t> words() const;
+
+        /// Set the block content from a bitmap, choosing the best form
+        void assignWords(std::vector<std::uint64_t>&& w);
+    };
+
+    /// @return the index of the block with the key, or _blocks.size()
+    std::size_t _findBlock(std::uint16_t key) const;
+
+    /// @return the first position of a bitmap block at or after the bit
+    static std::uint32_t _nextBit(Block const& block, std::uint32_t bit);
+
+    std::vector<Block> _blocks;     ///< sorted by key
+};
+
+ChunkSet operator|(ChunkSet lhs, ChunkSet const& rhs);
+ChunkSet operator&(ChunkSet lhs, ChunkSet const& rhs);
+ChunkSet operator-(ChunkSet lhs, ChunkSet const& rhs);
+
+std::ostream& operator<<(std::ostream& os, ChunkSet const& chunks);
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_CHUNKSET_H
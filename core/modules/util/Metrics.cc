@@ -0,0 +1,233 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/Metrics.h"
+
+// System headers
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::atomic<unsigned int> nextShard{0};
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+unsigned int metrics::threadShard() {
+    thread_local unsigned int const shard = nextShard.fetch_add(1) % SHARDS;
+    return shard;
+}
+
+std::int64_t MetricCounter::get() const {
+    std::int64_t total = 0;
+    for (auto const& cell : _cells) {
+        total += cell.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void MetricGauge::set(std::int64_t value) {
+    // Cells sum up to the value, only the cell of this thread keeps a non-zero value.
+    unsigned int const shard = metrics::threadShard();
+    for (unsigned int i = 0; i < metrics::SHARDS; ++i) {
+        if (i != shard) _cells[i].value.store(0, std::memory_order_relaxed);
+    }
+    _cells[shard].value.store(value, std::memory_order_relaxed);
+}
+
+std::int64_t MetricGauge::get() const {
+    std::int64_t total = 0;
+    for (auto const& cell : _cells) {
+        total += cell.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+unsigned int MetricHistogram::bucketIndex(std::uint64_t value) {
+    if (value < SUB_BUCKETS) return value;
+    unsigned int const exponent = 63 - __builtin_clzll(value);
+    unsigned int const shift = exponent - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + ((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+std::uint64_t MetricHistogram::bucketLowerBound(unsigned int index) {
+    if (index < SUB_BUCKETS) return index;
+    unsigned int const shift = index / SUB_BUCKETS - 1;
+    return static_cast<std::uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+}
+
+void MetricHistogram::record(double value) {
+    std::uint64_t scaled = 0;
+    if (value > 0) {
+        double const v = std::round(value * _scale);
+        scaled = v >= 9.2e18 ? static_cast<std::uint64_t>(9.2e18) : static_cast<std::uint64_t>(v);
+    }
+    auto& shard = _shards[metrics::threadShard()];
+    shard.buckets[bucketIndex(scaled)].fetch_add(1, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(scaled, std::memory_order_relaxed);
+    std::uint64_t max = _max.load(std::memory_order_relaxed);
+    while (scaled > max && not _max.compare_exchange_weak(max, scaled, std::memory_order_relaxed)) {}
+}
+
+MetricHistogram::Summary MetricHistogram::getSummary() const {
+    Summary summary;
+    summary.scale = _scale;
+    std::uint64_t sum = 0;
+    for (auto const& shard : _shards) {
+        for (unsigned int i = 0; i < BUCKETS; ++i) {
+            summary.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+        summary.count += shard.count.load(std::memory_order_relaxed);
+        sum += shard.sum.load(std::memory_order_relaxed);
+    }
+    summary.sum = sum / _scale;
+    summary.max = _max.load(std::memory_order_relaxed) / _scale;
+    return summary;
+}
+
+double MetricHistogram::Summary::quantile(double q) const {
+    if (count == 0) return 0;
+    // Buckets and count are read at slightly different times, rely on buckets only.
+    std::uint64_t total = 0;
+    for (auto n : buckets) total += n;
+    std::uint64_t const rank = static_cast<std::uint64_t>(std::ceil(q * total));
+    std::uint64_t seen = 0;
+    for (unsigned int i = 0; i < BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= rank && buckets[i] > 0) {
+            // Middle of the bucket, but never above the largest value seen
+            double const lower = bucketLowerBound(i);
+            double const upper = (i + 1 < BUCKETS) ? bucketLowerBound(i + 1) : lower;
+            double const value = (lower + upper - 1) / 2 / scale;
+            return (max > 0 && value > max) ? max : value;
+        }
+    }
+    return max;
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricCounter::Ptr MetricsRegistry::counter(std::string const& name, std::string const& help) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto& entry = _entries[name];
+    if (entry.counter == nullptr) {
+        if (entry.gauge || entry.histogram || entry.func) {
+            throw std::logic_error("Metric " + name + " is not a counter");
+        }
+        entry.help = help;
+        entry.counter = std::make_shared<MetricCounter>();
+    }
+    return entry.counter;
+}
+
+MetricGauge::Ptr MetricsRegistry::gauge(std::string const& name, std::string const& help) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto& entry = _entries[name];
+    if (entry.gauge == nullptr) {
+        if (entry.counter || entry.histogram || entry.func) {
+            throw std::logic_error("Metric " + name + " is not a gauge");
+        }
+        entry.help = help;
+        entry.gauge = std::make_shared<MetricGauge>();
+    }
+    return entry.gauge;
+}
+
+MetricHistogram::Ptr MetricsRegistry::histogram(std::string const& name, std::string const& help,
+                                                double scale) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto& entry = _entries[name];
+    if (entry.histogram == nullptr) {
+        if (entry.counter || entry.gauge || entry.func) {
+            throw std::logic_error("Metric " + name + " is not a histogram");
+        }
+        entry.help = help;
+        entry.histogram = std::make_shared<MetricHistogram>(scale);
+    }
+    return entry.histogram;
+}
+
+void MetricsRegistry::gaugeFunction(std::string const& name, std::string const& help,
+                                    std::function<double()> const& func) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto& entry = _entries[name];
+    if (entry.counter || entry.gauge || entry.histogram) {
+        throw std::logic_error("Metric " + name + " is not a gauge function");
+    }
+    entry.help = help;
+    entry.func = func;
+}
+
+void MetricsRegistry::removeGaugeFunction(std::string const& name) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto itr = _entries.find(name);
+    if (itr != _entries.end() && itr->second.func) {
+        _entries.erase(itr);
+    }
+}
+
+void MetricsRegistry::write(std::ostream& os) const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    for (auto const& item : _entries) {
+        auto const& name = item.first;
+        auto const& entry = item.second;
+        os << "# HELP " << name << " " << entry.help << "\n";
+        if (entry.counter) {
+            os << "# TYPE " << name << " counter\n"
+               << name << " " << entry.counter->get() << "\n";
+        } else if (entry.gauge) {
+            os << "# TYPE " << name << " gauge\n"
+               << name << " " << entry.gauge->get() << "\n";
+        } else if (entry.func) {
+            os << "# TYPE " << name << " gauge\n"
+               << name << " " << entry.func() << "\n";
+        } else if (entry.histogram) {
+            auto const summary = entry.histogram->getSummary();
+            os << "# TYPE " << name << " summary\n";
+            for (double q : {0.5, 0.9, 0.99}) {
+                os << name << "{quantile=\"" << q << "\"} " << summary.quantile(q) << "\n";
+            }
+            os << name << "_sum " << summary.sum << "\n"
+               << name << "_count " << summary.count << "\n"
+               << name << "_max " << summary.max << "\n";
+        }
+    }
+}
+
+std::string MetricsRegistry::format() const {
+    std::ostringstream os;
+    write(os);
+    return os.str();
+}
+
+}}} // namespace lsst::qserv::util
@@ -0,0 +1,209 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_METRICS_H
+#define LSST_QSERV_UTIL_METRICS_H
+
+// System headers
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/// Metrics are updated on hot paths without locks: each metric keeps
+/// a set of cells and every thread updates the cell of its own shard,
+/// cells are only summed up when the metric is read.
+namespace metrics {
+
+/// Number of cells of a metric, threads are assigned to shards round-robin.
+constexpr unsigned int SHARDS = 16;
+
+/// @return the shard of the calling thread
+unsigned int threadShard();
+
+/// Atomic value on its own cache line.
+struct alignas(64) Cell {
+    std::atomic<std::int64_t> value{0};
+};
+
+} // namespace metrics
+
+/// A value which only grows, e.g. number of merged rows.
+class MetricCounter {
+public:
+    typedef std::shared_ptr<MetricCounter> Ptr;
+
+    MetricCounter() = default;
+    MetricCounter(MetricCounter const&) = delete;
+    MetricCounter& operator=(MetricCounter const&) = delete;
+
+    void add(std::int64_t n=1) {
+        _cells[metrics::threadShard()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    std::int64_t get() const;
+
+private:
+    std::array<metrics::Cell, metrics::SHARDS> _cells;
+};
+
+/// A value which goes up and down, e.g. number of queued tasks.
+class MetricGauge {
+public:
+    typedef std::shared_ptr<MetricGauge> Ptr;
+
+    MetricGauge() = default;
+    MetricGauge(MetricGauge const&) = delete;
+    MetricGauge& operator=(MetricGauge const&) = delete;
+
+    /// Set the value, increments made by other threads at the same time may be lost.
+    void set(std::int64_t value);
+
+    void add(std::int64_t n) {
+        _cells[metrics::threadShard()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    std::int64_t get() const;
+
+private:
+    std::array<metrics::Cell, metrics::SHARDS> _cells;
+};
+
+/**
+ *  Distribution of values, e.g. latency of an operation.
+ *
+ *  Values are kept in log-linear buckets as in HDR histograms: each power
+ *  of 2 is split into SUB_BUCKETS linear buckets, so that the relative error
+ *  of a reported quantile is bounded (~6%) over the whole range of int64.
+ *  Recorded values are multiplied by the scale of the histogram and rounded,
+ *  e.g. a histogram of seconds with scale 1e6 has microsecond resolution.
+ */
+class MetricHistogram {
+public:
+    typedef std::shared_ptr<MetricHistogram> Ptr;
+
+    static constexpr unsigned int SUB_BUCKET_BITS = 3;
+    static constexpr unsigned int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr unsigned int BUCKETS = SUB_BUCKETS * (65 - SUB_BUCKET_BITS);
+
+    /// Snapshot of the histogram
+    struct Summary {
+        std::uint64_t count = 0;
+        double sum = 0;
+        double max = 0;
+        double quantile(double q) const;
+        std::array<std::uint64_t, BUCKETS> buckets{};
+        double scale = 1;
+    };
+
+    /// @param scale: multiplier giving the resolution of recorded values
+    explicit MetricHistogram(double scale=1e6) : _scale(scale) {}
+
+    MetricHistogram(MetricHistogram const&) = delete;
+    MetricHistogram& operator=(MetricHistogram const&) = delete;
+
+    /// Record a value, negative values are recorded as 0.
+    void record(double value);
+
+    Summary getSummary() const;
+
+    /// @return bucket of a scaled value
+    static unsigned int bucketIndex(std::uint64_t value);
+
+    /// @return the smallest scaled value of the bucket
+    static std::uint64_t bucketLowerBound(unsigned int index);
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<std::uint64_t>, BUCKETS> buckets{};
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> sum{0};
+    };
+
+    double const _scale;
+    std::array<Shard, metrics::SHARDS> _shards;
+    std::atomic<std::uint64_t> _max{0};
+};
+
+/**
+ *  MetricsRegistry keeps named metrics of a process and formats them in the
+ *  Prometheus text exposition format. Metrics should be looked up once
+ *  (e.g. into static variables), updates never touch the registry.
+ */
+class MetricsRegistry {
+public:
+    /// The registry of the process
+    static MetricsRegistry& instance();
+
+    MetricsRegistry() = default;
+    MetricsRegistry(MetricsRegistry const&) = delete;
+    MetricsRegistry& operator=(MetricsRegistry const&) = delete;
+
+    /// @return the counter with the name, created if needed
+    MetricCounter::Ptr counter(std::string const& name, std::string const& help);
+
+    /// @return the gauge with the name, created if needed
+    MetricGauge::Ptr gauge(std::string const& name, std::string const& help);
+
+    /// @return the histogram with the name, created if needed
+    MetricHistogram::Ptr histogram(std::string const& name, std::string const& help, double scale=1e6);
+
+    /// Add a gauge whose value is computed when metrics are read, it replaces
+    /// any gauge with the same name. The function must not call the registry.
+    void gaugeFunction(std::string const& name, std::string const& help,
+                       std::function<double()> const& func);
+
+    /// Remove a gauge added by gaugeFunction()
+    void removeGaugeFunction(std::string const& name);
+
+    /// Write all metrics in the text exposition format
+    void write(std::ostream& os) const;
+
+    /// @return all metrics in the text exposition format
+    std::string format() const;
+
+private:
+    struct Entry {
+        std::string help;
+        MetricCounter::Ptr counter;
+        MetricGauge::Ptr gauge;
+        MetricHistogram::Ptr histogram;
+        std::function<double()> func;
+    };
+
+    mutable std::mutex _mtx; ///< protects _entries
+    std::map<std::string, Entry> _entries;
+};
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_METRICS_H
@@ -0,0 +1,157 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/**
+ * @file
+ *
+ * @ingroup util
+ *
+ * @brief test ChunkSet class
+ */
+
+// System headers
+#include <set>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Qserv headers
+#include "util/ChunkSet.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE ChunkSet
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+namespace util = lsst::qserv::util;
+
+namespace {
+
+/// @return a set of every n-th number in a range [begin,end)
+template <typename Set>
+Set makeSet(int begin, int end, int step) {
+    Set s;
+    for (int i = begin; i < end; i += step) s.insert(i);
+    return s;
+}
+
+bool sameElements(util::ChunkSet const& chunks, std::set<int> const& ref) {
+    return chunks.size() == ref.size() and
+           std::vector<int>(ref.begin(), ref.end()) == chunks.toVector();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(InsertErase) {
+    util::ChunkSet s;
+    BOOST_CHECK(s.empty());
+    BOOST_CHECK(s.begin() == s.end());
+    BOOST_CHECK(s.insert(3));
+    BOOST_CHECK(not s.insert(3));
+    BOOST_CHECK(s.insert(1234567890));
+    BOOST_CHECK(s.insert(70000));
+    BOOST_CHECK_EQUAL(s.size(), 3U);
+    BOOST_CHECK(s.find(70000) != s.end());
+    BOOST_CHECK_EQUAL(*s.find(70000), 70000);
+    BOOST_CHECK(s.find(4) == s.end());
+    BOOST_CHECK_EQUAL(s.count(1234567890), 1U);
+    BOOST_CHECK((s.toVector() == std::vector<int>{3, 70000, 1234567890}));
+    BOOST_CHECK_EQUAL(s.erase(70000), 1U);
+    BOOST_CHECK_EQUAL(s.erase(70000), 0U);
+    BOOST_CHECK_EQUAL(s.count(70000), 0U);
+    BOOST_CHECK_EQUAL(s.size(), 2U);
+
+    std::ostringstream os;
+    os << s;
+    BOOST_CHECK_EQUAL(os.str(), "[3, 1234567890]");
+}
+
+BOOST_AUTO_TEST_CASE(DenseBlocks) {
+    // Cross the array/bitmap threshold in both directions
+    auto ref = makeSet<std::set<int>>(0, 200000, 3);
+    auto s = makeSet<util::ChunkSet>(0, 200000, 3);
+    BOOST_CHECK(sameElements(s, ref));
+    BOOST_CHECK(s.memoryUsage() < ref.size() * sizeof(int));
+    for (int i = 0; i < 200000; i += 6) {
+        s.erase(i);
+        ref.erase(i);
+    }
+    BOOST_CHECK(sameElements(s, ref));
+    for (int i = 0; i < 200000; i += 2) {
+        s.erase(i + 1);
+        ref.erase(i + 1);
+    }
+    BOOST_CHECK(sameElements(s, ref));
+}
+
+BOOST_AUTO_TEST_CASE(Algebra) {
+    // Mix sparse and dense blocks on both sides
+    auto a = makeSet<std::set<int>>(0, 300000, 2);
+    auto b = makeSet<std::set<int>>(100000, 500000, 37);
+    util::ChunkSet const sa(a.begin(), a.end());
+    util::ChunkSet const sb(b.begin(), b.end());
+
+    std::set<int> ref;
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::inserter(ref, ref.end()));
+    BOOST_CHECK(sameElements(sa | sb, ref));
+
+    ref.clear();
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(ref, ref.end()));
+    BOOST_CHECK(sameElements(sa & sb, ref));
+    BOOST_CHECK(sameElements(sb & sa, ref));
+
+    ref.clear();
+    std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(ref, ref.end()));
+    BOOST_CHECK(sameElements(sa - sb, ref));
+
+    ref.clear();
+    std::set_difference(b.begin(), b.end(), a.begin(), a.end(), std::inserter(ref, ref.end()));
+    BOOST_CHECK(sameElements(sb - sa, ref));
+
+    BOOST_CHECK((sa - sa).empty());
+    BOOST_CHECK((sa & util::ChunkSet()).empty());
+    BOOST_CHECK((sa | util::ChunkSet()) == sa);
+}
+
+BOOST_AUTO_TEST_CASE(Serialization) {
+    auto s = makeSet<util::ChunkSet>(0, 150000, 5);
+    s.insert(1234567890);
+
+    std::string const fileName = "/tmp/testChunkSet_" + std::to_string(::getpid()) + ".bin";
+    s.save(fileName);
+    BOOST_CHECK(util::ChunkSet::isBinaryFile(fileName));
+    util::ChunkSet const loaded = util::ChunkSet::load(fileName);
+    ::unlink(fileName.c_str());
+    BOOST_CHECK(loaded == s);
+
+    std::ostringstream os;
+    util::ChunkSet{1, 2, 3}.write(os);
+    std::string const buf = os.str();
+    BOOST_CHECK((util::ChunkSet::fromBuffer(buf.data(), buf.size()) == util::ChunkSet{1, 2, 3}));
+    BOOST_CHECK_THROW(util::ChunkSet::fromBuffer(buf.data(), buf.size() - 1), std::invalid_argument);
+    BOOST_CHECK_THROW(util::ChunkSet::fromBuffer("1 2 3\n", 6), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,112 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+ /**
+  * @file
+  *
+  * @brief Test metrics.
+  */
+
+// System headers
+#include <string>
+#include <thread>
+#include <vector>
+
+// Qserv headers
+#include "util/Metrics.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE Metrics
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using namespace lsst::qserv::util;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Counter) {
+    MetricCounter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&counter]() {
+            for (int i = 0; i < 1000; ++i) counter.add();
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    BOOST_CHECK_EQUAL(counter.get(), 8000);
+
+    MetricGauge gauge;
+    gauge.add(5);
+    gauge.add(-2);
+    BOOST_CHECK_EQUAL(gauge.get(), 3);
+    gauge.set(10);
+    BOOST_CHECK_EQUAL(gauge.get(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(Buckets) {
+    // Bucket bounds are contiguous and increasing
+    for (unsigned int i = 1; i < MetricHistogram::BUCKETS - 1; ++i) {
+        BOOST_REQUIRE(MetricHistogram::bucketLowerBound(i) > MetricHistogram::bucketLowerBound(i - 1));
+        BOOST_REQUIRE_EQUAL(MetricHistogram::bucketIndex(MetricHistogram::bucketLowerBound(i)), i);
+        BOOST_REQUIRE_EQUAL(MetricHistogram::bucketIndex(MetricHistogram::bucketLowerBound(i + 1) - 1), i);
+    }
+    BOOST_CHECK_EQUAL(MetricHistogram::bucketIndex(0), 0U);
+    BOOST_CHECK(MetricHistogram::bucketIndex(UINT64_MAX) < MetricHistogram::BUCKETS);
+}
+
+BOOST_AUTO_TEST_CASE(Histogram) {
+    MetricHistogram histo(1000);  // millisecond resolution
+    for (int i = 1; i <= 1000; ++i) {
+        histo.record(i / 1000.0);
+    }
+    auto const summary = histo.getSummary();
+    BOOST_CHECK_EQUAL(summary.count, 1000U);
+    BOOST_CHECK_CLOSE(summary.sum, 500.5, 0.01);
+    BOOST_CHECK_CLOSE(summary.max, 1.0, 0.01);
+    // Quantiles are within the relative error of the buckets
+    BOOST_CHECK_CLOSE(summary.quantile(0.5), 0.5, 7);
+    BOOST_CHECK_CLOSE(summary.quantile(0.99), 0.99, 7);
+    BOOST_CHECK(summary.quantile(1.0) <= 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(Registry) {
+    MetricsRegistry registry;
+    auto counter = registry.counter("qserv_test_total", "Test counter");
+    BOOST_CHECK(registry.counter("qserv_test_total", "Test counter") == counter);
+    BOOST_CHECK_THROW(registry.gauge("qserv_test_total", "Not a gauge"), std::logic_error);
+    counter->add(3);
+    registry.histogram("qserv_test_seconds", "Test histogram")->record(0.5);
+    registry.gaugeFunction("qserv_test_queued", "Test gauge", []() { return 7; });
+
+    std::string const text = registry.format();
+    BOOST_CHECK(text.find("# TYPE qserv_test_total counter\nqserv_test_total 3\n") != std::string::npos);
+    BOOST_CHECK(text.find("qserv_test_queued 7\n") != std::string::npos);
+    BOOST_CHECK(text.find("qserv_test_seconds_count 1\n") != std::string::npos);
+    BOOST_CHECK(text.find("qserv_test_seconds{quantile=\"0.5\"} 0.5") != std::string::npos);
+
+    registry.removeGaugeFunction("qserv_test_queued");
+    BOOST_CHECK(registry.format().find("qserv_test_queued") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
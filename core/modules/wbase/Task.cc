@@ -98,6 +98,7 @@ IdSet Task::allIds{};
 Task::Task(Task::TaskMsgPtr const& t, SendChannel::Ptr const& sc)
     : msg(t), sendChannel(sc),
       _qId(t->queryid()), _jId(t->jobid()), _attemptCount(t->attemptcount()),
+      _traceId(t->traceid()),
       _idStr(QueryIdHelper::makeIdStr(_qId, _jId)) {
     hash = hashTaskMsg(*t);
 
@@ -210,6 +211,20 @@ std::chrono::milliseconds Task::finished(std::chrono::system_clock::time_point c
 }
 
 
+/// @return the time the Task was put on the queue, epoch if it was never queued.
+std::chrono::system_clock::time_point Task::getQueueTime() const {
+    std::lock_guard<std::mutex> guard(_stateMtx);
+    return _queueTime;
+}
+
+
+/// @return the time the Task was started, epoch if it has not started.
+std::chrono::system_clock::time_point Task::getStartTime() const {
+    std::lock_guard<std::mutex> guard(_stateMtx);
+    return _startTime;
+}
+
+
 /// @return the amount of time spent so far on the task in milliseconds.
 std::chrono::milliseconds Task::getRunTime() const {
     std::chrono::milliseconds duration{0};
@@ -28,6 +28,7 @@
 // System headers
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -172,11 +173,17 @@ public:
     void queued(std::chrono::system_clock::time_point const& now);
     void started(std::chrono::system_clock::time_point const& now);
     std::chrono::milliseconds finished(std::chrono::system_clock::time_point const& now);
+    std::chrono::system_clock::time_point getQueueTime() const;
+    std::chrono::system_clock::time_point getStartTime() const;
+
+    /// @return trace id from the czar, 0 if the czar did not ask for trace spans
+    std::uint64_t getTraceId() const { return _traceId; }
 
 private:
     QueryId  const    _qId{0}; //< queryId from czar
     int      const    _jId{0}; //< jobId from czar
     int      const    _attemptCount{0}; // attemptCount from czar
+    std::uint64_t const _traceId{0}; //< traceId from czar
     std::string const _idStr{QueryIdHelper::makeIdStr(0, 0, true)}; // < for logging only
 
     std::atomic<bool> _cancelled{false};
@@ -71,7 +71,12 @@ WorkerConfig::WorkerConfig(const util::ConfigStore& configStore)
       _scanMaxMinutesMed(configStore.getInt("scheduler.scanmaxminutes_med", 60*8)),
       _scanMaxMinutesSlow(configStore.getInt("scheduler.scanmaxminutes_slow", 60*12)),
       _scanMaxMinutesSnail(configStore.getInt("scheduler.scanmaxminutes_snail", 60*24)),
-      _maxTasksBootedPerUserQuery(configStore.getInt("scheduler.maxtasksbootedperuserquery", 5)) {
+      _maxTasksBootedPerUserQuery(configStore.getInt("scheduler.maxtasksbootedperuserquery", 5)),
+      _metricsPort(configStore.getInt("metrics.port", 0)),
+      _resultSpoolDir(configStore.get("results.spool_dir", "")),
+      _resultSpoolThresholdMb(configStore.getInt("results.spool_threshold_mb", 16)),
+      _resultCombineMaxMb(configStore.getInt("results.combine_max_mb", 64)),
+      _semiJoinMaxKeys(configStore.getInt("semijoin.max_keys", 10000)) {
 }
 
 std::ostream& operator<<(std::ostream &out, WorkerConfig const& workerConfig) {
@@ -89,6 +94,14 @@ std::ostream& operator<<(std::ostream &out, WorkerConfig const& workerConfig) {
     out << " Reserved threads fast=" << workerConfig._maxReserveFast
          << " med=" << workerConfig._maxReserveMed << " slow=" << workerConfig._maxReserveSlow;
 
+    out << " metricsPort=" << workerConfig._metricsPort;
+
+    out << " resultSpoolDir=" << workerConfig._resultSpoolDir
+        << " resultSpoolThresholdMb=" << workerConfig._resultSpoolThresholdMb
+        << " resultCombineMaxMb=" << workerConfig._resultCombineMaxMb;
+
+    out << " semiJoinMaxKeys=" << workerConfig._semiJoinMaxKeys;
+
     return out;
 }
 
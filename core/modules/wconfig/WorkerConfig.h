@@ -88,6 +88,51 @@ public:
     }
 
 
+    /* Get the TCP port of the HTTP endpoint serving worker metrics.
+     *
+     * @return the port number, 0 if metrics are not served.
+     */
+    unsigned int getMetricsPort() const {
+        return _metricsPort;
+    }
+
+
+    /* Get the directory where large results are spooled before they are sent to the czar.
+     *
+     * @return the spool directory, empty if results are not spooled.
+     */
+    std::string const& getResultSpoolDir() const {
+        return _resultSpoolDir;
+    }
+
+
+    /* Get the size of a result above which the rest of it is spooled.
+     *
+     * @return the spool threshold in MB.
+     */
+    unsigned int getResultSpoolThresholdMb() const {
+        return _resultSpoolThresholdMb;
+    }
+
+
+    /* Get the limit of aggregate rows combined per user query, see wdb::ResultCombiner.
+     *
+     * @return the limit in MB, 0 if results are not combined.
+     */
+    unsigned int getResultCombineMaxMb() const {
+        return _resultCombineMaxMb;
+    }
+
+
+    /* Get the most director keys a semi-join predicate is replaced by, see wdb::SemiJoinFilter.
+     *
+     * @return the number of keys, 0 if semi-join predicates are left to MySQL.
+     */
+    unsigned int getSemiJoinMaxKeys() const {
+        return _semiJoinMaxKeys;
+    }
+
+
     /* Get maximum time in minutes for all tasks in a user query to finish for the fast scan.
      *
      * @return Maximum minutes for a user query to complete on the fast scan.
@@ -300,6 +345,12 @@ private:
     unsigned int const _scanMaxMinutesSlow;
     unsigned int const _scanMaxMinutesSnail;
     unsigned int const _maxTasksBootedPerUserQuery;
+    unsigned int const _metricsPort;
+
+    std::string const _resultSpoolDir;
+    unsigned int const _resultSpoolThresholdMb;
+    unsigned int const _resultCombineMaxMb;
+    unsigned int const _semiJoinMaxKeys;
 };
 
 }}} // namespace qserv::core::wconfig
@@ -44,6 +44,7 @@
 #include "wbase/WorkerCommand.h"
 #include "wdb/ChunkResource.h"
 #include "wdb/QueryRunner.h"
+#include "wdb/ResultCombiner.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wcontrol.Foreman");
@@ -56,11 +57,16 @@ namespace wcontrol {
 Foreman::Foreman(Scheduler::Ptr                  const& scheduler,
                  uint                                   poolSize,
                  mysql::MySqlConfig              const& mySqlConfig,
-                 wpublish::QueriesAndChunks::Ptr const& queries)
+                 wpublish::QueriesAndChunks::Ptr const& queries,
+                 wdb::ResultSpool::Config        const& spoolConfig,
+                 std::uint64_t                          combineMaxBytes,
+                 unsigned int                           semiJoinMaxKeys)
 
     :   _scheduler  (scheduler),
         _mySqlConfig(mySqlConfig),
-        _queries    (queries) {
+        _queries    (queries),
+        _spoolConfig(spoolConfig),
+        _semiJoinMaxKeys(semiJoinMaxKeys) {
 
     // Make the chunk resource mgr
     // Creating backend makes a connection to the database for making temporary tables.
@@ -69,6 +75,7 @@ Foreman::Foreman(Scheduler::Ptr                  const& scheduler,
     // Previous instances of the worker should be terminated before a new worker is started.
     _backend = std::make_shared<wdb::SQLBackend>(_mySqlConfig);
     _chunkResourceMgr = wdb::ChunkResourceMgr::newMgr(_backend);
+    _resultCombiner = wdb::ResultCombiner::create(combineMaxBytes);
 
     assert(_scheduler); // Cannot operate without scheduler.
 
@@ -99,7 +106,8 @@ void Foreman::processTask(std::shared_ptr<wbase::Task> const& task) {
                 task->sendChannel->sendError("Unsupported wire protocol", 1);
             }
         } else {
-            auto qr = wdb::QueryRunner::newQueryRunner(task, _chunkResourceMgr, _mySqlConfig);
+            auto qr = wdb::QueryRunner::newQueryRunner(task, _chunkResourceMgr, _mySqlConfig,
+                                                       _spoolConfig, _resultCombiner, _semiJoinMaxKeys);
             qr->runQuery();
         }
     };
@@ -26,6 +26,7 @@
 
 // System headers
 #include <atomic>
+#include <cstdint>
 #include <memory>
 
 // Qserv headers
@@ -34,6 +35,7 @@
 #include "wbase/Base.h"
 #include "wbase/MsgProcessor.h"
 //#include "wbase/Task.h"
+#include "wdb/ResultSpool.h"
 #include "wpublish/QueriesAndChunks.h"
 
 
@@ -44,6 +46,7 @@ namespace wdb {
     class SQLBackend;
     class ChunkResourceMgr;
     class QueryRunner;
+    class ResultCombiner;
 }}}
 
 namespace lsst {
@@ -85,11 +88,17 @@ public:
      * @param poolSize    - size of the thread pool
      * @param mySqlConfig - configuration object for the MySQL service
      * @param queries     - query statistics collector
+     * @param spoolConfig - where and when large results are spooled
+     * @param combineMaxBytes - limit of aggregate rows combined per user query, 0 disables combining
+     * @param semiJoinMaxKeys - most keys a semi-join predicate is replaced by, 0 disables it
      */
     Foreman(Scheduler::Ptr                  const& scheduler,
             uint                                   poolSize,
             mysql::MySqlConfig              const& mySqlConfig,
-            wpublish::QueriesAndChunks::Ptr const& queries);
+            wpublish::QueriesAndChunks::Ptr const& queries,
+            wdb::ResultSpool::Config        const& spoolConfig = wdb::ResultSpool::Config(),
+            std::uint64_t                          combineMaxBytes = 0,
+            unsigned int                           semiJoinMaxKeys = 0);
 
     virtual ~Foreman();
 
@@ -118,6 +127,7 @@ private:
 
     std::shared_ptr<wdb::SQLBackend>       _backend;
     std::shared_ptr<wdb::ChunkResourceMgr> _chunkResourceMgr;
+    std::shared_ptr<wdb::ResultCombiner>   _resultCombiner;
 
     util::ThreadPool::Ptr _pool;
     Scheduler::Ptr        _scheduler;
@@ -127,6 +137,8 @@ private:
 
     mysql::MySqlConfig const        _mySqlConfig;
     wpublish::QueriesAndChunks::Ptr _queries;
+    wdb::ResultSpool::Config const  _spoolConfig;
+    unsigned int const              _semiJoinMaxKeys;
 };
 
 }}}  // namespace lsst::qserv::wcontrol
@@ -33,9 +33,14 @@
 
 // System headers
 #include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 // Third-party headers
 #include <boost/algorithm/string/replace.hpp>
@@ -62,6 +67,7 @@
 #include "sql/SqlErrorObject.h"
 #include "util/common.h"
 #include "util/IterableFormatter.h"
+#include "util/Metrics.h"
 #include "util/MultiError.h"
 #include "util/StringHash.h"
 #include "util/Timer.h"
@@ -69,9 +75,40 @@
 #include "wbase/Base.h"
 #include "wbase/SendChannel.h"
 #include "wdb/ChunkResource.h"
+#include "wdb/SemiJoinFilter.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wdb.QueryRunner");
+
+using lsst::qserv::util::MetricsRegistry;
+
+auto const memWaitSeconds = MetricsRegistry::instance().histogram(
+    "qserv_worker_memwait_seconds", "Time tasks wait for tables to be locked in memory");
+auto const transmitSeconds = MetricsRegistry::instance().histogram(
+    "qserv_worker_transmit_seconds", "Time to send a result message to the czar");
+auto const transmitHeaderSeconds = MetricsRegistry::instance().histogram(
+    "qserv_worker_transmit_header_seconds", "Time to send a result header to the czar");
+auto const transmitBytes = MetricsRegistry::instance().counter(
+    "qserv_worker_transmit_bytes_total", "Result bytes sent to the czar");
+auto const transmitRows = MetricsRegistry::instance().counter(
+    "qserv_worker_transmit_rows_total", "Result rows sent to the czar");
+auto const spoolBytes = MetricsRegistry::instance().counter(
+    "qserv_worker_spool_bytes_total", "Result bytes spooled to local disk");
+auto const combinedRows = MetricsRegistry::instance().counter(
+    "qserv_worker_combined_rows_total", "Result rows combined with rows of other tasks of the query");
+auto const semiJoinQueries = MetricsRegistry::instance().counter(
+    "qserv_worker_semijoin_queries_total", "Queries run with the keys of their semi-join predicate");
+auto const semiJoinEmpty = MetricsRegistry::instance().counter(
+    "qserv_worker_semijoin_empty_total", "Queries with a semi-join predicate selecting no keys");
+
+/// @return microseconds since the epoch
+std::uint64_t toMicros(std::chrono::system_clock::time_point const& tp) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
+}
+
+std::uint64_t nowMicros() {
+    return toMicros(std::chrono::system_clock::now());
+}
 }
 
 namespace lsst {
@@ -81,8 +118,12 @@ namespace wdb {
 
 QueryRunner::Ptr QueryRunner::newQueryRunner(wbase::Task::Ptr const& task,
                                              ChunkResourceMgr::Ptr const& chunkResourceMgr,
-                                             mysql::MySqlConfig const& mySqlConfig) {
-    Ptr qr{new QueryRunner{task, chunkResourceMgr, mySqlConfig}}; // Private constructor.
+                                             mysql::MySqlConfig const& mySqlConfig,
+                                             ResultSpool::Config const& spoolConfig,
+                                             ResultCombiner::Ptr const& resultCombiner,
+                                             unsigned int semiJoinMaxKeys) {
+    Ptr qr{new QueryRunner{task, chunkResourceMgr, mySqlConfig, spoolConfig,
+                           resultCombiner, semiJoinMaxKeys}}; // Private constructor.
     // Let the Task know this is its QueryRunner.
     bool cancelled = qr->_task->setTaskQueryRunner(qr);
     if (cancelled) {
@@ -96,8 +137,12 @@ QueryRunner::Ptr QueryRunner::newQueryRunner(wbase::Task::Ptr const& task,
 /// and correct setup of enable_shared_from_this.
 QueryRunner::QueryRunner(wbase::Task::Ptr const& task,
                          ChunkResourceMgr::Ptr const& chunkResourceMgr,
-                         mysql::MySqlConfig const& mySqlConfig)
-    : _task(task), _chunkResourceMgr(chunkResourceMgr), _mySqlConfig(mySqlConfig) {
+                         mysql::MySqlConfig const& mySqlConfig,
+                         ResultSpool::Config const& spoolConfig,
+                         ResultCombiner::Ptr const& resultCombiner,
+                         unsigned int semiJoinMaxKeys)
+    : _task(task), _chunkResourceMgr(chunkResourceMgr), _mySqlConfig(mySqlConfig),
+      _spoolConfig(spoolConfig), _resultCombiner(resultCombiner), _semiJoinMaxKeys(semiJoinMaxKeys) {
     int rc = mysql_thread_init();
     assert(rc == 0);
     assert(_task->msg);
@@ -127,9 +172,6 @@ void QueryRunner::_setDb() {
 }
 
 
-util::TimerHistogram memWaitHisto("memWait Hist", {1, 5, 10, 20, 40});
-
-
 bool QueryRunner::runQuery() {
     LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " QueryRunner::runQuery()");
 
@@ -149,19 +191,46 @@ bool QueryRunner::runQuery() {
         return false;
     }
 
+    if (_task->getTraceId() != 0) {
+        // Time spent waiting in the scheduler queue.
+        auto const queueTime = _task->getQueueTime();
+        auto const startTime = _task->getStartTime();
+        if (queueTime.time_since_epoch().count() != 0 && startTime >= queueTime) {
+            _addTraceSpan("schedule", toMicros(queueTime),
+                          std::chrono::duration<double>(startTime - queueTime).count());
+        }
+    }
+
     // Wait for memman to finish reserving resources. This can take several seconds.
     util::Timer memTimer;
+    std::uint64_t const memStart = nowMicros();
     memTimer.start();
     _task->waitForMemMan();
     memTimer.stop();
-    auto logMsg = memWaitHisto.addTime(memTimer.getElapsed(), _task->getIdStr());
-    LOGS(_log, LOG_LVL_INFO, logMsg);
+    memWaitSeconds->record(memTimer.getElapsed());
+    _addTraceSpan("memWait", memStart, memTimer.getElapsed());
+    LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " memWait=" << memTimer.getElapsed());
 
     if (_task->getCancelled()) {
         LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " runQuery, task was cancelled after locking tables.");
         return false;
     }
 
+    // Aggregate rows of Tasks of the same query running at the same time may be
+    // combined, the last of them to finish sends the rows when it leaves.
+    class LeaveCombiner {
+    public:
+        explicit LeaveCombiner(QueryRunner* qr) : _qr(qr) {}
+        ~LeaveCombiner() { _qr->_leaveCombiner(); }
+    private:
+        QueryRunner* _qr;
+    };
+    if (_resultCombiner != nullptr && _resultCombiner->enabled() && _task->msg->combineop_size() > 0) {
+        _resultCombiner->join(_task->getQueryId());
+        _combining = true;
+    }
+    LeaveCombiner leaveCombiner(this);
+
     _setDb();
     LOGS(_log, LOG_LVL_DEBUG,  _task->getIdStr() << " Exec in flight for Db=" << _dbName);
     bool connOk = _initConnection();
@@ -199,6 +268,58 @@ MYSQL_RES* QueryRunner::_primeResult(std::string const& query) {
         return _mysqlConn->getResult();
 }
 
+bool QueryRunner::_selectSemiJoinKeys(SemiJoinFilter const& filter, std::vector<std::string>& keys) {
+    util::Timer timer;
+    std::uint64_t const start = nowMicros();
+    timer.start();
+    // One more key than allowed tells that there are too many.
+    std::string const keyQuery = filter.getKeyQuery() + " LIMIT " + std::to_string(_semiJoinMaxKeys + 1);
+    if (!_mysqlConn->queryUnbuffered(keyQuery) || _mysqlConn->getResult() == nullptr) {
+        // The join of the query itself filters the rows then.
+        LOGS(_log, LOG_LVL_WARN, _task->getIdStr() << " semi-join keys failed: " << _mysqlConn->getError());
+        return false;
+    }
+    MYSQL_RES* res = _mysqlConn->getResult();
+    // Numbers are not quoted, as in UserQueryProcessList (IS_NUM is true for
+    // TIMESTAMP in mariadb 10.2).
+    auto const type = mysql_fetch_field_direct(res, 0)->type;
+    bool const numeric = IS_NUM(type) && type != MYSQL_TYPE_TIMESTAMP;
+    keys.clear();
+    bool tooMany = false;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(res)) != nullptr) {
+        if (row[0] == nullptr) {
+            continue; // NULL never matches.
+        }
+        if (keys.size() == _semiJoinMaxKeys) {
+            tooMany = true;
+            break;
+        }
+        unsigned long const length = mysql_fetch_lengths(res)[0];
+        if (numeric) {
+            keys.emplace_back(row[0], length);
+        } else {
+            std::string escaped(2*length + 1, '\0');
+            escaped.resize(mysql_real_escape_string(_mysqlConn->getMySql(), &escaped[0], row[0], length));
+            keys.push_back("'" + escaped + "'");
+        }
+    }
+    _mysqlConn->freeResult();
+    timer.stop();
+    _addTraceSpan("semijoin", start, timer.getElapsed());
+    if (tooMany) {
+        LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " semi-join over " << _semiJoinMaxKeys << " keys");
+        return false;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " semi-join keys=" << keys.size()
+                              << " time=" << timer.getElapsed());
+    semiJoinQueries->add(1);
+    if (keys.empty()) {
+        semiJoinEmpty->add(1);
+    }
+    return true;
+}
+
 void QueryRunner::_initMsgs() {
     _protoHeader = std::make_shared<proto::ProtoHeader>();
     _initMsg();
@@ -233,19 +354,13 @@ void QueryRunner::_fillSchema(MYSQL_RES* result) {
 bool QueryRunner::_fillRows(MYSQL_RES* result, int numFields, uint& rowCount, size_t& tSize) {
     MYSQL_ROW row;
 
+    // Rows of an unbuffered result are produced by MySQL while they are fetched,
+    // fetching is traced separately from transmitting them.
+    util::Timer fetchTimer;
+    std::uint64_t fetchStart = nowMicros();
+    fetchTimer.start();
     while ((row = mysql_fetch_row(result))) {
-        auto lengths = mysql_fetch_lengths(result);
-        proto::RowBundle* rawRow =_result->add_row();
-        for(int i=0; i < numFields; ++i) {
-            if (row[i]) {
-                rawRow->add_column(row[i], lengths[i]);
-                rawRow->add_isnull(false);
-            } else {
-                rawRow->add_column();
-                rawRow->add_isnull(true);
-            }
-        }
-        tSize += rawRow->ByteSize();
+        tSize += appendRow(*_result, row, mysql_fetch_lengths(result), numFields);
         ++rowCount;
 
         unsigned int szLimit = std::min(proto::ProtoHeaderWrap::PROTOBUFFER_DESIRED_LIMIT,
@@ -259,7 +374,11 @@ bool QueryRunner::_fillRows(MYSQL_RES* result, int numFields, uint& rowCount, si
             }
             LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " Large message size=" << tSize
                  << ", splitting message rowCount=" << rowCount);
+            fetchTimer.stop();
+            _addTraceSpan("fetch", fetchStart, fetchTimer.getElapsed());
             _transmit(false, rowCount, tSize);
+            fetchStart = nowMicros();
+            fetchTimer.start();
             rowCount = 0;
             tSize = 0;
             _initMsg();
@@ -269,25 +388,42 @@ bool QueryRunner::_fillRows(MYSQL_RES* result, int numFields, uint& rowCount, si
             // scheduler for this worker should stop waiting for this task. leavePool()
             // will tell the scheduler this task is finished and create a new thread in the pool
             // to replace this thread.
-            auto pet = _task->getAndNullPoolEventThread();
-            if (pet != nullptr) {
-                pet->leavePool();
-            } else {
-                LOGS(_log, LOG_LVL_DEBUG, "Large result PoolEventThread was null. Probably already moved. b");
+            // A spooled result doesn't wait for the czar, the thread leaves the pool
+            // once the query is done (see _dispatchChannel).
+            if (_spool == nullptr) {
+                auto pet = _task->getAndNullPoolEventThread();
+                if (pet != nullptr) {
+                    pet->leavePool();
+                } else {
+                    LOGS(_log, LOG_LVL_DEBUG, "Large result PoolEventThread was null. Probably already moved. b");
+                }
             }
         }
     }
+    fetchTimer.stop();
+    _addTraceSpan("fetch", fetchStart, fetchTimer.getElapsed());
     return true;
 }
 
 
-util::TimerHistogram transmitHisto("transmit Hist", {0.1, 1, 5, 10, 20, 40});
-
-
 /// Transmit result data with its header.
 /// If 'last' is true, this is the last message in the result set
 /// and flags are set accordingly.
 void QueryRunner::_transmit(bool last, uint rowCount, size_t tSize) {
+    if (!last || _task->getTraceId() == 0) {
+        _transmitMsg(last, rowCount, tSize);
+        return;
+    }
+    // Spans recorded while sending the rows, the last "transmit" in particular,
+    // are only known after the message was serialized. They are sent in
+    // a final message without rows.
+    _transmitMsg(false, rowCount, tSize);
+    if (_cancelled) return;
+    _initMsg();
+    _transmitMsg(true, 0, 0);
+}
+
+void QueryRunner::_transmitMsg(bool last, uint rowCount, size_t tSize) {
     LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " _transmit last=" << last
          << " rowCount=" << rowCount << " tSize=" << tSize);
     std::string resultString;
@@ -298,6 +434,13 @@ void QueryRunner::_transmit(bool last, uint rowCount, size_t tSize) {
     _result->set_rowcount(rowCount);
     _result->set_transmitsize(tSize);
     _result->set_attemptcount(_task->getAttemptCount());
+    for (auto const& span : _traceSpans) {
+        proto::TraceSpan* traceSpan = _result->add_tracespan();
+        traceSpan->set_stage(span.stage);
+        traceSpan->set_start(span.start);
+        traceSpan->set_duration(span.duration);
+    }
+    _traceSpans.clear();
     if (!_multiError.empty()) {
         std::string chunkId = std::to_string(_task->msg->chunkid());
         std::string msg = "Error(s) in result for chunk #" + chunkId + ": " + _multiError.toOneLineString();
@@ -307,6 +450,14 @@ void QueryRunner::_transmit(bool last, uint rowCount, size_t tSize) {
     _result->SerializeToString(&resultString);
     _result.reset(); // don't need it anymore and a new one will be made when needed..
 
+    if (_spoolResult(resultString, last)) {
+        transmitRows->add(rowCount);
+        transmitBytes->add(tSize);
+        _largeResult = true;
+        return;
+    }
+    _resultBytes += resultString.size();
+
     _transmitHeader(resultString);
     LOGS(_log, LOG_LVL_DEBUG, "_transmit last=" << last << " " << _task->getIdStr()
          << " resultString=" << util::prettyCharList(resultString, 5));
@@ -314,7 +465,9 @@ void QueryRunner::_transmit(bool last, uint rowCount, size_t tSize) {
     if (!_cancelled) {
         // StreamBuffer::create invalidates resultString by using std::move()
         xrdsvc::StreamBuffer::Ptr streamBuf(xrdsvc::StreamBuffer::createWithMove(resultString));
-        _sendBuf(streamBuf, last, transmitHisto, "body");
+        _sendBuf(streamBuf, last, *transmitSeconds, "body");
+        transmitRows->add(rowCount);
+        transmitBytes->add(tSize);
     } else {
         LOGS(_log, LOG_LVL_DEBUG, "_transmit cancelled");
     }
@@ -322,47 +475,129 @@ void QueryRunner::_transmit(bool last, uint rowCount, size_t tSize) {
 }
 
 
+bool QueryRunner::_spoolResult(std::string const& resultString, bool last) {
+    if (_spool == nullptr) {
+        // Only the part of a result above the threshold is spooled, and spooling
+        // is pointless if this is the final message.
+        if (last || _spoolFailed || !_spoolConfig.enabled()
+            || _resultBytes + resultString.size() <= _spoolConfig.thresholdBytes) {
+            return false;
+        }
+        std::string const name = "qserv-result-" + std::to_string(_task->getQueryId())
+                               + "-" + std::to_string(_task->getJobId());
+        try {
+            _spool = ResultSpool::create(_spoolConfig.dir, name);
+        } catch (std::runtime_error const& e) {
+            LOGS(_log, LOG_LVL_WARN, _task->getIdStr() << " not spooling the result: " << e.what());
+            _spoolFailed = true;
+            return false;
+        }
+        LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " spooling the result after "
+             << _resultBytes << " bytes");
+    }
+
+    util::Timer t;
+    std::uint64_t const start = nowMicros();
+    t.start();
+    std::string const header = makeHeader(*_protoHeader, resultString, _largeResult);
+    bool const spooled = _spool->append(header, resultString, last);
+    t.stop();
+    _addTraceSpan("spool", start, t.getElapsed());
+    if (spooled) {
+        spoolBytes->add(header.size() + resultString.size());
+        return true;
+    }
+
+    // The disk is probably full, send what has been spooled and go on without the spool.
+    LOGS(_log, LOG_LVL_WARN, _task->getIdStr() << " spooling failed, sending the result directly");
+    _spoolFailed = true;
+    _sendSpool();
+    return false;
+}
+
+
+void QueryRunner::_sendSpool() {
+    auto spool = std::move(_spool);
+    LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " sending " << spool->getMessageCount()
+         << " spooled messages, bytes=" << spool->getBytes());
+    std::string header;
+    std::string body;
+    bool last = false;
+    for (std::size_t i = 0; i < spool->getMessageCount() && !_cancelled; ++i) {
+        if (!spool->read(i, header, body, last)) {
+            // The czar can't be given a consistent result anymore.
+            _task->sendChannel->sendError("Failed to read the spooled result", EIO);
+            _cancelled = true;
+            break;
+        }
+        xrdsvc::StreamBuffer::Ptr headerBuf(xrdsvc::StreamBuffer::createWithMove(header));
+        _sendBuf(headerBuf, false, *transmitHeaderSeconds, "header");
+        if (_cancelled) break;
+        xrdsvc::StreamBuffer::Ptr bodyBuf(xrdsvc::StreamBuffer::createWithMove(body));
+        _sendBuf(bodyBuf, last, *transmitSeconds, "body");
+    }
+}
+
+
 void QueryRunner::_sendBuf(xrdsvc::StreamBuffer::Ptr& streamBuf, bool last,
-                           util::TimerHistogram& histo, std::string const& note) {
+                           util::MetricHistogram& histo, std::string const& note) {
     bool sent = _task->sendChannel->sendStream(streamBuf, last);
     if (!sent) {
         LOGS(_log, LOG_LVL_ERROR, _task->getIdStr() << " Failed to transmit " << note << "!");
         _cancelled = true;
     } else {
         util::Timer t;
+        std::uint64_t const start = nowMicros();
         t.start();
         LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " _sendbuf wait start");
         streamBuf->waitForDoneWithThis(); // Block until this buffer has been sent.
         LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " _sendbuf wait end");
         t.stop();
-        auto logMsg = histo.addTime(t.getElapsed(), _task->getIdStr());
-        LOGS(_log, LOG_LVL_DEBUG, logMsg);
+        histo.record(t.getElapsed());
+        _addTraceSpan("transmit", start, t.getElapsed());
+        LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " _sendbuf " << note << " time=" << t.getElapsed());
     }
 }
 
 
-util::TimerHistogram transHeaderHisto("transHeader Hist", {0.1, 1, 5, 10, 20, 40});
+size_t QueryRunner::appendRow(proto::Result& result, MYSQL_ROW row, unsigned long const* lengths,
+                              int numFields) {
+    proto::RowBundle* rawRow = result.add_row();
+    for(int i=0; i < numFields; ++i) {
+        if (row[i]) {
+            rawRow->add_column(row[i], lengths[i]);
+            rawRow->add_isnull(false);
+        } else {
+            rawRow->add_column();
+            rawRow->add_isnull(true);
+        }
+    }
+    return rawRow->ByteSize();
+}
 
+std::string QueryRunner::makeHeader(proto::ProtoHeader& protoHeader, std::string const& msg,
+                                    bool largeResult) {
+    protoHeader.set_protocol(2); // protocol 2: row-by-row message
+    protoHeader.set_size(msg.size());
+    protoHeader.set_md5(util::StringHash::getMd5(msg.data(), msg.size()));
+    protoHeader.set_wname(getHostname());
+    protoHeader.set_largeresult(largeResult);
+    std::string protoHeaderString;
+    protoHeader.SerializeToString(&protoHeaderString);
+
+    // Make sure protoheader size can be encoded in a byte.
+    assert(protoHeaderString.size() < 255);
+    return proto::ProtoHeaderWrap::wrap(protoHeaderString);
+}
 
 /// Transmit the protoHeader
 void QueryRunner::_transmitHeader(std::string& msg) {
     LOGS(_log, LOG_LVL_DEBUG, "_transmitHeader");
-    // Set header
-    _protoHeader->set_protocol(2); // protocol 2: row-by-row message
-    _protoHeader->set_size(msg.size());
-    _protoHeader->set_md5(util::StringHash::getMd5(msg.data(), msg.size()));
-    _protoHeader->set_wname(getHostname());
-    _protoHeader->set_largeresult(_largeResult);
-    std::string protoHeaderString;
-    _protoHeader->SerializeToString(&protoHeaderString);
-
     // Flush to channel.
-    // Make sure protoheader size can be encoded in a byte.
-    assert(protoHeaderString.size() < 255);
     if (!_cancelled) {
-        auto msgBuf = proto::ProtoHeaderWrap::wrap(protoHeaderString);
+        auto msgBuf = makeHeader(*_protoHeader, msg, _largeResult);
         xrdsvc::StreamBuffer::Ptr streamBuf(xrdsvc::StreamBuffer::createWithMove(msgBuf)); // invalidates msgBuf
-        _sendBuf(streamBuf, false, transHeaderHisto, "header");
+        _sendBuf(streamBuf, false, *transmitHeaderSeconds, "header");
     } else {
         LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " _transmitHeader cancelled");
     }
@@ -428,6 +663,17 @@ bool QueryRunner::_dispatchChannel() {
     size_t tSize = 0;
 
     try {
+        // The semi-join comes only from its own field of the message, the
+        // keys are selected once for all fragments.
+        SemiJoinFilter::Ptr semiJoin;
+        bool semiJoinSelected = false;
+        std::vector<std::string> semiJoinKeys;
+        if (_semiJoinMaxKeys != 0 && m.has_semijoin()) {
+            semiJoin = SemiJoinFilter::create(m.semijoin().column(), m.semijoin().keyquery());
+            if (semiJoin == nullptr) {
+                LOGS(_log, LOG_LVL_WARN, _task->getIdStr() << " invalid semi-join ignored");
+            }
+        }
         for(int i=0; i < m.fragment_size(); ++i) {
             if (_cancelled) {
                 break;
@@ -446,12 +692,22 @@ bool QueryRunner::_dispatchChannel() {
                 }
             }
             ChunkResource cr(req.getResourceFragment(i));
+            if (semiJoin != nullptr && !semiJoinSelected) {
+                semiJoinSelected = true;
+                if (!_selectSemiJoinKeys(*semiJoin, semiJoinKeys)) {
+                    semiJoin.reset();
+                }
+            }
             // Use query fragment as-is, funnel results.
-            for(auto const& query : queries) {
+            for(auto const& fragmentQuery : queries) {
+                std::string const query = semiJoin != nullptr ? semiJoin->apply(fragmentQuery, semiJoinKeys)
+                                                              : fragmentQuery;
                 util::Timer sqlTimer;
+                std::uint64_t const sqlStart = nowMicros();
                 sqlTimer.start();
                 MYSQL_RES* res = _primeResult(query); // This runs the SQL query.
                 sqlTimer.stop();
+                _addTraceSpan("sql", sqlStart, sqlTimer.getElapsed());
                 LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " fragment time=" << sqlTimer.getElapsed()
                                                             << " query=" << query);
                 if (!res) {
@@ -479,8 +735,22 @@ bool QueryRunner::_dispatchChannel() {
         _multiError.push_back(worker_err);
     }
     if (!_cancelled) {
-        // Send results.
+        // Send results, unless they are sent with the rows of other Tasks.
+        if (_combineResult(erred)) {
+            return true;
+        }
         _transmit(true, rowCount, tSize);
+        if (_spool != nullptr) {
+            // All of the result is on local disk. Release the database connection
+            // and let the scheduler and memman go on without waiting for the czar,
+            // the chunk resources were released with the last fragment.
+            _mysqlConn->closeMySqlConn();
+            auto pet = _task->getAndNullPoolEventThread();
+            if (pet != nullptr) {
+                pet->leavePool();
+            }
+            _sendSpool();
+        }
     } else {
         erred = true;
         // Send poison error.
@@ -491,6 +761,149 @@ bool QueryRunner::_dispatchChannel() {
     return !erred;
 }
 
+bool QueryRunner::_combineResult(bool erred) {
+    // Only complete results without errors are combined, anything else is
+    // sent as usual and the czar handles it per job.
+    if (!_combining || erred || _largeResult || !_multiError.empty()) {
+        return false;
+    }
+    std::vector<std::string> const ops(_task->msg->combineop().begin(), _task->msg->combineop().end());
+    if (!_resultCombiner->add(_task->getQueryId(), _task, *_result, ops)) {
+        return false;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " combined rows=" << _result->row_size());
+    combinedRows->add(_result->row_size());
+    _result.reset();
+    return true;
+}
+
+void QueryRunner::_leaveCombiner() {
+    if (!_combining) return;
+    _combining = false;
+    auto flush = _resultCombiner->leave(_task->getQueryId());
+    if (flush.tasks.empty()) return;
+
+    // Sending waits for the czar, let the scheduler go on.
+    auto pet = _task->getAndNullPoolEventThread();
+    if (pet != nullptr) {
+        pet->leavePool();
+    }
+    // The rows go with the first Task which isn't cancelled, preferably this one.
+    std::stable_partition(flush.tasks.begin(), flush.tasks.end(),
+                          [this](wbase::Task::Ptr const& task) { return task == _task; });
+    LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " sending combined rows="
+         << flush.result->row_size() << " of tasks=" << flush.tasks.size());
+    // If the rows can't be sent the czar may already have merged some of them,
+    // or it retries the carrier's job. The other Tasks fail as well so that all
+    // of their jobs are retried, sending the rows with another Task would
+    // merge the retried chunk twice. Once the rows were sent, the czar doesn't
+    // retry the jobs listed with them, the query fails if one of them fails.
+    bool carrierFailed = false;
+    bool sent = false;
+    for (auto const& task : flush.tasks) {
+        if (task->getCancelled()) {
+            // Its rows are still listed with the carrier, the czar fails the
+            // query if it already runs the job again.
+            continue;
+        }
+        if (carrierFailed) {
+            task->sendChannel->sendError("Combined result of the query could not be sent", EIO);
+            continue;
+        }
+        if (_sendCombined(task, *flush.result, sent ? nullptr : &flush.tasks)) {
+            sent = true;
+        } else if (!sent) {
+            LOGS(_log, LOG_LVL_ERROR, task->getIdStr() << " combined rows of "
+                 << flush.tasks.size() << " tasks could not be sent");
+            carrierFailed = true;
+        }
+    }
+}
+
+bool QueryRunner::_sendCombined(wbase::Task::Ptr const& task, proto::Result const& combined,
+                                std::vector<wbase::Task::Ptr> const* combinedTasks) {
+    unsigned int const szLimit = std::min(proto::ProtoHeaderWrap::PROTOBUFFER_DESIRED_LIMIT,
+                                          proto::ProtoHeaderWrap::PROTOBUFFER_HARD_LIMIT);
+    int const rowCount = (combinedTasks != nullptr) ? combined.row_size() : 0;
+    // Every response of a combined job tells the czar not to retry it.
+    proto::ProtoHeader protoHeader;
+    protoHeader.set_combined(true);
+    bool largeResult = false;
+    int row = 0;
+    bool last = false;
+    while (!last) {
+        proto::Result result;
+        result.mutable_rowschema()->CopyFrom(combined.rowschema());
+        size_t tSize = 0;
+        uint msgRows = 0;
+        for (; row < rowCount && tSize <= szLimit; ++row, ++msgRows) {
+            result.add_row()->CopyFrom(combined.row(row));
+            tSize += combined.row(row).ByteSize();
+        }
+        last = row >= rowCount;
+        if (task->msg->has_session()) {
+            result.set_session(task->msg->session());
+        }
+        result.set_queryid(task->getQueryId());
+        result.set_jobid(task->getJobId());
+        result.set_continues(!last);
+        result.set_largeresult(largeResult);
+        result.set_rowcount(msgRows);
+        result.set_transmitsize(tSize);
+        result.set_attemptcount(task->getAttemptCount());
+        if (combinedTasks != nullptr && !largeResult) {
+            for (auto const& other : *combinedTasks) {
+                if (other == task) continue;
+                proto::Result::CombinedJob* combinedJob = result.add_combinedjob();
+                combinedJob->set_jobid(other->getJobId());
+                combinedJob->set_attemptcount(other->getAttemptCount());
+            }
+        }
+        if (task == _task) {
+            for (auto const& span : _traceSpans) {
+                proto::TraceSpan* traceSpan = result.add_tracespan();
+                traceSpan->set_stage(span.stage);
+                traceSpan->set_start(span.start);
+                traceSpan->set_duration(span.duration);
+            }
+            _traceSpans.clear();
+        }
+        std::string body;
+        result.SerializeToString(&body);
+        std::string header = makeHeader(protoHeader, body, largeResult);
+
+        xrdsvc::StreamBuffer::Ptr headerBuf(xrdsvc::StreamBuffer::createWithMove(header));
+        xrdsvc::StreamBuffer::Ptr bodyBuf(xrdsvc::StreamBuffer::createWithMove(body));
+        if (!task->sendChannel->sendStream(headerBuf, false)) {
+            LOGS(_log, LOG_LVL_ERROR, task->getIdStr() << " Failed to transmit combined header!");
+            return false;
+        }
+        headerBuf->waitForDoneWithThis();
+        if (!task->sendChannel->sendStream(bodyBuf, last)) {
+            LOGS(_log, LOG_LVL_ERROR, task->getIdStr() << " Failed to transmit combined body!");
+            return false;
+        }
+        bodyBuf->waitForDoneWithThis();
+        transmitRows->add(msgRows);
+        transmitBytes->add(tSize);
+        largeResult = true;
+    }
+    return true;
+}
+
+void QueryRunner::_addTraceSpan(std::string const& stage, std::uint64_t start, double seconds) {
+    if (_task->getTraceId() == 0) return;
+    std::uint64_t const duration = static_cast<std::uint64_t>(seconds * 1e6);
+    // Repeated stages, e.g. one per subchunk query, are summed up.
+    for (auto& span : _traceSpans) {
+        if (span.stage == stage) {
+            span.duration += duration;
+            return;
+        }
+    }
+    _traceSpans.push_back(TraceSpan{stage, start, duration});
+}
+
 void QueryRunner::cancel() {
     LOGS(_log, LOG_LVL_WARN, "Trying QueryRunner::cancel() call");
     _cancelled.store(true);
@@ -35,7 +35,10 @@
 
 // System headers
 #include <atomic>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 // Qserv headers
 #include "mysql/MySqlConfig.h"
@@ -43,6 +46,8 @@
 #include "util/MultiError.h"
 #include "wbase/Task.h"
 #include "wdb/ChunkResource.h"
+#include "wdb/ResultCombiner.h"
+#include "wdb/ResultSpool.h"
 
 namespace lsst {
 namespace qserv {
@@ -53,7 +58,7 @@ class Result;
 }
 
 namespace util {
-class TimerHistogram;
+class MetricHistogram;
 }
 
 namespace xrdsvc {
@@ -66,6 +71,8 @@ namespace lsst {
 namespace qserv {
 namespace wdb {
 
+class SemiJoinFilter;
+
 /// On the worker, run a query related to a Task, writing the results to a table or supplied SendChannel.
 ///
 class QueryRunner : public wbase::TaskQueryRunner, public std::enable_shared_from_this<QueryRunner> {
@@ -73,7 +80,10 @@ public:
     using Ptr = std::shared_ptr<QueryRunner>;
     static QueryRunner::Ptr newQueryRunner(wbase::Task::Ptr const& task,
                                            ChunkResourceMgr::Ptr const& chunkResourceMgr,
-                                           mysql::MySqlConfig const& mySqlConfig);
+                                           mysql::MySqlConfig const& mySqlConfig,
+                                           ResultSpool::Config const& spoolConfig = ResultSpool::Config(),
+                                           ResultCombiner::Ptr const& resultCombiner = nullptr,
+                                           unsigned int semiJoinMaxKeys = 0);
     // Having more than one copy of this would making tracking its progress difficult.
     QueryRunner(QueryRunner const&) = delete;
     QueryRunner& operator=(QueryRunner const&) = delete;
@@ -82,27 +92,72 @@ public:
     bool runQuery() override;
     void cancel() override; ///< Cancel the action (in-progress)
 
+    /// Append a row of a MySQL result to 'result'.
+    /// @return the serialized size of the row.
+    static size_t appendRow(proto::Result& result, MYSQL_ROW row, unsigned long const* lengths,
+                            int numFields);
+
+    /// Fill 'protoHeader' for the serialized Result 'msg'.
+    /// @return the wrapped header to be sent ahead of 'msg'.
+    static std::string makeHeader(proto::ProtoHeader& protoHeader, std::string const& msg,
+                                  bool largeResult);
+
 protected:
     QueryRunner(wbase::Task::Ptr const& task,
                 ChunkResourceMgr::Ptr const& chunkResourceMgr,
-                mysql::MySqlConfig const& mySqlConfig);
+                mysql::MySqlConfig const& mySqlConfig,
+                ResultSpool::Config const& spoolConfig,
+                ResultCombiner::Ptr const& resultCombiner,
+                unsigned int semiJoinMaxKeys);
 private:
     bool _initConnection();
     void _setDb();
     bool _dispatchChannel(); ///< Dispatch with output sent through a SendChannel
     MYSQL_RES* _primeResult(std::string const& query); ///< Obtain a result handle for a query.
 
+    /// Select the keys of a semi-join, see SemiJoinFilter.
+    /// @return false if the key query failed or selected too many keys,
+    ///         the queries then run with the placeholder left in place.
+    bool _selectSemiJoinKeys(SemiJoinFilter const& filter, std::vector<std::string>& keys);
+
     bool _fillRows(MYSQL_RES* result, int numFields, uint& rowCount, size_t& tsize);
     void _fillSchema(MYSQL_RES* result);
     void _initMsgs();
     void _initMsg();
 
-    /// Send result 'streamBuf' to the czar. 'histo' and 'note' are for logging purposes only.
+    /// Send result 'streamBuf' to the czar. The send time is recorded in 'histo',
+    /// 'note' is for logging purposes only.
     void _sendBuf(std::shared_ptr<xrdsvc::StreamBuffer>& streamBuf, bool last,
-                  util::TimerHistogram& histo, std::string const& note);
+                  util::MetricHistogram& histo, std::string const& note);
     void _transmit(bool last, uint rowCount, size_t size);
+    /// Send _result as one message, _transmit() adds a message for trace spans.
+    void _transmitMsg(bool last, uint rowCount, size_t size);
     void _transmitHeader(std::string& msg);
 
+    /// @return true if 'resultString' was written to the spool instead of being sent.
+    bool _spoolResult(std::string const& resultString, bool last);
+
+    /// Send the spooled messages to the czar and drop the spool.
+    void _sendSpool();
+
+    /// @return true if the complete result was added to the rows combined
+    /// for the query, it's then sent by the last Task of the query leaving.
+    bool _combineResult(bool erred);
+
+    /// Leave the ResultCombiner and send the combined rows if this was the
+    /// last running Task of the query.
+    void _leaveCombiner();
+
+    /// Send the schema of 'combined' as the complete result of 'task', with the rows
+    /// and the jobs of 'combinedTasks' unless it's nullptr.
+    /// @return false if it couldn't be sent.
+    bool _sendCombined(wbase::Task::Ptr const& task, proto::Result const& combined,
+                       std::vector<wbase::Task::Ptr> const* combinedTasks);
+
+    /// Record time spent in a stage if the czar asked for trace spans,
+    /// the spans are sent with the next result message.
+    void _addTraceSpan(std::string const& stage, std::uint64_t start, double seconds);
+
     ///< Actual task
     wbase::Task::Ptr _task;
 
@@ -118,6 +173,25 @@ private:
     std::shared_ptr<proto::ProtoHeader> _protoHeader;
     std::shared_ptr<proto::Result> _result;
     bool _largeResult{false}; //< True for all transmits after the first transmit.
+
+    ResultSpool::Config const _spoolConfig;
+    ResultSpool::Ptr _spool; ///< Messages waiting to be sent after the query finished.
+    bool _spoolFailed{false}; ///< Set if the spool couldn't be used, messages are sent directly.
+    std::uint64_t _resultBytes{0}; ///< Serialized bytes of the result so far.
+
+    ResultCombiner::Ptr const _resultCombiner;
+    bool _combining{false}; ///< Set while this Task is joined to _resultCombiner.
+
+    /// Most keys a semi-join predicate is replaced by, 0 if it's never replaced.
+    unsigned int const _semiJoinMaxKeys;
+
+    /// Time spent in a stage, in microseconds.
+    struct TraceSpan {
+        std::string stage;
+        std::uint64_t start;
+        std::uint64_t duration;
+    };
+    std::vector<TraceSpan> _traceSpans; ///< Spans not yet sent to the czar.
 };
 
 }}} // namespace
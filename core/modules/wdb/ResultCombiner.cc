@@ -0,0 +1,384 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wdb/ResultCombiner.h"
+
+// System headers
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <mysql/mysql.h>
+#include <unordered_map>
+#include <utility>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "proto/worker.pb.h"
+#include "wbase/Task.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wdb.ResultCombiner");
+
+/// How the text of a MySQL column type is combined.
+enum class Kind { EXACT, FLOAT, TEMPORAL, OTHER };
+
+Kind kindOf(int mysqlType) {
+    switch (mysqlType) {
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_NEWDECIMAL:
+        return Kind::EXACT;
+    case MYSQL_TYPE_FLOAT:
+    case MYSQL_TYPE_DOUBLE:
+        return Kind::FLOAT;
+    case MYSQL_TYPE_YEAR:
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_NEWDATE:
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_TIMESTAMP:
+        // Fixed width text, ordered like the values.
+        return Kind::TEMPORAL;
+    default:
+        return Kind::OTHER;
+    }
+}
+
+/// @return true if 'op' can be applied to values of 'kind' outside of MySQL.
+/// String comparison depends on collations, those are left to the czar.
+bool canCombine(std::string const& op, Kind kind) {
+    if (op.empty()) return true;
+    if (op == "SUM") return kind == Kind::EXACT || kind == Kind::FLOAT;
+    if (op == "MIN" || op == "MAX") return kind != Kind::OTHER;
+    return false;
+}
+
+/// @return true if 's' is a plain decimal number, as MySQL prints exact types.
+bool isDecimal(std::string const& s) {
+    std::size_t i = (!s.empty() && (s[0] == '-' || s[0] == '+')) ? 1 : 0;
+    bool digits = false;
+    bool point = false;
+    for (; i < s.size(); ++i) {
+        if (s[i] >= '0' && s[i] <= '9') {
+            digits = true;
+        } else if (s[i] == '.' && !point) {
+            point = true;
+        } else {
+            return false;
+        }
+    }
+    return digits;
+}
+
+bool isFloat(std::string const& s) {
+    if (s.empty()) return false;
+    char* end = nullptr;
+    std::strtod(s.c_str(), &end);
+    return *end == '\0';
+}
+
+/// Exact decimal value: (negative ? -1 : 1) * digits * 10^-scale
+struct Decimal {
+    bool negative{false};
+    std::string digits;
+    std::size_t scale{0};
+};
+
+Decimal parseDecimal(std::string const& s) {
+    Decimal d;
+    std::size_t i = 0;
+    if (!s.empty() && (s[0] == '-' || s[0] == '+')) {
+        d.negative = s[0] == '-';
+        i = 1;
+    }
+    auto const point = s.find('.', i);
+    if (point == std::string::npos) {
+        d.digits = s.substr(i);
+    } else {
+        d.digits = s.substr(i, point - i) + s.substr(point + 1);
+        d.scale = s.size() - point - 1;
+    }
+    return d;
+}
+
+/// Pad the digits of 'a' and 'b' to the same scale and length.
+void align(Decimal& a, Decimal& b) {
+    if (a.scale < b.scale) a.digits.append(b.scale - a.scale, '0');
+    if (b.scale < a.scale) b.digits.append(a.scale - b.scale, '0');
+    a.scale = b.scale = std::max(a.scale, b.scale);
+    if (a.digits.size() < b.digits.size()) a.digits.insert(0, b.digits.size() - a.digits.size(), '0');
+    if (b.digits.size() < a.digits.size()) b.digits.insert(0, a.digits.size() - b.digits.size(), '0');
+}
+
+std::string formatDecimal(Decimal const& d) {
+    std::string digits = d.digits;
+    auto const first = digits.find_first_not_of('0');
+    bool const zero = first == std::string::npos;
+    // Keep one digit in front of the point.
+    std::size_t const keep = d.scale + 1;
+    if (digits.size() > keep) {
+        digits.erase(0, std::min(zero ? digits.size() : first, digits.size() - keep));
+    } else {
+        digits.insert(0, keep - digits.size(), '0');
+    }
+    if (d.scale > 0) digits.insert(digits.size() - d.scale, 1, '.');
+    return (d.negative && !zero) ? "-" + digits : digits;
+}
+
+/// @return the sum of two exact values, without loss of precision.
+std::string addExact(std::string const& x, std::string const& y) {
+    Decimal a = parseDecimal(x);
+    Decimal b = parseDecimal(y);
+    align(a, b);
+    Decimal r;
+    r.scale = a.scale;
+    if (a.negative != b.negative && a.digits == b.digits) {
+        r.digits = std::string(a.digits.size(), '0');
+    } else if (a.negative == b.negative) {
+        r.negative = a.negative;
+        r.digits.resize(a.digits.size() + 1);
+        int carry = 0;
+        for (std::size_t i = a.digits.size(); i > 0; --i) {
+            int const sum = (a.digits[i - 1] - '0') + (b.digits[i - 1] - '0') + carry;
+            r.digits[i] = '0' + sum % 10;
+            carry = sum / 10;
+        }
+        r.digits[0] = '0' + carry;
+    } else {
+        // Subtract the smaller magnitude from the larger one.
+        Decimal const* big = &a;
+        Decimal const* small = &b;
+        if (a.digits < b.digits) std::swap(big, small);
+        r.negative = big->negative;
+        r.digits.resize(a.digits.size());
+        int borrow = 0;
+        for (std::size_t i = a.digits.size(); i > 0; --i) {
+            int diff = (big->digits[i - 1] - '0') - (small->digits[i - 1] - '0') - borrow;
+            borrow = diff < 0 ? 1 : 0;
+            r.digits[i - 1] = '0' + diff + 10 * borrow;
+        }
+    }
+    return formatDecimal(r);
+}
+
+/// @return <0, 0, >0 if exact value 'x' is smaller, equal or larger than 'y'.
+int compareExact(std::string const& x, std::string const& y) {
+    Decimal a = parseDecimal(x);
+    Decimal b = parseDecimal(y);
+    align(a, b);
+    bool const aZero = a.digits.find_first_not_of('0') == std::string::npos;
+    bool const bZero = b.digits.find_first_not_of('0') == std::string::npos;
+    bool const aNeg = a.negative && !aZero;
+    bool const bNeg = b.negative && !bZero;
+    if (aNeg != bNeg) return aNeg ? -1 : 1;
+    int const cmp = a.digits.compare(b.digits);
+    return aNeg ? -cmp : cmp;
+}
+
+/// @return <0, 0, >0 if 'x' is smaller, equal or larger than 'y'.
+int compareValues(Kind kind, std::string const& x, std::string const& y) {
+    switch (kind) {
+    case Kind::EXACT:
+        return compareExact(x, y);
+    case Kind::FLOAT: {
+        double const a = std::strtod(x.c_str(), nullptr);
+        double const b = std::strtod(y.c_str(), nullptr);
+        return (a < b) ? -1 : (b < a) ? 1 : 0;
+    }
+    default:
+        return x.compare(y);
+    }
+}
+
+std::string sumValues(Kind kind, std::string const& x, std::string const& y) {
+    if (kind == Kind::EXACT) return addExact(x, y);
+    char buf[32];
+    double const sum = std::strtod(x.c_str(), nullptr) + std::strtod(y.c_str(), nullptr);
+    std::snprintf(buf, sizeof(buf), "%.17g", sum);
+    return buf;
+}
+
+/// Combine column 'i' of 'from' into 'into', NULLs are ignored like SQL aggregates do.
+void combineColumn(std::string const& op, Kind kind, int i,
+                   lsst::qserv::proto::RowBundle& into, lsst::qserv::proto::RowBundle const& from) {
+    if (from.isnull(i)) return;
+    if (into.isnull(i)) {
+        into.set_column(i, from.column(i));
+        into.set_isnull(i, false);
+        return;
+    }
+    std::string const& current = into.column(i);
+    std::string const& value = from.column(i);
+    if (op == "SUM") {
+        into.set_column(i, sumValues(kind, current, value));
+    } else if (op == "MIN") {
+        if (compareValues(kind, value, current) < 0) into.set_column(i, value);
+    } else if (op == "MAX") {
+        if (compareValues(kind, value, current) > 0) into.set_column(i, value);
+    }
+}
+
+/// @return the grouping key of 'row', made of all columns without an op.
+std::string groupKey(lsst::qserv::proto::RowBundle const& row, std::vector<std::string> const& ops) {
+    std::string key;
+    for (std::size_t i = 0; i < ops.size(); ++i) {
+        if (!ops[i].empty()) continue;
+        if (row.isnull(i)) {
+            key += 'N';
+        } else {
+            std::string const& value = row.column(i);
+            key += std::to_string(value.size());
+            key += ':';
+            key += value;
+        }
+    }
+    return key;
+}
+
+}
+
+namespace lsst {
+namespace qserv {
+namespace wdb {
+
+void ResultCombiner::join(QueryId queryId) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    ++_groups[queryId].running;
+}
+
+
+bool ResultCombiner::_compatible(Group const& group, proto::Result const& result,
+                                 std::vector<std::string> const& ops) {
+    auto const& schema = result.rowschema();
+    int const columns = schema.columnschema_size();
+    if (ops.empty() || static_cast<int>(ops.size()) != columns) return false;
+    if (!group.held.empty()) {
+        if (ops != group.ops) return false;
+        auto const& groupSchema = group.held.front().result->rowschema();
+        for (int i = 0; i < columns; ++i) {
+            if (groupSchema.columnschema(i).mysqltype() != schema.columnschema(i).mysqltype()) {
+                return false;
+            }
+        }
+    }
+    std::vector<Kind> kinds;
+    for (int i = 0; i < columns; ++i) {
+        kinds.push_back(kindOf(schema.columnschema(i).mysqltype()));
+        if (!canCombine(ops[i], kinds.back())) return false;
+    }
+    // Values are checked up front, so that failing leaves the group unchanged.
+    for (auto const& row : result.row()) {
+        if (row.column_size() != columns || row.isnull_size() != columns) return false;
+        for (int i = 0; i < columns; ++i) {
+            if (ops[i].empty() || row.isnull(i)) continue;
+            if (kinds[i] == Kind::EXACT && !isDecimal(row.column(i))) return false;
+            if (kinds[i] == Kind::FLOAT && !isFloat(row.column(i))) return false;
+        }
+    }
+    return true;
+}
+
+
+bool ResultCombiner::add(QueryId queryId, std::shared_ptr<wbase::Task> const& task,
+                         proto::Result const& result, std::vector<std::string> const& ops) {
+    if (!enabled()) return false;
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _groups.find(queryId);
+    if (iter == _groups.end()) return false;
+    Group& group = iter->second;
+    std::uint64_t const bytes = result.ByteSize();
+    if (group.bytes + bytes > _maxQueryBytes || !_compatible(group, result, ops)) {
+        LOGS(_log, LOG_LVL_DEBUG, "QID=" << queryId << " not combining a result of " << bytes << " bytes");
+        return false;
+    }
+    if (group.held.empty()) {
+        group.ops = ops;
+    }
+    // The rows are combined when the query leaves, a Task may be cancelled until then.
+    group.held.push_back(Held{task, std::make_shared<proto::Result>(result)});
+    group.bytes += bytes;
+    LOGS(_log, LOG_LVL_DEBUG, "QID=" << queryId << " holding " << result.row_size()
+         << " rows, tasks=" << group.held.size() << " bytes=" << group.bytes);
+    return true;
+}
+
+
+ResultCombiner::Flush ResultCombiner::_combine(Group const& group) {
+    Flush flush;
+    std::unordered_map<std::string, int> rowIndex; // Grouping key to row in flush.result.
+    for (auto const& held : group.held) {
+        if (held.task != nullptr && held.task->getCancelled()) {
+            LOGS(_log, LOG_LVL_DEBUG, held.task->getIdStr() << " cancelled, rows not combined");
+            continue;
+        }
+        if (flush.result == nullptr) {
+            flush.result = std::make_shared<proto::Result>();
+            flush.result->mutable_rowschema()->CopyFrom(held.result->rowschema());
+        }
+        auto const& schema = held.result->rowschema();
+        for (auto const& row : held.result->row()) {
+            std::string const key = groupKey(row, group.ops);
+            auto rowIter = rowIndex.find(key);
+            if (rowIter == rowIndex.end()) {
+                rowIndex.emplace(key, flush.result->row_size());
+                flush.result->add_row()->CopyFrom(row);
+                continue;
+            }
+            proto::RowBundle& into = *flush.result->mutable_row(rowIter->second);
+            for (std::size_t i = 0; i < group.ops.size(); ++i) {
+                if (group.ops[i].empty()) continue;
+                combineColumn(group.ops[i], kindOf(schema.columnschema(i).mysqltype()), i, into, row);
+            }
+        }
+        flush.tasks.push_back(held.task);
+    }
+    return flush;
+}
+
+
+ResultCombiner::Flush ResultCombiner::leave(QueryId queryId) {
+    Flush flush;
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _groups.find(queryId);
+    if (iter == _groups.end()) return flush;
+    Group& group = iter->second;
+    if (--group.running > 0) return flush;
+    flush = _combine(group);
+    _groups.erase(iter);
+    return flush;
+}
+
+
+std::size_t ResultCombiner::getQueryCount() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _groups.size();
+}
+
+}}} // namespace lsst::qserv::wdb
@@ -0,0 +1,145 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_QSERV_WDB_RESULTCOMBINER_H
+#define LSST_QSERV_WDB_RESULTCOMBINER_H
+ /**
+  * @file
+  *
+  * @brief ResultCombiner pre-aggregates the results of the Tasks of a
+  * user query on a worker.
+  */
+
+// System headers
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "global/intTypes.h"
+
+namespace lsst {
+namespace qserv {
+namespace proto {
+class Result;
+}
+namespace wbase {
+class Task;
+}}}
+
+namespace lsst {
+namespace qserv {
+namespace wdb {
+
+/// ResultCombiner merges the partial aggregates of Tasks of the same user
+/// query that run on this worker, so that the czar merges one set of rows
+/// instead of one per chunk.
+///
+/// Tasks join when they start running and leave when they are done. A Task
+/// with a small, complete result may add its rows instead of sending them,
+/// it then gets no response until the last running Task of the query leaves.
+/// The rows are combined then, leaving out those of cancelled Tasks, whose
+/// jobs the czar may run again. The last Task is handed the combined rows
+/// and the Tasks whose rows they hold: one of them carries the rows, the
+/// others get empty results. The czar still receives a response for every
+/// job.
+///
+/// Rows are grouped by all columns without a combine op, columns with an op
+/// are combined with SUM, MIN or MAX. This is correct as the czar merge
+/// groups by these columns (or expressions of them) and applies the same
+/// functions again.
+class ResultCombiner {
+public:
+    using Ptr = std::shared_ptr<ResultCombiner>;
+
+    /// What the last Task of a query leaving has to send.
+    struct Flush {
+        /// Schema and combined rows, nullptr if none.
+        std::shared_ptr<proto::Result> result;
+        /// Tasks whose rows are in 'result', none of them got a response yet.
+        /// Cancelled Tasks are not included.
+        std::vector<std::shared_ptr<wbase::Task>> tasks;
+    };
+
+    /// @param maxQueryBytes: limit of the rows kept per query, 0 disables combining.
+    static Ptr create(std::uint64_t maxQueryBytes) { return Ptr(new ResultCombiner(maxQueryBytes)); }
+
+    ResultCombiner(ResultCombiner const&) = delete;
+    ResultCombiner& operator=(ResultCombiner const&) = delete;
+
+    bool enabled() const { return _maxQueryBytes != 0; }
+
+    /// A Task of 'queryId' started running.
+    void join(QueryId queryId);
+
+    /// Keep the complete result of a Task which joined, to be combined with
+    /// the rows of its query. 'task' must not be sent a response before it's
+    /// returned in a Flush.
+    /// @param ops: combine op of each result column, see proto::TaskMsg::combineop
+    /// @return false if the rows can't be combined, nothing is changed then.
+    bool add(QueryId queryId, std::shared_ptr<wbase::Task> const& task,
+             proto::Result const& result, std::vector<std::string> const& ops);
+
+    /// A Task which joined is done.
+    /// @return the combined rows and the Tasks to answer if it was the last
+    ///         running Task of the query, otherwise an empty Flush.
+    Flush leave(QueryId queryId);
+
+    /// @return the number of queries with Tasks running.
+    std::size_t getQueryCount() const;
+
+private:
+    explicit ResultCombiner(std::uint64_t maxQueryBytes) : _maxQueryBytes(maxQueryBytes) {}
+
+    /// The result of a Task waiting for the rows of its query to be sent.
+    struct Held {
+        std::shared_ptr<wbase::Task> task;
+        std::shared_ptr<proto::Result> result;
+    };
+
+    struct Group {
+        int running{0};
+        std::vector<std::string> ops;
+        std::uint64_t bytes{0};
+        std::vector<Held> held;
+    };
+
+    /// @return false if 'result' can't be combined with the results of 'group'.
+    static bool _compatible(Group const& group, proto::Result const& result,
+                            std::vector<std::string> const& ops);
+
+    /// @return the rows of the Tasks of 'group' which are not cancelled.
+    static Flush _combine(Group const& group);
+
+    std::uint64_t const _maxQueryBytes;
+
+    mutable std::mutex _mtx; ///< protects _groups
+    std::map<QueryId, Group> _groups;
+};
+
+}}} // namespace lsst::qserv::wdb
+
+#endif // LSST_QSERV_WDB_RESULTCOMBINER_H
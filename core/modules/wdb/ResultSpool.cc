@@ -0,0 +1,125 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wdb/ResultSpool.h"
+
+// System headers
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <stdlib.h>
+#include <unistd.h>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wdb.ResultSpool");
+
+/// Write all of 'size' bytes at 'offset'.
+bool writeAll(int fd, char const* data, std::size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t const n = ::pwrite(fd, data, size, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+/// Read all of 'size' bytes at 'offset'.
+bool readAll(int fd, std::string& data, std::size_t size, off_t offset) {
+    data.resize(size);
+    std::size_t done = 0;
+    while (done < size) {
+        ssize_t const n = ::pread(fd, &data[done], size - done, offset + done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) return false; // unexpected end of file
+        done += n;
+    }
+    return true;
+}
+
+} // namespace
+
+namespace lsst {
+namespace qserv {
+namespace wdb {
+
+ResultSpool::Ptr ResultSpool::create(std::string const& dir, std::string const& name) {
+    std::string path = dir + "/" + name + "-XXXXXX";
+    std::vector<char> tmpl(path.begin(), path.end());
+    tmpl.push_back('\0');
+    int const fd = ::mkstemp(tmpl.data());
+    if (fd < 0) {
+        throw std::runtime_error("ResultSpool: failed to create a file in " + dir + ": "
+                                 + std::strerror(errno));
+    }
+    // Nobody else needs the file by name.
+    ::unlink(tmpl.data());
+    LOGS(_log, LOG_LVL_DEBUG, "ResultSpool created " << tmpl.data());
+    return Ptr(new ResultSpool(fd));
+}
+
+
+ResultSpool::~ResultSpool() {
+    ::close(_fd);
+}
+
+
+bool ResultSpool::append(std::string const& header, std::string const& body, bool last) {
+    Message const msg{_size, static_cast<std::uint32_t>(header.size()),
+                      static_cast<std::uint32_t>(body.size()), last};
+    if (not writeAll(_fd, header.data(), header.size(), _size)
+        or not writeAll(_fd, body.data(), body.size(), _size + header.size())) {
+        LOGS(_log, LOG_LVL_ERROR, "ResultSpool write failed: " << std::strerror(errno));
+        return false;
+    }
+    _size += header.size() + body.size();
+    _messages.push_back(msg);
+    return true;
+}
+
+
+bool ResultSpool::read(std::size_t i, std::string& header, std::string& body, bool& last) const {
+    if (i >= _messages.size()) return false;
+    Message const& msg = _messages[i];
+    if (not readAll(_fd, header, msg.headerSize, msg.offset)
+        or not readAll(_fd, body, msg.bodySize, msg.offset + msg.headerSize)) {
+        LOGS(_log, LOG_LVL_ERROR, "ResultSpool read failed: " << std::strerror(errno));
+        return false;
+    }
+    last = msg.last;
+    return true;
+}
+
+}}} // namespace lsst::qserv::wdb
@@ -0,0 +1,95 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_QSERV_WDB_RESULTSPOOL_H
+#define LSST_QSERV_WDB_RESULTSPOOL_H
+ /**
+  * @file
+  *
+  * @brief ResultSpool keeps the result messages of a Task in a local file
+  * until the czar reads them.
+  */
+
+// System headers
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace wdb {
+
+/// ResultSpool is an append-only local file holding result messages in
+/// their wire format (a wrapped ProtoHeader followed by the serialized Result).
+/// The file is unlinked as soon as it has been created, so its space is given
+/// back when the spool is destroyed or the worker exits.
+class ResultSpool {
+public:
+    using Ptr = std::shared_ptr<ResultSpool>;
+
+    /// Spooling configuration of a worker.
+    struct Config {
+        std::string dir;                  ///< Directory for spill files, empty disables spooling.
+        std::uint64_t thresholdBytes{0};  ///< Messages are spooled once a result exceeds this size.
+
+        bool enabled() const { return not dir.empty(); }
+    };
+
+    /// @return a new spool with a file in 'dir', 'name' is used as the file name prefix.
+    /// @throws std::runtime_error if the file can't be created.
+    static Ptr create(std::string const& dir, std::string const& name);
+
+    ResultSpool(ResultSpool const&) = delete;
+    ResultSpool& operator=(ResultSpool const&) = delete;
+    ~ResultSpool();
+
+    /// Append a message. 'last' marks the final message of the result.
+    /// @return false if the message could not be written completely.
+    bool append(std::string const& header, std::string const& body, bool last);
+
+    /// Read message 'i' back.
+    /// @return false on read errors.
+    bool read(std::size_t i, std::string& header, std::string& body, bool& last) const;
+
+    std::size_t getMessageCount() const { return _messages.size(); }
+    std::uint64_t getBytes() const { return _size; }
+
+private:
+    explicit ResultSpool(int fd) : _fd(fd) {}
+
+    struct Message {
+        std::uint64_t offset;
+        std::uint32_t headerSize;
+        std::uint32_t bodySize;
+        bool last;
+    };
+
+    int const _fd;
+    std::uint64_t _size{0}; ///< Bytes written to the file.
+    std::vector<Message> _messages;
+};
+
+}}} // namespace lsst::qserv::wdb
+
+#endif // LSST_QSERV_WDB_RESULTSPOOL_H
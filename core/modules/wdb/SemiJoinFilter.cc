@@ -0,0 +1,77 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wdb/SemiJoinFilter.h"
+
+// System headers
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+// Qserv headers
+#include "global/constants.h"
+
+namespace lsst {
+namespace qserv {
+namespace wdb {
+
+SemiJoinFilter::Ptr SemiJoinFilter::create(std::string const& column, std::string const& keyQuery) {
+    // Only run what the czar builds, see qana::SemiJoinPlugin.
+    static std::string const select = "SELECT DISTINCT ";
+    if (keyQuery.compare(0, select.size(), select) != 0) {
+        return nullptr;
+    }
+    if (column.empty() || not std::all_of(column.begin(), column.end(), [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$'
+                || c == '.' || c == '`';
+        })) {
+        return nullptr;
+    }
+    return Ptr(new SemiJoinFilter(column, keyQuery));
+}
+
+std::string SemiJoinFilter::apply(std::string const& query, std::vector<std::string> const& keys) const {
+    std::size_t const pos = query.find(SEMIJOIN_PREDICATE);
+    std::size_t const len = std::strlen(SEMIJOIN_PREDICATE);
+    if (pos == std::string::npos || query.find(SEMIJOIN_PREDICATE, pos + len) != std::string::npos) {
+        // The placeholder can't be told from a literal then, the query is
+        // correct as it is.
+        return query;
+    }
+    std::string predicate;
+    if (keys.empty()) {
+        // No row can match, MySQL doesn't even read the tables then.
+        predicate = "FALSE";
+    } else {
+        predicate = _column + " IN (";
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (i != 0) predicate += ",";
+            predicate += keys[i];
+        }
+        predicate += ")";
+    }
+    return query.substr(0, pos) + predicate + query.substr(pos + len);
+}
+
+}}} // namespace lsst::qserv::wdb
@@ -0,0 +1,83 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_QSERV_WDB_SEMIJOINFILTER_H
+#define LSST_QSERV_WDB_SEMIJOINFILTER_H
+ /**
+  * @file
+  *
+  * @brief SemiJoinFilter replaces the semi-join predicate placeholder of
+  * a worker query by the keys selected for it.
+  */
+
+// System headers
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace wdb {
+
+/// SemiJoinFilter is the semi-join which qana::SemiJoinPlugin adds to queries
+/// joining a director table with restrictions, as received in
+/// proto::TaskMsg::SemiJoin. The worker runs the key query on its own and
+/// replaces the SEMIJOIN_PREDICATE placeholder of the fragment queries by
+/// a test for the keys found, so that MySQL can look up the rows of the joined
+/// table by key instead of evaluating the join for all of them.
+class SemiJoinFilter {
+public:
+    using Ptr = std::shared_ptr<SemiJoinFilter>;
+
+    /// @param column: the column compared with the keys, e.g. "s.objectId".
+    /// @param keyQuery: the query selecting the keys.
+    /// @return the filter, nullptr unless 'column' is a column name and
+    ///         'keyQuery' a SELECT DISTINCT statement.
+    static Ptr create(std::string const& column, std::string const& keyQuery);
+
+    SemiJoinFilter(SemiJoinFilter const&) = delete;
+    SemiJoinFilter& operator=(SemiJoinFilter const&) = delete;
+
+    /// @return the column compared with the keys.
+    std::string const& getColumn() const { return _column; }
+
+    /// @return the query selecting the keys.
+    std::string const& getKeyQuery() const { return _keyQuery; }
+
+    /// @param query: a fragment query.
+    /// @param keys: SQL literals of the keys selected by the key query.
+    /// @return 'query' with its placeholder replaced by a test for 'keys',
+    ///         or 'query' unchanged unless it has exactly one placeholder.
+    std::string apply(std::string const& query, std::vector<std::string> const& keys) const;
+
+private:
+    SemiJoinFilter(std::string const& column, std::string const& keyQuery)
+        : _column(column), _keyQuery(keyQuery) {}
+
+    std::string const _column;
+    std::string const _keyQuery;
+};
+
+}}} // namespace lsst::qserv::wdb
+
+#endif // LSST_QSERV_WDB_SEMIJOINFILTER_H
@@ -0,0 +1,187 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/**
+ * @file
+ *
+ * @brief Test ResultCombiner.
+ */
+
+// System headers
+#include <map>
+#include <memory>
+#include <mysql/mysql.h>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "proto/worker.pb.h"
+#include "wbase/Task.h"
+#include "wdb/ResultCombiner.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE ResultCombiner
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::proto::Result;
+using lsst::qserv::proto::TaskMsg;
+using lsst::qserv::wbase::Task;
+using lsst::qserv::wdb::ResultCombiner;
+
+namespace {
+
+/// @return a result with columns of 'types' and rows of 'values', "NULL" is a null.
+Result makeResult(std::vector<int> const& types, std::vector<std::vector<std::string>> const& values) {
+    Result result;
+    for (auto type : types) {
+        auto cs = result.mutable_rowschema()->add_columnschema();
+        cs->set_deprecated_hasdefault(false);
+        cs->set_sqltype("");
+        cs->set_mysqltype(type);
+    }
+    for (auto const& row : values) {
+        auto bundle = result.add_row();
+        for (auto const& value : row) {
+            bool const isNull = value == "NULL";
+            bundle->add_column(isNull ? "" : value);
+            bundle->add_isnull(isNull);
+        }
+    }
+    return result;
+}
+
+Task::Ptr makeTask(int jobId) {
+    auto msg = std::make_shared<TaskMsg>();
+    msg->set_queryid(1);
+    msg->set_jobid(jobId);
+    msg->set_scaninteractive(false);
+    msg->set_attemptcount(0);
+    return std::make_shared<Task>(msg, nullptr);
+}
+
+/// @return the rows of 'result' by the value of their first column.
+std::map<std::string, std::vector<std::string>> rowsByKey(Result const& result) {
+    std::map<std::string, std::vector<std::string>> rows;
+    for (auto const& row : result.row()) {
+        std::vector<std::string> values;
+        for (int i = 0; i < row.column_size(); ++i) {
+            values.push_back(row.isnull(i) ? "NULL" : row.column(i));
+        }
+        rows[values[0]] = values;
+    }
+    return rows;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Combine) {
+    auto combiner = ResultCombiner::create(1000000);
+    std::vector<int> const types = {MYSQL_TYPE_VAR_STRING, MYSQL_TYPE_LONGLONG, MYSQL_TYPE_NEWDECIMAL,
+                                    MYSQL_TYPE_DOUBLE, MYSQL_TYPE_DATETIME};
+    std::vector<std::string> const ops = {"", "SUM", "SUM", "MIN", "MAX"};
+    combiner->join(7);
+    combiner->join(7);
+    BOOST_CHECK_EQUAL(combiner->getQueryCount(), 1U);
+
+    auto r1 = makeResult(types, {{"a", "3", "1.50", "2.5", "2018-01-02 00:00:00"},
+                                 {"b", "1", "-0.25", "NULL", "NULL"}});
+    auto r2 = makeResult(types, {{"a", "9999999999999999999", "-2.75", "-1e3", "2017-12-31 23:59:59"},
+                                 {"c", "2", "0.00", "4", "2018-01-01 00:00:00"}});
+    BOOST_REQUIRE(combiner->add(7, nullptr, r1, ops));
+    BOOST_CHECK(combiner->leave(7).tasks.empty());
+    BOOST_REQUIRE(combiner->add(7, nullptr, r2, ops));
+    auto flush = combiner->leave(7);
+    BOOST_CHECK_EQUAL(flush.tasks.size(), 2U);
+    BOOST_REQUIRE(flush.result != nullptr);
+    BOOST_CHECK_EQUAL(flush.result->rowschema().columnschema_size(), 5);
+    BOOST_CHECK_EQUAL(combiner->getQueryCount(), 0U);
+
+    auto rows = rowsByKey(*flush.result);
+    BOOST_REQUIRE_EQUAL(rows.size(), 3U);
+    std::vector<std::string> const a = {"a", "10000000000000000002", "-1.25", "-1e3", "2018-01-02 00:00:00"};
+    std::vector<std::string> const b = {"b", "1", "-0.25", "NULL", "NULL"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(rows["a"].begin(), rows["a"].end(), a.begin(), a.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(rows["b"].begin(), rows["b"].end(), b.begin(), b.end());
+}
+
+BOOST_AUTO_TEST_CASE(Sums) {
+    auto combiner = ResultCombiner::create(1000000);
+    std::vector<int> const types = {MYSQL_TYPE_NEWDECIMAL};
+    std::vector<std::string> const ops = {"SUM"};
+    std::vector<std::string> const values = {"0.5", "-1.25", "100", "-99.25", "0.005"};
+    combiner->join(1);
+    for (auto const& value : values) {
+        BOOST_REQUIRE(combiner->add(1, nullptr, makeResult(types, {{value}}), ops));
+    }
+    auto flush = combiner->leave(1);
+    BOOST_REQUIRE_EQUAL(flush.result->row_size(), 1);
+    BOOST_CHECK_EQUAL(flush.result->row(0).column(0), "0.005");
+}
+
+BOOST_AUTO_TEST_CASE(Cancelled) {
+    // The czar may run a cancelled job again, its rows are left out.
+    auto combiner = ResultCombiner::create(1000000);
+    std::vector<int> const types = {MYSQL_TYPE_LONGLONG, MYSQL_TYPE_LONGLONG};
+    std::vector<std::string> const ops = {"", "SUM"};
+    auto t1 = makeTask(1);
+    auto t2 = makeTask(2);
+    combiner->join(1);
+    BOOST_REQUIRE(combiner->add(1, t1, makeResult(types, {{"1", "10"}, {"2", "20"}}), ops));
+    BOOST_REQUIRE(combiner->add(1, t2, makeResult(types, {{"1", "5"}}), ops));
+    t2->cancel();
+    auto flush = combiner->leave(1);
+    BOOST_REQUIRE_EQUAL(flush.tasks.size(), 1U);
+    BOOST_CHECK(flush.tasks[0] == t1);
+    BOOST_REQUIRE(flush.result != nullptr);
+    auto rows = rowsByKey(*flush.result);
+    BOOST_REQUIRE_EQUAL(rows.size(), 2U);
+    BOOST_CHECK_EQUAL(rows["1"][1], "10");
+    BOOST_CHECK_EQUAL(rows["2"][1], "20");
+}
+
+BOOST_AUTO_TEST_CASE(NotCombined) {
+    auto combiner = ResultCombiner::create(1000000);
+    combiner->join(1);
+    // No combine ops, or not matching the columns.
+    auto r = makeResult({MYSQL_TYPE_LONGLONG}, {{"1"}});
+    BOOST_CHECK(not combiner->add(1, nullptr, r, {}));
+    BOOST_CHECK(not combiner->add(1, nullptr, r, {"", "SUM"}));
+    // Strings compare by collation.
+    BOOST_CHECK(not combiner->add(1, nullptr, makeResult({MYSQL_TYPE_VAR_STRING}, {{"x"}}), {"MIN"}));
+    // The query never joined.
+    BOOST_CHECK(not combiner->add(2, nullptr, r, {"SUM"}));
+    // Too large.
+    auto small = ResultCombiner::create(10);
+    small->join(1);
+    BOOST_CHECK(not small->add(1, nullptr, makeResult({MYSQL_TYPE_LONGLONG}, {{"1"}, {"2"}, {"3"}}), {""}));
+    BOOST_CHECK(small->leave(1).result == nullptr);
+
+    auto flush = combiner->leave(1);
+    BOOST_CHECK(flush.result == nullptr);
+    BOOST_CHECK(flush.tasks.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
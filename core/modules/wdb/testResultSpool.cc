@@ -0,0 +1,74 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/**
+ * @file
+ *
+ * @brief Test ResultSpool.
+ */
+
+// System headers
+#include <stdexcept>
+#include <string>
+
+// Qserv headers
+#include "wdb/ResultSpool.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE ResultSpool
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::wdb::ResultSpool;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(AppendRead) {
+    auto spool = ResultSpool::create("/tmp", "testResultSpool");
+    BOOST_CHECK_EQUAL(spool->getMessageCount(), 0U);
+
+    std::string const body(100000, 'b');
+    BOOST_REQUIRE(spool->append("header1", body, false));
+    BOOST_REQUIRE(spool->append("header2", "", true));
+    BOOST_CHECK_EQUAL(spool->getMessageCount(), 2U);
+    BOOST_CHECK_EQUAL(spool->getBytes(), 14U + body.size());
+
+    std::string header, data;
+    bool last = true;
+    BOOST_REQUIRE(spool->read(0, header, data, last));
+    BOOST_CHECK_EQUAL(header, "header1");
+    BOOST_CHECK(data == body);
+    BOOST_CHECK(not last);
+    BOOST_REQUIRE(spool->read(1, header, data, last));
+    BOOST_CHECK_EQUAL(header, "header2");
+    BOOST_CHECK(data.empty());
+    BOOST_CHECK(last);
+    BOOST_CHECK(not spool->read(2, header, data, last));
+}
+
+BOOST_AUTO_TEST_CASE(BadDirectory) {
+    BOOST_CHECK_THROW(ResultSpool::create("/nonexistent/dir", "testResultSpool"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
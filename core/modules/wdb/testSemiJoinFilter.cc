@@ -0,0 +1,83 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/**
+ * @file
+ *
+ * @brief Test SemiJoinFilter.
+ */
+
+// System headers
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "wdb/SemiJoinFilter.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE SemiJoinFilter
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::wdb::SemiJoinFilter;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Create) {
+    std::string const keyQuery = "SELECT DISTINCT o.objectId FROM LSST.Object_100 AS o WHERE (o.foo>1)";
+    auto filter = SemiJoinFilter::create("s.objectId", keyQuery);
+    BOOST_REQUIRE(filter != nullptr);
+    BOOST_CHECK_EQUAL(filter->getColumn(), "s.objectId");
+    BOOST_CHECK_EQUAL(filter->getKeyQuery(), keyQuery);
+    BOOST_CHECK(SemiJoinFilter::create("`s`.`objectId`", keyQuery) != nullptr);
+
+    BOOST_CHECK(SemiJoinFilter::create("", keyQuery) == nullptr);
+    BOOST_CHECK(SemiJoinFilter::create("s.objectId) OR (1", keyQuery) == nullptr);
+    BOOST_CHECK(SemiJoinFilter::create("s.objectId", "DELETE FROM LSST.Object_100") == nullptr);
+    BOOST_CHECK(SemiJoinFilter::create("s.objectId", "SELECT o.objectId FROM LSST.Object_100 AS o") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Apply) {
+    auto filter = SemiJoinFilter::create("s.objectId",
+        "SELECT DISTINCT o.objectId FROM LSST.Object_100 AS o WHERE (o.foo>1)");
+    BOOST_REQUIRE(filter != nullptr);
+    std::string const prefix = "SELECT s.ra,o.foo FROM LSST.Object_100 AS o,LSST.Source_100 AS s WHERE ";
+    std::string const suffix = " AND s.objectId=o.objectId AND o.foo>1";
+    std::string const query = prefix + "/*qserv_semijoin*/ TRUE" + suffix;
+    BOOST_CHECK_EQUAL(filter->apply(query, {"1", "5", "7"}), prefix + "s.objectId IN (1,5,7)" + suffix);
+    BOOST_CHECK_EQUAL(filter->apply(query, {}), prefix + "FALSE" + suffix);
+}
+
+BOOST_AUTO_TEST_CASE(NoPlaceholder) {
+    auto filter = SemiJoinFilter::create("s.objectId",
+        "SELECT DISTINCT o.objectId FROM LSST.Object_100 AS o WHERE (o.foo>1)");
+    BOOST_REQUIRE(filter != nullptr);
+    std::string query = "SELECT * FROM LSST.Source_100 AS s WHERE s.foo>1";
+    BOOST_CHECK_EQUAL(filter->apply(query, {"1"}), query);
+    // A literal with the placeholder text is left alone, and so is the query.
+    query = "SELECT * FROM LSST.Source_100 AS s WHERE /*qserv_semijoin*/ TRUE "
+        "AND s.name='/*qserv_semijoin*/ TRUE'";
+    BOOST_CHECK_EQUAL(filter->apply(query, {"1"}), query);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
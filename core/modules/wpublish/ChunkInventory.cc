@@ -424,9 +424,8 @@ ChunkInventory::ExistMap operator-(ChunkInventory const& lhs, ChunkInventory con
         string const& db = entry.first;
         ChunkInventory::ChunkMap const& chunks = entry.second;
         if (rhs_existMap.count(db)) {
-            for (int chunk: chunks)
-                if (not rhs_existMap.at(db).count(chunk))
-                    result[db].insert(chunk);   // this chunk was missing
+            ChunkInventory::ChunkMap missing = chunks - rhs_existMap.at(db);
+            if (not missing.empty()) result[db] = std::move(missing);
         } else
             result[db] = chunks;    // the whole database was missing
     }
@@ -29,13 +29,13 @@
 #include <memory>
 #include <mutex>
 #include <ostream>
-#include <set>
 #include <stdexcept>
 #include <string>
 
 // Qserv headers
 #include "global/ResourceUnit.h"
 #include "mysql/MySqlConfig.h"
+#include "util/ChunkSet.h"
 
 // Forward declarations
 namespace lsst {
@@ -75,8 +75,7 @@ class ChunkInventory {
 
 public:
 
-    // These should be converted to unordered_* with C++11
-    typedef std::set<int> ChunkMap;
+    typedef util::ChunkSet ChunkMap;
     typedef std::map<std::string, ChunkMap> ExistMap;
 
     typedef std::shared_ptr<ChunkInventory>       Ptr;
@@ -0,0 +1,478 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/**
+ * @file
+ *
+ * @brief Offline micro-benchmarks of the worker internals.
+ *
+ * Nothing is sent over the network and no MySQL server is needed:
+ *   scheduler - BlendScheduler and ChunkTasksQueue enqueue/dispatch of synthetic Tasks
+ *   memman    - MemManReal prepare/lock/unlock over sparse table files
+ *   rows      - QueryRunner row packing, Result serialization, header and StreamBuffer
+ *               creation for synthetic MySQL rows
+ *
+ * Each benchmark prints one JSON object per line on the standard output.
+ */
+
+// System headers
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// Third party headers
+#include "nlohmann/json.hpp"
+
+// Qserv headers
+#include "global/version.h"
+#include "memman/MemMan.h"
+#include "memman/MemManNone.h"
+#include "proto/ProtoHeaderWrap.h"
+#include "proto/ScanTableInfo.h"
+#include "proto/worker.pb.h"
+#include "util/CmdLineParser.h"
+#include "wbase/Task.h"
+#include "wdb/QueryRunner.h"
+#include "wpublish/QueriesAndChunks.h"
+#include "wsched/BlendScheduler.h"
+#include "wsched/ChunkTasksQueue.h"
+#include "wsched/GroupScheduler.h"
+#include "wsched/ScanScheduler.h"
+#include "xrdsvc/StreamBuffer.h"
+
+namespace memman   = lsst::qserv::memman;
+namespace proto    = lsst::qserv::proto;
+namespace util     = lsst::qserv::util;
+namespace wbase    = lsst::qserv::wbase;
+namespace wdb      = lsst::qserv::wdb;
+namespace wpublish = lsst::qserv::wpublish;
+namespace wsched   = lsst::qserv::wsched;
+namespace xrdsvc   = lsst::qserv::xrdsvc;
+
+using namespace std;
+
+namespace {
+
+// Command line parameters
+
+string benchmarks;
+unsigned int numTasks;
+unsigned int numChunks;
+unsigned int numTables;
+unsigned int fileMB;
+unsigned int memMB;
+string dataDir;
+unsigned int numRows;
+unsigned int numColumns;
+unsigned int columnWidth;
+
+
+class Stopwatch {
+public:
+    Stopwatch() : _start(chrono::steady_clock::now()) {}
+    double seconds() const {
+        return chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+    }
+private:
+    chrono::steady_clock::time_point _start;
+};
+
+
+double perSecond(double count, double seconds) {
+    return seconds > 0 ? count / seconds : 0;
+}
+
+
+/// Print a benchmark result as a single line of JSON.
+void report(string const& name, nlohmann::json const& params, nlohmann::json const& results) {
+    nlohmann::json out;
+    out["benchmark"] = name;
+    out["version"] = QSERV_SOURCE_VERSION;
+    out["params"] = params;
+    out["results"] = results;
+    cout << out.dump() << endl;
+}
+
+
+wbase::Task::Ptr makeScanTask(lsst::qserv::QueryId queryId, int jobId, int chunkId, int rating) {
+    auto taskMsg = make_shared<proto::TaskMsg>();
+    taskMsg->set_session(1);
+    taskMsg->set_queryid(queryId);
+    taskMsg->set_jobid(jobId);
+    taskMsg->set_chunkid(chunkId);
+    taskMsg->set_db("bench");
+    taskMsg->set_scanpriority(rating);
+    auto fragment = taskMsg->add_fragment();
+    fragment->add_query("SELECT * FROM bench.Object_CHUNK");
+    fragment->set_resulttable("r_bench");
+    auto scanTable = taskMsg->add_scantable();
+    scanTable->set_db("bench");
+    scanTable->set_table("Object");
+    scanTable->set_scanrating(rating);
+    scanTable->set_lockinmemory(true);
+    auto task = make_shared<wbase::Task>(taskMsg, shared_ptr<wbase::SendChannel>());
+    task->setSafeToMoveRunning(true); // MemManNone, no need to wait for memory.
+    return task;
+}
+
+
+/// Synthetic scan Tasks spread over the chunks and the scan ratings of all
+/// shared scan schedulers. Each query has one Task per chunk.
+vector<wbase::Task::Ptr> makeScanTasks() {
+    int const ratings[] = {proto::ScanInfo::Rating::FASTEST, proto::ScanInfo::Rating::FAST,
+                           proto::ScanInfo::Rating::MEDIUM, proto::ScanInfo::Rating::SLOW};
+    vector<wbase::Task::Ptr> tasks;
+    tasks.reserve(numTasks);
+    for (unsigned int i = 0; i < numTasks; ++i) {
+        lsst::qserv::QueryId const queryId = 1 + i / numChunks;
+        tasks.push_back(makeScanTask(queryId, i % numChunks, i % numChunks, ratings[queryId % 4]));
+    }
+    return tasks;
+}
+
+
+void benchScheduler() {
+    nlohmann::json params;
+    params["tasks"] = numTasks;
+    params["chunks"] = numChunks;
+
+    // BlendScheduler set up like in the worker with default configuration values.
+    auto memMan = make_shared<memman::MemManNone>(1, true);
+    int const maxThreads = 20;
+    int const maxActiveChunks = 20;
+    int priority = 2;
+    int const fast   = proto::ScanInfo::Rating::FAST;
+    int const medium = proto::ScanInfo::Rating::MEDIUM;
+    int const slow   = proto::ScanInfo::Rating::SLOW;
+    auto queries = make_shared<wpublish::QueriesAndChunks>(chrono::seconds(600), chrono::seconds(0), 5);
+    auto group = make_shared<wsched::GroupScheduler>("GroupSched", maxThreads, 2, 3, priority++);
+    auto scanFast = make_shared<wsched::ScanScheduler>("ScanFast", maxThreads, 3, priority++,
+            maxActiveChunks, memMan, proto::ScanInfo::Rating::FASTEST, fast, 60.0);
+    auto scanMed = make_shared<wsched::ScanScheduler>("ScanMed", maxThreads, 2, priority++,
+            maxActiveChunks, memMan, fast + 1, medium, 60.0);
+    auto scanSlow = make_shared<wsched::ScanScheduler>("ScanSlow", maxThreads, 2, priority++,
+            maxActiveChunks, memMan, medium + 1, slow, 60.0);
+    vector<wsched::ScanScheduler::Ptr> scanSchedulers{scanFast, scanMed};
+    auto blend = make_shared<wsched::BlendScheduler>("BlendSched", queries, maxThreads,
+                                                     group, scanSlow, scanSchedulers);
+    queries->setBlendScheduler(blend);
+
+    auto tasks = makeScanTasks();
+    Stopwatch enqueueTime;
+    for (auto const& task : tasks) {
+        queries->addTask(task);
+        blend->queCmd(task);
+    }
+    double const enqueueSeconds = enqueueTime.seconds();
+
+    // Run the Tasks the way util::ThreadPool does, with no time spent in them.
+    unsigned int dispatched = 0;
+    Stopwatch dispatchTime;
+    while (dispatched < numTasks) {
+        auto cmd = blend->getCmd(false);
+        if (cmd == nullptr) break;
+        blend->commandStart(cmd);
+        blend->commandFinish(cmd);
+        ++dispatched;
+    }
+    double const dispatchSeconds = dispatchTime.seconds();
+
+    nlohmann::json results;
+    results["enqueued_per_sec"] = perSecond(numTasks, enqueueSeconds);
+    results["dispatched"] = dispatched;
+    results["dispatched_per_sec"] = perSecond(dispatched, dispatchSeconds);
+    report("scheduler.blend", params, results);
+
+    // ChunkTasksQueue on its own, as used by each ScanScheduler.
+    wsched::ChunkTasksQueue chunkTasksQueue(nullptr, memMan);
+    tasks = makeScanTasks();
+    enqueueTime = Stopwatch();
+    for (auto const& task : tasks) {
+        chunkTasksQueue.queueTask(task);
+    }
+    double const queueSeconds = enqueueTime.seconds();
+    dispatched = 0;
+    dispatchTime = Stopwatch();
+    while (dispatched < numTasks) {
+        auto task = chunkTasksQueue.getTask(true);
+        if (task == nullptr) break;
+        chunkTasksQueue.taskComplete(task);
+        ++dispatched;
+    }
+    double const getSeconds = dispatchTime.seconds();
+
+    results = nlohmann::json();
+    results["enqueued_per_sec"] = perSecond(numTasks, queueSeconds);
+    results["dispatched"] = dispatched;
+    results["dispatched_per_sec"] = perSecond(dispatched, getSeconds);
+    report("scheduler.chunkTasksQueue", params, results);
+}
+
+
+void benchMemMan() {
+    nlohmann::json params;
+    params["chunks"] = numChunks;
+    params["tables"] = numTables;
+    params["file_mb"] = fileMB;
+    params["mem_mb"] = memMB;
+
+    // Sparse files named the way MySQL stores chunk tables.
+    string const root = dataDir + "/qserv-worker-bench-" + to_string(getpid());
+    string const dbDir = root + "/bench";
+    vector<string> files;
+    auto cleanup = [&]() {
+        for (auto const& file : files) unlink(file.c_str());
+        rmdir(dbDir.c_str());
+        rmdir(root.c_str());
+    };
+    if (mkdir(root.c_str(), 0700) != 0 or mkdir(dbDir.c_str(), 0700) != 0) {
+        cleanup();
+        throw runtime_error("failed to create " + dbDir);
+    }
+    vector<memman::TableInfo> tables;
+    for (unsigned int t = 0; t < numTables; ++t) {
+        string const table = "Table" + to_string(t);
+        tables.emplace_back("bench/" + table);
+        for (unsigned int chunk = 0; chunk < numChunks; ++chunk) {
+            string const file = dbDir + "/" + table + "_" + to_string(chunk) + ".MYD";
+            int const fd = open(file.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0600);
+            if (fd >= 0) files.push_back(file);
+            if (fd < 0 or ftruncate(fd, off_t(fileMB) * 1048576) != 0) {
+                if (fd >= 0) close(fd);
+                cleanup();
+                throw runtime_error("failed to create " + file);
+            }
+            close(fd);
+        }
+    }
+
+    shared_ptr<memman::MemMan> memMan(memman::MemMan::create(uint64_t(memMB) * 1048576, root));
+    double prepareSeconds = 0, lockSeconds = 0, unlockSeconds = 0;
+    unsigned int locked = 0;
+    for (unsigned int chunk = 0; chunk < numChunks; ++chunk) {
+        Stopwatch prepareTime;
+        auto handle = memMan->prepare(tables, chunk);
+        prepareSeconds += prepareTime.seconds();
+        if (handle == memman::MemMan::HandleType::INVALID) continue;
+        Stopwatch lockTime;
+        if (memMan->lock(handle, true) == 0) ++locked;
+        lockSeconds += lockTime.seconds();
+        Stopwatch unlockTime;
+        memMan->unlock(handle);
+        unlockSeconds += unlockTime.seconds();
+    }
+    auto const stats = memMan->getStatistics();
+    memMan.reset();
+    cleanup();
+
+    nlohmann::json results;
+    results["locked"] = locked;
+    results["prepare_ms"] = prepareSeconds * 1000 / numChunks;
+    results["lock_ms"] = lockSeconds * 1000 / numChunks;
+    results["unlock_ms"] = unlockSeconds * 1000 / numChunks;
+    results["lock_mb_per_sec"] = perSecond(double(locked) * numTables * fileMB, lockSeconds);
+    results["map_errors"] = stats.numMapErrors;
+    results["lock_errors"] = stats.numLokErrors;
+    report("memman", params, results);
+}
+
+
+void benchRows() {
+    nlohmann::json params;
+    params["rows"] = numRows;
+    params["columns"] = numColumns;
+    params["width"] = columnWidth;
+
+    // A synthetic MYSQL_ROW, the first column is a row number.
+    string const text(columnWidth, 'x');
+    vector<string> values(numColumns, text);
+    vector<char*> row(numColumns);
+    vector<unsigned long> lengths(numColumns);
+    for (unsigned int i = 0; i < numColumns; ++i) {
+        row[i] = &values[i][0];
+        lengths[i] = values[i].size();
+    }
+    string rowNumber;
+
+    size_t const szLimit = min(proto::ProtoHeaderWrap::PROTOBUFFER_DESIRED_LIMIT,
+                               proto::ProtoHeaderWrap::PROTOBUFFER_HARD_LIMIT);
+    double fillSeconds = 0, serializeSeconds = 0, headerSeconds = 0, bufferSeconds = 0;
+    uint64_t bytes = 0;
+    unsigned int messages = 0;
+    bool largeResult = false;
+    proto::ProtoHeader protoHeader;
+    auto result = make_shared<proto::Result>();
+
+    // Same steps as QueryRunner::_transmit() and _transmitHeader()
+    auto transmit = [&]() {
+        Stopwatch serializeTime;
+        string resultString;
+        result->set_continues(true);
+        result->set_largeresult(largeResult);
+        result->SerializeToString(&resultString);
+        serializeSeconds += serializeTime.seconds();
+        Stopwatch headerTime;
+        string header = wdb::QueryRunner::makeHeader(protoHeader, resultString, largeResult);
+        headerSeconds += headerTime.seconds();
+        bytes += header.size() + resultString.size();
+        Stopwatch bufferTime;
+        for (auto str : {&header, &resultString}) {
+            // XrdSsi calls Recycle() once the buffer has been sent.
+            auto streamBuf = xrdsvc::StreamBuffer::createWithMove(*str);
+            streamBuf->Recycle();
+        }
+        bufferSeconds += bufferTime.seconds();
+        result = make_shared<proto::Result>();
+        largeResult = true;
+        ++messages;
+    };
+
+    size_t tSize = 0;
+    Stopwatch totalTime;
+    Stopwatch fillTime;
+    for (unsigned int j = 0; j < numRows; ++j) {
+        if (numColumns > 0) {
+            rowNumber = to_string(j);
+            row[0] = &rowNumber[0];
+            lengths[0] = rowNumber.size();
+        }
+        tSize += wdb::QueryRunner::appendRow(*result, row.data(), lengths.data(), numColumns);
+        if (tSize > szLimit) {
+            fillSeconds += fillTime.seconds();
+            transmit();
+            tSize = 0;
+            fillTime = Stopwatch();
+        }
+    }
+    fillSeconds += fillTime.seconds();
+    transmit();
+    double const totalSeconds = totalTime.seconds();
+
+    nlohmann::json results;
+    results["messages"] = messages;
+    results["bytes"] = bytes;
+    results["rows_per_sec"] = perSecond(numRows, totalSeconds);
+    results["mb_per_sec"] = perSecond(bytes / 1048576., totalSeconds);
+    results["fill_sec"] = fillSeconds;
+    results["serialize_sec"] = serializeSeconds;
+    results["header_sec"] = headerSeconds;
+    results["buffer_sec"] = bufferSeconds;
+    report("rows", params, results);
+}
+
+
+int test() {
+    vector<string> const known = {"scheduler", "memman", "rows"};
+    vector<string> selected;
+    if (benchmarks == "all") {
+        selected = known;
+    } else {
+        string::size_type pos = 0;
+        while (pos != string::npos) {
+            auto const next = benchmarks.find(',', pos);
+            selected.push_back(benchmarks.substr(pos, next == string::npos ? next : next - pos));
+            pos = (next == string::npos) ? next : next + 1;
+        }
+    }
+    for (auto const& name : selected) {
+        if (not util::CmdLineParser::in(name, known)) {
+            cerr << "error: unknown benchmark: " << name << endl;
+            return 1;
+        }
+    }
+    for (auto const& name : selected) {
+        if      (name == "scheduler") benchScheduler();
+        else if (name == "memman")    benchMemMan();
+        else if (name == "rows")      benchRows();
+    }
+    return 0;
+}
+} // namespace
+
+
+int main(int argc, const char* const argv[]) {
+
+    // Verify that the version of the library that we linked against is
+    // compatible with the version of the headers we compiled against.
+
+    GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+    // Parse command line parameters
+    try {
+        util::CmdLineParser parser(
+            argc,
+            argv,
+            "\n"
+            "Usage:\n"
+            "  [--bench=<names>]\n"
+            "  [--tasks=<value>]\n"
+            "  [--chunks=<value>]\n"
+            "  [--tables=<value>]\n"
+            "  [--file-mb=<value>]\n"
+            "  [--mem-mb=<value>]\n"
+            "  [--dir=<path>]\n"
+            "  [--rows=<value>]\n"
+            "  [--columns=<value>]\n"
+            "  [--width=<value>]\n"
+            "\n"
+            "Flags and options:\n"
+            "  --bench=<names>     - comma-separated list of benchmarks: scheduler, memman, rows\n"
+            "                        (default: 'all')\n"
+            "  --tasks=<value>     - the number of Tasks for the scheduler benchmark (default: 100000)\n"
+            "  --chunks=<value>    - the number of chunks (default: 1000)\n"
+            "  --tables=<value>    - the number of tables per chunk for the memman benchmark (default: 2)\n"
+            "  --file-mb=<value>   - the size of each sparse table file (default: 16)\n"
+            "  --mem-mb=<value>    - memory available to memman (default: 1024)\n"
+            "  --dir=<path>        - a directory for temporary table files (default: '/tmp')\n"
+            "  --rows=<value>      - the number of rows for the rows benchmark (default: 1000000)\n"
+            "  --columns=<value>   - the number of columns per row (default: 10)\n"
+            "  --width=<value>     - the width of each column value (default: 16)\n");
+
+        ::benchmarks  = parser.option<string>("bench", "all");
+        ::numTasks    = parser.option<unsigned int>("tasks", 100000);
+        ::numChunks   = max(1U, parser.option<unsigned int>("chunks", 1000));
+        ::numTables   = max(1U, parser.option<unsigned int>("tables", 2));
+        ::fileMB      = parser.option<unsigned int>("file-mb", 16);
+        ::memMB       = parser.option<unsigned int>("mem-mb", 1024);
+        ::dataDir     = parser.option<string>("dir", "/tmp");
+        ::numRows     = parser.option<unsigned int>("rows", 1000000);
+        ::numColumns  = parser.option<unsigned int>("columns", 10);
+        ::columnWidth = parser.option<unsigned int>("width", 16);
+
+    } catch (exception const& ex) {
+        return 1;
+    }
+    try {
+        return ::test();
+    } catch (exception const& ex) {
+        cerr << "benchmark failed: " << ex.what() << endl;
+        return 1;
+    }
+}
@@ -41,12 +41,15 @@
 // Qserv headers
 #include "memman/MemMan.h"
 #include "memman/MemManNone.h"
+#include "metrics/MetricsServer.h"
 #include "mysql/MySqlConnection.h"
 #include "sql/SqlConnection.h"
+#include "util/Metrics.h"
 #include "wbase/Base.h"
 #include "wconfig/WorkerConfig.h"
 #include "wconfig/WorkerConfigError.h"
 #include "wcontrol/Foreman.h"
+#include "wdb/ResultSpool.h"
 #include "wpublish/ChunkInventory.h"
 #include "wsched/BlendScheduler.h"
 #include "wsched/FifoScheduler.h"
@@ -145,8 +148,32 @@ SsiService::SsiService(XrdSsiLogger* log, wconfig::WorkerConfig const& workerCon
     unsigned int requiredTasksCompleted = workerConfig.getRequiredTasksCompleted();
     queries->setRequiredTasksCompleted(requiredTasksCompleted);
 
+    // Large results are spooled to local disk, see wdb::ResultSpool.
+    wdb::ResultSpool::Config spoolConfig;
+    spoolConfig.dir = workerConfig.getResultSpoolDir();
+    spoolConfig.thresholdBytes = std::uint64_t(workerConfig.getResultSpoolThresholdMb())*1000000;
+
     _foreman = std::make_shared<wcontrol::Foreman>(
-            blendSched, poolSize, workerConfig.getMySqlConfig(), queries);
+            blendSched, poolSize, workerConfig.getMySqlConfig(), queries, spoolConfig,
+            std::uint64_t(workerConfig.getResultCombineMaxMb())*1000000,
+            workerConfig.getSemiJoinMaxKeys());
+
+    // Queue depths are computed when metrics are read.
+    std::weak_ptr<wsched::BlendScheduler> weakSched = blendSched;
+    auto& registry = util::MetricsRegistry::instance();
+    registry.gaugeFunction("qserv_worker_queued_tasks", "Tasks waiting in the scheduler queues",
+        [weakSched]() {
+            auto sched = weakSched.lock();
+            return sched ? static_cast<double>(sched->getSize()) : 0.0;
+        });
+    registry.gaugeFunction("qserv_worker_inflight_tasks", "Tasks being run by the schedulers",
+        [weakSched]() {
+            auto sched = weakSched.lock();
+            return sched ? static_cast<double>(sched->getInFlight()) : 0.0;
+        });
+    if (workerConfig.getMetricsPort() != 0) {
+        _metricsServer = metrics::MetricsServer::create(workerConfig.getMetricsPort());
+    }
 }
 
 SsiService::~SsiService() {
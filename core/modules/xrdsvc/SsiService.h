@@ -40,6 +40,9 @@ class XrdSsiLogger;
 
 namespace lsst {
 namespace qserv {
+namespace metrics {
+  class MetricsServer;
+}
 namespace wcontrol {
   class Foreman;
 }
@@ -77,6 +80,7 @@ private:
 
     std::shared_ptr<wpublish::ChunkInventory> _chunkInventory;
     std::shared_ptr<wcontrol::Foreman> _foreman;
+    std::shared_ptr<metrics::MetricsServer> _metricsServer; ///< nullptr if metrics are not served
 
     mysql::MySqlConfig const _mySqlConfig;
 